@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Compares the strategies of the hash-based groupby for increasing numbers of
+ * groups. With few groups, the rows of the global table strategy contend for
+ * a few slots of the hash table, which the shared memory strategy avoids; with
+ * many groups, the thread block tables overflow and only add work. The auto
+ * strategy should follow the faster of the two.
+ *
+ * Every configuration runs a SUM of an int64 column grouped by an int64
+ * column, whose keys are drawn uniformly from [0, groups).
+ *
+ * Usage: groupby_strategy_bench [num_rows] [repetitions]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <cuda_runtime.h>
+
+#include <cudf.h>
+#include <cudf/functions.h>
+#include <rmm/rmm.h>
+
+struct device_column
+{
+  gdf_column column{};
+
+  device_column(gdf_size_type size)
+  {
+    RMM_ALLOC(&column.data, size * sizeof(int64_t), 0);
+    gdf_column_view(&column, column.data, nullptr, size, GDF_INT64);
+  }
+
+  ~device_column()
+  {
+    RMM_FREE(column.data, 0);
+  }
+};
+
+// The mean time in milliseconds of a groupby with the given strategy
+float time_groupby(gdf_column * keys, gdf_column * values, gdf_groupby_strategy strategy,
+                   int repetitions)
+{
+  const gdf_size_type num_rows = keys->size;
+
+  gdf_context ctxt{};
+  ctxt.flag_method = GDF_HASH;
+  ctxt.groupby_strategy = strategy;
+
+  cudaEvent_t start, stop;
+  cudaEventCreate(&start);
+  cudaEventCreate(&stop);
+
+  float total_ms{0};
+  for (int r = 0; r < repetitions; ++r) {
+    device_column out_keys(num_rows);
+    device_column out_values(num_rows);
+    gdf_column * in_key_columns[] = {keys};
+    gdf_column * out_key_columns[] = {&out_keys.column};
+
+    cudaEventRecord(start);
+    gdf_error error = gdf_group_by_sum(1, in_key_columns, values, nullptr,
+                                       out_key_columns, &out_values.column, &ctxt);
+    cudaEventRecord(stop);
+    cudaEventSynchronize(stop);
+
+    if (GDF_SUCCESS != error) {
+      std::fprintf(stderr, "gdf_group_by_sum failed with error %d\n", error);
+      std::exit(1);
+    }
+
+    float ms{0};
+    cudaEventElapsedTime(&ms, start, stop);
+    total_ms += ms;
+  }
+
+  cudaEventDestroy(start);
+  cudaEventDestroy(stop);
+  return total_ms / repetitions;
+}
+
+int main(int argc, char** argv)
+{
+  const gdf_size_type num_rows = (argc > 1) ? std::atoi(argv[1]) : (1 << 25);
+  const int repetitions = (argc > 2) ? std::atoi(argv[2]) : 5;
+
+  rmmInitialize(nullptr);
+
+  std::printf("%10s %12s %12s %12s\n", "groups", "global ms", "shared ms", "auto ms");
+
+  for (long long num_groups = 1; num_groups <= 10000000; num_groups *= 10) {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<long long> key_distribution(0, num_groups - 1);
+    std::vector<int64_t> host_keys(num_rows);
+    std::vector<int64_t> host_values(num_rows);
+    for (gdf_size_type i = 0; i < num_rows; ++i) {
+      host_keys[i] = key_distribution(generator);
+      host_values[i] = i % 1000;
+    }
+
+    device_column keys(num_rows);
+    device_column values(num_rows);
+    cudaMemcpy(keys.column.data, host_keys.data(), num_rows * sizeof(int64_t), cudaMemcpyHostToDevice);
+    cudaMemcpy(values.column.data, host_values.data(), num_rows * sizeof(int64_t), cudaMemcpyHostToDevice);
+
+    const float global_ms = time_groupby(&keys.column, &values.column, GDF_GROUPBY_GLOBAL_TABLE, repetitions);
+    const float shared_ms = time_groupby(&keys.column, &values.column, GDF_GROUPBY_SHARED_MEMORY, repetitions);
+    const float auto_ms = time_groupby(&keys.column, &values.column, GDF_GROUPBY_AUTO, repetitions);
+
+    std::printf("%10lld %12.3f %12.3f %12.3f\n", num_groups, global_ms, shared_ms, auto_ms);
+  }
+
+  rmmFinalize();
+
+  return 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Compares the probe lengths of the hash table layouts at increasing load
+ * factors. The probe length is the number of buckets read to find a key (or
+ * to prove it absent), which is what bounds the number of memory transactions
+ * of a probe on the device. The layouts are measured with the host map, which
+ * shares the layout and probing scheme of the device map.
+ *
+ * Usage: probe_length_bench [table_size]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <hash/host_concurrent_unordered_map.cuh>
+#include <utilities/host_parallel.h>
+
+struct probe_stats
+{
+  double mean_hit{0};
+  size_t max_hit{0};
+  double mean_miss{0};
+  size_t max_miss{0};
+  double build_ms{0};
+};
+
+template <typename Probing>
+probe_stats measure(size_t table_size, double load_factor, std::vector<int> const & keys)
+{
+  using map_type = host_concurrent_unordered_map<int, int, std::numeric_limits<int>::max(),
+                                                 MurmurHash3_32<int>, std::equal_to<int>,
+                                                 false, Probing>;
+  map_type the_map(table_size, 0);
+
+  const size_t num_keys = static_cast<size_t>(load_factor * the_map.size());
+
+  auto start = std::chrono::steady_clock::now();
+  cudf::detail::host_parallel_for(num_keys, [&](size_t i) {
+    the_map.insert(std::make_pair(keys[i], 1), sum_op<int>());
+  });
+  auto stop = std::chrono::steady_clock::now();
+
+  probe_stats stats;
+  stats.build_ms = std::chrono::duration<double, std::milli>(stop - start).count();
+
+  for (size_t i = 0; i < num_keys; ++i) {
+    const size_t length = the_map.probe_length(keys[i]);
+    stats.mean_hit += length;
+    stats.max_hit = std::max(stats.max_hit, length);
+  }
+  stats.mean_hit /= num_keys;
+
+  // The keys past num_keys were not inserted
+  const size_t num_misses = std::min(num_keys, keys.size() - num_keys);
+  for (size_t i = 0; i < num_misses; ++i) {
+    const size_t length = the_map.probe_length(keys[num_keys + i]);
+    stats.mean_miss += length;
+    stats.max_miss = std::max(stats.max_miss, length);
+  }
+  stats.mean_miss /= num_misses;
+
+  return stats;
+}
+
+template <typename Probing>
+void run(std::string const & name, size_t table_size, std::vector<int> const & keys)
+{
+  for (double load_factor : {0.5, 0.7, 0.8, 0.85, 0.9, 0.95}) {
+    probe_stats stats = measure<Probing>(table_size, load_factor, keys);
+    std::printf("%-12s %6.2f %10.2f %8zu %10.2f %8zu %10.1f\n",
+                name.c_str(), load_factor,
+                stats.mean_hit, stats.max_hit,
+                stats.mean_miss, stats.max_miss,
+                stats.build_ms);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  const size_t table_size = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : (1u << 22);
+
+  // Distinct random keys: the first ones are inserted, the rest probe for misses
+  std::vector<int> keys(2 * table_size);
+  for (size_t i = 0; i < keys.size(); ++i) keys[i] = static_cast<int>(i);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+
+  std::printf("%-12s %6s %10s %8s %10s %8s %10s\n",
+              "layout", "load", "mean hit", "max hit", "mean miss", "max miss", "build ms");
+  run<linear_probing>("linear", table_size, keys);
+  run<bucketed_probing<4>>("bucketed<4>", table_size, keys);
+  run<bucketed_probing<8>>("bucketed<8>", table_size, keys);
+
+  return 0;
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Compares the multi-column ORDER BY through a comparison sort of the rows,
+ * whose LesserRTTI comparator dispatches on the dtype of every column for
+ * every comparison, with the radix sort of their normalized keys, for tables
+ * whose keys take one to three 64 bit words.
+ *
+ * The values of every column are drawn uniformly from [0, 1000), so that the
+ * rows tie on their first columns and the comparisons reach the last ones.
+ *
+ * Usage: order_by_bench [num_rows] [repetitions]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <cuda_runtime.h>
+
+#include <cudf.h>
+#include <cudf/functions.h>
+#include <rmm/rmm.h>
+#include <rmm/thrust_rmm_allocator.h>
+#include <sqls/sqls_rtti_comp.h>
+
+struct device_column
+{
+  gdf_column column{};
+
+  device_column(gdf_size_type size, gdf_dtype dtype)
+  {
+    RMM_ALLOC(&column.data, size * sizeof(int64_t), 0);
+    gdf_column_view(&column, column.data, nullptr, size, dtype);
+  }
+
+  ~device_column()
+  {
+    RMM_FREE(column.data, 0);
+  }
+};
+
+template <typename T>
+void fill_column(device_column & column, std::mt19937 & generator)
+{
+  std::uniform_int_distribution<int> distribution(0, 999);
+  std::vector<T> host_values(column.column.size);
+  for (auto & value : host_values) {
+    value = static_cast<T>(distribution(generator));
+  }
+  cudaMemcpy(column.column.data, host_values.data(), host_values.size() * sizeof(T), cudaMemcpyHostToDevice);
+}
+
+// The mean time in milliseconds of an ORDER BY, through LesserRTTI or the
+// normalized keys
+float time_order_by(std::vector<gdf_column> & columns, bool normalized_keys, int repetitions)
+{
+  const size_t num_rows = columns[0].size;
+  const size_t num_columns = columns.size();
+
+  std::vector<void*> host_data(num_columns);
+  std::vector<int> host_types(num_columns);
+  for (size_t c = 0; c < num_columns; ++c) {
+    host_data[c] = columns[c].data;
+    host_types[c] = columns[c].dtype;
+  }
+  thrust::device_vector<void*, rmm_allocator<void*>> d_cols(host_data.begin(), host_data.end());
+  thrust::device_vector<int, rmm_allocator<int>> d_types(host_types.begin(), host_types.end());
+  thrust::device_vector<size_t, rmm_allocator<size_t>> d_indx(num_rows);
+
+  cudaEvent_t start, stop;
+  cudaEventCreate(&start);
+  cudaEventCreate(&stop);
+
+  float total_ms{0};
+  for (int r = 0; r < repetitions; ++r) {
+    gdf_error error = GDF_SUCCESS;
+
+    cudaEventRecord(start);
+    if (normalized_keys) {
+      error = gdf_order_by_asc_desc(num_rows, columns.data(), num_columns, nullptr, nullptr,
+                                    d_indx.data().get());
+    }
+    else {
+      multi_col_order_by(num_rows, num_columns, d_cols.data().get(), d_types.data().get(),
+                         d_indx.data().get());
+    }
+    cudaEventRecord(stop);
+    cudaEventSynchronize(stop);
+
+    if (GDF_SUCCESS != error) {
+      std::fprintf(stderr, "gdf_order_by_asc_desc failed with error %d\n", error);
+      std::exit(1);
+    }
+
+    float ms{0};
+    cudaEventElapsedTime(&ms, start, stop);
+    total_ms += ms;
+  }
+
+  cudaEventDestroy(start);
+  cudaEventDestroy(stop);
+  return total_ms / repetitions;
+}
+
+int main(int argc, char** argv)
+{
+  const gdf_size_type num_rows = (argc > 1) ? std::atoi(argv[1]) : (1 << 24);
+  const int repetitions = (argc > 2) ? std::atoi(argv[2]) : 5;
+
+  rmmInitialize(nullptr);
+
+  std::mt19937 generator(42);
+  device_column int32_a(num_rows, GDF_INT32);
+  device_column int32_b(num_rows, GDF_INT32);
+  device_column int64_a(num_rows, GDF_INT64);
+  device_column float64_a(num_rows, GDF_FLOAT64);
+  device_column int8_a(num_rows, GDF_INT8);
+  fill_column<int32_t>(int32_a, generator);
+  fill_column<int32_t>(int32_b, generator);
+  fill_column<int64_t>(int64_a, generator);
+  fill_column<double>(float64_a, generator);
+  fill_column<int8_t>(int8_a, generator);
+
+  struct configuration
+  {
+    char const * name;
+    std::vector<gdf_column> columns;
+  };
+  std::vector<configuration> configurations{
+    {"int32", {int32_a.column}},
+    {"int32,int32", {int32_a.column, int32_b.column}},
+    {"int64,float64", {int64_a.column, float64_a.column}},
+    {"int32,float64,int8,int64", {int32_a.column, float64_a.column, int8_a.column, int64_a.column}}};
+
+  std::printf("%26s %6s %14s %14s\n", "columns", "words", "LesserRTTI ms", "radix ms");
+
+  for (auto & config : configurations) {
+    normalized_key_layout layout;
+    make_normalized_key_layout(static_cast<int>(config.columns.size()), config.columns.data(), nullptr, nullptr, false, layout);
+
+    const float comparison_ms = time_order_by(config.columns, false, repetitions);
+    const float radix_ms = time_order_by(config.columns, true, repetitions);
+
+    std::printf("%26s %6d %14.3f %14.3f\n", config.name, layout.num_words(), comparison_ms, radix_ms);
+  }
+
+  rmmFinalize();
+
+  return 0;
+}
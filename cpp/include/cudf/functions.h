@@ -93,6 +93,85 @@ gdf_error gdf_column_free(gdf_column *column);
 /* ----------------------------------------------------------------------------*/
 gdf_error gdf_column_concat(gdf_column *output, gdf_column *columns_to_concat[], int num_columns);
 
+/* spilling */
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Enables spilling of registered columns to host memory under memory
+ * pressure.
+ *
+ * Installs an RMM out of memory callback that copies the least recently used
+ * registered columns which are not acquired to pinned host memory, frees their
+ * device memory and lets the failed allocation retry.
+ * 
+ * @Param[in] enable 1 to enable spilling, 0 to disable it
+ * 
+ * @Returns GDF_SUCCESS
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error gdf_spill_enable(int enable);
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Registers the device buffers of a column as spillable.
+ *
+ * The column buffers are owned by the spill manager until the column is
+ * unregistered, and must only be accessed between gdf_spill_acquire and
+ * gdf_spill_release since they may move to host memory and back.
+ * 
+ * @Param[in] column The column whose data and valid buffers are registered
+ * @Param[out] handle The handle to access the column with
+ * 
+ * @Returns GDF_SUCCESS, or GDF_DATASET_EMPTY if the column has no data
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error gdf_spill_register(gdf_column *column, gdf_spill_handle *handle);
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Makes a registered column resident on the device and pins it
+ * there until gdf_spill_release.
+ *
+ * The column is copied back from host memory if it was spilled, in which case
+ * its buffers live at new device addresses.
+ * 
+ * @Param[in] handle The handle returned by gdf_spill_register
+ * @Param[out] column Updated with the current device buffers of the column
+ * 
+ * @Returns GDF_SUCCESS, GDF_INVALID_API_CALL if the handle is unknown, or
+ * GDF_MEMORYMANAGER_ERROR if the column cannot be copied back to the device
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error gdf_spill_acquire(gdf_spill_handle handle, gdf_column *column);
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Unpins a column acquired with gdf_spill_acquire, making it
+ * spillable again.
+ * 
+ * @Param[in] handle The handle returned by gdf_spill_register
+ * 
+ * @Returns GDF_SUCCESS, or GDF_INVALID_API_CALL if the handle is unknown or the
+ * column is not acquired
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error gdf_spill_release(gdf_spill_handle handle);
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Stops managing a column and returns ownership of its buffers,
+ * copied back to the device if needed.
+ * 
+ * @Param[in] handle The handle returned by gdf_spill_register
+ * @Param[out] column Updated with the device buffers of the column
+ * 
+ * @Returns GDF_SUCCESS, GDF_INVALID_API_CALL if the handle is unknown or the
+ * column is acquired, or GDF_MEMORYMANAGER_ERROR if the column cannot be copied
+ * back to the device. On failure the column remains registered.
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error gdf_spill_unregister(gdf_spill_handle handle, gdf_column *column);
+
 /* context operations */
 
 gdf_error gdf_context_view(gdf_context *context, int flag_sorted, gdf_method flag_method,
@@ -208,6 +287,8 @@ gdf_error gdf_segmented_radixsort_generic(gdf_segmented_radixsort_plan_type *hdl
  * If join_context->flag_method is set to GDF_SORT then the null_count of the
  * columns must be set to 0 otherwise a GDF_VALIDITY_UNSUPPORTED error is
  * returned.
+ * With GDF_SORT, the rows are merged in the lexicographic order of the join
+ * columns, and each side is sorted first unless join_context->flag_sorted is 1.
  * 
  * @Param[in] left_cols[] The columns of the left dataframe
  * @Param[in] num_left_cols The number of columns in the left dataframe
@@ -251,6 +332,8 @@ gdf_error gdf_inner_join(
  * If join_context->flag_method is set to GDF_SORT then the null_count of the
  * columns must be set to 0 otherwise a GDF_VALIDITY_UNSUPPORTED error is
  * returned.
+ * With GDF_SORT, the rows are merged in the lexicographic order of the join
+ * columns, and each side is sorted first unless join_context->flag_sorted is 1.
  * 
  * @Param[in] left_cols[] The columns of the left dataframe
  * @Param[in] num_left_cols The number of columns in the left dataframe
@@ -294,6 +377,8 @@ gdf_error gdf_left_join(
  * If join_context->flag_method is set to GDF_SORT then the null_count of the
  * columns must be set to 0 otherwise a GDF_VALIDITY_UNSUPPORTED error is
  * returned.
+ * With GDF_SORT, the rows are merged in the lexicographic order of the join
+ * columns, and each side is sorted first unless join_context->flag_sorted is 1.
  * 
  * @Param[in] left_cols[] The columns of the left dataframe
  * @Param[in] num_left_cols The number of columns in the left dataframe
@@ -330,6 +415,209 @@ gdf_error gdf_full_join(
                          gdf_column * right_indices,
                          gdf_context *join_context);
 
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Performs a left semi-join on the specified columns of two dataframes
+ * (left, right): selects the rows of the left dataframe that have an equal row in
+ * the right dataframe, i.e., `WHERE key IN (SELECT key FROM right)`.
+ *
+ * Each left row is selected at most once, however many right rows it matches.
+ * Rows with a NULL in a join column match no row.
+ * 
+ * @Param[in] left_cols[] The columns of the left dataframe
+ * @Param[in] left_join_cols[] The column indices of columns from the left dataframe
+ * to join on
+ * @Param[in] right_cols[] The columns of the right dataframe
+ * @Param[in] right_join_cols[] The column indices of columns from the right dataframe
+ * to join on
+ * @Param[in] num_cols_to_join The total number of columns to join on
+ * @Param[out] left_indices The indices of the selected rows of the left dataframe, in
+ * increasing order. Its data is allocated by the function.
+ * @Param[in] join_context The context to use to control how the join is performed.
+ * Only GDF_HASH is supported.
+ * 
+ * @Returns   GDF_SUCCESS if the join operation was successful, otherwise an appropriate
+ * error code
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error gdf_left_semi_join(gdf_column **left_cols,
+                             int left_join_cols[],
+                             gdf_column **right_cols,
+                             int right_join_cols[],
+                             int num_cols_to_join,
+                             gdf_column * left_indices,
+                             gdf_context *join_context);
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Performs a left anti-join on the specified columns of two dataframes
+ * (left, right): selects the rows of the left dataframe that have no equal row in
+ * the right dataframe, i.e., `WHERE NOT EXISTS (SELECT ... WHERE left.key = right.key)`.
+ *
+ * Rows with a NULL in a join column match no row, so they are selected.
+ * 
+ * @Param[in] left_cols[] The columns of the left dataframe
+ * @Param[in] left_join_cols[] The column indices of columns from the left dataframe
+ * to join on
+ * @Param[in] right_cols[] The columns of the right dataframe
+ * @Param[in] right_join_cols[] The column indices of columns from the right dataframe
+ * to join on
+ * @Param[in] num_cols_to_join The total number of columns to join on
+ * @Param[out] left_indices The indices of the selected rows of the left dataframe, in
+ * increasing order. Its data is allocated by the function.
+ * @Param[in] join_context The context to use to control how the join is performed.
+ * Only GDF_HASH is supported.
+ * 
+ * @Returns   GDF_SUCCESS if the join operation was successful, otherwise an appropriate
+ * error code
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error gdf_left_anti_join(gdf_column **left_cols,
+                             int left_join_cols[],
+                             gdf_column **right_cols,
+                             int right_join_cols[],
+                             int num_cols_to_join,
+                             gdf_column * left_indices,
+                             gdf_context *join_context);
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Performs an as-of join of two dataframes (left, right): matches every
+ * left row with the last right row whose on value is less than or equal to its own,
+ * e.g., every trade with the latest quote at or before its timestamp.
+ *
+ * If by columns are given, only right rows whose by columns equal those of the
+ * left row are matched, e.g., the quotes of the symbol of the trade. Among right
+ * rows of equal by and on values, the last one in the right dataframe is matched.
+ * The join is sort based, and rows with NULLs are not supported.
+ * 
+ * @Param[in] left_on The ordered column of the left dataframe, of type GDF_INT32,
+ * GDF_INT64, GDF_DATE32, GDF_DATE64 or GDF_TIMESTAMP
+ * @Param[in] right_on The ordered column of the right dataframe, of the type of left_on
+ * @Param[in] left_by[] The equality columns of the left dataframe
+ * @Param[in] right_by[] The equality columns of the right dataframe
+ * @Param[in] num_by_cols The number of equality columns, may be 0
+ * @Param[in] tolerance The largest difference between the on values of a left row
+ * and its match, in the units of the on column. Negative for no limit.
+ * @Param[out] left_indices The index of every left row, in order. Its data is
+ * allocated by the function.
+ * @Param[out] right_indices The index of the matched right row of every left row,
+ * or -1 if there is none. Its data is allocated by the function.
+ * @Param[in] join_context The context of the join. If flag_sorted is 1, the rows of
+ * both dataframes are already sorted by the by columns then the on column.
+ * 
+ * @Returns   GDF_SUCCESS if the join operation was successful, otherwise an appropriate
+ * error code
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error gdf_asof_join(gdf_column *left_on,
+                        gdf_column *right_on,
+                        gdf_column **left_by,
+                        gdf_column **right_by,
+                        int num_by_cols,
+                        int64_t tolerance,
+                        gdf_column * left_indices,
+                        gdf_column * right_indices,
+                        gdf_context *join_context);
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Builds a join hash table on a set of build columns, to be probed with
+ * any number of probe tables by gdf_join_probe, e.g., a dimension table joined
+ * with a stream of fact table batches.
+ *
+ * The data of the build columns is not copied and must stay valid until the
+ * hash table is freed with gdf_join_hash_table_free.
+ * 
+ * @Param[in] build_cols[] The columns to join on
+ * @Param[in] num_cols The number of columns to join on
+ * @Param[out] hash_table The new hash table
+ * @Param[in] join_context The context of the join. Only GDF_HASH is supported,
+ * flag_hash_64bit selects the row hash function, and hash_table_stats, if not
+ * nullptr, receives the statistics of the hash table.
+ * 
+ * @Returns   GDF_SUCCESS if the hash table was built, otherwise an appropriate
+ * error code
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error gdf_join_build(gdf_column **build_cols,
+                         int num_cols,
+                         gdf_join_hash_table **hash_table,
+                         gdf_context *join_context);
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Joins a probe table with the build columns of a join hash table
+ * 
+ * @Param[in] hash_table The hash table, built by gdf_join_build
+ * @Param[in] probe_cols[] The columns of the probe table to join on, of the same
+ * number and types as the build columns
+ * @Param[in] num_cols The number of columns to join on
+ * @Param[in] left_join If 0, performs an inner join. Otherwise performs a left join,
+ * where a probe row without a match has one output row whose build index is -1.
+ * @Param[out] probe_indices The indices of the joined rows of the probe table. Its
+ * data is allocated by the function.
+ * @Param[out] build_indices The indices of the joined rows of the build columns. Its
+ * data is allocated by the function.
+ * @Param[in] join_context The context of the join. flag_exact_join_size and
+ * hash_table_stats (only num_hash_collisions is set) apply to the probe.
+ * 
+ * @Returns   GDF_SUCCESS if the join operation was successful, otherwise an appropriate
+ * error code
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error gdf_join_probe(gdf_join_hash_table *hash_table,
+                         gdf_column **probe_cols,
+                         int num_cols,
+                         int left_join,
+                         gdf_column * probe_indices,
+                         gdf_column * build_indices,
+                         gdf_context *join_context);
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Joins a probe table with the build columns of a join hash table one
+ * chunk of probe rows at a time, for probe tables whose join output, or the
+ * columns gathered from it, do not fit in device memory at once.
+ *
+ * The probe rows are split in chunks of chunk_rows rows, and the output of each
+ * chunk is handed to the callback before the next chunk is probed. The output
+ * index columns are freed when the callback returns, so the callback gathers or
+ * copies what it needs. The probe columns may be in any memory the device can
+ * read, e.g., managed or pinned host memory, and only one chunk of them is read
+ * at a time.
+ * 
+ * @Param[in] hash_table The hash table, built by gdf_join_build
+ * @Param[in] probe_cols[] The columns of the probe table to join on, of the same
+ * number and types as the build columns
+ * @Param[in] num_cols The number of columns to join on
+ * @Param[in] left_join If 0, performs an inner join, otherwise a left join
+ * @Param[in] chunk_rows The number of probe rows of a chunk, rounded up to a
+ * multiple of GDF_VALID_BITSIZE. 0 probes the whole table as one chunk.
+ * @Param[in] callback The consumer of the output of every chunk
+ * @Param[in] user_data Passed to every call of the callback
+ * @Param[in] join_context The context of the join, see gdf_join_probe
+ * 
+ * @Returns   GDF_SUCCESS if every chunk was joined and consumed, otherwise the
+ * first error of a chunk or of the callback
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error gdf_join_probe_chunked(gdf_join_hash_table *hash_table,
+                                 gdf_column **probe_cols,
+                                 int num_cols,
+                                 int left_join,
+                                 gdf_size_type chunk_rows,
+                                 gdf_join_chunk_callback callback,
+                                 void *user_data,
+                                 gdf_context *join_context);
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Frees a join hash table built by gdf_join_build
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error gdf_join_hash_table_free(gdf_join_hash_table *hash_table);
+
 /* partioning */
 
 /* --------------------------------------------------------------------------*/
@@ -350,6 +638,8 @@ gdf_error gdf_full_join(
  * partitions. Where partition_offsets[i] indicates the starting position
  * of partition 'i'
  * @Param[in] hash The hash function to use
+ * @Param[in] seed The seed of the hash function. Partitioning a partition again
+ * with a different seed spreads its rows over the new partitions.
  * 
  * @Returns  If the operation was successful, returns GDF_SUCCESS
  */
@@ -361,7 +651,54 @@ gdf_error gdf_hash_partition(int num_input_cols,
                              int num_partitions, 
                              gdf_column * partitioned_output[],
                              int partition_offsets[],
-                             gdf_hash_func hash);
+                             gdf_hash_func hash,
+                             uint32_t seed);
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @brief Hash partitions the input columns into num_partitions partitions, and
+ * each partition into num_sub_partitions sub-partitions, in a single pass.
+ *
+ * A row belongs to partition p if gdf_hash_partition with the same hash and
+ * seed would place it in partition p, and to sub-partition s of p if
+ * gdf_hash_partition with sub_seed and num_sub_partitions would place it in
+ * partition s. The rows are rearranged by partition, then by sub-partition.
+ * 
+ * @Param[in] num_input_cols The number of columns in the input columns
+ * @Param[in] input[] The input set of columns
+ * @Param[in] columns_to_hash[] Indices of the columns in the input set to hash
+ * @Param[in] num_cols_to_hash The number of columns to hash
+ * @Param[in] num_partitions The number of first level partitions
+ * @Param[in] num_sub_partitions The number of sub-partitions of each partition.
+ * num_partitions * num_sub_partitions counters must fit in the shared memory of a block.
+ * @Param[out] partitioned_output Preallocated gdf_columns to hold the rearrangement 
+ * of the input columns
+ * @Param[out] partition_offsets Preallocated array of num_partitions offsets,
+ * where partition_offsets[p] indicates the starting position of partition 'p'
+ * @Param[out] sub_partition_offsets Preallocated array of
+ * num_partitions * num_sub_partitions offsets, where
+ * sub_partition_offsets[p * num_sub_partitions + s] indicates the starting
+ * position of sub-partition 's' of partition 'p'
+ * @Param[in] hash The hash function to use, GDF_HASH_MURMUR3 or GDF_HASH_MURMUR3_64
+ * @Param[in] seed The seed of the hash function of the first level
+ * @Param[in] sub_seed The seed of the hash function of the second level, which
+ * must differ from seed
+ * 
+ * @Returns  If the operation was successful, returns GDF_SUCCESS
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error gdf_hash_partition_two_level(int num_input_cols, 
+                                       gdf_column * input[], 
+                                       int columns_to_hash[],
+                                       int num_cols_to_hash,
+                                       int num_partitions, 
+                                       int num_sub_partitions, 
+                                       gdf_column * partitioned_output[],
+                                       int partition_offsets[],
+                                       int sub_partition_offsets[],
+                                       gdf_hash_func hash,
+                                       uint32_t seed,
+                                       uint32_t sub_seed);
 
 /* prefixsum */
 
@@ -437,13 +774,35 @@ gdf_error gdf_prefixsum_i64(gdf_column *inp, gdf_column *out, int inclusive);
  * @Param num_cols The number of columns in the input set
  * @Param input The list of columns whose rows will be hashed
  * @Param hash The hash function to use
+ * @Param seed The seed of the hash function, 0 for the default hash values
  * @Param output The hash value of each row of the input
  * 
  * @Returns   GDF_SUCCESS if the operation was successful, otherwise an appropriate
  * error code
  */
 /* ----------------------------------------------------------------------------*/
-gdf_error gdf_hash(int num_cols, gdf_column **input, gdf_hash_func hash, gdf_column *output);
+gdf_error gdf_hash(int num_cols, gdf_column **input, gdf_hash_func hash, uint32_t seed,
+                   gdf_column *output);
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Estimates the number of distinct rows of a set of columns with a
+ * HyperLogLog sketch of their 64-bit row hash values, in a single pass and a
+ * fixed amount of memory. Rows containing a NULL are not counted.
+ * 
+ * @Param num_cols The number of columns in the input set
+ * @Param input The columns whose distinct rows are counted
+ * @Param precision The sketch has 2^precision registers, and a relative standard
+ * error of about 1.04 / sqrt(2^precision). 0 for the default of 14, otherwise
+ * between 4 and 18.
+ * @Param count Receives the estimated number of distinct rows
+ * 
+ * @Returns   GDF_SUCCESS if the operation was successful, otherwise an appropriate
+ * error code
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error gdf_approx_count_distinct(int num_cols, gdf_column **input, int precision,
+                                    size_t *count);
 
 /* trig */
 
@@ -844,6 +1203,38 @@ gdf_error gdf_order_by(size_t nrows,     //in: # rows
 		       int* d_types,     //out: pre-allocated device-side array to be filled with gdf_colum::dtype for each column; slicing of gdf_column array (host)
 		       size_t* d_indx);  //out: device-side array of re-rdered row indices
 
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Computes the permutation that sorts the rows of a table by the
+ * given columns, each ascending or descending, with its NULLs first or last.
+ *
+ * The sort columns of every row are normalized into unsigned keys whose
+ * unsigned order is the order of the rows, which are radix sorted, 64 bits at
+ * a time. Equal rows keep their order.
+ *
+ * @Param nrows The number of rows
+ * @Param cols The host-side array of the sort columns, at most 32, of
+ * GDF_INT8, GDF_INT16, GDF_INT32, GDF_INT64, GDF_FLOAT32 or GDF_FLOAT64. -0.0
+ * sorts equal to 0.0, and NaN after every other value.
+ * @Param ncols The number of sort columns
+ * @Param orders The order of every column, or nullptr to sort every column
+ * ascending
+ * @Param null_orders Where the NULLs of every column are sorted, or nullptr to
+ * sort every NULL last
+ * @Param[out] d_indx The device-side array of the sorted row indices
+ *
+ * @Returns GDF_SUCCESS on success, GDF_UNSUPPORTED_DTYPE for a column of
+ * another dtype, GDF_COLUMN_SIZE_TOO_BIG for more than 32 columns or more
+ * than INT_MAX rows
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error gdf_order_by_asc_desc(size_t nrows,
+                                gdf_column* cols,
+                                size_t ncols,
+                                order_by_type* orders,
+                                gdf_null_order* null_orders,
+                                size_t* d_indx);
+
 gdf_error gdf_filter(size_t nrows,     //in: # rows
 		     gdf_column* cols, //in: host-side array of gdf_columns with 0 null_count otherwise GDF_VALIDITY_UNSUPPORTED is returned
 		     size_t ncols,     //in: # cols
@@ -854,8 +1245,8 @@ gdf_error gdf_filter(size_t nrows,     //in: # rows
 		     size_t* new_sz);  //out: host-side # rows that remain after filtering
 
 gdf_error gdf_group_by_sum(int ncols,                    // # columns
-                           gdf_column** cols,            //input cols with 0 null_count otherwise GDF_VALIDITY_UNSUPPORTED is returned
-                           gdf_column* col_agg,          //column to aggregate on with 0 null_count otherwise GDF_VALIDITY_UNSUPPORTED is returned
+                           gdf_column** cols,            //input cols with 0 null_count unless the method is GDF_HASH, otherwise GDF_VALIDITY_UNSUPPORTED is returned
+                           gdf_column* col_agg,          //column to aggregate on with 0 null_count unless the method is GDF_HASH, otherwise GDF_VALIDITY_UNSUPPORTED is returned
                            gdf_column* out_col_indices,  //if not null return indices of re-ordered rows
                            gdf_column** out_col_values,  //if not null return the grouped-by columns
                                                          //(multi-gather based on indices, which are needed anyway)
@@ -863,8 +1254,8 @@ gdf_error gdf_group_by_sum(int ncols,                    // # columns
                            gdf_context* ctxt);           //struct with additional info: bool is_sorted, flag_sort_or_hash, bool flag_count_distinct
 
 gdf_error gdf_group_by_min(int ncols,                    // # columns
-                           gdf_column** cols,            //input cols with 0 null_count otherwise GDF_VALIDITY_UNSUPPORTED is returned
-                           gdf_column* col_agg,          //column to aggregate on with 0 null_count otherwise GDF_VALIDITY_UNSUPPORTED is returned
+                           gdf_column** cols,            //input cols with 0 null_count unless the method is GDF_HASH, otherwise GDF_VALIDITY_UNSUPPORTED is returned
+                           gdf_column* col_agg,          //column to aggregate on with 0 null_count unless the method is GDF_HASH, otherwise GDF_VALIDITY_UNSUPPORTED is returned
                            gdf_column* out_col_indices,  //if not null return indices of re-ordered rows
                            gdf_column** out_col_values,  //if not null return the grouped-by columns
                                                          //(multi-gather based on indices, which are needed anyway)
@@ -873,8 +1264,8 @@ gdf_error gdf_group_by_min(int ncols,                    // # columns
 
 
 gdf_error gdf_group_by_max(int ncols,                    // # columns
-                           gdf_column** cols,            //input cols with 0 null_count otherwise GDF_VALIDITY_UNSUPPORTED is returned
-                           gdf_column* col_agg,          //column to aggregate on with 0 null_count otherwise GDF_VALIDITY_UNSUPPORTED is returned
+                           gdf_column** cols,            //input cols with 0 null_count unless the method is GDF_HASH, otherwise GDF_VALIDITY_UNSUPPORTED is returned
+                           gdf_column* col_agg,          //column to aggregate on with 0 null_count unless the method is GDF_HASH, otherwise GDF_VALIDITY_UNSUPPORTED is returned
                            gdf_column* out_col_indices,  //if not null return indices of re-ordered rows
                            gdf_column** out_col_values,  //if not null return the grouped-by columns
                                                          //(multi-gather based on indices, which are needed anyway)
@@ -883,8 +1274,8 @@ gdf_error gdf_group_by_max(int ncols,                    // # columns
 
 
 gdf_error gdf_group_by_avg(int ncols,                    // # columns
-                           gdf_column** cols,            //input cols with 0 null_count otherwise GDF_VALIDITY_UNSUPPORTED is returned
-                           gdf_column* col_agg,          //column to aggregate on with 0 null_count otherwise GDF_VALIDITY_UNSUPPORTED is returned
+                           gdf_column** cols,            //input cols with 0 null_count unless the method is GDF_HASH, otherwise GDF_VALIDITY_UNSUPPORTED is returned
+                           gdf_column* col_agg,          //column to aggregate on with 0 null_count unless the method is GDF_HASH, otherwise GDF_VALIDITY_UNSUPPORTED is returned
                            gdf_column* out_col_indices,  //if not null return indices of re-ordered rows
                            gdf_column** out_col_values,  //if not null return the grouped-by columns
                                                          //(multi-gather based on indices, which are needed anyway)
@@ -892,14 +1283,179 @@ gdf_error gdf_group_by_avg(int ncols,                    // # columns
                            gdf_context* ctxt);            //struct with additional info: bool is_sorted, flag_sort_or_hash, bool flag_count_distinct
 
 gdf_error gdf_group_by_count(int ncols,                    // # columns
-                             gdf_column** cols,            //input cols with 0 null_count otherwise GDF_VALIDITY_UNSUPPORTED is returned
-                             gdf_column* col_agg,          //column to aggregate on with 0 null_count otherwise GDF_VALIDITY_UNSUPPORTED is returned
+                             gdf_column** cols,            //input cols with 0 null_count unless the method is GDF_HASH, otherwise GDF_VALIDITY_UNSUPPORTED is returned
+                             gdf_column* col_agg,          //column to aggregate on with 0 null_count unless the method is GDF_HASH, otherwise GDF_VALIDITY_UNSUPPORTED is returned
                              gdf_column* out_col_indices,  //if not null return indices of re-ordered rows
                              gdf_column** out_col_values,  //if not null return the grouped-by columns
                                                          //(multi-gather based on indices, which are needed anyway)
                              gdf_column* out_col_agg,      //aggregation result
                              gdf_context* ctxt);            //struct with additional info: bool is_sorted, flag_sort_or_hash, bool flag_count_distinct
 
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Groups the rows of a set of columns and computes any number of
+ * aggregations of them, each on its own column with its own operation.
+ *
+ * With GDF_HASH, all the aggregations are computed in a single pass over the
+ * input. With GDF_SORT, they are computed one at a time.
+ *
+ * With GDF_HASH, the columns may have NULLs. NULL values are skipped by every
+ * aggregation, and not counted by GDF_COUNT. The result of a group without any
+ * non-null value is NULL, except for GDF_COUNT, which is then 0. Rows with a NULL
+ * key are dropped, or form groups of their own if ctxt->flag_groupby_include_nulls
+ * is 1. The validity masks of the outputs, if allocated, are written along with
+ * their data, and their null_count is set. The output of an aggregation whose
+ * result can be NULL, GDF_VAR and GDF_STD or any other operation than GDF_COUNT
+ * on a column with nulls, must have a validity mask.
+ *
+ * GDF_VAR and GDF_STD (sample variance and standard deviation) and GDF_FIRST and
+ * GDF_LAST (the value of the first and last row of the group) require GDF_HASH.
+ * GDF_VAR and GDF_STD are NULL for a group of fewer than 2 values. GDF_MEDIAN
+ * requires GDF_SORT, see gdf_group_by_quantile for any other quantile.
+ * 
+ * @Param[in] ncols The number of columns to group-by
+ * @Param[in] cols The columns to group-by, with 0 null_count unless the method
+ * is GDF_HASH, otherwise GDF_VALIDITY_UNSUPPORTED is returned
+ * @Param[in] num_aggs The number of columns to aggregate on
+ * @Param[in] col_aggs The columns to aggregate on, with 0 null_count unless the
+ * method is GDF_HASH, otherwise GDF_VALIDITY_UNSUPPORTED is returned
+ * @Param[in] agg_ops The aggregation operation of each column to aggregate on
+ * @Param[out] out_col_values Preallocated grouped-by columns
+ * @Param[out] out_col_aggs Preallocated aggregation results, one per column to
+ * aggregate on. With GDF_HASH, each result is converted to the dtype of its column.
+ * @Param[in] ctxt The method, the sorting of the result, the handling of NULL keys,
+ * the cardinality hint and the hash table statistics
+ * 
+ * @Returns GDF_SUCCESS, GDF_VALIDITY_MISSING if the output of an aggregation
+ * whose result can be NULL has no validity mask, or the error code of the groupby
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error gdf_group_by(int ncols,
+                       gdf_column** cols,
+                       int num_aggs,
+                       gdf_column** col_aggs,
+                       gdf_agg_op* agg_ops,
+                       gdf_column** out_col_values,
+                       gdf_column** out_col_aggs,
+                       gdf_context* ctxt);
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  The number of partial aggregate columns of an aggregation
+ * operation, see gdf_group_by_partial
+ * 
+ * @Param[in] op The aggregation operation
+ * 
+ * @Returns The number of columns, 0 if the operation has no partial aggregates
+ */
+/* ----------------------------------------------------------------------------*/
+int gdf_group_by_num_partial_columns(gdf_agg_op op);
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Groups the rows of a part of a table and computes the partial
+ * aggregates of any number of aggregations, the intermediate state that
+ * gdf_group_by_merge merges with that of the other parts of the table. The
+ * partial aggregate columns of every aggregation are, in order:
+ *
+ * GDF_SUM, GDF_MIN, GDF_MAX, GDF_COUNT, GDF_FIRST, GDF_LAST: the aggregation itself
+ * GDF_AVG: the SUM, and the COUNT as GDF_INT64
+ * GDF_VAR, GDF_STD: the COUNT as GDF_INT64, the mean, and the sum of squared
+ * deviations from the mean (M2) as GDF_FLOAT64
+ *
+ * The groupby is that of gdf_group_by with GDF_HASH, with the same handling of NULLs
+ * and validity masks, except that M2 is never NULL and needs no validity mask.
+ * 
+ * @Param[in] ncols The number of columns to group-by
+ * @Param[in] cols The columns to group-by
+ * @Param[in] num_aggs The number of columns to aggregate on
+ * @Param[in] col_aggs The columns to aggregate on
+ * @Param[in] agg_ops The aggregation operation of each column to aggregate on
+ * @Param[out] out_col_values Preallocated grouped-by columns
+ * @Param[out] out_col_partials Preallocated partial aggregate columns, the
+ * gdf_group_by_num_partial_columns of every aggregation in order
+ * @Param[in] ctxt The method, which must be GDF_HASH, and the options of gdf_group_by
+ * 
+ * @Returns GDF_SUCCESS, GDF_UNSUPPORTED_METHOD for an operation without partial
+ * aggregates, GDF_UNSUPPORTED_DTYPE for a COUNT or M2 column of another dtype,
+ * or the error code of the groupby
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error gdf_group_by_partial(int ncols,
+                               gdf_column** cols,
+                               int num_aggs,
+                               gdf_column** col_aggs,
+                               gdf_agg_op* agg_ops,
+                               gdf_column** out_col_values,
+                               gdf_column** out_col_partials,
+                               gdf_context* ctxt);
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Merges the partial aggregates of the parts of a table, computed
+ * by gdf_group_by_partial, into the results of the aggregations on the whole
+ * table, as gdf_group_by computes them. The COUNTs are summed, AVG is the sum
+ * of the SUMs divided by the sum of the COUNTs, and VAR and STD merge the
+ * moments of the parts. FIRST and LAST require the parts to be concatenated in
+ * the order of their rows.
+ * 
+ * @Param[in] ncols The number of grouped-by columns
+ * @Param[in] cols The grouped-by columns of the partial aggregates of the
+ * parts, concatenated
+ * @Param[in] num_aggs The number of aggregations
+ * @Param[in] col_partials The partial aggregate columns of the parts,
+ * concatenated, in the layout of gdf_group_by_partial
+ * @Param[in] agg_ops The aggregation operation of each aggregation
+ * @Param[out] out_col_values Preallocated grouped-by columns
+ * @Param[out] out_col_aggs Preallocated aggregation results, one per
+ * aggregation, each converted to the dtype of its column. The results of
+ * GDF_VAR and GDF_STD, and those of any other operation than GDF_COUNT on
+ * partial aggregates with nulls, can be NULL and need a validity mask.
+ * @Param[in] ctxt The method, which must be GDF_HASH, and the options of gdf_group_by
+ * 
+ * @Returns GDF_SUCCESS, GDF_VALIDITY_MISSING if the output of an aggregation
+ * whose result can be NULL has no validity mask, or the error code of the groupby
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error gdf_group_by_merge(int ncols,
+                             gdf_column** cols,
+                             int num_aggs,
+                             gdf_column** col_partials,
+                             gdf_agg_op* agg_ops,
+                             gdf_column** out_col_values,
+                             gdf_column** out_col_aggs,
+                             gdf_context* ctxt);
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Groups the rows of a set of columns and computes a quantile of the
+ * values of a column within every group, as GDF_MEDIAN does for the 0.5 quantile.
+ * The groups are sorted.
+ * 
+ * @Param[in] ncols The number of columns to group-by
+ * @Param[in] cols The columns to group-by, with 0 null_count
+ * @Param[in] col_agg The column to aggregate on, with 0 null_count
+ * @Param[out] out_col_indices If not null, the indices of the re-ordered rows
+ * @Param[out] out_col_values If not null, preallocated grouped-by columns
+ * @Param[out] out_col_agg The preallocated quantile of every group, converted to its dtype
+ * @Param[in] q The requested quantile in [0,1]
+ * @Param[in] method How to interpolate between the two values around the quantile
+ * @Param[in] ctxt The method, which must be GDF_SORT, and whether the rows are sorted
+ * 
+ * @Returns GDF_SUCCESS, GDF_INVALID_API_CALL if q or method is invalid, or the
+ * error code of the groupby
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error gdf_group_by_quantile(int ncols,
+                                gdf_column** cols,
+                                gdf_column* col_agg,
+                                gdf_column* out_col_indices,
+                                gdf_column** out_col_values,
+                                gdf_column* out_col_agg,
+                                double q,
+                                gdf_quantile_method method,
+                                gdf_context* ctxt);
+
 gdf_error gdf_quantile_exact(	gdf_column*         col_in,       //input column with 0 null_count otherwise GDF_VALIDITY_UNSUPPORTED is returned
                                 gdf_quantile_method prec,         //precision: type of quantile method calculation
                                 double              q,            //requested quantile in [0,1]
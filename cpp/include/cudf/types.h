@@ -67,6 +67,7 @@ typedef enum {
 typedef enum {
     GDF_HASH_MURMUR3=0, /**< Murmur3 hash function */
     GDF_HASH_IDENTITY,  /**< Identity hash function that simply returns the key to be hashed */
+    GDF_HASH_MURMUR3_64, /**< 64-bit Murmur3 hash function (first half of MurmurHash3_x64_128) */
 } gdf_hash_func;
 
 typedef enum {
@@ -102,9 +103,26 @@ typedef struct gdf_column_{
 typedef enum {
   GDF_SORT = 0,   /**< Indicates that the sort-based implementation of the function will be used */
   GDF_HASH,       /**< Indicates that the hash-based implementation of the function will be used */
+  GDF_HASH_PARTITIONED, /**< Indicates that the radix-partitioned hash-based implementation of the
+                             function will be used. Only supported by joins. */
   N_GDF_METHODS,  /* additional methods should go BEFORE N_GDF_METHODS */
 } gdf_method;
 
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  These enums select how the hash-based groupby aggregates the rows
+ * of a group.
+ */
+/* ----------------------------------------------------------------------------*/
+typedef enum {
+  GDF_GROUPBY_AUTO = 0,        /**< Selects the strategy from the cardinality hint, or the estimated
+                                    number of groups */
+  GDF_GROUPBY_GLOBAL_TABLE,    /**< Every row updates the hash table in global memory */
+  GDF_GROUPBY_SHARED_MEMORY,   /**< Every thread block aggregates its rows in a small hash table in
+                                    shared memory, then merges it into the global hash table. Faster
+                                    for few groups, whose slots of the global table are contended */
+} gdf_groupby_strategy;
+
 typedef enum {
   GDF_QUANT_LINEAR =0,
   GDF_QUANT_LOWER,
@@ -128,6 +146,11 @@ typedef enum {
   GDF_AVG,            /**< Computes arithmetic mean of all values in the aggregation column */
   GDF_COUNT,          /**< Computes histogram of the occurance of each key in the GroupBy Columns */
   GDF_COUNT_DISTINCT, /**< Counts the number of distinct keys in the GroupBy columns */
+  GDF_VAR,            /**< Computes the sample variance (n - 1 degrees of freedom) of the values in the aggregation column */
+  GDF_STD,            /**< Computes the sample standard deviation of the values in the aggregation column */
+  GDF_FIRST,          /**< Returns the value of the first row, by row index, in the aggregation column */
+  GDF_LAST,           /**< Returns the value of the last row, by row index, in the aggregation column */
+  GDF_MEDIAN,         /**< Computes the median of the values in the aggregation column */
   N_GDF_AGG_OPS,      /**< The total number of aggregation operations. ALL NEW OPERATIONS SHOULD BE ADDED ABOVE THIS LINE*/
 } gdf_agg_op;
 
@@ -153,6 +176,47 @@ typedef enum {
   GDF_NUM_COLORS, /** Add new colors above this line */
 } gdf_color;
 
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Statistics of the hash table built by a hash-based join or groupby,
+ * to detect skewed keys and poor hash functions.
+ */
+/* ----------------------------------------------------------------------------*/
+typedef struct gdf_hash_table_stats_{
+  size_t table_size;          /**< The number of slots in the hash table */
+  size_t num_entries;         /**< The number of occupied slots */
+  double load_factor;         /**< num_entries / table_size */
+  double mean_probe_length;   /**< The mean number of buckets read to find an entry */
+  size_t max_probe_length;    /**< The largest number of buckets read to find an entry */
+  size_t num_hash_collisions; /**< The number of unequal rows with equal hash values. For
+                                   groupby, distinct groups minus distinct hash values. For
+                                   join, (probe row, build row) pairs with equal hash values
+                                   and unequal rows. */
+  int build_side_swapped;     /**< For joins, 1 if the hash table was built on the left
+                                   table instead of the right one, 0 otherwise */
+} gdf_hash_table_stats;
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Cost hook of a candidate build side of a hash inner join, lower is
+ * better. The hash table is built on the left table when building it there is
+ * strictly cheaper than on the right table.
+ *
+ * @Param build_rows The number of rows of the build side
+ * @Param build_distinct_keys The number of distinct keys of the build side, 0 if unknown
+ * @Param probe_rows The number of rows of the probe side
+ * @Param probe_distinct_keys The number of distinct keys of the probe side, 0 if unknown
+ * @Param entry_size The size in bytes of a slot of the hash table
+ * @Param occupancy_percent The target occupancy of the hash table
+ */
+/* ----------------------------------------------------------------------------*/
+typedef double (*gdf_join_build_side_cost)(size_t build_rows,
+                                           size_t build_distinct_keys,
+                                           size_t probe_rows,
+                                           size_t probe_distinct_keys,
+                                           size_t entry_size,
+                                           int64_t occupancy_percent);
+
 /* --------------------------------------------------------------------------*/
 /** 
  * @Synopsis  This struct holds various information about how an operation should be 
@@ -165,8 +229,41 @@ typedef struct gdf_context_{
   int flag_distinct;      /**< for COUNT: DISTINCT = 1, else = 0 */
   int flag_sort_result;   /**< When method is GDF_HASH, 0 = result is not sorted, 1 = result is sorted */
   int flag_sort_inplace;  /**< 0 = No sort in place allowed, 1 = else */
+  size_t cardinality_hint; /**< When method is GDF_HASH, the expected number of distinct keys. 0 = unknown,
+                                in which case a groupby of a large input estimates it */
+  int flag_hash_64bit;    /**< When method is GDF_HASH, 1 = key the join hash table on 64-bit row hashes,
+                               0 = 32-bit. 64-bit hashes double the size of the table and avoid
+                               comparing the rows of unequal keys with equal hash values */
+  gdf_hash_table_stats *hash_table_stats; /**< When method is GDF_HASH and not NULL, receives the
+                                               statistics of the hash table */
+  size_t max_partition_rows; /**< When method is GDF_HASH_PARTITIONED, the largest number of build
+                                  rows in a partition. 0 = as many as keep the hash table of a
+                                  partition in the L2 cache */
+  int flag_exact_join_size; /**< When method is GDF_HASH, 1 = size the join output exactly with a
+                                 counting pass over the probe rows, and write it in probe row order,
+                                 0 = estimate the size from a sample and probe again on overflow */
+  int flag_groupby_include_nulls; /**< When grouping with GDF_HASH, 1 = the rows with a NULL key form
+                                       groups of their own, NULLs being equal to each other,
+                                       0 = they are dropped */
+  gdf_groupby_strategy groupby_strategy; /**< When grouping with GDF_HASH a single aggregation
+                                              column, how the rows are aggregated */
+  size_t join_left_distinct_keys;  /**< When joining with GDF_HASH, the number of distinct keys of
+                                        the left table, e.g., from gdf_approx_count_distinct.
+                                        0 = unknown */
+  size_t join_right_distinct_keys; /**< When joining with GDF_HASH, the number of distinct keys of
+                                        the right table. 0 = unknown */
+  gdf_join_build_side_cost join_build_side_cost; /**< When inner joining with GDF_HASH, the cost
+                                                      hook choosing the side the hash table is
+                                                      built on. nullptr = the default cost */
 } gdf_context;
 
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Handle to a spillable column, see gdf_spill_register
+ */
+/* ----------------------------------------------------------------------------*/
+typedef unsigned long gdf_spill_handle;
+
 struct _OpaqueIpcParser;
 typedef struct _OpaqueIpcParser gdf_ipc_parser_type;
 
@@ -179,6 +276,38 @@ struct _OpaqueSegmentedRadixsortPlan;
 typedef struct _OpaqueSegmentedRadixsortPlan gdf_segmented_radixsort_plan_type;
 
 
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Handle to a join hash table built once and probed many times, see
+ * gdf_join_build
+ */
+/* ----------------------------------------------------------------------------*/
+struct _OpaqueJoinHashTable;
+typedef struct _OpaqueJoinHashTable gdf_join_hash_table;
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Consumer of the output of a chunk of probe rows, see
+ * gdf_join_probe_chunked
+ *
+ * @Param chunk_begin The first probe row of the chunk
+ * @Param chunk_end One past the last probe row of the chunk
+ * @Param probe_indices The probe row indices of the joined rows, relative to
+ * chunk_begin
+ * @Param build_indices The build row indices of the joined rows
+ * @Param user_data The user data passed to gdf_join_probe_chunked
+ *
+ * @Returns GDF_SUCCESS to continue with the next chunk, any other value stops
+ * the probe and is returned by gdf_join_probe_chunked
+ */
+/* ----------------------------------------------------------------------------*/
+typedef gdf_error (*gdf_join_chunk_callback)(gdf_size_type chunk_begin,
+                                             gdf_size_type chunk_end,
+                                             gdf_column * probe_indices,
+                                             gdf_column * build_indices,
+                                             void * user_data);
+
+
 
 
 typedef enum{
@@ -186,6 +315,14 @@ typedef enum{
 	GDF_ORDER_DESC
 } order_by_type;
 
+/**
+ * @brief  Where an ORDER BY sorts the NULLs of a column
+ */
+typedef enum{
+	GDF_NULLS_LAST,   ///< NULLs after every value, whether ascending or descending
+	GDF_NULLS_FIRST   ///< NULLs before every value, whether ascending or descending
+} gdf_null_order;
+
 typedef enum{
 	GDF_EQUALS,
 	GDF_NOT_EQUALS,
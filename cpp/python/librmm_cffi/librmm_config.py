@@ -32,3 +32,7 @@ initial_pool_size = 0
 
 # enable run-time logging of all memory events (alloc, free, realloc)
 enable_logging = False
+
+# track outstanding allocations to report leaks, double frees and frees of
+# unknown pointers at finalization
+enable_leak_tracking = False
@@ -80,7 +80,8 @@ class _RMMWrapper(object):
         opts = self._ffi.new("rmmOptions_t *",
                              [rmm_cfg.use_pool_allocator,
                               rmm_cfg.initial_pool_size,
-                              rmm_cfg.enable_logging])
+                              rmm_cfg.enable_logging,
+                              rmm_cfg.enable_leak_tracking])
         return self.rmmInitialize(opts)
 
     def finalize(self):
@@ -93,7 +94,7 @@ class _RMMWrapper(object):
            this file.)
         """
         # Go up stack to find first caller outside this file (more useful)
-        if rmm_cfg.enable_logging:
+        if rmm_cfg.enable_logging or rmm_cfg.enable_leak_tracking:
             frame = inspect.currentframe().f_back
             while frame:
                 filename = inspect.getfile(frame)
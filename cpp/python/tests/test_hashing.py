@@ -49,7 +49,7 @@ def _call_hash_multi(api, ncols, col_input, magic, nrows):
     libgdf.gdf_column_view(col_out, unwrap_devary(d_out), ffi.NULL,
                            out_ary.size, get_dtype(d_out.dtype))
 
-    api(ncols, col_input, magic, col_out)
+    api(ncols, col_input, magic, 0, col_out)
 
     hashed_result = d_out.copy_to_host()
     print(hashed_result)
@@ -7,6 +7,16 @@ gdf_error gdf_context_view(gdf_context *context, int flag_sorted, gdf_method fla
     context->flag_distinct = flag_distinct;
     context->flag_sort_result = flag_sort_result;
     context->flag_sort_inplace = flag_sort_inplace;
+    context->cardinality_hint = 0;
+    context->flag_hash_64bit = 0;
+    context->hash_table_stats = nullptr;
+    context->max_partition_rows = 0;
+    context->flag_exact_join_size = 0;
+    context->flag_groupby_include_nulls = 0;
+    context->groupby_strategy = GDF_GROUPBY_AUTO;
+    context->join_left_distinct_keys = 0;
+    context->join_right_distinct_keys = 0;
+    context->join_build_side_cost = nullptr;
     return GDF_SUCCESS;
 }
 
@@ -532,6 +532,9 @@ public:
    * @Param rhs The other table whose row is compared to this tables
    * @Param this_row_index The row index of this table to compare
    * @Param rhs_row_index The row index of the rhs table to compare
+   * @Param nulls_are_equal If true, two NULL elements are equal, e.g., to
+   * group the rows with NULL keys. Otherwise a row containing a NULL is equal
+   * to no row.
    * 
    * @Returns True if the elements in both rows are equivalent, otherwise False
    */
@@ -539,13 +542,14 @@ public:
   __device__
   bool rows_equal(gdf_table const & rhs, 
                   const size_type this_row_index, 
-                  const size_type rhs_row_index) const
+                  const size_type rhs_row_index,
+                  bool nulls_are_equal = false) const
   {
 
     // If either row contains a NULL, then by definition, because NULL != x for all x,
     // the two rows are not equal
     bool const valid = this->is_row_valid(this_row_index) && rhs.is_row_valid(rhs_row_index);
-    if (false == valid) 
+    if ((false == valid) && (false == nulls_are_equal))
     {
       return false;
     }
@@ -560,6 +564,19 @@ public:
         return false;
       }
 
+      // A NULL element is only equal to another NULL element
+      if(false == valid)
+      {
+        bool const this_elem_valid = gdf_is_valid(d_columns_valids[i], this_row_index);
+        bool const rhs_elem_valid = gdf_is_valid(rhs.d_columns_valids[i], rhs_row_index);
+        if(this_elem_valid != rhs_elem_valid){
+          return false;
+        }
+        if(false == this_elem_valid){
+          continue;
+        }
+      }
+
       bool is_equal = cudf::type_dispatcher(this_col_type, 
                                             elements_are_equal{}, 
                                             d_columns_data[i], 
@@ -582,16 +599,22 @@ public:
   template < template <typename> typename hash_function >
   struct hash_element
   {
+    using result_type = hash_result_t<hash_function>;
+
     template <typename col_type>
     __device__ __forceinline__
-    void operator()(hash_value_type& hash_value, 
+    void operator()(result_type& hash_value, 
                     void const * col_data,
                     size_type row_index,
-                    size_type col_index)
+                    size_type col_index,
+                    uint32_t seed,
+                    bool is_valid = true)
     {
-      hash_function<col_type> hasher;
+      hash_function<col_type> hasher{seed};
       col_type const * const current_column{static_cast<col_type const*>(col_data)};
-      hash_value_type const key_hash{hasher(current_column[row_index])};
+
+      // The data under a NULL is undefined, so all NULLs hash as the same value
+      result_type const key_hash{is_valid ? hasher(current_column[row_index]) : hasher(col_type{})};
 
       // Only combine hash-values after the first column
       if(0 == col_index)
@@ -608,17 +631,21 @@ public:
    * @Param row_index The row of the table to compute the hash value for
    * @Param num_columns_to_hash The number of columns in the row to hash. If 0, 
    * hashes all columns
+   * @Param seed The seed of the hash function. Hashing with different seeds
+   * gives independent hash values, e.g., for the levels of a recursive partitioning.
    * @tparam hash_function The hash function that is used for each element in the row,
-   * as well as combine hash values
+   * as well as combine hash values. Its result_type is the type of the hash value,
+   * e.g., 64 bits for MurmurHash3_64.
    * 
    * @Returns The hash value of the row
    */
   /* ----------------------------------------------------------------------------*/
   template <template <typename> class hash_function = default_hash>
   __device__ 
-  hash_value_type hash_row(size_type row_index, size_type num_columns_to_hash = 0) const
+  hash_result_t<hash_function> hash_row(size_type row_index, size_type num_columns_to_hash = 0,
+                                        uint32_t seed = 0) const
   {
-    hash_value_type hash_value{0};
+    hash_result_t<hash_function> hash_value{0};
 
     // If num_columns_to_hash is zero, hash all columns
     if(0 == num_columns_to_hash) 
@@ -633,7 +660,8 @@ public:
 
       cudf::type_dispatcher(current_column_type, 
                           hash_element<hash_function>{}, 
-                          hash_value, d_columns_data[i], row_index, i);
+                          hash_value, d_columns_data[i], row_index, i, seed,
+                          gdf_is_valid(d_columns_valids[i], row_index));
     }
 
     return hash_value;
@@ -659,7 +687,7 @@ public:
   template <typename index_type>
   gdf_error gather(index_type const * const row_gather_map,
                    gdf_table<size_type> & gather_output_table,
-                   bool range_check = false)
+                   bool range_check = false) const
   {
     gdf_error gdf_status{GDF_SUCCESS};
   
@@ -751,14 +779,14 @@ public:
 
   template <typename index_type>
   gdf_error gather(Vector<index_type> const & row_gather_map,
-          gdf_table<size_type> & gather_output_table, bool range_check = false)
+          gdf_table<size_type> & gather_output_table, bool range_check = false) const
   {
       return gather(row_gather_map.data().get(), gather_output_table, range_check);
   }
 
   template <typename index_type>
   gdf_error gather(gdf_column * row_gather_map,
-          gdf_table<size_type> & gather_output_table, bool range_check = false)
+          gdf_table<size_type> & gather_output_table, bool range_check = false) const
   {
       auto ptr = static_cast<index_type*>(row_gather_map->data);
       return gather(ptr, gather_output_table, range_check);
@@ -808,6 +836,25 @@ public:
 
       cudaStream_t stream = NULL;
 
+      // Vector that will store the permutation of the rows after the sort
+      Vector<size_type> permuted_indices(column_length);
+
+      // Radix sort the normalized keys of the rows when the columns have them
+      // and cub can sort that many rows. Like the LesserRTTI comparison, the
+      // sort ignores the validity
+      std::vector<gdf_column> columns(num_columns);
+      for (size_type i = 0; i < num_columns; ++i) {
+        columns[i] = *host_columns[i];
+      }
+      normalized_key_layout layout;
+      if (radix_sortable_rows(column_length)
+          && make_normalized_key_layout(num_columns, columns.data(), nullptr, nullptr, true, layout)
+          && (cudaSuccess == normalized_keys_order_by(column_length, layout,
+                                                      permuted_indices.data().get(), stream))) {
+        gather<size_type>(permuted_indices);
+        return permuted_indices;
+      }
+
       // Functor that defines a `less` operator between rows of a set of
       // gdf_columns
       LesserRTTI<size_type> comparator(d_columns_data,
@@ -817,8 +864,6 @@ public:
       rmm_temp_allocator allocator(stream);
 	    auto exec = thrust::cuda::par(allocator).on(stream);
 
-      // Vector that will store the permutation of the rows after the sort
-      Vector<size_type> permuted_indices(column_length);
       thrust::sequence(exec, permuted_indices.begin(), permuted_indices.end());
 
       // Use the LesserRTTI functor to sort the rows of the table and the
@@ -17,6 +17,7 @@
 #ifndef AGGREGATION_OPERATIONS_H
 #define AGGREGATION_OPERATIONS_H
 
+#include <cmath>
 #include <limits>
 
 // This header defines the functors that may be used as aggregation operations for 
@@ -84,4 +85,69 @@ struct avg_op
   }
 };
 
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The count, mean and sum of squared deviations from the mean (M2)
+ * of a set of values, from which their variance is computed. The moments of
+ * the empty set, moments{}, are the identity of welford_op.
+ */
+/* ----------------------------------------------------------------------------*/
+struct moments
+{
+  double count;
+  double mean;
+  double m2;
+
+  // The sample variance, with count - 1 degrees of freedom
+  __host__ __device__ double variance() const
+  {
+    return m2 / (count - 1);
+  }
+};
+
+// Functor for VAR and STD. Merges the moments of two sets of values with the
+// parallel algorithm of Chan et al., which, unlike the difference of the sum of
+// squares and the squared sum, does not cancel out the variance of values far
+// from 0. Adding a single value is Welford's algorithm.
+struct welford_op
+{
+  __host__ __device__ moments operator()(moments new_value, moments old_value) const
+  {
+    const double count = new_value.count + old_value.count;
+    if(0 == count) return old_value;
+
+    const double delta = new_value.mean - old_value.mean;
+    moments merged;
+    merged.count = count;
+    merged.mean = old_value.mean + delta * (new_value.count / count);
+    merged.m2 = old_value.m2 + new_value.m2 + delta * delta * (old_value.count * new_value.count / count);
+    return merged;
+  }
+
+  __host__ __device__ moments operator()(double new_value, moments old_value) const
+  {
+    return (*this)(moments{1, new_value, 0}, old_value);
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The moments of a set of values from the sum and the sum of squares
+ * of their differences with a shift value. The variance is then computed from
+ * values of the magnitude of the spread of the set, rather than of the values,
+ * when the shift is one of them.
+ */
+/* ----------------------------------------------------------------------------*/
+__host__ __device__ inline moments moments_from_shifted_sums(double count,
+                                                             double shift,
+                                                             double sum,
+                                                             double sum_of_squares)
+{
+  if(0 == count) return moments{0, 0, 0};
+
+  const double shifted_mean = sum / count;
+  const double m2 = sum_of_squares - sum * shifted_mean;
+  return moments{count, shift + shifted_mean, (m2 > 0) ? m2 : 0};
+}
+
 #endif
@@ -33,6 +33,9 @@
  * @Param groupby_output_table The output groupby table
  * @Param out_aggregation_column The output aggregation column
  * @Param sort_result Flag to optionally sort the output
+ * @Param cardinality_hint The expected number of groups, 0 if unknown
+ * @Param hash_table_stats If not nullptr, receives the statistics of the hash table
+ * @Param strategy How the rows are aggregated
  * @tparam aggregation_type  The type of the aggregation column
  * @tparam op A binary functor that implements the aggregation operation
  * 
@@ -46,7 +49,10 @@ gdf_error typed_groupby(gdf_table<size_type> const & groupby_input_table,
                         gdf_column* in_aggregation_column,       
                         gdf_table<size_type> & groupby_output_table,
                         gdf_column* out_aggregation_column,
-                        bool sort_result = false)
+                        bool sort_result = false,
+                        size_t cardinality_hint = 0,
+                        gdf_hash_table_stats * hash_table_stats = nullptr,
+                        gdf_groupby_strategy strategy = GDF_GROUPBY_AUTO)
 {
   // Template the functor on the type of the aggregation column
   using op_type = op<aggregation_type>;
@@ -64,7 +70,10 @@ gdf_error typed_groupby(gdf_table<size_type> const & groupby_input_table,
                                          out_agg_col, 
                                          &output_size, 
                                          op_type(), 
-                                         sort_result);
+                                         sort_result,
+                                         cardinality_hint,
+                                         hash_table_stats,
+                                         strategy);
 
   out_aggregation_column->size = output_size;
 
@@ -91,7 +100,10 @@ gdf_error dispatch_aggregation_type(gdf_table<size_type> const & groupby_input_t
                                     gdf_column* in_aggregation_column,       
                                     gdf_table<size_type> & groupby_output_table,
                                     gdf_column* out_aggregation_column,
-                                    bool sort_result = false)
+                                    bool sort_result = false,
+                                    size_t cardinality_hint = 0,
+                                    gdf_hash_table_stats * hash_table_stats = nullptr,
+                                    gdf_groupby_strategy strategy = GDF_GROUPBY_AUTO)
 {
 
 
@@ -119,7 +131,10 @@ gdf_error dispatch_aggregation_type(gdf_table<size_type> const & groupby_input_t
                                          in_aggregation_column, 
                                          groupby_output_table, 
                                          out_aggregation_column, 
-                                         sort_result);
+                                         sort_result,
+                                         cardinality_hint,
+                                         hash_table_stats,
+                                         strategy);
       }
     case GDF_INT16:  
       { 
@@ -127,7 +142,10 @@ gdf_error dispatch_aggregation_type(gdf_table<size_type> const & groupby_input_t
                                           in_aggregation_column, 
                                           groupby_output_table, 
                                           out_aggregation_column, 
-                                          sort_result);
+                                          sort_result,
+                                         cardinality_hint,
+                                         hash_table_stats,
+                                         strategy);
       }
     case GDF_INT32:  
       { 
@@ -135,7 +153,10 @@ gdf_error dispatch_aggregation_type(gdf_table<size_type> const & groupby_input_t
                                           in_aggregation_column, 
                                           groupby_output_table, 
                                           out_aggregation_column, 
-                                          sort_result);
+                                          sort_result,
+                                         cardinality_hint,
+                                         hash_table_stats,
+                                         strategy);
       }
     case GDF_INT64:  
       { 
@@ -143,7 +164,10 @@ gdf_error dispatch_aggregation_type(gdf_table<size_type> const & groupby_input_t
                                           in_aggregation_column, 
                                           groupby_output_table, 
                                           out_aggregation_column, 
-                                          sort_result);
+                                          sort_result,
+                                         cardinality_hint,
+                                         hash_table_stats,
+                                         strategy);
       }
     case GDF_FLOAT32:
       { 
@@ -151,7 +175,10 @@ gdf_error dispatch_aggregation_type(gdf_table<size_type> const & groupby_input_t
                                         in_aggregation_column, 
                                         groupby_output_table, 
                                         out_aggregation_column, 
-                                        sort_result);
+                                        sort_result,
+                                         cardinality_hint,
+                                         hash_table_stats,
+                                         strategy);
       }
     case GDF_FLOAT64:
       { 
@@ -159,7 +186,10 @@ gdf_error dispatch_aggregation_type(gdf_table<size_type> const & groupby_input_t
                                          in_aggregation_column, 
                                          groupby_output_table, 
                                          out_aggregation_column, 
-                                         sort_result);
+                                         sort_result,
+                                         cardinality_hint,
+                                         hash_table_stats,
+                                         strategy);
       }
     case GDF_DATE32:    
       {
@@ -167,7 +197,10 @@ gdf_error dispatch_aggregation_type(gdf_table<size_type> const & groupby_input_t
                                           in_aggregation_column, 
                                           groupby_output_table, 
                                           out_aggregation_column, 
-                                          sort_result);
+                                          sort_result,
+                                         cardinality_hint,
+                                         hash_table_stats,
+                                         strategy);
       }
     case GDF_DATE64:   
       {
@@ -175,7 +208,10 @@ gdf_error dispatch_aggregation_type(gdf_table<size_type> const & groupby_input_t
                                           in_aggregation_column, 
                                           groupby_output_table, 
                                           out_aggregation_column, 
-                                          sort_result);
+                                          sort_result,
+                                         cardinality_hint,
+                                         hash_table_stats,
+                                         strategy);
       }
     case GDF_TIMESTAMP:
       {
@@ -183,7 +219,10 @@ gdf_error dispatch_aggregation_type(gdf_table<size_type> const & groupby_input_t
                                           in_aggregation_column, 
                                           groupby_output_table, 
                                           out_aggregation_column, 
-                                          sort_result);
+                                          sort_result,
+                                         cardinality_hint,
+                                         hash_table_stats,
+                                         strategy);
       }
     default:
       std::cerr << "Unsupported aggregation column type: " << aggregation_column_type << std::endl;
@@ -202,6 +241,11 @@ gdf_error dispatch_aggregation_type(gdf_table<size_type> const & groupby_input_t
  * @Param[in,out] in_aggregation_column The column to perform the aggregation on
  * @Param[in,out] out_groupby_columns[] A preallocated buffer to store the resultant group-by columns
  * @Param[in,out] out_aggregation_column A preallocated buffer to store the resultant aggregation column
+ * @Param[in] sort_result Flag to optionally sort the output
+ * @Param[in] cardinality_hint The expected number of groups, 0 if unknown. Sizes the
+ * hash table for the hint instead of the number of input rows.
+ * @Param[out] hash_table_stats If not nullptr, receives the statistics of the hash table
+ * @Param[in] strategy How the rows are aggregated
  * @tparam[in] aggregation_operation A functor that defines the aggregation operation
  * 
  * @Returns gdf_error
@@ -214,7 +258,10 @@ gdf_error gdf_group_by_hash(size_type ncols,
                             gdf_column* in_aggregation_column,       
                             gdf_column* out_groupby_columns[],
                             gdf_column* out_aggregation_column,
-                            bool sort_result = false)
+                            bool sort_result = false,
+                            size_t cardinality_hint = 0,
+                            gdf_hash_table_stats * hash_table_stats = nullptr,
+                            gdf_groupby_strategy strategy = GDF_GROUPBY_AUTO)
 {
 
 
@@ -248,7 +295,133 @@ gdf_error gdf_group_by_hash(size_type ncols,
                                                           in_aggregation_column, 
                                                           *groupby_output_table, 
                                                           out_aggregation_column, 
-                                                          sort_result);
+                                                          sort_result,
+                                                          cardinality_hint,
+                                                          hash_table_stats,
+                                                          strategy);
+}
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  The aggregation of a column with an operation, whose aggregates
+ * are allocated by the groupby
+ */
+/* ----------------------------------------------------------------------------*/
+inline aggregation_info make_aggregation_info(gdf_column const * column, gdf_agg_op op)
+{
+  aggregation_info aggregation;
+  aggregation.input = column->data;
+  aggregation.input_valid = (column->null_count > 0) ? column->valid : nullptr;
+  aggregation.input_dtype = aggregation_dtype(column->dtype);
+  aggregation.op = op;
+  aggregation.values = nullptr;
+  aggregation.counts = nullptr;
+  aggregation.input_counts = nullptr;
+  aggregation.input_m2s = nullptr;
+  return aggregation;
+}
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Computes a hash-based group-by with any number of aggregations in
+ * a single pass over the input, see GroupbyHashMultiAggregation.
+ * 
+ * @Param[in] ncols The number of columns to group-by
+ * @Param[in] in_groupby_columns[] The columns to group-by
+ * @Param[in] aggregations The aggregations, see make_aggregation_info
+ * @Param[in,out] out_groupby_columns[] Preallocated buffers to store the resultant group-by columns
+ * @Param[in,out] out_aggregation_columns[] Preallocated buffers to store the resultant
+ * aggregation columns, one per aggregation
+ * @Param[in] sort_result Flag to optionally sort the output
+ * @Param[in] include_null_keys If true, rows with a NULL key form groups of their
+ * own, otherwise they are dropped
+ * @Param[in] cardinality_hint The expected number of groups, 0 if unknown
+ * @Param[out] hash_table_stats If not nullptr, receives the statistics of the hash table
+ * 
+ * @Returns gdf_error
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename size_type>
+gdf_error gdf_group_by_hash_aggregations(size_type ncols,
+                                         gdf_column* in_groupby_columns[],
+                                         std::vector<aggregation_info> const & aggregations,
+                                         gdf_column* out_groupby_columns[],
+                                         gdf_column* out_aggregation_columns[],
+                                         bool sort_result = false,
+                                         bool include_null_keys = false,
+                                         size_t cardinality_hint = 0,
+                                         gdf_hash_table_stats * hash_table_stats = nullptr)
+{
+  // Wrap the groupby input and output columns in a gdf_table
+  std::unique_ptr< const gdf_table<size_type> > groupby_input_table{new gdf_table<size_type>(ncols, in_groupby_columns)};
+  std::unique_ptr< gdf_table<size_type> > groupby_output_table{new gdf_table<size_type>(ncols, out_groupby_columns)};
+
+  size_type output_size{0};
+
+  return GroupbyHashMultiAggregation(*groupby_input_table,
+                                     aggregations,
+                                     *groupby_output_table,
+                                     out_aggregation_columns,
+                                     &output_size,
+                                     sort_result,
+                                     include_null_keys,
+                                     cardinality_hint,
+                                     hash_table_stats);
+}
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  The libgdf entry point for a hash-based group-by with any number
+ * of aggregation columns, each with its own aggregation operation, computed in
+ * a single pass over the input.
+ * 
+ * @Param[in] ncols The number of columns to group-by
+ * @Param[in] in_groupby_columns[] The columns to group-by
+ * @Param[in] num_aggregations The number of aggregation columns
+ * @Param[in] in_aggregation_columns[] The columns to aggregate
+ * @Param[in] aggregation_ops[] The aggregation operation of each aggregation column,
+ * one of GDF_SUM, GDF_MIN, GDF_MAX, GDF_AVG, GDF_COUNT, GDF_VAR, GDF_STD, GDF_FIRST
+ * and GDF_LAST
+ * @Param[in,out] out_groupby_columns[] Preallocated buffers to store the resultant group-by columns
+ * @Param[in,out] out_aggregation_columns[] Preallocated buffers to store the resultant
+ * aggregation columns. The result is converted to the dtype of each buffer.
+ * @Param[in] sort_result Flag to optionally sort the output
+ * @Param[in] include_null_keys If true, rows with a NULL key form groups of their
+ * own, otherwise they are dropped. NULL values are always skipped.
+ * @Param[in] cardinality_hint The expected number of groups, 0 if unknown
+ * @Param[out] hash_table_stats If not nullptr, receives the statistics of the hash table
+ * 
+ * @Returns gdf_error
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename size_type>
+gdf_error gdf_group_by_hash_multi(size_type ncols,
+                                  gdf_column* in_groupby_columns[],
+                                  int num_aggregations,
+                                  gdf_column* in_aggregation_columns[],
+                                  gdf_agg_op aggregation_ops[],
+                                  gdf_column* out_groupby_columns[],
+                                  gdf_column* out_aggregation_columns[],
+                                  bool sort_result = false,
+                                  bool include_null_keys = false,
+                                  size_t cardinality_hint = 0,
+                                  gdf_hash_table_stats * hash_table_stats = nullptr)
+{
+  std::vector<aggregation_info> aggregations(num_aggregations);
+  for(int a = 0; a < num_aggregations; ++a)
+  {
+    aggregations[a] = make_aggregation_info(in_aggregation_columns[a], aggregation_ops[a]);
+  }
+
+  return gdf_group_by_hash_aggregations(ncols,
+                                        in_groupby_columns,
+                                        aggregations,
+                                        out_groupby_columns,
+                                        out_aggregation_columns,
+                                        sort_result,
+                                        include_null_keys,
+                                        cardinality_hint,
+                                        hash_table_stats);
 }
 
 /* --------------------------------------------------------------------------*/
@@ -339,6 +512,10 @@ void compute_average(gdf_column * avg_column, gdf_column const & count_column, g
  * @Param in_aggregation_column The aggregation input column
  * @Param out_groupby_columns[] The output groupby columns
  * @Param out_aggregation_column The output aggregation column
+ * @Param cardinality_hint The expected number of groups, 0 if unknown
+ * @Param hash_table_stats If not nullptr, receives the statistics of the hash table
+ * of the first pass
+ * @Param strategy How the rows are aggregated
  * @tparam sum_type The type used for the SUM aggregation output column
  * 
  * @Returns gdf_error with error code on failure, otherwise GDF_SUCCESS
@@ -349,7 +526,10 @@ gdf_error multi_pass_avg(int ncols,
                          gdf_column* in_groupby_columns[],        
                          gdf_column* in_aggregation_column,       
                          gdf_column* out_groupby_columns[],
-                         gdf_column* out_aggregation_column)
+                         gdf_column* out_aggregation_column,
+                         size_t cardinality_hint = 0,
+                         gdf_hash_table_stats * hash_table_stats = nullptr,
+                         gdf_groupby_strategy strategy = GDF_GROUPBY_AUTO)
 {
   // Allocate intermediate output gdf_columns for the output of the Count and Sum aggregations
   const size_t output_size = out_aggregation_column->size;
@@ -362,11 +542,11 @@ gdf_error multi_pass_avg(int ncols,
 
   // Compute the counts for each key 
   gdf_column count_output = create_gdf_column<size_t>(output_size);
-  gdf_group_by_hash<count_op>(ncols, in_groupby_columns, in_aggregation_column, out_groupby_columns, &count_output, sort_result);
+  gdf_group_by_hash<count_op>(ncols, in_groupby_columns, in_aggregation_column, out_groupby_columns, &count_output, sort_result, cardinality_hint, hash_table_stats, strategy);
 
   // Compute the sum for each key. Should be okay to reuse the groupby column output
   gdf_column sum_output = create_gdf_column<sum_type>(output_size);
-  gdf_group_by_hash<sum_op>(ncols, in_groupby_columns, in_aggregation_column, out_groupby_columns, &sum_output, sort_result); 
+  gdf_group_by_hash<sum_op>(ncols, in_groupby_columns, in_aggregation_column, out_groupby_columns, &sum_output, sort_result, cardinality_hint, nullptr, strategy);
 
   // Compute the average from the Sum and Count columns and store into the passed in aggregation output buffer
   const gdf_dtype gdf_output_type = out_aggregation_column->dtype;
@@ -397,6 +577,9 @@ gdf_error multi_pass_avg(int ncols,
  * @Param in_aggregation_column The input aggregation column
  * @Param out_groupby_columns[] The output groupby columns
  * @Param out_aggregation_column The output aggregation column
+ * @Param cardinality_hint The expected number of groups, 0 if unknown
+ * @Param hash_table_stats If not nullptr, receives the statistics of the hash table
+ * @Param strategy How the rows are aggregated
  * 
  * @Returns gdf_error with error code on failure, otherwise GDF_SUCESS
  */
@@ -405,17 +588,20 @@ gdf_error gdf_group_by_hash_avg(int ncols,
                                 gdf_column* in_groupby_columns[],        
                                 gdf_column* in_aggregation_column,       
                                 gdf_column* out_groupby_columns[],
-                                gdf_column* out_aggregation_column)
+                                gdf_column* out_aggregation_column,
+                                size_t cardinality_hint = 0,
+                                gdf_hash_table_stats * hash_table_stats = nullptr,
+                                gdf_groupby_strategy strategy = GDF_GROUPBY_AUTO)
 {
   // Deduce the type used for the SUM aggregation, assuming we use the same type as the aggregation column
   const gdf_dtype gdf_sum_type = in_aggregation_column->dtype;
   switch(gdf_sum_type){
-    case GDF_INT8:   { return multi_pass_avg<int8_t>(ncols, in_groupby_columns, in_aggregation_column, out_groupby_columns, out_aggregation_column);}
-    case GDF_INT16:  { return multi_pass_avg<int16_t>(ncols, in_groupby_columns, in_aggregation_column, out_groupby_columns, out_aggregation_column);}
-    case GDF_INT32:  { return multi_pass_avg<int32_t>(ncols, in_groupby_columns, in_aggregation_column, out_groupby_columns, out_aggregation_column);}
-    case GDF_INT64:  { return multi_pass_avg<int64_t>(ncols, in_groupby_columns, in_aggregation_column, out_groupby_columns, out_aggregation_column);}
-    case GDF_FLOAT32:{ return multi_pass_avg<float>(ncols, in_groupby_columns, in_aggregation_column, out_groupby_columns, out_aggregation_column);}
-    case GDF_FLOAT64:{ return multi_pass_avg<double>(ncols, in_groupby_columns, in_aggregation_column, out_groupby_columns, out_aggregation_column);}
+    case GDF_INT8:   { return multi_pass_avg<int8_t>(ncols, in_groupby_columns, in_aggregation_column, out_groupby_columns, out_aggregation_column, cardinality_hint, hash_table_stats, strategy);}
+    case GDF_INT16:  { return multi_pass_avg<int16_t>(ncols, in_groupby_columns, in_aggregation_column, out_groupby_columns, out_aggregation_column, cardinality_hint, hash_table_stats, strategy);}
+    case GDF_INT32:  { return multi_pass_avg<int32_t>(ncols, in_groupby_columns, in_aggregation_column, out_groupby_columns, out_aggregation_column, cardinality_hint, hash_table_stats, strategy);}
+    case GDF_INT64:  { return multi_pass_avg<int64_t>(ncols, in_groupby_columns, in_aggregation_column, out_groupby_columns, out_aggregation_column, cardinality_hint, hash_table_stats, strategy);}
+    case GDF_FLOAT32:{ return multi_pass_avg<float>(ncols, in_groupby_columns, in_aggregation_column, out_groupby_columns, out_aggregation_column, cardinality_hint, hash_table_stats, strategy);}
+    case GDF_FLOAT64:{ return multi_pass_avg<double>(ncols, in_groupby_columns, in_aggregation_column, out_groupby_columns, out_aggregation_column, cardinality_hint, hash_table_stats, strategy);}
     default: return GDF_UNSUPPORTED_DTYPE;
   }
 }
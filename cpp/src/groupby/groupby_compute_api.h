@@ -18,13 +18,20 @@
 #define GROUPBY_COMPUTE_API_H
 
 #include <cuda_runtime.h>
+#include <algorithm>
+#include <cmath>
 #include <limits>
 #include <memory>
 #include <thrust/device_vector.h>
 #include <thrust/gather.h>
 #include <thrust/copy.h>
+#include <thrust/fill.h>
+#include <vector>
 
 #include "hash/managed.cuh"
+#include "hash/hash_table_growth.h"
+#include "hash/hash_table_stats.cuh"
+#include "hash/hyperloglog_kernels.cuh"
 #include "groupby_kernels.cuh"
 #include "dataframe/cudf_table.cuh"
 #include "rmm/thrust_rmm_allocator.h"
@@ -36,11 +43,82 @@ using Vector = thrust::device_vector<T, rmm_allocator<T>>;
 
 
 // The occupancy of the hash table determines it's capacity. A value of 50 implies
-// 50% occupancy, i.e., hash_table_size == 2 * input_size
+// 50% occupancy, i.e., hash_table_size == 2 * input_size. When a cardinality hint
+// is given or the number of groups is estimated, this is the occupancy at which
+// the hash table grows.
 constexpr unsigned int DEFAULT_HASH_TABLE_OCCUPANCY{50};
 
 constexpr unsigned int THREAD_BLOCK_SIZE{256};
 
+// Without a cardinality hint, the number of groups of an input of at least this
+// many rows is estimated with a HyperLogLog sketch to size the hash table. A
+// smaller input gets a small table anyway.
+constexpr size_t MIN_ROWS_TO_ESTIMATE_GROUPS{1 << 16};
+
+// The estimated number of groups is increased by this fraction, many times the
+// standard error of the sketch, so that the hash table rarely has to grow
+constexpr double GROUPS_ESTIMATE_MARGIN{0.1};
+
+// With the GDF_GROUPBY_AUTO strategy, a single aggregation groupby of at most
+// this many groups aggregates in shared memory first
+constexpr size_t SHARED_GROUPBY_MAX_GROUPS{256};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The number of groups to size the hash table of a groupby for.
+ *
+ * This is the cardinality hint if given. Otherwise, for a large input, it is
+ * the number of distinct rows of the groupby columns estimated with a
+ * HyperLogLog sketch, plus a margin and a group for the NULL keys, which the
+ * sketch skips. If the estimate is too low, the hash table grows.
+ *
+ * @Param groupby_input_table The set of columns to groupby
+ * @Param cardinality_hint The expected number of groups, or 0 if unknown
+ *
+ * @Returns The number of groups, or 0 to size the hash table for the input
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename size_type>
+size_t estimate_num_groups(gdf_table<size_type> const & groupby_input_table,
+                           size_t cardinality_hint)
+{
+  const size_t num_rows = groupby_input_table.get_column_length();
+  if((0 != cardinality_hint) || (num_rows < MIN_ROWS_TO_ESTIMATE_GROUPS)) {
+    return cardinality_hint;
+  }
+
+  hyperloglog_sketch sketch;
+  if(GDF_SUCCESS != compute_hyperloglog_sketch(groupby_input_table, sketch)) {
+    return 0;
+  }
+  return static_cast<size_t>(std::ceil(sketch.estimate() * (1.0 + GROUPS_ESTIMATE_MARGIN))) + 1;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Whether a single aggregation groupby aggregates the rows in the
+ * shared memory of every thread block before the global hash table.
+ *
+ * The thread block tables pay off when the rows of many blocks contend for a
+ * few slots of the global hash table, so GDF_GROUPBY_AUTO selects them for at
+ * most SHARED_GROUPBY_MAX_GROUPS groups. A block table holds
+ * SHARED_GROUPBY_MAX_BLOCK_GROUPS groups, which leaves room for an estimate
+ * that is too low.
+ *
+ * @Param strategy The strategy requested by the caller
+ * @Param num_groups The expected number of groups, or 0 if unknown
+ */
+/* ----------------------------------------------------------------------------*/
+inline bool use_shared_memory_groupby(gdf_groupby_strategy strategy, size_t num_groups)
+{
+  switch(strategy)
+  {
+    case GDF_GROUPBY_SHARED_MEMORY: return true;
+    case GDF_GROUPBY_GLOBAL_TABLE:  return false;
+    default: return (num_groups > 0) && (num_groups <= SHARED_GROUPBY_MAX_GROUPS);
+  }
+}
+
 /* --------------------------------------------------------------------------*/
 /**
  * @Synopsis  This functor is used inside the hash table's insert function to 
@@ -68,15 +146,19 @@ struct row_comparator
    * @Param map The hash table
    * @Param l_table The left gdf_table
    * @Param r_table The right gdf_table
+   * @Param nulls_equal If true, rows with NULLs in the same columns and equal
+   * other elements are equal, so that they form a group
    */
   /* ----------------------------------------------------------------------------*/
   row_comparator(map_type const & map,
                  gdf_table<size_type> const & l_table,
-                 gdf_table<size_type> const & r_table) 
+                 gdf_table<size_type> const & r_table,
+                 bool nulls_equal = false) 
                 : the_map{map}, 
                   left_table{l_table}, 
                   right_table{r_table},
-                  unused_key{map.get_unused_key()}
+                  unused_key{map.get_unused_key()},
+                  nulls_are_equal{nulls_equal}
   {
   
   }
@@ -109,16 +191,36 @@ struct row_comparator
       return default_comparator(left_index, right_index);
 
     // Check for equality between the two rows of the two tables
-    return left_table.rows_equal(right_table, left_index, right_index);
+    return left_table.rows_equal(right_table, left_index, right_index, nulls_are_equal);
   }
 
   const map_key_comparator default_comparator{};
   const key_type unused_key;
+  const bool nulls_are_equal;
   map_type const & the_map;
   gdf_table<size_type> const & left_table;
   gdf_table<size_type> const & right_table;
 };
 
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Computes the hash value of a hash table key, i.e., the hash of the
+ * gdf_table row the key refers to. Used to rehash the table when it grows.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename size_type>
+struct row_hasher
+{
+  row_hasher(gdf_table<size_type> const & t) : table{t} {}
+
+  __device__ hash_value_type operator()(size_type row_index) const
+  {
+    return table.hash_row(row_index);
+  }
+
+  gdf_table<size_type> const & table;
+};
+
 /* --------------------------------------------------------------------------*/
 /** 
 * @Synopsis Performs the groupby operation for an arbtirary number of groupby columns and
@@ -134,6 +236,11 @@ struct row_comparator
 * @Param out_size The size of the output
 * @Param aggregation_op The aggregation operation to perform 
 * @Param sort_result Flag to optionally sort the output table
+* @Param cardinality_hint The expected number of groups, or 0 if unknown. When
+* given, the hash table is sized for the hint and grows if the hint is too low.
+* When unknown, the number of groups of a large input is estimated.
+* @Param[out] hash_table_stats If not nullptr, receives the statistics of the hash table
+* @Param strategy How the rows are aggregated, see use_shared_memory_groupby
 * 
 * @Returns   
 */
@@ -147,10 +254,17 @@ gdf_error GroupbyHash(gdf_table<size_type> const & groupby_input_table,
                         aggregation_type * out_aggregation_column,
                         size_type * out_size,
                         aggregation_operation aggregation_op,
-                        bool sort_result = false)
+                        bool sort_result = false,
+                        size_t cardinality_hint = 0,
+                        gdf_hash_table_stats * hash_table_stats = nullptr,
+                        gdf_groupby_strategy strategy = GDF_GROUPBY_AUTO)
 {
   const size_type input_num_rows = groupby_input_table.get_column_length();
 
+  cardinality_hint = estimate_num_groups(groupby_input_table, cardinality_hint);
+
+  const bool use_shared_memory = use_shared_memory_groupby(strategy, cardinality_hint);
+
   // The map will store (row index, aggregation value)
   // Where row index is the row number of the first row to be successfully inserted
   // for a given unique row
@@ -161,29 +275,198 @@ gdf_error GroupbyHash(gdf_table<size_type> const & groupby_input_table,
                                             equal_to<size_type>,
                                             legacy_allocator<thrust::pair<size_type, aggregation_type> > >;
 
-  // The hash table occupancy and the input size determines the size of the hash table
-  // e.g., for a 50% occupancy, the size of the hash table is twice that of the input
-  const size_type hash_table_size = static_cast<size_type>((static_cast<uint64_t>(input_num_rows) * 100 / DEFAULT_HASH_TABLE_OCCUPANCY));
+  using comparator_type = row_comparator<map_type, size_type>;
+
+  // The hash table occupancy and the input size (or the cardinality hint) determine
+  // the size of the hash table e.g., for a 50% occupancy and no hint, the size of the
+  // hash table is twice that of the input
+  hash_table_growth_policy growth_policy;
+  growth_policy.max_occupancy_percent = DEFAULT_HASH_TABLE_OCCUPANCY;
+  size_type hash_table_size = static_cast<size_type>(growth_policy.initial_size(input_num_rows, cardinality_hint));
   
   // Initialize the hash table with the aggregation operation functor's identity value
   std::unique_ptr<map_type> the_map(new map_type(hash_table_size, aggregation_operation::IDENTITY));
+  the_map->set_max_occupancy(growth_policy.max_occupancy(hash_table_size));
 
-  const dim3 build_grid_size ((input_num_rows + THREAD_BLOCK_SIZE - 1) / THREAD_BLOCK_SIZE, 1, 1);
   const dim3 block_size (THREAD_BLOCK_SIZE, 1, 1);
 
-  CUDA_TRY(cudaGetLastError());
+  // With shared memory, only as many thread blocks as are resident at once stride
+  // over the rows, so that every block table aggregates many rows. Every block
+  // writes at most SHARED_GROUPBY_MAX_BLOCK_GROUPS partial aggregates.
+  dim3 shared_grid_size (1, 1, 1);
+  size_type max_num_partials{0};
+  Vector<size_type> partial_rows;
+  Vector<aggregation_type> partial_values;
+  size_type * num_partials{nullptr};
+  if(use_shared_memory) {
+    int device{0};
+    int num_multiprocessors{0};
+    int blocks_per_multiprocessor{0};
+    CUDA_TRY(cudaGetDevice(&device));
+    CUDA_TRY(cudaDeviceGetAttribute(&num_multiprocessors, cudaDevAttrMultiProcessorCount, device));
+    CUDA_TRY(cudaOccupancyMaxActiveBlocksPerMultiprocessor(&blocks_per_multiprocessor,
+                                                           build_shared_aggregation_table<map_type,
+                                                                                          aggregation_operation,
+                                                                                          aggregation_type,
+                                                                                          size_type,
+                                                                                          comparator_type>,
+                                                           THREAD_BLOCK_SIZE,
+                                                           0));
+    const size_type max_grid_size = std::max(1, num_multiprocessors * blocks_per_multiprocessor);
+    shared_grid_size.x = std::min(max_grid_size, (input_num_rows + THREAD_BLOCK_SIZE - 1) / THREAD_BLOCK_SIZE);
+
+    max_num_partials = shared_grid_size.x * SHARED_GROUPBY_MAX_BLOCK_GROUPS;
+    partial_rows.resize(max_num_partials);
+    partial_values.resize(max_num_partials);
+    RMM_TRY(RMM_ALLOC((void**)&num_partials, sizeof(size_type), 0)); // TODO: non-default stream?
+  }
+
+  // Rows that do not fit in the hash table are collected in an overflow list. This
+  // is only needed when the table was sized from a hint smaller than the input.
+  // The partial aggregates of the shared memory groupby have overflow lists too.
+  const bool can_overflow = growth_policy.max_occupancy(hash_table_size) < static_cast<size_t>(input_num_rows);
+  Vector<size_type> overflow_rows;
+  Vector<size_type> pending_rows;
+  Vector<size_type> overflow_partials;
+  Vector<size_type> pending_partials;
+  // The number of overflow rows, then the number of overflow partial aggregates
+  size_type * overflow_count{nullptr};
+  if(can_overflow) {
+    overflow_rows.resize(input_num_rows);
+    pending_rows.resize(input_num_rows);
+    overflow_partials.resize(max_num_partials);
+    pending_partials.resize(max_num_partials);
+    RMM_TRY(RMM_ALLOC((void**)&overflow_count, 2 * sizeof(size_type), 0)); // TODO: non-default stream?
+  }
 
-  // Inserts (i, aggregation_column[i]) as a key-value pair into the
-  // hash table. When a given key already exists in the table, the aggregation operation
-  // is computed between the new and existing value, and the result is stored back.
-  build_aggregation_table<<<build_grid_size, block_size>>>(the_map.get(), 
-                                                           groupby_input_table, 
-                                                           in_aggregation_column,
-                                                           input_num_rows,
-                                                           aggregation_op,
-                                                           row_comparator<map_type, size_type>(*the_map, groupby_input_table, groupby_input_table));
   CUDA_TRY(cudaGetLastError());
 
+  // The first pass inserts every row, later passes only the rows and the partial
+  // aggregates that overflowed
+  bool first_pass{true};
+  const size_type * rows_to_insert{nullptr};
+  size_type num_rows_to_insert{input_num_rows};
+  const size_type * partials_to_merge{nullptr};
+  size_type num_partials_to_merge{0};
+
+  while((num_rows_to_insert > 0) || (num_partials_to_merge > 0)) {
+
+    if(can_overflow) {
+      CUDA_TRY(cudaMemset(overflow_count, 0, 2 * sizeof(size_type)));
+    }
+
+    if(use_shared_memory && first_pass) {
+      CUDA_TRY(cudaMemset(num_partials, 0, sizeof(size_type)));
+
+      // Aggregates the rows in the shared memory of every thread block, and writes
+      // the groups of every block as partial aggregates
+      build_shared_aggregation_table<<<shared_grid_size, block_size>>>(the_map.get(),
+                                                                       groupby_input_table,
+                                                                       in_aggregation_column,
+                                                                       aggregation_op,
+                                                                       comparator_type(*the_map, groupby_input_table, groupby_input_table),
+                                                                       input_num_rows,
+                                                                       overflow_rows.data().get(),
+                                                                       overflow_count,
+                                                                       partial_rows.data().get(),
+                                                                       partial_values.data().get(),
+                                                                       num_partials);
+      CUDA_TRY(cudaGetLastError());
+
+      CUDA_TRY( cudaMemcpy(&num_partials_to_merge, num_partials, sizeof(size_type), cudaMemcpyDeviceToHost) );
+    }
+    else if(num_rows_to_insert > 0) {
+      const dim3 build_grid_size ((num_rows_to_insert + THREAD_BLOCK_SIZE - 1) / THREAD_BLOCK_SIZE, 1, 1);
+
+      // Inserts (i, aggregation_column[i]) as a key-value pair into the
+      // hash table. When a given key already exists in the table, the aggregation operation
+      // is computed between the new and existing value, and the result is stored back.
+      build_aggregation_table<<<build_grid_size, block_size>>>(the_map.get(), 
+                                                               groupby_input_table, 
+                                                               in_aggregation_column,
+                                                               aggregation_op,
+                                                               comparator_type(*the_map, groupby_input_table, groupby_input_table),
+                                                               rows_to_insert,
+                                                               num_rows_to_insert,
+                                                               overflow_rows.data().get(),
+                                                               overflow_count);
+      CUDA_TRY(cudaGetLastError());
+    }
+
+    if(num_partials_to_merge > 0) {
+      const dim3 merge_grid_size ((num_partials_to_merge + THREAD_BLOCK_SIZE - 1) / THREAD_BLOCK_SIZE, 1, 1);
+
+      // Combines the partial aggregates of the same group in the hash table
+      merge_partial_aggregates<<<merge_grid_size, block_size>>>(the_map.get(),
+                                                                groupby_input_table,
+                                                                partial_rows.data().get(),
+                                                                partial_values.data().get(),
+                                                                typename partial_merge_operation<aggregation_operation>::type(),
+                                                                comparator_type(*the_map, groupby_input_table, groupby_input_table),
+                                                                partials_to_merge,
+                                                                num_partials_to_merge,
+                                                                overflow_partials.data().get(),
+                                                                (nullptr == overflow_count) ? nullptr : overflow_count + 1);
+      CUDA_TRY(cudaGetLastError());
+    }
+
+    first_pass = false;
+
+    size_type num_overflow[2] = {0, 0};
+    if(can_overflow) {
+      CUDA_TRY( cudaMemcpy(num_overflow, overflow_count, 2 * sizeof(size_type), cudaMemcpyDeviceToHost) );
+    }
+
+    if(0 == num_overflow[0] + num_overflow[1]) {
+      break;
+    }
+
+    // The table reached its maximum occupancy. Grow it by rehashing the existing
+    // entries into a larger table, then resume with the rows and the partial
+    // aggregates that did not fit
+    const size_type new_hash_table_size = static_cast<size_type>(growth_policy.next_size(hash_table_size,
+                                                                                         the_map->get_occupancy(),
+                                                                                         num_overflow[0] + num_overflow[1]));
+    std::unique_ptr<map_type> new_map(new map_type(new_hash_table_size, aggregation_operation::IDENTITY));
+    new_map->set_max_occupancy(growth_policy.max_occupancy(new_hash_table_size));
+
+    const dim3 rehash_grid_size ((hash_table_size + THREAD_BLOCK_SIZE - 1) / THREAD_BLOCK_SIZE, 1, 1);
+    rehash_hashtbl<<<rehash_grid_size, block_size>>>(the_map->data(),
+                                                     hash_table_size,
+                                                     new_map.get(),
+                                                     row_hasher<size_type>(groupby_input_table));
+    CUDA_TRY(cudaGetLastError());
+
+    the_map = std::move(new_map);
+    hash_table_size = new_hash_table_size;
+
+    overflow_rows.swap(pending_rows);
+    rows_to_insert = pending_rows.data().get();
+    num_rows_to_insert = num_overflow[0];
+
+    overflow_partials.swap(pending_partials);
+    partials_to_merge = pending_partials.data().get();
+    num_partials_to_merge = num_overflow[1];
+  }
+
+  if(nullptr != overflow_count) {
+    RMM_TRY( RMM_FREE(overflow_count, 0) );
+  }
+  if(nullptr != num_partials) {
+    RMM_TRY( RMM_FREE(num_partials, 0) );
+  }
+
+  // The keys of the map are distinct groups, so equal hash values are collisions
+  if(nullptr != hash_table_stats) {
+    gdf_error stats_error = compute_hash_table_stats<typename map_type::probing>(the_map->data(),
+                                                                                 hash_table_size,
+                                                                                 map_type::get_unused_key(),
+                                                                                 row_hasher<size_type>(groupby_input_table),
+                                                                                 true,
+                                                                                 hash_table_stats);
+    if(GDF_SUCCESS != stats_error) return stats_error;
+  }
+
   // Used by threads to coordinate where to write their results
   size_type * global_write_index{nullptr};
   RMM_TRY(RMM_ALLOC((void**)&global_write_index, sizeof(size_type), 0)); // TODO: non-default stream?
@@ -224,4 +507,412 @@ gdf_error GroupbyHash(gdf_table<size_type> const & groupby_input_table,
 
   return GDF_SUCCESS;
 }
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The dtype an aggregation column of the given dtype is read as: the
+ * date, timestamp and category types are read as the integer of their width.
+ */
+/* ----------------------------------------------------------------------------*/
+inline gdf_dtype aggregation_dtype(gdf_dtype dtype)
+{
+  switch(dtype)
+  {
+    case GDF_DATE32:
+    case GDF_CATEGORY:  return GDF_INT32;
+    case GDF_DATE64:
+    case GDF_TIMESTAMP: return GDF_INT64;
+    default:            return dtype;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Allocates the aggregates of every slot of the hash table for an
+ * aggregation, initialized with the identity value of its operation.
+ *
+ * @Param[in,out] aggregation The aggregation, whose values and counts are set
+ * @Param values The storage of the values
+ * @Param counts The storage of the counts
+ * @Param num_slots The capacity of the hash table
+ * @tparam input_type The type of the aggregation column
+ *
+ * @Returns GDF_SUCCESS, or GDF_UNSUPPORTED_METHOD for an unsupported operation
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename input_type>
+gdf_error allocate_typed_aggregation_storage(aggregation_info & aggregation,
+                                             Vector<char> & values,
+                                             Vector<unsigned long long> & counts,
+                                             size_t num_slots)
+{
+  using storage_type = aggregate_storage_t<input_type>;
+
+  storage_type identity{};
+  switch(aggregation.op)
+  {
+    case GDF_SUM:
+    case GDF_AVG:   { identity = sum_op<storage_type>::IDENTITY; break; }
+    case GDF_MIN:   { identity = min_op<storage_type>::IDENTITY; break; }
+    case GDF_MAX:   { identity = max_op<storage_type>::IDENTITY; break; }
+    case GDF_COUNT:
+    case GDF_VAR:
+    case GDF_STD:
+    case GDF_FIRST:
+    case GDF_LAST:  { break; }
+    default:        return GDF_UNSUPPORTED_METHOD;
+  }
+
+  rmm_temp_allocator allocator(0);
+  auto exec = thrust::cuda::par(allocator).on(0);
+
+  aggregation.values = nullptr;
+  if((GDF_VAR == aggregation.op) || (GDF_STD == aggregation.op)){
+    values.resize(num_slots * sizeof(shifted_sums));
+    shifted_sums * d_sums = reinterpret_cast<shifted_sums *>(values.data().get());
+    thrust::fill(exec, d_sums, d_sums + num_slots, shifted_sums{UNSET_SHIFT, 0, 0});
+    aggregation.values = d_sums;
+  }
+  else if((GDF_FIRST == aggregation.op) || (GDF_LAST == aggregation.op)){
+    // The row index of FIRST is the smallest, of LAST the largest
+    values.resize(num_slots * sizeof(unsigned long long));
+    unsigned long long * d_rows = reinterpret_cast<unsigned long long *>(values.data().get());
+    thrust::fill(exec, d_rows, d_rows + num_slots,
+                 (GDF_FIRST == aggregation.op) ? std::numeric_limits<unsigned long long>::max() : 0ull);
+    aggregation.values = d_rows;
+  }
+  else if(GDF_COUNT != aggregation.op){
+    values.resize(num_slots * sizeof(storage_type));
+    storage_type * d_values = reinterpret_cast<storage_type *>(values.data().get());
+    thrust::fill(exec, d_values, d_values + num_slots, identity);
+    aggregation.values = d_values;
+  }
+
+  // The counts also tell the groups without any non-null value, whose result is NULL
+  aggregation.counts = nullptr;
+  if((GDF_COUNT == aggregation.op) || (GDF_AVG == aggregation.op)
+     || (GDF_VAR == aggregation.op) || (GDF_STD == aggregation.op)
+     || (nullptr != aggregation.input_valid)){
+    counts.assign(num_slots, 0);
+    aggregation.counts = counts.data().get();
+  }
+
+  return GDF_SUCCESS;
+}
+
+inline gdf_error allocate_aggregation_storage(aggregation_info & aggregation,
+                                              Vector<char> & values,
+                                              Vector<unsigned long long> & counts,
+                                              size_t num_slots)
+{
+  switch(aggregation.input_dtype)
+  {
+    case GDF_INT8:    return allocate_typed_aggregation_storage<int8_t>(aggregation, values, counts, num_slots);
+    case GDF_INT16:   return allocate_typed_aggregation_storage<int16_t>(aggregation, values, counts, num_slots);
+    case GDF_INT32:   return allocate_typed_aggregation_storage<int32_t>(aggregation, values, counts, num_slots);
+    case GDF_INT64:   return allocate_typed_aggregation_storage<int64_t>(aggregation, values, counts, num_slots);
+    case GDF_FLOAT32: return allocate_typed_aggregation_storage<float>(aggregation, values, counts, num_slots);
+    case GDF_FLOAT64: return allocate_typed_aggregation_storage<double>(aggregation, values, counts, num_slots);
+    default:          return GDF_UNSUPPORTED_DTYPE;
+  }
+}
+
+template <typename input_type, typename output_type, typename size_type>
+gdf_error transform_aggregation(aggregation_info const & aggregation,
+                                size_type const * group_slots,
+                                size_type num_groups,
+                                gdf_column * out_aggregation_column)
+{
+  out_aggregation_column->size = num_groups;
+  out_aggregation_column->null_count = 0;
+  if(0 == num_groups){
+    return GDF_SUCCESS;
+  }
+
+  finalize_aggregate<input_type, output_type, size_type> finalize{
+      static_cast<input_type const *>(aggregation.input), aggregation.values, aggregation.counts, aggregation.op};
+
+  Vector<size_type> null_count(1, 0);
+
+  const size_type num_masks = gdf_get_num_chars_bitmask(num_groups);
+  const dim3 block_size (THREAD_BLOCK_SIZE, 1, 1);
+  const dim3 grid_size ((num_masks + THREAD_BLOCK_SIZE - 1) / THREAD_BLOCK_SIZE, 1, 1);
+
+  extract_aggregation_result<<<grid_size, block_size>>>(finalize,
+                                                        group_slots,
+                                                        num_groups,
+                                                        static_cast<output_type *>(out_aggregation_column->data),
+                                                        out_aggregation_column->valid,
+                                                        null_count.data().get());
+  CUDA_TRY(cudaGetLastError());
+
+  out_aggregation_column->null_count = null_count[0];
+  return GDF_SUCCESS;
+}
+
+template <typename input_type, typename size_type>
+gdf_error extract_typed_aggregation(aggregation_info const & aggregation,
+                                    size_type const * group_slots,
+                                    size_type num_groups,
+                                    gdf_column * out_aggregation_column)
+{
+  switch(aggregation_dtype(out_aggregation_column->dtype))
+  {
+    case GDF_INT8:    return transform_aggregation<input_type, int8_t>(aggregation, group_slots, num_groups, out_aggregation_column);
+    case GDF_INT16:   return transform_aggregation<input_type, int16_t>(aggregation, group_slots, num_groups, out_aggregation_column);
+    case GDF_INT32:   return transform_aggregation<input_type, int32_t>(aggregation, group_slots, num_groups, out_aggregation_column);
+    case GDF_INT64:   return transform_aggregation<input_type, int64_t>(aggregation, group_slots, num_groups, out_aggregation_column);
+    case GDF_FLOAT32: return transform_aggregation<input_type, float>(aggregation, group_slots, num_groups, out_aggregation_column);
+    case GDF_FLOAT64: return transform_aggregation<input_type, double>(aggregation, group_slots, num_groups, out_aggregation_column);
+    default:          return GDF_UNSUPPORTED_DTYPE;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Whether the result of an aggregation can be NULL for some group:
+ * VAR and STD for a group with fewer than 2 non-null values, and any operation
+ * but COUNT for a group without any non-null value, which only exists if the
+ * column has nulls.
+ */
+/* ----------------------------------------------------------------------------*/
+inline bool aggregation_may_be_null(aggregation_info const & aggregation)
+{
+  if(GDF_COUNT == aggregation.op) return false;
+  return (GDF_VAR == aggregation.op) || (GDF_STD == aggregation.op)
+         || (nullptr != aggregation.input_valid);
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Writes the result of an aggregation for every group to its output
+ * column, converted to the dtype of the output column, along with its validity
+ * mask if the output column has one. The result of a group without any non-null
+ * value is NULL, except for COUNT, which is then 0. The result of VAR and STD
+ * is also NULL for a group with a single non-null value. The output column of
+ * an aggregation_may_be_null must have a validity mask.
+ *
+ * @Param aggregation The aggregation
+ * @Param group_slots The slot of every group, in output order
+ * @Param num_groups The number of groups
+ * @Param out_aggregation_column Preallocated output column
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename size_type>
+gdf_error extract_aggregation(aggregation_info const & aggregation,
+                              size_type const * group_slots,
+                              size_type num_groups,
+                              gdf_column * out_aggregation_column)
+{
+  switch(aggregation.input_dtype)
+  {
+    case GDF_INT8:    return extract_typed_aggregation<int8_t>(aggregation, group_slots, num_groups, out_aggregation_column);
+    case GDF_INT16:   return extract_typed_aggregation<int16_t>(aggregation, group_slots, num_groups, out_aggregation_column);
+    case GDF_INT32:   return extract_typed_aggregation<int32_t>(aggregation, group_slots, num_groups, out_aggregation_column);
+    case GDF_INT64:   return extract_typed_aggregation<int64_t>(aggregation, group_slots, num_groups, out_aggregation_column);
+    case GDF_FLOAT32: return extract_typed_aggregation<float>(aggregation, group_slots, num_groups, out_aggregation_column);
+    case GDF_FLOAT64: return extract_typed_aggregation<double>(aggregation, group_slots, num_groups, out_aggregation_column);
+    default:          return GDF_UNSUPPORTED_DTYPE;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/** 
+* @Synopsis Performs the groupby operation for an arbitrary number of groupby
+* columns and an arbitrary number of aggregation columns, each with its own
+* aggregation operation, in a single pass over the input.
+*
+* The hash table maps every group to the index of its first row, and the
+* aggregates are stored column-wise, one array per aggregation indexed by the
+* slot of the group in the hash table. Every input row is inserted once, and
+* every aggregation is updated from the slot returned by the insert. AVG is
+* accumulated as a SUM and a COUNT in the same pass, VAR and STD as shifted_sums
+* and a COUNT, and FIRST and LAST as the smallest and largest row index, whose
+* value is read when the result is extracted.
+*
+* NULL values are skipped by every aggregation. Rows with a NULL key are either
+* dropped, or grouped with the rows whose key is NULL in the same columns and
+* equal in the others.
+* 
+* @Param[in] groupby_input_table The set of columns to groupby
+* @Param[in] aggregations The aggregations, of which input, input_valid,
+* input_dtype and op are set, and input_counts and input_m2s to merge partial
+* aggregates. The aggregates are allocated here.
+* @Param[out] groupby_output_table Preallocated buffer(s) for the groupby column
+* result. This will hold a single entry for every unique row in the input table.
+* @Param[out] out_aggregation_columns Preallocated output columns, one per
+* aggregation, where entry 'i' is the aggregation of the group in row 'i' of
+* groupby_output_table
+* @Param[out] out_size The number of groups
+* @Param sort_result Flag to optionally sort the output table
+* @Param include_null_keys If true, rows with a NULL key form groups of their
+* own, otherwise they are dropped
+* @Param cardinality_hint The expected number of groups, or 0 if unknown. When
+* given, the hash table is sized for the hint. When unknown, the number of
+* groups of a large input is estimated. The aggregates are indexed by slot, so
+* the table is not grown: if the hint or estimate is too low, the pass is
+* redone on a table sized for the input.
+* @Param[out] hash_table_stats If not nullptr, receives the statistics of the hash table
+* 
+* @Returns GDF_SUCCESS, GDF_VALIDITY_MISSING if the output column of an
+* aggregation_may_be_null has no validity mask, or the error code of the groupby
+*/
+/* ----------------------------------------------------------------------------*/
+template <typename size_type>
+gdf_error GroupbyHashMultiAggregation(gdf_table<size_type> const & groupby_input_table,
+                                      std::vector<aggregation_info> aggregations,
+                                      gdf_table<size_type> & groupby_output_table,
+                                      gdf_column * out_aggregation_columns[],
+                                      size_type * out_size,
+                                      bool sort_result = false,
+                                      bool include_null_keys = false,
+                                      size_t cardinality_hint = 0,
+                                      gdf_hash_table_stats * hash_table_stats = nullptr)
+{
+  const size_type input_num_rows = groupby_input_table.get_column_length();
+  const int num_aggregations = static_cast<int>(aggregations.size());
+
+  // Without a validity mask, a NULL result would be indistinguishable from a value
+  for(int a = 0; a < num_aggregations; ++a) {
+    GDF_REQUIRE((nullptr != out_aggregation_columns[a]->valid) || !aggregation_may_be_null(aggregations[a]),
+                GDF_VALIDITY_MISSING);
+  }
+
+  cardinality_hint = estimate_num_groups(groupby_input_table, cardinality_hint);
+
+  // The map will store (row index, index of the first row of the group)
+  using map_type = concurrent_unordered_map<size_type, 
+                                            size_type, 
+                                            std::numeric_limits<size_type>::max(), 
+                                            default_hash<size_type>, 
+                                            equal_to<size_type>,
+                                            legacy_allocator<thrust::pair<size_type, size_type> > >;
+
+  hash_table_growth_policy growth_policy;
+  growth_policy.max_occupancy_percent = DEFAULT_HASH_TABLE_OCCUPANCY;
+  size_type hash_table_size = static_cast<size_type>(growth_policy.initial_size(input_num_rows, cardinality_hint));
+
+  std::unique_ptr<map_type> the_map;
+  std::vector<Vector<char>> slot_values(num_aggregations);
+  std::vector<Vector<unsigned long long>> slot_counts(num_aggregations);
+  Vector<aggregation_info> d_aggregations(num_aggregations);
+
+  Vector<int> overflow(1);
+
+  const dim3 block_size (THREAD_BLOCK_SIZE, 1, 1);
+  const dim3 build_grid_size ((input_num_rows + THREAD_BLOCK_SIZE - 1) / THREAD_BLOCK_SIZE, 1, 1);
+
+  CUDA_TRY(cudaGetLastError());
+
+  while(true) {
+
+    the_map.reset(new map_type(hash_table_size, min_op<size_type>::IDENTITY));
+    the_map->set_max_occupancy(growth_policy.max_occupancy(hash_table_size));
+
+    for(int a = 0; a < num_aggregations; ++a) {
+      gdf_error gdf_error_code = allocate_aggregation_storage(aggregations[a],
+                                                              slot_values[a],
+                                                              slot_counts[a],
+                                                              hash_table_size);
+      if(GDF_SUCCESS != gdf_error_code) return gdf_error_code;
+    }
+    thrust::copy(aggregations.begin(), aggregations.end(), d_aggregations.begin());
+    overflow[0] = 0;
+
+    build_multi_aggregation_table<<<build_grid_size, block_size>>>(the_map.get(),
+                                                                   groupby_input_table,
+                                                                   d_aggregations.data().get(),
+                                                                   num_aggregations,
+                                                                   row_comparator<map_type, size_type>(*the_map, groupby_input_table, groupby_input_table, include_null_keys),
+                                                                   input_num_rows,
+                                                                   !include_null_keys,
+                                                                   overflow.data().get());
+    CUDA_TRY(cudaGetLastError());
+
+    if(0 == overflow[0]) {
+      break;
+    }
+
+    // The hint was too low. A table sized for the input holds every group.
+    hash_table_size = static_cast<size_type>(growth_policy.initial_size(input_num_rows));
+  }
+
+  // The keys of the map are distinct groups, so equal hash values are collisions
+  if(nullptr != hash_table_stats) {
+    gdf_error stats_error = compute_hash_table_stats<typename map_type::probing>(the_map->data(),
+                                                                                 hash_table_size,
+                                                                                 map_type::get_unused_key(),
+                                                                                 row_hasher<size_type>(groupby_input_table),
+                                                                                 true,
+                                                                                 hash_table_stats);
+    if(GDF_SUCCESS != stats_error) return stats_error;
+  }
+
+  // Used by threads to coordinate where to write their results
+  Vector<size_type> global_write_index(1, 0);
+  Vector<size_type> group_rows(the_map->get_occupancy());
+  Vector<size_type> group_slots(the_map->get_occupancy());
+
+  const dim3 extract_grid_size ((hash_table_size + THREAD_BLOCK_SIZE - 1) / THREAD_BLOCK_SIZE, 1, 1);
+
+  // Records the first row and the slot of every group
+  extract_multi_aggregation_groups<<<extract_grid_size, block_size>>>(the_map.get(),
+                                                                      hash_table_size,
+                                                                      group_rows.data().get(),
+                                                                      group_slots.data().get(),
+                                                                      global_write_index.data().get());
+  CUDA_TRY(cudaGetLastError());
+
+  *out_size = global_write_index[0];
+  groupby_output_table.set_column_length(*out_size);
+
+  // Gathers the keys of the groups, with their validity, from their first rows.
+  // The gather only sets the valid bits, so the output masks are cleared first
+  for(size_type i = 0; i < groupby_output_table.get_num_columns(); ++i) {
+    gdf_column * out_key_column = groupby_output_table.get_column(i);
+    if(nullptr != out_key_column->valid) {
+      CUDA_TRY(cudaMemset(out_key_column->valid, 0, gdf_get_num_chars_bitmask(*out_size)));
+    }
+  }
+  gdf_error gather_error = groupby_input_table.gather(group_rows, groupby_output_table);
+  if(GDF_SUCCESS != gather_error) return gather_error;
+
+  for(size_type i = 0; i < groupby_output_table.get_num_columns(); ++i) {
+    gdf_column * out_key_column = groupby_output_table.get_column(i);
+    out_key_column->null_count = 0;
+    if((nullptr != out_key_column->valid) && (*out_size > 0)) {
+      int valid_count{0};
+      gdf_error count_error = gdf_count_nonzero_mask(out_key_column->valid, *out_size, &valid_count);
+      if(GDF_SUCCESS != count_error) return count_error;
+      out_key_column->null_count = *out_size - valid_count;
+    }
+  }
+
+  // Optionally sort the groups. The aggregates are then read in sorted order,
+  // so only the slots need to be permuted. The sort ignores the validity, so
+  // the groups of a NULL key are ordered by their underlying data
+  if(true == sort_result) {
+    rmm_temp_allocator allocator(0);
+    auto exec = thrust::cuda::par(allocator).on(0);
+
+    auto sorted_indices = groupby_output_table.sort();
+    Vector<size_type> sorted_slots(*out_size);
+    thrust::gather(exec,
+                   sorted_indices.begin(), sorted_indices.end(),
+                   group_slots.begin(),
+                   sorted_slots.begin());
+    group_slots.swap(sorted_slots);
+  }
+
+  for(int a = 0; a < num_aggregations; ++a) {
+    gdf_error gdf_error_code = extract_aggregation(aggregations[a],
+                                                   group_slots.data().get(),
+                                                   *out_size,
+                                                   out_aggregation_columns[a]);
+    if(GDF_SUCCESS != gdf_error_code) return gdf_error_code;
+  }
+
+  return GDF_SUCCESS;
+}
+
 #endif
@@ -22,6 +22,26 @@
 
 #include "aggregation_operations.cuh"
 
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Records a row that could not be inserted because the hash table
+ * reached its maximum occupancy. The host grows the table and inserts the
+ * recorded rows again.
+ * 
+ * @Param row_index The index of the row in the input table
+ * @Param overflow_rows The list of rows to retry
+ * @Param overflow_count The number of rows in overflow_rows
+ */
+/* ----------------------------------------------------------------------------*/
+template<typename size_type>
+__device__ __forceinline__ void add_to_overflow(size_type row_index,
+                                                size_type * const overflow_rows,
+                                                size_type * const overflow_count)
+{
+  const size_type write_index = atomicAdd(overflow_count, size_type(1));
+  overflow_rows[write_index] = row_index;
+}
+
 /* --------------------------------------------------------------------------*/
 /** 
  * @Synopsis Takes in two columns of equal length. One column to groupby and the
@@ -34,8 +54,12 @@
  * @Param the_map The hash table to use for building the aggregation table
  * @Param groupby_column The column used as keys into the hash table
  * @Param aggregation_column The column used as the values of the hash table
- * @Param column_size The size of both columns
  * @Param op The aggregation operation to perform between new and existing hash table values
+ * @Param row_indices The rows to insert, or nullptr to insert rows [0, num_rows)
+ * @Param num_rows The number of rows to insert
+ * @Param overflow_rows Receives the rows whose key did not fit in the map. May be
+ * nullptr if the map can hold every row.
+ * @Param overflow_count The number of rows written to overflow_rows
  * 
  * @Returns   
  */
@@ -48,27 +72,36 @@ template<typename map_type,
 __global__ void build_aggregation_table(map_type * const __restrict__ the_map,
                                         gdf_table<size_type> const & groupby_input_table,
                                         const aggregation_type * const __restrict__ aggregation_column,
-                                        size_type column_size,
                                         aggregation_operation op,
-                                        row_comparator the_comparator)
+                                        row_comparator the_comparator,
+                                        const size_type * const __restrict__ row_indices,
+                                        size_type num_rows,
+                                        size_type * const overflow_rows,
+                                        size_type * const overflow_count)
 {
   size_type i = threadIdx.x + blockIdx.x * blockDim.x;
 
-  while( i < column_size ){
+  while( i < num_rows ){
+
+    const size_type row_index = (nullptr == row_indices) ? i : row_indices[i];
 
     // Hash the current row of the input table
-    const auto row_hash = groupby_input_table.hash_row(i);
+    const auto row_hash = groupby_input_table.hash_row(row_index);
 
     // Attempt to insert the current row's index.  
     // The hash value of the row will determine the write location.
     // The rows at the current row index and the existing row index 
     // will be compared for equality. If they are equal, the aggregation
     // operation is performed.
-    the_map->insert(thrust::make_pair(i, aggregation_column[i]), 
-                    op,
-                    the_comparator,
-                    true,
-                    row_hash);
+    const auto insert_location = the_map->insert(thrust::make_pair(row_index, aggregation_column[row_index]), 
+                                                 op,
+                                                 the_comparator,
+                                                 true,
+                                                 row_hash);
+
+    if(the_map->end() == insert_location){
+      add_to_overflow(row_index, overflow_rows, overflow_count);
+    }
 
     i += blockDim.x * gridDim.x;
   }
@@ -82,16 +115,21 @@ template<typename map_type,
 __global__ void build_aggregation_table(map_type * const __restrict__ the_map,
                                         gdf_table<size_type> const & groupby_input_table,
                                         const aggregation_type * const __restrict__ aggregation_column,
-                                        size_type column_size,
                                         count_op<typename map_type::mapped_type> op,
-                                        row_comparator the_comparator)
+                                        row_comparator the_comparator,
+                                        const size_type * const __restrict__ row_indices,
+                                        size_type num_rows,
+                                        size_type * const overflow_rows,
+                                        size_type * const overflow_count)
 {
   size_type i = threadIdx.x + blockIdx.x * blockDim.x;
 
-  // Hash the current row of the input table
-  const auto row_hash = groupby_input_table.hash_row(i);
+  while( i < num_rows ){
 
-  while( i < column_size ){
+    const size_type row_index = (nullptr == row_indices) ? i : row_indices[i];
+
+    // Hash the current row of the input table
+    const auto row_hash = groupby_input_table.hash_row(row_index);
 
     // When the aggregator is COUNT, ignore the aggregation column and just insert '0'
     // Attempt to insert the current row's index.  
@@ -99,11 +137,658 @@ __global__ void build_aggregation_table(map_type * const __restrict__ the_map,
     // The rows at the current row index and the existing row index 
     // will be compared for equality. If they are equal, the aggregation
     // operation is performed.
-    the_map->insert(thrust::make_pair(i, static_cast<typename map_type::mapped_type>(0)), 
-                    op,
-                    the_comparator,
-                    true,
-                    row_hash);
+    const auto insert_location = the_map->insert(thrust::make_pair(row_index, static_cast<typename map_type::mapped_type>(0)), 
+                                                 op,
+                                                 the_comparator,
+                                                 true,
+                                                 row_hash);
+
+    if(the_map->end() == insert_location){
+      add_to_overflow(row_index, overflow_rows, overflow_count);
+    }
+
+    i += blockDim.x * gridDim.x;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  One aggregation of a multi-aggregation groupby, as read by the
+ * kernels. The aggregates of a group are stored column-wise, at the index of
+ * the slot of the group in the hash table.
+ */
+/* ----------------------------------------------------------------------------*/
+struct aggregation_info
+{
+  void const * input;                 ///< The data of the aggregation column
+  gdf_valid_type const * input_valid; ///< The validity mask of the aggregation column, nullptr if it has no nulls
+  gdf_dtype input_dtype;              ///< The dtype of the data, one of GDF_INT8 to GDF_FLOAT64
+  gdf_agg_op op;                      ///< The aggregation operation
+  void * values;                      ///< The SUM (also of AVG), MIN or MAX of every slot, the shifted_sums
+                                      ///< of VAR and STD, the row index of FIRST and LAST, nullptr for COUNT
+  unsigned long long * counts;        ///< The number of non-null values of every slot for COUNT, AVG, VAR,
+                                      ///< STD and any column with nulls, otherwise nullptr
+  int64_t const * input_counts;       ///< When merging the partial aggregates of AVG, VAR and STD, the number
+                                      ///< of values of every row, otherwise nullptr: every row is one value
+  double const * input_m2s;           ///< When merging the partial aggregates of VAR and STD, the M2 of every
+                                      ///< row, whose input is the mean, otherwise nullptr
+};
+
+// The shift of shifted_sums before the first value of the group is aggregated.
+// A NaN, whose variance is NaN anyway.
+constexpr unsigned long long UNSET_SHIFT{0x7ff4dead0000beefull};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The aggregates of a group for VAR and STD: the sum and the sum of
+ * squares of the differences of its values with the first one aggregated, from
+ * which moments_from_shifted_sums computes its variance. Unlike the moments of
+ * welford_op, they are updated with an atomic operation each.
+ */
+/* ----------------------------------------------------------------------------*/
+struct shifted_sums
+{
+  unsigned long long shift; ///< The bits of the double all the values are shifted by, or UNSET_SHIFT
+  double sum;
+  double sum_of_squares;
+};
+
+// The type the aggregates of an input type are accumulated in. There is no
+// native atomicCAS for 1 and 2 byte types, so they are widened to int32_t
+template <typename input_type>
+struct aggregate_storage { using type = input_type; };
+template <>
+struct aggregate_storage<int8_t> { using type = int32_t; };
+template <>
+struct aggregate_storage<int16_t> { using type = int32_t; };
+
+template <typename input_type>
+using aggregate_storage_t = typename aggregate_storage<input_type>::type;
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Atomically replaces *address with op(value, *address)
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename value_type, typename aggregation_operation>
+__device__ __forceinline__ void atomic_aggregate(value_type * address,
+                                                 value_type value,
+                                                 aggregation_operation op)
+{
+  value_type old_value = *address;
+  value_type expected{old_value};
+
+  // Guard against another thread's update of *address
+  do
+  {
+    expected = old_value;
+    old_value = atomicCAS(address, expected, op(value, expected));
+  }
+  while( expected != old_value );
+}
+
+// Specializations for the aggregations with a native atomic function
+__device__ __forceinline__ void atomic_aggregate(int32_t * address, int32_t value, sum_op<int32_t>)
+{
+  atomicAdd(address, value);
+}
+__device__ __forceinline__ void atomic_aggregate(int64_t * address, int64_t value, sum_op<int64_t>)
+{
+  atomicAdd(address, value);
+}
+__device__ __forceinline__ void atomic_aggregate(float * address, float value, sum_op<float>)
+{
+  atomicAdd(address, value);
+}
+__device__ __forceinline__ void atomic_aggregate(int32_t * address, int32_t value, min_op<int32_t>)
+{
+  atomicMin(address, value);
+}
+__device__ __forceinline__ void atomic_aggregate(int32_t * address, int32_t value, max_op<int32_t>)
+{
+  atomicMax(address, value);
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Adds a value to the shifted_sums of its group, or the moments of
+ * a partial group: count values of mean value and sum of squared deviations m2.
+ * The first value aggregated becomes the shift of the group.
+ */
+/* ----------------------------------------------------------------------------*/
+__device__ __forceinline__ void update_shifted_sums(shifted_sums * sums,
+                                                    double value,
+                                                    double count = 1,
+                                                    double m2 = 0)
+{
+  // The shift is only written once, so a value read other than UNSET_SHIFT is final
+  unsigned long long shift = sums->shift;
+  if(UNSET_SHIFT == shift){
+    const unsigned long long value_bits = static_cast<unsigned long long>(__double_as_longlong(value));
+    shift = atomicCAS(&sums->shift, UNSET_SHIFT, value_bits);
+    if(UNSET_SHIFT == shift){
+      shift = value_bits;
+    }
+  }
+
+  const double shifted_value = value - __longlong_as_double(static_cast<long long>(shift));
+  atomic_aggregate(&sums->sum, count * shifted_value, sum_op<double>());
+  atomic_aggregate(&sums->sum_of_squares, m2 + count * shifted_value * shifted_value, sum_op<double>());
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Aggregates a row of an aggregation column into the aggregates of
+ * the slot of its group. NULL values are skipped, and not counted by COUNT. A
+ * row of partial aggregates counts for the number of values it aggregates.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename input_type, typename size_type>
+__device__ __forceinline__ void update_typed_aggregation(aggregation_info const & aggregation,
+                                                         size_type row_index,
+                                                         size_type slot)
+{
+  using storage_type = aggregate_storage_t<input_type>;
+
+  if(false == gdf_is_valid(aggregation.input_valid, row_index)){
+    return;
+  }
+
+  const unsigned long long weight = (nullptr != aggregation.input_counts)
+                                    ? static_cast<unsigned long long>(aggregation.input_counts[row_index])
+                                    : 1ull;
+
+  if((GDF_FIRST == aggregation.op) || (GDF_LAST == aggregation.op)){
+    // The value of the row is only read when the result is extracted
+    unsigned long long * const slot_row = static_cast<unsigned long long *>(aggregation.values) + slot;
+    if(GDF_FIRST == aggregation.op){
+      atomicMin(slot_row, static_cast<unsigned long long>(row_index));
+    }
+    else{
+      atomicMax(slot_row, static_cast<unsigned long long>(row_index));
+    }
+  }
+  else if(GDF_COUNT != aggregation.op){
+    const input_type value = static_cast<input_type const *>(aggregation.input)[row_index];
+    storage_type * const slot_value = static_cast<storage_type *>(aggregation.values) + slot;
+
+    switch(aggregation.op)
+    {
+      case GDF_SUM:
+      case GDF_AVG: { atomic_aggregate(slot_value, static_cast<storage_type>(value), sum_op<storage_type>()); break; }
+      case GDF_MIN: { atomic_aggregate(slot_value, static_cast<storage_type>(value), min_op<storage_type>()); break; }
+      case GDF_MAX: { atomic_aggregate(slot_value, static_cast<storage_type>(value), max_op<storage_type>()); break; }
+      case GDF_VAR:
+      case GDF_STD:
+        {
+          update_shifted_sums(static_cast<shifted_sums *>(aggregation.values) + slot,
+                              static_cast<double>(value),
+                              static_cast<double>(weight),
+                              (nullptr != aggregation.input_m2s) ? aggregation.input_m2s[row_index] : 0.0);
+          break;
+        }
+      default: break;
+    }
+  }
+
+  if(nullptr != aggregation.counts){
+    atomicAdd(aggregation.counts + slot, weight);
+  }
+}
+
+template <typename size_type>
+__device__ __forceinline__ void update_aggregation(aggregation_info const & aggregation,
+                                                   size_type row_index,
+                                                   size_type slot)
+{
+  switch(aggregation.input_dtype)
+  {
+    case GDF_INT8:    { update_typed_aggregation<int8_t>(aggregation, row_index, slot); break; }
+    case GDF_INT16:   { update_typed_aggregation<int16_t>(aggregation, row_index, slot); break; }
+    case GDF_INT32:   { update_typed_aggregation<int32_t>(aggregation, row_index, slot); break; }
+    case GDF_INT64:   { update_typed_aggregation<int64_t>(aggregation, row_index, slot); break; }
+    case GDF_FLOAT32: { update_typed_aggregation<float>(aggregation, row_index, slot); break; }
+    case GDF_FLOAT64: { update_typed_aggregation<double>(aggregation, row_index, slot); break; }
+    default: break;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis Inserts every row of the groupby table into a hash table that maps
+ * each group to the index of its first row, and aggregates every aggregation
+ * column into the slot of the group of the row. All the aggregations are
+ * computed in this single pass over the input.
+ *
+ * @Param the_map The hash table, whose values are initialized with min_op::IDENTITY
+ * @Param groupby_input_table The groupby columns
+ * @Param aggregations The aggregations
+ * @Param num_aggregations The number of aggregations
+ * @Param the_comparator Compares the rows referred to by two keys
+ * @Param num_rows The number of rows to insert
+ * @Param skip_null_keys If true, the rows with a NULL key are dropped
+ * @Param overflow Set to 1 if a row did not fit in the map, whose aggregates
+ * are then incomplete
+ */
+/* ----------------------------------------------------------------------------*/
+template<typename map_type,
+         typename size_type,
+         typename row_comparator>
+__global__ void build_multi_aggregation_table(map_type * const __restrict__ the_map,
+                                              gdf_table<size_type> const & groupby_input_table,
+                                              aggregation_info const * const __restrict__ aggregations,
+                                              int num_aggregations,
+                                              row_comparator the_comparator,
+                                              size_type num_rows,
+                                              bool skip_null_keys,
+                                              int * const overflow)
+{
+  size_type i = threadIdx.x + blockIdx.x * blockDim.x;
+
+  while( i < num_rows ){
+
+    if(skip_null_keys && (false == groupby_input_table.is_row_valid(i))){
+      i += blockDim.x * gridDim.x;
+      continue;
+    }
+
+    const auto row_hash = groupby_input_table.hash_row(i);
+
+    // The value of a group is the smallest index of its rows
+    const auto insert_location = the_map->insert(thrust::make_pair(i, i),
+                                                 min_op<size_type>(),
+                                                 the_comparator,
+                                                 true,
+                                                 row_hash);
+
+    if(the_map->end() == insert_location){
+      *overflow = 1;
+    }
+    else {
+      const size_type slot = static_cast<size_type>(&(*insert_location) - the_map->data());
+      for(int a = 0; a < num_aggregations; ++a){
+        update_aggregation(aggregations[a], i, slot);
+      }
+    }
+
+    i += blockDim.x * gridDim.x;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis Extracts the groups of a multi-aggregation hash table: records the
+ * first row of every group, from which its key is gathered, and the slot of the
+ * group, from which its aggregates are read.
+ *
+ * @Param the_map The hash table to extract from
+ * @Param map_size The total capacity of the hash table
+ * @Param group_rows Receives the first row of every group
+ * @Param group_slots Receives the slot of every group
+ * @Param global_write_index A variable in device global memory used to coordinate
+ * where threads write their output
+ */
+/* ----------------------------------------------------------------------------*/
+template<typename map_type,
+         typename size_type>
+__global__ void extract_multi_aggregation_groups(const map_type * const __restrict__ the_map,
+                                                 const size_type map_size,
+                                                 size_type * const __restrict__ group_rows,
+                                                 size_type * const __restrict__ group_slots,
+                                                 size_type * const global_write_index)
+{
+  size_type i = threadIdx.x + blockIdx.x * blockDim.x;
+
+  constexpr typename map_type::key_type unused_key{map_type::get_unused_key()};
+
+  const typename map_type::value_type * const __restrict__ hashtabl_values = the_map->data();
+
+  while(i < map_size){
+
+    if( hashtabl_values[i].first != unused_key){
+      const size_type thread_write_index = atomicAdd(global_write_index, 1);
+      group_rows[thread_write_index] = hashtabl_values[i].second;
+      group_slots[thread_write_index] = i;
+    }
+    i += gridDim.x * blockDim.x;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Computes the result of an aggregation for a group from the
+ * aggregates of its slot. AVG is computed as SUM / COUNT, like compute_average.
+ * FIRST and LAST read the value of their row. The result is NULL if the group
+ * has no non-null value, except for COUNT, or for VAR and STD, fewer than 2.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename input_type, typename output_type, typename size_type>
+struct finalize_aggregate
+{
+  using storage_type = aggregate_storage_t<input_type>;
+
+  input_type const * input;
+  void const * values;
+  unsigned long long const * counts;
+  gdf_agg_op op;
+
+  __device__ output_type operator()(size_type slot) const
+  {
+    if(false == is_valid(slot)) return output_type{};
+
+    switch(op)
+    {
+      case GDF_COUNT: return static_cast<output_type>(counts[slot]);
+      case GDF_AVG:   return static_cast<output_type>(static_cast<storage_type const *>(values)[slot] / static_cast<output_type>(counts[slot]));
+      case GDF_VAR:
+      case GDF_STD:
+        {
+          shifted_sums const & sums = static_cast<shifted_sums const *>(values)[slot];
+          const double variance = moments_from_shifted_sums(static_cast<double>(counts[slot]),
+                                                            __longlong_as_double(static_cast<long long>(sums.shift)),
+                                                            sums.sum,
+                                                            sums.sum_of_squares).variance();
+          return static_cast<output_type>((GDF_STD == op) ? sqrt(variance) : variance);
+        }
+      case GDF_FIRST:
+      case GDF_LAST:  return static_cast<output_type>(input[static_cast<unsigned long long const *>(values)[slot]]);
+      default:        return static_cast<output_type>(static_cast<storage_type const *>(values)[slot]);
+    }
+  }
+
+  __device__ bool is_valid(size_type slot) const
+  {
+    if(GDF_COUNT == op) return true;
+    if((GDF_VAR == op) || (GDF_STD == op)) return counts[slot] > 1;
+    return (nullptr == counts) || (counts[slot] > 0);
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Writes the result of an aggregation for every group, and its
+ * validity mask in the same pass. Every thread writes the results of
+ * GDF_VALID_BITSIZE consecutive groups, so that it owns their byte of the mask.
+ *
+ * @Param finalize Computes the result of a group from its slot
+ * @Param group_slots The slot of every group, in output order
+ * @Param num_groups The number of groups
+ * @Param out_data The output data
+ * @Param out_valid The output validity mask, or nullptr
+ * @Param null_count Incremented with the number of NULL results
+ */
+/* ----------------------------------------------------------------------------*/
+template<typename finalize_type,
+         typename output_type,
+         typename size_type>
+__global__ void extract_aggregation_result(finalize_type finalize,
+                                           const size_type * const __restrict__ group_slots,
+                                           const size_type num_groups,
+                                           output_type * const __restrict__ out_data,
+                                           gdf_valid_type * const __restrict__ out_valid,
+                                           size_type * const null_count)
+{
+  const size_type num_masks = gdf_get_num_chars_bitmask(num_groups);
+
+  size_type mask_index = threadIdx.x + blockIdx.x * blockDim.x;
+
+  while(mask_index < num_masks){
+    gdf_valid_type mask{0};
+    size_type num_nulls{0};
+
+    for(int bit = 0; bit < GDF_VALID_BITSIZE; ++bit){
+      const size_type group = mask_index * GDF_VALID_BITSIZE + bit;
+      if(group >= num_groups) break;
+
+      const size_type slot = group_slots[group];
+      out_data[group] = finalize(slot);
+      if(finalize.is_valid(slot)){
+        mask |= static_cast<gdf_valid_type>(1 << bit);
+      }
+      else{
+        ++num_nulls;
+      }
+    }
+
+    if(nullptr != out_valid){
+      out_valid[mask_index] = mask;
+    }
+    if(num_nulls > 0){
+      atomicAdd(null_count, num_nulls);
+    }
+
+    mask_index += gridDim.x * blockDim.x;
+  }
+}
+
+// The number of slots of the hash table of a thread block in the shared memory
+// groupby. A power of 2.
+constexpr int SHARED_GROUPBY_TABLE_SIZE{1024};
+
+// A thread block table holds at most this many groups, i.e., it is at most half
+// full. The rows of its other groups are inserted in the global hash table.
+constexpr int SHARED_GROUPBY_MAX_BLOCK_GROUPS{SHARED_GROUPBY_TABLE_SIZE / 2};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The aggregation operation of a functor, on another value type
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename aggregation_operation, typename value_type>
+struct rebind_operation;
+
+template <template <typename> class op, typename T, typename value_type>
+struct rebind_operation<op<T>, value_type> { using type = op<value_type>; };
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The operation that combines two partial aggregates of a group:
+ * the operation itself, except for COUNT whose partial counts are summed
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename aggregation_operation>
+struct partial_merge_operation
+{
+  using type = aggregation_operation;
+  static constexpr bool counts_rows{false};
+};
+
+template <typename T>
+struct partial_merge_operation<count_op<T>>
+{
+  using type = sum_op<T>;
+  static constexpr bool counts_rows{true};
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis Aggregates the rows into a hash table in the shared memory of every
+ * thread block, then writes the groups of the block table as partial aggregates.
+ *
+ * When there are few groups, every row of build_aggregation_table updates one
+ * of a few slots of the global hash table, and the atomics on these slots are
+ * serialized. Here the rows of a block only contend within the block, and the
+ * global hash table is updated once per group and block by
+ * merge_partial_aggregates. A block table holds at most
+ * SHARED_GROUPBY_MAX_BLOCK_GROUPS groups, the rows of the other groups are
+ * inserted in the global hash table directly.
+ *
+ * The aggregates of the block tables are stored as aggregate_storage_t, as the
+ * 1 and 2 byte types have no native atomicCAS.
+ *
+ * @Param the_map The global hash table, for the rows that do not fit in a block table
+ * @Param groupby_input_table The groupby columns
+ * @Param aggregation_column The column to aggregate
+ * @Param op The aggregation operation
+ * @Param the_comparator Compares the rows referred to by two keys
+ * @Param num_rows The number of rows
+ * @Param overflow_rows Receives the rows that did not fit in the global hash
+ * table either. May be nullptr if the map can hold every row.
+ * @Param overflow_count The number of rows written to overflow_rows
+ * @Param partial_rows Receives the first row of the group of every partial
+ * aggregate. Holds SHARED_GROUPBY_MAX_BLOCK_GROUPS per thread block.
+ * @Param partial_values Receives every partial aggregate
+ * @Param num_partials The number of partial aggregates written
+ */
+/* ----------------------------------------------------------------------------*/
+template<typename map_type,
+         typename aggregation_operation,
+         typename aggregation_type,
+         typename size_type,
+         typename row_comparator>
+__global__ void build_shared_aggregation_table(map_type * const __restrict__ the_map,
+                                               gdf_table<size_type> const & groupby_input_table,
+                                               const aggregation_type * const __restrict__ aggregation_column,
+                                               aggregation_operation op,
+                                               row_comparator the_comparator,
+                                               size_type num_rows,
+                                               size_type * const overflow_rows,
+                                               size_type * const overflow_count,
+                                               size_type * const __restrict__ partial_rows,
+                                               aggregation_type * const __restrict__ partial_values,
+                                               size_type * const num_partials)
+{
+  using storage_type = aggregate_storage_t<aggregation_type>;
+  using merge_traits = partial_merge_operation<aggregation_operation>;
+  using shared_operation = typename rebind_operation<typename merge_traits::type, storage_type>::type;
+
+  constexpr size_type unused_key{map_type::get_unused_key()};
+  constexpr size_type slot_mask{SHARED_GROUPBY_TABLE_SIZE - 1};
+
+  __shared__ size_type shared_keys[SHARED_GROUPBY_TABLE_SIZE];
+  __shared__ storage_type shared_values[SHARED_GROUPBY_TABLE_SIZE];
+  __shared__ int num_shared_groups;
+
+  for(int slot = threadIdx.x; slot < SHARED_GROUPBY_TABLE_SIZE; slot += blockDim.x){
+    shared_keys[slot] = unused_key;
+    shared_values[slot] = shared_operation::IDENTITY;
+  }
+  if(0 == threadIdx.x){
+    num_shared_groups = 0;
+  }
+  __syncthreads();
+
+  size_type i = threadIdx.x + blockIdx.x * blockDim.x;
+
+  while( i < num_rows ){
+
+    const auto row_hash = groupby_input_table.hash_row(i);
+
+    // A COUNT counts the rows of a group in its block table
+    const storage_type value = merge_traits::counts_rows ? storage_type{1}
+                                                         : static_cast<storage_type>(aggregation_column[i]);
+
+    bool aggregated{false};
+    size_type slot = static_cast<size_type>(row_hash) & slot_mask;
+
+    for(int attempt = 0; attempt < SHARED_GROUPBY_TABLE_SIZE; ++attempt){
+
+      size_type current_key = static_cast<volatile size_type *>(shared_keys)[slot];
+
+      // The group is not in the table. Claim the slot, unless the table holds
+      // its maximum number of groups.
+      if(unused_key == current_key){
+        if(atomicAdd(&num_shared_groups, 1) >= SHARED_GROUPBY_MAX_BLOCK_GROUPS){
+          break;
+        }
+        current_key = atomicCAS(&shared_keys[slot], unused_key, i);
+        if(unused_key == current_key){
+          atomic_aggregate(&shared_values[slot], value, shared_operation());
+          aggregated = true;
+          break;
+        }
+        // Another row claimed the slot first
+        atomicSub(&num_shared_groups, 1);
+      }
+
+      if(the_comparator(current_key, i)){
+        atomic_aggregate(&shared_values[slot], value, shared_operation());
+        aggregated = true;
+        break;
+      }
+
+      slot = (slot + 1) & slot_mask;
+    }
+
+    if(false == aggregated){
+      const aggregation_type map_value = merge_traits::counts_rows ? aggregation_type{0} : aggregation_column[i];
+      const auto insert_location = the_map->insert(thrust::make_pair(i, map_value),
+                                                   op,
+                                                   the_comparator,
+                                                   true,
+                                                   row_hash);
+      if(the_map->end() == insert_location){
+        add_to_overflow(i, overflow_rows, overflow_count);
+      }
+    }
+
+    i += blockDim.x * gridDim.x;
+  }
+
+  __syncthreads();
+
+  for(int slot = threadIdx.x; slot < SHARED_GROUPBY_TABLE_SIZE; slot += blockDim.x){
+    const size_type current_key = shared_keys[slot];
+    if(unused_key != current_key){
+      const size_type write_index = atomicAdd(num_partials, size_type(1));
+      partial_rows[write_index] = current_key;
+      partial_values[write_index] = static_cast<aggregation_type>(shared_values[slot]);
+    }
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis Inserts the partial aggregates of build_shared_aggregation_table
+ * into the global hash table, combining those of the same group.
+ *
+ * @Param the_map The global hash table
+ * @Param groupby_input_table The groupby columns
+ * @Param partial_rows The first row of the group of every partial aggregate
+ * @Param partial_values The partial aggregates
+ * @Param op The partial_merge_operation of the aggregation
+ * @Param the_comparator Compares the rows referred to by two keys
+ * @Param partial_indices The partial aggregates to insert, or nullptr to insert
+ * [0, num_partials)
+ * @Param num_partials The number of partial aggregates to insert
+ * @Param overflow_partials Receives the partial aggregates whose group did not
+ * fit in the map. May be nullptr if the map can hold every group.
+ * @Param overflow_count The number of partial aggregates written to overflow_partials
+ */
+/* ----------------------------------------------------------------------------*/
+template<typename map_type,
+         typename aggregation_operation,
+         typename aggregation_type,
+         typename size_type,
+         typename row_comparator>
+__global__ void merge_partial_aggregates(map_type * const __restrict__ the_map,
+                                         gdf_table<size_type> const & groupby_input_table,
+                                         const size_type * const __restrict__ partial_rows,
+                                         const aggregation_type * const __restrict__ partial_values,
+                                         aggregation_operation op,
+                                         row_comparator the_comparator,
+                                         const size_type * const __restrict__ partial_indices,
+                                         size_type num_partials,
+                                         size_type * const overflow_partials,
+                                         size_type * const overflow_count)
+{
+  size_type i = threadIdx.x + blockIdx.x * blockDim.x;
+
+  while( i < num_partials ){
+
+    const size_type partial_index = (nullptr == partial_indices) ? i : partial_indices[i];
+    const size_type row_index = partial_rows[partial_index];
+
+    const auto insert_location = the_map->insert(thrust::make_pair(row_index, partial_values[partial_index]),
+                                                 op,
+                                                 the_comparator,
+                                                 true,
+                                                 groupby_input_table.hash_row(row_index));
+
+    if(the_map->end() == insert_location){
+      add_to_overflow(partial_index, overflow_partials, overflow_count);
+    }
+
     i += blockDim.x * gridDim.x;
   }
 }
@@ -0,0 +1,657 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HOST_GROUPBY_H
+#define HOST_GROUPBY_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "cudf.h"
+#include "groupby/aggregation_operations.cuh"
+#include "groupby/partial_aggregation.h"
+#include "hash/hash_functions.cuh"
+#include "hash/hash_table_growth.h"
+#include "hash/host_concurrent_unordered_map.cuh"
+#include "utilities/host_parallel.h"
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The result of host_group_by
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename key_type, typename value_type>
+struct host_groupby_result
+{
+  /// The key of every group, key_type{} for the NULL key
+  std::vector<key_type> keys;
+
+  /// Whether the key of every group is valid
+  std::vector<bool> key_valid;
+
+  /// The result of every aggregation, one vector per aggregation, with the
+  /// result of the group keys[i] at index i, value_type{} if NULL
+  std::vector<std::vector<value_type>> aggregates;
+
+  /// Whether every result of every aggregation is valid
+  std::vector<std::vector<bool>> aggregate_valid;
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The identity of the aggregates of a host groupby operation
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename value_type>
+value_type host_aggregate_identity(gdf_agg_op op)
+{
+  if (GDF_MIN == op) return min_op<value_type>::IDENTITY;
+  if (GDF_MAX == op) return max_op<value_type>::IDENTITY;
+  return value_type{};
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Combines a value, or the partial aggregate of a group, into an
+ * aggregate of a host groupby. COUNT only counts, so its value is unchanged.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename value_type>
+void host_aggregate(gdf_agg_op op, value_type value, value_type & aggregate)
+{
+  switch (op) {
+    case GDF_SUM:
+    case GDF_AVG: aggregate = sum_op<value_type>()(value, aggregate); break;
+    case GDF_MIN: aggregate = min_op<value_type>()(value, aggregate); break;
+    case GDF_MAX: aggregate = max_op<value_type>()(value, aggregate); break;
+    default: break;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Extracts the groups of the map of a host groupby in slot order,
+ * and computes their results from the aggregates and counts of their slots
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename key_type, typename value_type, typename map_type>
+host_groupby_result<key_type, value_type>
+extract_host_groups(map_type const & the_map,
+                    std::vector<key_type> const & keys,
+                    std::vector<bool> const & key_valid,
+                    std::vector<gdf_agg_op> const & ops,
+                    std::vector<std::vector<value_type>> const & slot_values,
+                    std::vector<std::vector<size_t>> const & slot_counts)
+{
+  using size_type = typename map_type::key_type;
+  constexpr size_type unused_key{map_type::get_unused_key()};
+
+  auto is_key_valid = [&key_valid](size_t row) { return key_valid.empty() || key_valid[row]; };
+
+  host_groupby_result<key_type, value_type> result;
+  result.aggregates.resize(ops.size());
+  result.aggregate_valid.resize(ops.size());
+  for (size_t slot = 0; slot < the_map.size(); ++slot) {
+    if (unused_key == the_map.begin()[slot].first.load()) continue;
+
+    const size_type first_row = the_map.begin()[slot].second.load();
+    result.keys.push_back(is_key_valid(first_row) ? keys[first_row] : key_type{});
+    result.key_valid.push_back(is_key_valid(first_row));
+    for (size_t a = 0; a < ops.size(); ++a) {
+      const value_type count = static_cast<value_type>(slot_counts[a][slot]);
+      const bool valid = (GDF_COUNT == ops[a]) || (slot_counts[a][slot] > 0);
+      value_type aggregate{};
+      if (valid) {
+        switch (ops[a]) {
+          case GDF_COUNT: aggregate = count; break;
+          case GDF_AVG: aggregate = slot_values[a][slot] / count; break;
+          default: aggregate = slot_values[a][slot]; break;
+        }
+      }
+      result.aggregates[a].push_back(aggregate);
+      result.aggregate_valid[a].push_back(valid);
+    }
+  }
+  return result;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host implementation of the multi-aggregation hash groupby, the
+ * reference of gdf_group_by.
+ *
+ * Like the device implementation, the map holds the index of the first row of
+ * every group, keyed by row index, and the aggregates are stored column-wise at
+ * the slot of the group. The rows are inserted from several threads, then the
+ * aggregations are computed one per thread. AVG is SUM / COUNT in value_type,
+ * COUNT is converted to value_type. The groups are in slot order.
+ *
+ * NULL values are skipped, and the result of a group without any non-null
+ * value is NULL, except for COUNT, which is then 0. Rows with a NULL key are
+ * dropped, or form a single group if include_null_keys is true.
+ *
+ * @Param keys The key of every row
+ * @Param values The columns to aggregate, each of the size of keys
+ * @Param ops The operation of every column to aggregate, one of GDF_SUM,
+ * GDF_MIN, GDF_MAX, GDF_AVG and GDF_COUNT
+ * @Param num_threads The number of host threads, 0 for the default
+ * @Param key_valid Whether the key of every row is valid, empty if all are
+ * @Param value_valid Whether every value of every column to aggregate is
+ * valid, empty if all are, or with an empty vector for a column without NULLs
+ * @Param include_null_keys If true, the rows with a NULL key form a group,
+ * otherwise they are dropped
+ *
+ * @Returns The keys and aggregates of the groups
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename key_type, typename value_type, typename size_type = int>
+host_groupby_result<key_type, value_type>
+host_group_by(std::vector<key_type> const & keys,
+              std::vector<std::vector<value_type>> const & values,
+              std::vector<gdf_agg_op> const & ops,
+              unsigned int num_threads = 0,
+              std::vector<bool> const & key_valid = {},
+              std::vector<std::vector<bool>> const & value_valid = {},
+              bool include_null_keys = false)
+{
+  using map_type = host_concurrent_unordered_map<size_type,
+                                                 size_type,
+                                                 std::numeric_limits<size_type>::max()>;
+  constexpr size_type unused_key{map_type::get_unused_key()};
+
+  const size_t num_rows = keys.size();
+  const size_t num_aggregations = ops.size();
+
+  hash_table_growth_policy growth_policy;
+  map_type the_map(growth_policy.initial_size(num_rows), min_op<size_type>::IDENTITY);
+
+  auto is_key_valid = [&key_valid](size_t row) { return key_valid.empty() || key_valid[row]; };
+  auto is_value_valid = [&value_valid](size_t a, size_t row) {
+    return (a >= value_valid.size()) || value_valid[a].empty() || value_valid[a][row];
+  };
+
+  // Compares the keys of the rows two map keys refer to. NULL keys are equal
+  // to each other and hash as key_type{}.
+  auto rows_equal = [&](size_type left_row, size_type right_row) {
+    if ((unused_key == left_row) || (unused_key == right_row)) return left_row == right_row;
+    if (!is_key_valid(left_row) || !is_key_valid(right_row)) {
+      return is_key_valid(left_row) == is_key_valid(right_row);
+    }
+    return keys[left_row] == keys[right_row];
+  };
+
+  // Insert every row, and record the slot of its group
+  constexpr size_t dropped_row{std::numeric_limits<size_t>::max()};
+  std::vector<size_t> row_slots(num_rows, dropped_row);
+  cudf::detail::host_parallel_for(num_rows, [&](size_t i) {
+    if (!include_null_keys && !is_key_valid(i)) return;
+    const size_type row = static_cast<size_type>(i);
+    auto location = the_map.insert(std::make_pair(row, row),
+                                   min_op<size_type>(),
+                                   rows_equal,
+                                   true,
+                                   default_hash<key_type>()(is_key_valid(i) ? keys[i] : key_type{}));
+    row_slots[i] = location - the_map.begin();
+  }, num_threads);
+
+  // Aggregate every column into the slots of the groups, one column per thread
+  const size_t num_slots = the_map.size();
+  std::vector<std::vector<value_type>> slot_values(num_aggregations);
+  std::vector<std::vector<size_t>> slot_counts(num_aggregations);
+  cudf::detail::host_parallel_for(num_aggregations, [&](size_t a) {
+    slot_values[a].assign(num_slots, host_aggregate_identity<value_type>(ops[a]));
+    slot_counts[a].assign(num_slots, 0);
+
+    for (size_t i = 0; i < num_rows; ++i) {
+      if ((dropped_row == row_slots[i]) || !is_value_valid(a, i)) continue;
+      host_aggregate(ops[a], values[a][i], slot_values[a][row_slots[i]]);
+      ++slot_counts[a][row_slots[i]];
+    }
+  }, num_threads);
+
+  return extract_host_groups<key_type, value_type>(the_map, keys, key_valid, ops, slot_values, slot_counts);
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host analogue of the shared memory groupby of GroupbyHash, to
+ * test its privatization: the result is that of host_group_by.
+ *
+ * Every thread aggregates a contiguous range of rows in a table of its own
+ * with local_capacity slots, like a thread block in its shared memory. A local
+ * table holds at most local_capacity / 2 groups, the rows of the other groups
+ * of the range spill to the shared map. The local groups are then inserted in
+ * the shared map as partial aggregates, and combined with those of the other
+ * threads and with the spilled rows: the values with the operation, and the
+ * counts by summing them.
+ *
+ * @Param keys The key of every row
+ * @Param values The columns to aggregate, each of the size of keys
+ * @Param ops The operation of every column to aggregate, one of GDF_SUM,
+ * GDF_MIN, GDF_MAX, GDF_AVG and GDF_COUNT
+ * @Param num_threads The number of host threads, 0 for the default
+ * @Param local_capacity The number of slots of the table of a thread
+ * @Param key_valid Whether the key of every row is valid, empty if all are
+ * @Param value_valid Whether every value of every column to aggregate is
+ * valid, empty if all are, or with an empty vector for a column without NULLs
+ * @Param include_null_keys If true, the rows with a NULL key form a group,
+ * otherwise they are dropped
+ *
+ * @Returns The keys and aggregates of the groups
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename key_type, typename value_type, typename size_type = int>
+host_groupby_result<key_type, value_type>
+host_group_by_privatized(std::vector<key_type> const & keys,
+                         std::vector<std::vector<value_type>> const & values,
+                         std::vector<gdf_agg_op> const & ops,
+                         unsigned int num_threads = 0,
+                         size_t local_capacity = 1024,
+                         std::vector<bool> const & key_valid = {},
+                         std::vector<std::vector<bool>> const & value_valid = {},
+                         bool include_null_keys = false)
+{
+  using map_type = host_concurrent_unordered_map<size_type,
+                                                 size_type,
+                                                 std::numeric_limits<size_type>::max()>;
+  constexpr size_type unused_key{map_type::get_unused_key()};
+
+  const size_t num_rows = keys.size();
+  const size_t num_aggregations = ops.size();
+  const size_t max_local_groups = local_capacity / 2;
+
+  auto is_key_valid = [&key_valid](size_t row) { return key_valid.empty() || key_valid[row]; };
+  auto is_value_valid = [&value_valid](size_t a, size_t row) {
+    return (a >= value_valid.size()) || value_valid[a].empty() || value_valid[a][row];
+  };
+  auto row_hash = [&](size_t row) {
+    return default_hash<key_type>()(is_key_valid(row) ? keys[row] : key_type{});
+  };
+
+  // Compares the keys of two rows. NULL keys are equal to each other.
+  auto keys_equal = [&](size_type left_row, size_type right_row) {
+    if (!is_key_valid(left_row) || !is_key_valid(right_row)) {
+      return is_key_valid(left_row) == is_key_valid(right_row);
+    }
+    return keys[left_row] == keys[right_row];
+  };
+  auto rows_equal = [&](size_type left_row, size_type right_row) {
+    if ((unused_key == left_row) || (unused_key == right_row)) return left_row == right_row;
+    return keys_equal(left_row, right_row);
+  };
+
+  // The groups of the local table of a thread, and the rows it could not hold
+  struct local_result
+  {
+    std::vector<size_type> group_rows;
+    std::vector<std::vector<value_type>> group_values;
+    std::vector<std::vector<size_t>> group_counts;
+    std::vector<size_type> spilled_rows;
+  };
+
+  if (0 == num_threads) num_threads = cudf::detail::default_host_threads();
+  const size_t num_ranges = std::max<size_t>(1, std::min<size_t>(num_threads, num_rows));
+  const size_t range_size = (num_rows + num_ranges - 1) / num_ranges;
+  std::vector<local_result> local_results(num_ranges);
+
+  cudf::detail::host_parallel_for(num_ranges, [&](size_t r) {
+    local_result & local = local_results[r];
+    std::vector<size_type> local_rows(local_capacity, unused_key);
+    std::vector<std::vector<value_type>> local_values(num_aggregations);
+    std::vector<std::vector<size_t>> local_counts(num_aggregations, std::vector<size_t>(local_capacity, 0));
+    for (size_t a = 0; a < num_aggregations; ++a) {
+      local_values[a].assign(local_capacity, host_aggregate_identity<value_type>(ops[a]));
+    }
+    size_t num_local_groups{0};
+
+    const size_t end = std::min(num_rows, (r + 1) * range_size);
+    for (size_t i = r * range_size; i < end; ++i) {
+      if (!include_null_keys && !is_key_valid(i)) continue;
+      const size_type row = static_cast<size_type>(i);
+
+      // Linear probing, stopping at an empty slot if the table is full
+      size_t slot = row_hash(i) % local_capacity;
+      bool found{false};
+      for (size_t attempt = 0; attempt < local_capacity; ++attempt) {
+        if (unused_key == local_rows[slot]) {
+          if (num_local_groups == max_local_groups) break;
+          local_rows[slot] = row;
+          ++num_local_groups;
+          found = true;
+          break;
+        }
+        if (keys_equal(local_rows[slot], row)) {
+          found = true;
+          break;
+        }
+        slot = (slot + 1) % local_capacity;
+      }
+
+      if (!found) {
+        local.spilled_rows.push_back(row);
+        continue;
+      }
+      for (size_t a = 0; a < num_aggregations; ++a) {
+        if (!is_value_valid(a, i)) continue;
+        host_aggregate(ops[a], values[a][i], local_values[a][slot]);
+        ++local_counts[a][slot];
+      }
+    }
+
+    // Write the groups of the local table as partial aggregates
+    local.group_values.resize(num_aggregations);
+    local.group_counts.resize(num_aggregations);
+    for (size_t slot = 0; slot < local_capacity; ++slot) {
+      if (unused_key == local_rows[slot]) continue;
+      local.group_rows.push_back(local_rows[slot]);
+      for (size_t a = 0; a < num_aggregations; ++a) {
+        local.group_values[a].push_back(local_values[a][slot]);
+        local.group_counts[a].push_back(local_counts[a][slot]);
+      }
+    }
+  }, num_threads);
+
+  // Insert the partial aggregates and the spilled rows in the shared map. The
+  // value of a group is the smallest of the rows inserted for it.
+  std::vector<std::pair<size_t, size_t>> entries;
+  for (size_t r = 0; r < num_ranges; ++r) {
+    for (size_t g = 0; g < local_results[r].group_rows.size(); ++g) entries.emplace_back(r, g);
+  }
+  const size_t num_partials = entries.size();
+  for (size_t r = 0; r < num_ranges; ++r) {
+    for (size_t s = 0; s < local_results[r].spilled_rows.size(); ++s) entries.emplace_back(r, s);
+  }
+  auto entry_row = [&](size_t e) {
+    local_result const & local = local_results[entries[e].first];
+    return (e < num_partials) ? local.group_rows[entries[e].second] : local.spilled_rows[entries[e].second];
+  };
+
+  hash_table_growth_policy growth_policy;
+  map_type the_map(growth_policy.initial_size(entries.size()), min_op<size_type>::IDENTITY);
+  std::vector<size_t> entry_slots(entries.size());
+  cudf::detail::host_parallel_for(entries.size(), [&](size_t e) {
+    const size_type row = entry_row(e);
+    auto location = the_map.insert(std::make_pair(row, row),
+                                   min_op<size_type>(),
+                                   rows_equal,
+                                   true,
+                                   row_hash(row));
+    entry_slots[e] = location - the_map.begin();
+  }, num_threads);
+
+  // Combine the partial aggregates and the spilled rows, one column per thread
+  const size_t num_slots = the_map.size();
+  std::vector<std::vector<value_type>> slot_values(num_aggregations);
+  std::vector<std::vector<size_t>> slot_counts(num_aggregations);
+  cudf::detail::host_parallel_for(num_aggregations, [&](size_t a) {
+    slot_values[a].assign(num_slots, host_aggregate_identity<value_type>(ops[a]));
+    slot_counts[a].assign(num_slots, 0);
+
+    for (size_t e = 0; e < entries.size(); ++e) {
+      local_result const & local = local_results[entries[e].first];
+      const size_t index = entries[e].second;
+      const size_t slot = entry_slots[e];
+      if (e < num_partials) {
+        if (0 == local.group_counts[a][index]) continue;
+        host_aggregate(ops[a], local.group_values[a][index], slot_values[a][slot]);
+        slot_counts[a][slot] += local.group_counts[a][index];
+      }
+      else {
+        const size_type row = local.spilled_rows[index];
+        if (!is_value_valid(a, row)) continue;
+        host_aggregate(ops[a], values[a][row], slot_values[a][slot]);
+        ++slot_counts[a][slot];
+      }
+    }
+  }, num_threads);
+
+  return extract_host_groups<key_type, value_type>(the_map, keys, key_valid, ops, slot_values, slot_counts);
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Assigns every row to its group, the groups numbered in the order
+ * of their first row. NULL keys are equal to each other.
+ *
+ * @Param keys The key of every row
+ * @Param key_valid Whether the key of every row is valid, empty if all are
+ * @Param include_null_keys If true, the rows with a NULL key form a group,
+ * otherwise they are dropped
+ * @Param[out] result Receives the keys of the groups
+ *
+ * @Returns The group of every row, or the number of rows for a dropped row
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename key_type, typename value_type>
+std::vector<size_t> host_group_rows(std::vector<key_type> const & keys,
+                                    std::vector<bool> const & key_valid,
+                                    bool include_null_keys,
+                                    host_groupby_result<key_type, value_type> & result)
+{
+  std::map<std::pair<bool, key_type>, size_t> groups;
+  std::vector<size_t> row_groups(keys.size(), keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    const bool valid = key_valid.empty() || key_valid[i];
+    if (!include_null_keys && !valid) continue;
+
+    const auto key = std::make_pair(valid, valid ? keys[i] : key_type{});
+    auto group = groups.find(key);
+    if (groups.end() == group) {
+      group = groups.emplace(key, result.keys.size()).first;
+      result.keys.push_back(key.second);
+      result.key_valid.push_back(valid);
+    }
+    row_groups[i] = group->second;
+  }
+  return row_groups;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The aggregates of a group in the host partial groupby and merge:
+ * the number of values, the SUM (also of AVG), MIN, MAX, FIRST or LAST, and
+ * the moments of VAR and STD
+ */
+/* ----------------------------------------------------------------------------*/
+struct host_aggregate_state
+{
+  double count{0};
+  double value{0};
+  moments stats{0, 0, 0};
+
+  // Adds count values: a single value, or the partial aggregate of a group of
+  // count values, whose M2 is m2 and whose value is the mean for VAR and STD
+  void add(gdf_agg_op op, double count_to_add, double value_to_add, double m2 = 0)
+  {
+    switch (op) {
+      case GDF_SUM:
+      case GDF_AVG: value += value_to_add; break;
+      case GDF_MIN: value = (0 == count) ? value_to_add : std::min(value, value_to_add); break;
+      case GDF_MAX: value = (0 == count) ? value_to_add : std::max(value, value_to_add); break;
+      case GDF_FIRST: if (0 == count) value = value_to_add; break;
+      case GDF_LAST: value = value_to_add; break;
+      case GDF_VAR:
+      case GDF_STD: stats = welford_op{}(moments{count_to_add, value_to_add, m2}, stats); break;
+      default: break;
+    }
+    count += count_to_add;
+  }
+
+  // The result of the aggregation, and whether it is valid
+  std::pair<double, bool> result(gdf_agg_op op) const
+  {
+    switch (op) {
+      case GDF_COUNT: return {count, true};
+      case GDF_AVG: return {(count > 0) ? value / count : 0, count > 0};
+      case GDF_VAR: return {(count > 1) ? stats.variance() : 0, count > 1};
+      case GDF_STD: return {(count > 1) ? std::sqrt(stats.variance()) : 0, count > 1};
+      default: return {(count > 0) ? value : 0, count > 0};
+    }
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host implementation of gdf_group_by_partial, the reference of its
+ * partial aggregates and the input of host_group_by_merge.
+ *
+ * The partial aggregates of every operation are in the layout of
+ * partial_aggregation_ops, in double, with a NULL for the SUM, MIN, MAX, FIRST,
+ * LAST and mean of a group without any non-null value. The groups are in the
+ * order of their first row, the rows with a NULL key are dropped or form a
+ * single group if include_null_keys is true.
+ *
+ * @Param keys The key of every row
+ * @Param values The columns to aggregate, each of the size of keys
+ * @Param ops The operation of every column to aggregate, one with partial aggregates
+ * @Param key_valid Whether the key of every row is valid, empty if all are
+ * @Param value_valid Whether every value of every column to aggregate is
+ * valid, empty if all are, or with an empty vector for a column without NULLs
+ * @Param include_null_keys If true, the rows with a NULL key form a group,
+ * otherwise they are dropped
+ *
+ * @Returns The keys and partial aggregates of the groups
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename key_type, typename value_type>
+host_groupby_result<key_type, double>
+host_group_by_partial(std::vector<key_type> const & keys,
+                      std::vector<std::vector<value_type>> const & values,
+                      std::vector<gdf_agg_op> const & ops,
+                      std::vector<bool> const & key_valid = {},
+                      std::vector<std::vector<bool>> const & value_valid = {},
+                      bool include_null_keys = false)
+{
+  host_groupby_result<key_type, double> result;
+  const std::vector<size_t> row_groups = host_group_rows(keys, key_valid, include_null_keys, result);
+  const size_t num_groups = result.keys.size();
+
+  auto is_value_valid = [&value_valid](size_t a, size_t row) {
+    return (a >= value_valid.size()) || value_valid[a].empty() || value_valid[a][row];
+  };
+
+  for (size_t a = 0; a < ops.size(); ++a) {
+    std::vector<host_aggregate_state> states(num_groups);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      if ((num_groups > row_groups[i]) && is_value_valid(a, i)) {
+        states[row_groups[i]].add(ops[a], 1, static_cast<double>(values[a][i]));
+      }
+    }
+
+    // The partial aggregate columns, each a (value, valid) per group
+    std::vector<std::vector<std::pair<double, bool>>> partials(partial_aggregation_ops(ops[a]).size());
+    for (auto const & state : states) {
+      switch (ops[a]) {
+        case GDF_AVG:
+          partials[0].push_back(state.result(GDF_SUM));
+          partials[1].push_back(state.result(GDF_COUNT));
+          break;
+        case GDF_VAR:
+        case GDF_STD:
+          partials[0].push_back(state.result(GDF_COUNT));
+          partials[1].push_back({state.stats.mean, state.count > 0});
+          partials[2].push_back({state.stats.m2, true});
+          break;
+        default:
+          partials[0].push_back(state.result(ops[a]));
+          break;
+      }
+    }
+    for (auto const & partial : partials) {
+      result.aggregates.emplace_back();
+      result.aggregate_valid.emplace_back();
+      for (auto const & p : partial) {
+        result.aggregates.back().push_back(p.first);
+        result.aggregate_valid.back().push_back(p.second);
+      }
+    }
+  }
+  return result;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host implementation of gdf_group_by_merge: merges the partial
+ * aggregates of the parts of a table, concatenated in the order of their rows,
+ * into the results of the aggregations on the whole table.
+ *
+ * The results are those of host_group_by, and for VAR and STD, the sample
+ * variance and standard deviation, NULL for a group of fewer than 2 values.
+ * The groups are in the order of their first partial aggregate.
+ *
+ * @Param partials The keys and partial aggregates of the parts, concatenated,
+ * as computed by host_group_by_partial
+ * @Param ops The operation of every aggregation
+ * @Param include_null_keys If true, the partial aggregates of a NULL key form
+ * a group, otherwise they are dropped
+ *
+ * @Returns The keys and aggregates of the groups
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename key_type>
+host_groupby_result<key_type, double>
+host_group_by_merge(host_groupby_result<key_type, double> const & partials,
+                    std::vector<gdf_agg_op> const & ops,
+                    bool include_null_keys = false)
+{
+  host_groupby_result<key_type, double> result;
+  const std::vector<size_t> row_groups = host_group_rows(partials.keys, partials.key_valid,
+                                                         include_null_keys, result);
+  const size_t num_groups = result.keys.size();
+
+  size_t first = 0;
+  for (size_t a = 0; a < ops.size(); ++a) {
+    const gdf_agg_op op = ops[a];
+    auto const & values = partials.aggregates[first + partial_value_column(op)];
+    auto const & valid = partials.aggregate_valid[first + partial_value_column(op)];
+    const bool is_weighted = (GDF_AVG == op) || (GDF_VAR == op) || (GDF_STD == op);
+
+    std::vector<host_aggregate_state> states(num_groups);
+    for (size_t i = 0; i < partials.keys.size(); ++i) {
+      if ((num_groups <= row_groups[i]) || !valid[i]) continue;
+
+      host_aggregate_state & state = states[row_groups[i]];
+      if (GDF_COUNT == op) {
+        state.add(op, values[i], 0);
+      }
+      else if (is_weighted) {
+        const double count = partials.aggregates[first + partial_count_column(op)][i];
+        const double m2 = (GDF_AVG == op) ? 0 : partials.aggregates[first + 2][i];
+        state.add(op, count, values[i], m2);
+      }
+      else {
+        state.add(op, 1, values[i]);
+      }
+    }
+
+    result.aggregates.emplace_back();
+    result.aggregate_valid.emplace_back();
+    for (auto const & state : states) {
+      const std::pair<double, bool> aggregate = state.result(op);
+      result.aggregates.back().push_back(aggregate.first);
+      result.aggregate_valid.back().push_back(aggregate.second);
+    }
+    first += partial_aggregation_ops(op).size();
+  }
+  return result;
+}
+
+#endif // HOST_GROUPBY_H
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PARTIAL_AGGREGATION_H
+#define PARTIAL_AGGREGATION_H
+
+#include <vector>
+
+#include "cudf.h"
+
+// The partial aggregates of a group-by on a part of a table are the columns of
+// the intermediate state of every aggregation. The partial aggregates of the
+// parts of a table, concatenated, are merged into the result of the
+// aggregations on the whole table.
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The aggregations computing the partial aggregate columns of an
+ * aggregation operation, in the order of the columns:
+ *
+ * GDF_SUM, GDF_MIN, GDF_MAX, GDF_COUNT, GDF_FIRST, GDF_LAST: the aggregation itself
+ * GDF_AVG: the SUM and the COUNT
+ * GDF_VAR, GDF_STD: the COUNT, the mean (AVG) and M2, computed from the VAR
+ *
+ * @Returns The aggregations, empty if the operation has no partial aggregate
+ */
+/* ----------------------------------------------------------------------------*/
+inline std::vector<gdf_agg_op> partial_aggregation_ops(gdf_agg_op op)
+{
+  switch (op) {
+    case GDF_SUM:
+    case GDF_MIN:
+    case GDF_MAX:
+    case GDF_COUNT:
+    case GDF_FIRST:
+    case GDF_LAST: return {op};
+    case GDF_AVG:  return {GDF_SUM, GDF_COUNT};
+    case GDF_VAR:
+    case GDF_STD:  return {GDF_COUNT, GDF_AVG, GDF_VAR};
+    default:       return {};
+  }
+}
+
+// The index of the COUNT among the partial aggregate columns of AVG, VAR and STD
+inline int partial_count_column(gdf_agg_op op)
+{
+  return (GDF_AVG == op) ? 1 : 0;
+}
+
+// The index of the column the partial aggregates of an operation are merged
+// from: the SUM of AVG and the mean of VAR and STD, which are weighted by the
+// COUNT column. The M2 of VAR and STD follows the mean.
+inline int partial_value_column(gdf_agg_op op)
+{
+  return ((GDF_VAR == op) || (GDF_STD == op)) ? 1 : 0;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The aggregation merging the partial aggregates of an operation:
+ * the COUNTs are summed, and AVG, VAR and STD merge their weighted partial
+ * aggregates. FIRST and LAST take the first and last partial aggregate, so the
+ * parts must be concatenated in the order of their rows.
+ */
+/* ----------------------------------------------------------------------------*/
+inline gdf_agg_op merge_aggregation_op(gdf_agg_op op)
+{
+  return (GDF_COUNT == op) ? GDF_SUM : op;
+}
+
+#endif // PARTIAL_AGGREGATION_H
@@ -17,6 +17,7 @@
 #ifndef CONCURRENT_UNORDERED_MAP_CUH
 #define CONCURRENT_UNORDERED_MAP_CUH
 
+#include <algorithm>
 #include <iterator>
 #include <type_traits>
 #include <cassert>
@@ -29,6 +30,7 @@
 #include "managed_allocator.cuh"
 #include "managed.cuh"
 #include "hash_functions.cuh"
+#include "hash_probing.cuh"
 
 // TODO: replace this with CUDA_TRY and propagate the error
 #ifndef CUDA_RT_CALL
@@ -312,6 +314,10 @@ __host__ __device__ bool operator!=(const cycle_iterator_adapter<T>& lhs, const
 /**
  * Does support concurrent insert, but not concurrent insert and probping.
  *
+ * The Probing parameter selects the table layout: linear_probing (the default)
+ * or bucketed_probing<N>, which groups the slots in buckets of N slots read
+ * together and sustains much higher occupancies. See hash_probing.cuh.
+ *
  * TODO:
  *  - add constructor that takes pointer to hash_table to avoid allocations
  *  - extend interface to accept streams
@@ -322,12 +328,14 @@ template <typename Key,
           typename Hasher = default_hash<Key>,
           typename Equality = equal_to<Key>,
           typename Allocator = managed_allocator<thrust::pair<Key, Element> >,
-          bool count_collisions = false>
+          bool count_collisions = false,
+          typename Probing = linear_probing>
 class concurrent_unordered_map : public managed
 {
 
 public:
     using size_type = size_t;
+    using probing = Probing;
     using hasher = Hasher;
     using key_equal = Equality;
     using allocator_type = Allocator;
@@ -351,7 +359,8 @@ public:
                                       const Hasher& hf = hasher(),
                                       const Equality& eql = key_equal(),
                                       const allocator_type& a = allocator_type())
-        : m_hf(hf), m_equal(eql), m_allocator(a), m_hashtbl_size(n), m_hashtbl_capacity(n), m_collisions(0), m_unused_element(unused_element)
+        : m_hf(hf), m_equal(eql), m_allocator(a), m_hashtbl_size(probing::capacity(n)), m_hashtbl_capacity(probing::capacity(n)), m_collisions(0), m_unused_element(unused_element),
+          m_occupancy(0), m_max_occupancy(n)
     {
         m_hashtbl_values = m_allocator.allocate( m_hashtbl_capacity );
         constexpr int block_size = 128;
@@ -407,6 +416,32 @@ public:
         return unused_key;
     }
 
+    /* --------------------------------------------------------------------------*/
+    /** 
+     * @Synopsis  Limits the number of distinct keys the map accepts. Once the map
+     * holds max_occupancy keys, inserting a new key returns end() so that the
+     * caller can grow the map (see hash_table_growth_policy). Inserting a key
+     * that is already present always succeeds.
+     * 
+     * @Param max_occupancy The maximum number of keys, at most size()
+     */
+    /* ----------------------------------------------------------------------------*/
+    void set_max_occupancy(size_type max_occupancy)
+    {
+        m_max_occupancy = std::min(max_occupancy, m_hashtbl_size);
+    }
+
+    /* --------------------------------------------------------------------------*/
+    /** 
+     * @Synopsis  Returns the number of keys in the map. Only valid on the host
+     * once the kernels inserting into the map have completed.
+     */
+    /* ----------------------------------------------------------------------------*/
+    size_type get_occupancy() const
+    {
+        return m_occupancy;
+    }
+
     // Generic update of a hash table value for any aggregator
     template <typename aggregation_type>
     __forceinline__  __device__
@@ -505,42 +540,122 @@ public:
           hash_value = m_hf(x.first);
         }
 
-        size_type current_index         = hash_value % hashtbl_size;
-        value_type *current_hash_bucket = &(hashtbl_values[current_index]);
+        constexpr int bucket_size{probing::bucket_size};
+        size_type bucket_start = probing::first_slot(hash_value, hashtbl_size);
 
         const key_type insert_key = x.first;
         
-        bool insert_success = false;
-        
-        while (false == insert_success) {
+        for (size_type attempt = 0; attempt < hashtbl_size; attempt += bucket_size) {
+
+          // Read every slot of the bucket at once. The keys read may be stale,
+          // but a slot only ever changes from unused_key to a key, which the
+          // atomicCAS below detects.
+          value_type bucket[bucket_size];
+#pragma unroll
+          for (int slot = 0; slot < bucket_size; ++slot) {
+            bucket[slot] = load_pair_vectorized(hashtbl_values + bucket_start + slot);
+          }
+
+          for (int slot = 0; slot < bucket_size; ++slot) {
 
-          key_type& existing_key = current_hash_bucket->first;
-          mapped_type& existing_value = current_hash_bucket->second;
+            value_type *current_hash_bucket = &(hashtbl_values[bucket_start + slot]);
+            key_type& existing_key = current_hash_bucket->first;
+            mapped_type& existing_value = current_hash_bucket->second;
+
+            const key_type current_key = bucket[slot].first;
+
+            if ( !keys_equal( unused_key, current_key ) ) {
+              // This key has already been inserted, aggregate into its value
+              if ( keys_equal( insert_key, current_key ) ) {
+                update_existing_value(existing_value, x, op);
+                return iterator( m_hashtbl_values,m_hashtbl_values+hashtbl_size, current_hash_bucket);
+              }
+              if ( count_collisions ) {
+                atomicAdd( &m_collisions, 1ull );
+              }
+              continue;
+            }
 
-          // Try and set the existing_key for the current hash bucket to insert_key
-          const key_type old_key = atomicCAS( &existing_key, unused_key, insert_key);
+            // insert_key was not found before this empty slot, so claiming it
+            // adds a new key. If the map is at its maximum occupancy, fail and
+            // let the caller grow the map and retry
+            if ( *static_cast<volatile unsigned long long*>(&m_occupancy) >= m_max_occupancy ) {
+              return end();
+            }
 
-          // If old_key == unused_key, the current hash bucket was empty
-          // and existing_key was updated to insert_key by the atomicCAS. 
-          // If old_key == insert_key, this key has already been inserted. 
-          // In either case, perform the atomic aggregation of existing_value and insert_value
-          // Because the hash table is initialized with the identity value of the aggregation
-          // operation, it is safe to perform the operation when the existing_value still 
-          // has its initial value
-          // TODO: Use template specialization to make use of native atomic functions
-          // TODO: How to handle data types less than 32 bits?
-          if ( keys_equal( unused_key, old_key ) || keys_equal(insert_key, old_key) ) {
+            // Try and set the existing_key for the current slot to insert_key
+            const key_type old_key = atomicCAS( &existing_key, unused_key, insert_key);
+
+            // If old_key == unused_key, the current slot was empty
+            // and existing_key was updated to insert_key by the atomicCAS. 
+            // If old_key == insert_key, this key has been inserted concurrently. 
+            // In either case, perform the atomic aggregation of existing_value and insert_value
+            // Because the hash table is initialized with the identity value of the aggregation
+            // operation, it is safe to perform the operation when the existing_value still 
+            // has its initial value
+            // TODO: Use template specialization to make use of native atomic functions
+            // TODO: How to handle data types less than 32 bits?
+            if ( keys_equal( unused_key, old_key ) ) {
+              atomicAdd( &m_occupancy, 1ull );
+              update_existing_value(existing_value, x, op);
+              return iterator( m_hashtbl_values,m_hashtbl_values+hashtbl_size, current_hash_bucket);
+            }
 
-            update_existing_value(existing_value, x, op);
+            if ( keys_equal(insert_key, old_key) ) {
+              update_existing_value(existing_value, x, op);
+              return iterator( m_hashtbl_values,m_hashtbl_values+hashtbl_size, current_hash_bucket);
+            }
 
-            insert_success = true;
+            // Another key claimed the slot first
+            if ( count_collisions ) {
+              atomicAdd( &m_collisions, 1ull );
+            }
           }
 
-          current_index = (current_index+1)%hashtbl_size;
-          current_hash_bucket = &(hashtbl_values[current_index]);
+          bucket_start = probing::next_bucket(bucket_start, hashtbl_size);
         }
         
-        return iterator( m_hashtbl_values,m_hashtbl_values+hashtbl_size, current_hash_bucket);
+        return end();
+    }
+
+    /* --------------------------------------------------------------------------*/
+    /** 
+     * @Synopsis  Inserts a (key, value) pair whose key is known not to be in the
+     * map, without aggregation. Used to rehash the entries of a map into a
+     * larger one; ignores the maximum occupancy.
+     * 
+     * @Param[in] x The (key, value) pair to insert
+     * @Param[in] precomputed_hash Indicates if a precomputed hash value is being passed in
+     * @Param[in] precomputed_hash_value The precomputed hash value
+     * 
+     * @Returns An iterator to the inserted pair, or end() if the map is full
+     */
+    /* ----------------------------------------------------------------------------*/
+    template<typename hash_value_type = typename Hasher::result_type>
+    __forceinline__
+    __device__ iterator insert_unique(const value_type& x,
+                                      bool precomputed_hash = false,
+                                      hash_value_type precomputed_hash_value = 0)
+    {
+        const size_type hashtbl_size = m_hashtbl_size;
+        const hash_value_type hash_value = precomputed_hash ? precomputed_hash_value : m_hf(x.first);
+
+        // The slots are claimed in probe order, so that the occupied slots of
+        // a bucket stay a prefix of the bucket
+        size_type current_index = probing::first_slot(hash_value, hashtbl_size);
+
+        for (size_type attempt = 0; attempt < hashtbl_size; ++attempt) {
+          value_type *current_hash_bucket = &(m_hashtbl_values[current_index]);
+          const key_type old_key = atomicCAS( &(current_hash_bucket->first), unused_key, x.first );
+          if ( m_equal( unused_key, old_key ) ) {
+            current_hash_bucket->second = x.second;
+            atomicAdd( &m_occupancy, 1ull );
+            return iterator( m_hashtbl_values,m_hashtbl_values+hashtbl_size, current_hash_bucket);
+          }
+          current_index = (current_index+1)%hashtbl_size;
+        }
+
+        return end();
     }
     
     /* This function is not currently implemented
@@ -604,33 +719,33 @@ public:
     __forceinline__
     __host__ __device__ const_iterator find(const key_type& k ) const
     {
-        size_type key_hash = m_hf( k );
-        size_type hash_tbl_idx = key_hash%m_hashtbl_size;
+        constexpr int bucket_size{probing::bucket_size};
+        size_type bucket_start = probing::first_slot(m_hf( k ), m_hashtbl_size);
         
-        value_type* begin_ptr = 0;
-        
-        size_type counter = 0;
-        while ( 0 == begin_ptr ) {
-            value_type* tmp_ptr = m_hashtbl_values + hash_tbl_idx;
-            const key_type tmp_val = tmp_ptr->first;
-            if ( m_equal( k, tmp_val ) ) {
-                begin_ptr = tmp_ptr;
-                break;
-            }
-            if ( m_equal( unused_key , tmp_val ) || counter > m_hashtbl_size ) {
-                begin_ptr = m_hashtbl_values + m_hashtbl_size;
-                break;
+        for (size_type counter = 0; counter < m_hashtbl_size; counter += bucket_size) {
+            for (int slot = 0; slot < bucket_size; ++slot) {
+                value_type* tmp_ptr = m_hashtbl_values + bucket_start + slot;
+                const key_type tmp_val = tmp_ptr->first;
+                if ( m_equal( k, tmp_val ) ) {
+                    return const_iterator( m_hashtbl_values,m_hashtbl_values+m_hashtbl_size,tmp_ptr);
+                }
+                // The occupied slots of a bucket are a prefix of the bucket, so an
+                // empty slot ends the probe sequence
+                if ( m_equal( unused_key , tmp_val ) ) {
+                    return end();
+                }
             }
-            hash_tbl_idx = (hash_tbl_idx+1)%m_hashtbl_size;
-            ++counter;
+            bucket_start = probing::next_bucket(bucket_start, m_hashtbl_size);
         }
         
-        return const_iterator( m_hashtbl_values,m_hashtbl_values+m_hashtbl_size,begin_ptr);
+        return end();
     }
     
     gdf_error assign_async( const concurrent_unordered_map& other, cudaStream_t stream = 0 )
     {
         m_collisions = other.m_collisions;
+        m_occupancy = other.m_occupancy;
+        m_max_occupancy = other.m_max_occupancy;
         if ( other.m_hashtbl_size <= m_hashtbl_capacity ) {
             m_hashtbl_size = other.m_hashtbl_size;
         } else {
@@ -648,10 +763,19 @@ public:
     {
         constexpr int block_size = 128;
         init_hashtbl<<<((m_hashtbl_size-1)/block_size)+1,block_size,0,stream>>>( m_hashtbl_values, m_hashtbl_size, unused_key, m_unused_element );
+        m_occupancy = 0;
         if ( count_collisions )
             m_collisions = 0;
     }
     
+    /* --------------------------------------------------------------------------*/
+    /** 
+     * @Synopsis  Returns the number of occupied slots holding a different key
+     * that inserts have probed past. Only counted when the count_collisions
+     * template parameter is true. Only valid on the host once the kernels
+     * inserting into the map have completed.
+     */
+    /* ----------------------------------------------------------------------------*/
     unsigned long long get_num_collisions() const
     {
         return m_collisions;
@@ -691,6 +815,42 @@ private:
     value_type* m_hashtbl_values;
     
     unsigned long long m_collisions;
+
+    unsigned long long m_occupancy;
+    unsigned long long m_max_occupancy;
 };
 
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Reinserts every entry of a hash table into a larger map, the
+ * parallel rehash performed when a map grows.
+ * 
+ * @Param old_values The buckets of the map being grown
+ * @Param old_size The number of buckets in old_values
+ * @Param new_map The map to insert into
+ * @Param key_hasher Functor computing the hash value of a key. Maps whose keys
+ * are row indices hash the row rather than the key.
+ */
+/* ----------------------------------------------------------------------------*/
+template<typename map_type,
+         typename size_type,
+         typename key_hasher_type>
+__global__ void rehash_hashtbl(const typename map_type::value_type * const __restrict__ old_values,
+                               const size_type old_size,
+                               map_type * const __restrict__ new_map,
+                               key_hasher_type key_hasher)
+{
+    constexpr typename map_type::key_type unused_key{map_type::get_unused_key()};
+
+    size_type i = threadIdx.x + blockIdx.x * blockDim.x;
+
+    while( i < old_size ){
+        const typename map_type::value_type current_pair = old_values[i];
+        if( current_pair.first != unused_key ){
+            new_map->insert_unique(current_pair, true, key_hasher(current_pair.first));
+        }
+        i += blockDim.x * gridDim.x;
+    }
+}
+
 #endif //CONCURRENT_UNORDERED_MAP_CUH
@@ -65,6 +65,11 @@ __inline__ __device__ int64_t atomicCAS(int64_t* address, int64_t compare, int64
   return (int64_t)atomicCAS((unsigned long long*)address, (unsigned long long)compare, (unsigned long long)val);
 }
 
+__inline__ __device__ uint64_t atomicCAS(uint64_t* address, uint64_t compare, uint64_t val)
+{
+  return (uint64_t)atomicCAS((unsigned long long*)address, (unsigned long long)compare, (unsigned long long)val);
+}
+
 __inline__ __device__ int64_t atomicAdd(int64_t* address, int64_t val)
 {
   return (int64_t)atomicAdd((unsigned long long*)address, (unsigned long long)val);
@@ -367,6 +372,11 @@ public:
         return const_iterator( m_hashtbl_values,m_hashtbl_values+m_hashtbl_size,m_hashtbl_values+m_hashtbl_size );
     }
     
+    __host__ __device__ value_type* data() const
+    {
+      return m_hashtbl_values;
+    }
+
     __forceinline__
     static constexpr __host__ __device__ key_type get_unused_key()
     {
@@ -21,6 +21,9 @@
 
 using hash_value_type = uint32_t;
 
+/// Wide hash values, for hash tables of billions of rows
+using hash_value64_type = uint64_t;
+
 //MurmurHash3_32 implementation from https://github.com/aappleby/smhasher/blob/master/src/MurmurHash3.cpp 
 //-----------------------------------------------------------------------------
 // MurmurHash3 was written by Austin Appleby, and is placed in the public
@@ -29,6 +32,10 @@ using hash_value_type = uint32_t;
 // algorithms are optimized for their respective platforms. You can still
 // compile and run any of them on any platform, but your performance with the
 // non-native version will be less than optimal.
+//
+// The seed selects one of a family of independent hash functions. Rows that
+// share a hash value (and thus a partition) under one seed are spread again by
+// another seed, which is what recursive hash partitioning relies on.
 template <typename Key>
 struct MurmurHash3_32
 {
@@ -38,7 +45,7 @@ struct MurmurHash3_32
     
     __forceinline__ 
     __host__ __device__ 
-    MurmurHash3_32() : m_seed( 0 ) {}
+    MurmurHash3_32(uint32_t seed = 0) : m_seed( seed ) {}
     
     __forceinline__ 
     __host__ __device__ uint32_t rotl32( uint32_t x, int8_t r ) const
@@ -122,10 +129,144 @@ private:
     const uint32_t m_seed;
 };
 
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  64-bit hash function: the first 64 bits of MurmurHash3_x64_128,
+ * from the same smhasher source as MurmurHash3_32.
+ *
+ * With 32-bit hash values, a table of n distinct rows has about n^2 / 2^33
+ * pairs of rows with equal hash values, each of which costs a full row
+ * comparison on probe. With 64-bit hash values such pairs are negligible
+ * up to billions of rows.
+ *
+ * The blocks of the key are assembled byte by byte, so keys of any size and
+ * alignment can be hashed on the device, and the result does not depend on
+ * the endianness of the host. The seed has the same role as for MurmurHash3_32.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename Key>
+struct MurmurHash3_64
+{
+
+    using argument_type = Key;
+    using result_type = hash_value64_type;
+    
+    __forceinline__ 
+    __host__ __device__ 
+    MurmurHash3_64(uint32_t seed = 0) : m_seed( seed ) {}
+    
+    __forceinline__ 
+    __host__ __device__ uint64_t rotl64( uint64_t x, int8_t r ) const
+    {
+      return (x << r) | (x >> (64 - r));
+    }
+    
+    __forceinline__ 
+    __host__ __device__ uint64_t fmix64( uint64_t k ) const
+    {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdULL;
+        k ^= k >> 33;
+        k *= 0xc4ceb9fe1a85ec53ULL;
+        k ^= k >> 33;
+        return k;
+    }
+
+    __forceinline__ 
+    __host__ __device__ uint64_t getblock64( const uint8_t * const data, int i ) const
+    {
+        uint64_t block{0};
+        for(int b = 7; b >= 0; --b)
+        {
+            block = (block << 8) | data[i*8 + b];
+        }
+        return block;
+    }
+    
+    /* --------------------------------------------------------------------------*/
+    /** 
+     * @Synopsis  Combines two hash values into a new single hash value. Called 
+     * repeatedly to create a hash value from several variables.
+     * 64-bit variant of the Boost hash_combine function, see MurmurHash3_32
+     * 
+     * @Param lhs The first hash value to combine
+     * @Param rhs The second hash value to combine
+     * 
+     * @Returns A hash value that intelligently combines the lhs and rhs hash values
+     */
+    /* ----------------------------------------------------------------------------*/
+    __host__ __device__ result_type hash_combine(result_type lhs, result_type rhs) const
+    {
+      result_type combined{lhs};
+
+      combined ^= rhs + 0x9e3779b97f4a7c15ULL + (combined << 6) + (combined >> 2);
+
+      return combined;
+    }
+  
+    __forceinline__ 
+    __host__ __device__ result_type operator()(const Key& key) const
+    {
+        constexpr int len = sizeof(argument_type);
+        const uint8_t * const data = (const uint8_t*)&key;
+        constexpr int nblocks = len / 16;
+        uint64_t h1 = m_seed;
+        uint64_t h2 = m_seed;
+        constexpr uint64_t c1 = 0x87c37b91114253d5ULL;
+        constexpr uint64_t c2 = 0x4cf5ad432745937fULL;
+        //----------
+        // body
+        for(int i = 0; i < nblocks; i++)
+        {
+            uint64_t k1 = getblock64(data, i*2 + 0);
+            uint64_t k2 = getblock64(data, i*2 + 1);
+            k1 *= c1; k1 = rotl64(k1,31); k1 *= c2; h1 ^= k1;
+            h1 = rotl64(h1,27); h1 += h2; h1 = h1*5+0x52dce729;
+            k2 *= c2; k2 = rotl64(k2,33); k2 *= c1; h2 ^= k2;
+            h2 = rotl64(h2,31); h2 += h1; h2 = h2*5+0x38495ab5;
+        }
+        //----------
+        // tail
+        const uint8_t * tail = (const uint8_t*)(data + nblocks*16);
+        uint64_t k1 = 0;
+        uint64_t k2 = 0;
+        switch(len & 15)
+        {
+            case 15: k2 ^= uint64_t(tail[14]) << 48;
+            case 14: k2 ^= uint64_t(tail[13]) << 40;
+            case 13: k2 ^= uint64_t(tail[12]) << 32;
+            case 12: k2 ^= uint64_t(tail[11]) << 24;
+            case 11: k2 ^= uint64_t(tail[10]) << 16;
+            case 10: k2 ^= uint64_t(tail[ 9]) << 8;
+            case  9: k2 ^= uint64_t(tail[ 8]) << 0;
+                     k2 *= c2; k2 = rotl64(k2,33); k2 *= c1; h2 ^= k2;
+            case  8: k1 ^= uint64_t(tail[ 7]) << 56;
+            case  7: k1 ^= uint64_t(tail[ 6]) << 48;
+            case  6: k1 ^= uint64_t(tail[ 5]) << 40;
+            case  5: k1 ^= uint64_t(tail[ 4]) << 32;
+            case  4: k1 ^= uint64_t(tail[ 3]) << 24;
+            case  3: k1 ^= uint64_t(tail[ 2]) << 16;
+            case  2: k1 ^= uint64_t(tail[ 1]) << 8;
+            case  1: k1 ^= uint64_t(tail[ 0]) << 0;
+                     k1 *= c1; k1 = rotl64(k1,31); k1 *= c2; h1 ^= k1;
+        };
+        //----------
+        // finalization
+        h1 ^= len; h2 ^= len;
+        h1 += h2; h2 += h1;
+        h1 = fmix64(h1); h2 = fmix64(h2);
+        h1 += h2;
+        return h1;
+    }
+private:
+    const uint64_t m_seed;
+};
+
 /* --------------------------------------------------------------------------*/
 /** 
  * @Synopsis  This hash function simply returns the value that is asked to be hash
- reinterpreted as the result_type of the functor.
+ reinterpreted as the result_type of the functor. It accepts a seed for
+ uniformity with the other hash functions, but ignores it.
  */
 /* ----------------------------------------------------------------------------*/
 template <typename Key>
@@ -133,6 +274,8 @@ struct IdentityHash
 {
     using result_type = hash_value_type;
 
+    __host__ __device__ IdentityHash(uint32_t /* seed */ = 0) {}
+
     /* --------------------------------------------------------------------------*/
     /** 
      * @Synopsis  Combines two hash values into a new single hash value. Called 
@@ -170,6 +313,8 @@ struct IdentityHash<cudf::detail::wrapper<T,type_id>>
 {
     using result_type = hash_value_type;
 
+    __host__ __device__ IdentityHash(uint32_t /* seed */ = 0) {}
+
     __host__ __device__ result_type hash_combine(result_type lhs, result_type rhs) const
     {
       result_type combined{lhs};
@@ -189,4 +334,9 @@ struct IdentityHash<cudf::detail::wrapper<T,type_id>>
 template <typename Key>
 using default_hash = MurmurHash3_32<Key>;
 
+/// The type of the hash values of a family of hash functions, e.g.,
+/// hash_result_t<MurmurHash3_64> is hash_value64_type
+template <template <typename> class hash_function>
+using hash_result_t = typename hash_function<int32_t>::result_type;
+
 #endif //HASH_FUNCTIONS_CUH
@@ -0,0 +1,588 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef HASH_PARTITION_CUH
+#define HASH_PARTITION_CUH
+
+#include <thrust/scan.h>
+
+#include "cudf.h"
+#include "rmm/rmm.h"
+#include "rmm/thrust_rmm_allocator.h"
+#include "utilities/error_utils.h"
+#include "dataframe/cudf_table.cuh"
+#include "hash/hash_functions.cuh"
+#include "utilities/int_fastdiv.h"
+
+constexpr int PARTITION_BLOCK_SIZE = 256;
+constexpr int PARTITION_ROWS_PER_THREAD = 1;
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  This function determines if a number is a power of 2.
+ * 
+ * @Param number The number to check.
+ * 
+ * @Returns True if the number is a power of 2.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T>
+bool is_power_two( T number )
+{
+  return (0 == (number & (number - 1)));
+}
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Functor to map a hash value to a particular 'bin' or partition number
+ * that uses the FAST modulo operation implemented in int_fastdiv from here:
+ * https://github.com/milakov/int_fastdiv
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename hash_value_t,
+          typename size_type,
+          typename output_type>
+struct fast_modulo_partitioner
+{
+
+  fast_modulo_partitioner(int num_partitions) : fast_divisor{num_partitions}{}
+
+  __host__ __device__
+  output_type operator()(hash_value_t hash_value) const
+  {
+    // Using int_fastdiv casts 'hash_value' to an int, which can 
+    // result in negative modulos, requiring taking the absolute value
+    // Because of the casting it can also return results that are not
+    // the same as using the normal % operator
+    output_type partition_number = std::abs(hash_value % fast_divisor);
+
+    return partition_number;
+  }
+
+  const int_fastdiv fast_divisor;
+};
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Functor to map a hash value to a particular 'bin' or partition number
+ * that uses the modulo operation.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename hash_value_t,
+          typename size_type,
+          typename output_type>
+struct modulo_partitioner
+{
+  modulo_partitioner(size_type num_partitions) : divisor{num_partitions}{}
+
+  __host__ __device__
+  output_type operator()(hash_value_t hash_value) const 
+  {
+    return hash_value % divisor;
+  }
+
+  const size_type divisor;
+};
+
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Functor to map a hash value to a particular 'bin' or partition number
+ * that uses bitshifts. Only works when num_partitions is a power of 2.
+ *
+ * For n % d, if d is a power of two, then it can be computed more efficiently via 
+ * a single bitwise AND as:
+ * n & (d - 1)
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename hash_value_t,
+          typename size_type,
+          typename output_type>
+struct bitwise_partitioner
+{
+  bitwise_partitioner(size_type num_partitions) : divisor{(num_partitions - 1)}
+  {
+    assert( is_power_two(num_partitions) );
+  }
+
+  __host__ __device__
+  output_type operator()(hash_value_t hash_value) const 
+  {
+    return hash_value & (divisor);
+  }
+
+  const size_type divisor;
+};
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Functor to map a row of a gdf_table to a partition number by hashing
+ * the row with a seeded hash function and applying a partitioner to the hash value.
+ */
+/* ----------------------------------------------------------------------------*/
+template <template <typename> class hash_function,
+          typename partitioner_type,
+          typename size_type>
+struct hash_row_partitioner
+{
+  hash_row_partitioner(gdf_table<size_type> const & table_to_hash,
+                       partitioner_type partitioner,
+                       uint32_t _seed)
+    : the_table{table_to_hash}, the_partitioner{partitioner}, seed{_seed}
+  {}
+
+  __device__
+  size_type operator()(size_type row_index) const
+  {
+    // See here why template disambiguator is required: 
+    // https://stackoverflow.com/questions/4077110/template-disambiguator
+    return the_partitioner(the_table.template hash_row<hash_function>(row_index, 0, seed));
+  }
+
+  gdf_table<size_type> const & the_table;
+  const partitioner_type the_partitioner;
+  const uint32_t seed;
+};
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Functor to map a row to a partition of a two-level partitioning.
+ * Partition p of the first level is split into the sub-partitions
+ * [p * num_sub_partitions, (p + 1) * num_sub_partitions), so that partitioning
+ * with the combined partition numbers orders the rows by first-level partition,
+ * then by sub-partition.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename first_level_type,
+          typename second_level_type,
+          typename size_type>
+struct two_level_row_partitioner
+{
+  two_level_row_partitioner(first_level_type first, second_level_type second,
+                            size_type _num_sub_partitions)
+    : first_level{first}, second_level{second}, num_sub_partitions{_num_sub_partitions}
+  {}
+
+  __device__
+  size_type operator()(size_type row_index) const
+  {
+    return first_level(row_index) * num_sub_partitions + second_level(row_index);
+  }
+
+  const first_level_type first_level;
+  const second_level_type second_level;
+  const size_type num_sub_partitions;
+};
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Creates the hash_row_partitioner of a table for a number of
+ * partitions and passes it to a callback. Uses the bitwise_partitioner when the
+ * number of partitions is a power of two, and the modulo_partitioner otherwise.
+ *
+ * @Returns The result of the callback
+ */
+/* ----------------------------------------------------------------------------*/
+template <template <typename> class hash_function,
+          typename size_type,
+          typename callback_type>
+gdf_error with_hash_row_partitioner(gdf_table<size_type> const & table_to_hash,
+                                    const size_type num_partitions,
+                                    uint32_t seed,
+                                    callback_type callback)
+{
+  using hash_t = hash_result_t<hash_function>;
+
+  // If the number of partitions is a power of two, we can compute the partition 
+  // number of each row more efficiently with bitwise operations
+  if( true == is_power_two(num_partitions) )
+  {
+    using partitioner_type = bitwise_partitioner<hash_t, size_type, size_type>;
+    return callback(hash_row_partitioner<hash_function, partitioner_type, size_type>(
+        table_to_hash, partitioner_type(num_partitions), seed));
+  }
+
+  using partitioner_type = modulo_partitioner<hash_t, size_type, size_type>;
+  return callback(hash_row_partitioner<hash_function, partitioner_type, size_type>(
+      table_to_hash, partitioner_type(num_partitions), seed));
+}
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @brief Computes which partition each row of a gdf_table will belong to, e.g.,
+   by hashing each row and applying a partition function to the hash value. 
+   Records the size of each partition for each thread block as well as the global
+   size of each partition across all thread blocks.
+ * 
+ * @Param[in] num_rows The number of rows in the table
+ * @Param[in] num_partitions The number of partitions to divide the rows into
+ * @Param[in] row_partitioner The functor that maps a row index to a partition number,
+ * see hash_row_partitioner
+ * @Param[out] row_partition_numbers Array that holds which partition each row belongs to
+ * @Param[out] block_partition_sizes Array that holds the size of each partition for each block,
+ * i.e., { {block0 partition0 size, block1 partition0 size, ...}, 
+         {block0 partition1 size, block1 partition1 size, ...},
+         ...
+         {block0 partition(num_partitions-1) size, block1 partition(num_partitions -1) size, ...} }
+ * @Param[out] global_partition_sizes The number of rows in each partition.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename row_partitioner_type,
+          typename size_type>
+__global__ 
+void compute_row_partition_numbers(const size_type num_rows,
+                                   const size_type num_partitions,
+                                   const row_partitioner_type row_partitioner,
+                                   size_type * row_partition_numbers,
+                                   size_type * block_partition_sizes,
+                                   size_type * global_partition_sizes)
+{
+  // Accumulate histogram of the size of each partition in shared memory
+  extern __shared__ size_type shared_partition_sizes[];
+
+  size_type row_number = threadIdx.x + blockIdx.x * blockDim.x;
+
+  // Initialize local histogram
+  size_type partition_number = threadIdx.x;
+  while(partition_number < num_partitions)
+  {
+    shared_partition_sizes[partition_number] = 0;
+    partition_number += blockDim.x;
+  }
+
+  __syncthreads();
+
+  // Compute the partition to which each row belongs, store it to the array of
+  // partition numbers and increment the shared memory counter for that partition
+  while( row_number < num_rows)
+  {
+    const size_type partition_number = row_partitioner(row_number);
+
+    row_partition_numbers[row_number] = partition_number;
+
+    atomicAdd(&(shared_partition_sizes[partition_number]), size_type(1));
+
+    row_number += blockDim.x * gridDim.x;
+  }
+
+  __syncthreads();
+
+  // Flush shared memory histogram to global memory
+  partition_number = threadIdx.x;
+  while(partition_number < num_partitions)
+  {
+    const size_type block_partition_size = shared_partition_sizes[partition_number];
+
+    // Update global size of each partition
+    atomicAdd(&global_partition_sizes[partition_number], block_partition_size);
+
+    // Record the size of this partition in this block
+    const size_type write_location = partition_number * gridDim.x + blockIdx.x;
+    block_partition_sizes[write_location] = block_partition_size;
+    partition_number += blockDim.x;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Given an array of partition numbers, computes the final output location
+   for each element in the output such that all rows with the same partition are 
+   contiguous in memory.
+ * 
+ * @Param row_partition_numbers The array that records the partition number for each row
+ * @Param num_rows The number of rows
+ * @Param num_partitions THe number of partitions
+ * @Param[out] block_partition_offsets Array that holds the offset of each partition for each thread block,
+ * i.e., { {block0 partition0 offset, block1 partition0 offset, ...}, 
+         {block0 partition1 offset, block1 partition1 offset, ...},
+         ...
+         {block0 partition(num_partitions-1) offset, block1 partition(num_partitions -1) offset, ...} }
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename size_type>
+__global__ 
+void compute_row_output_locations(size_type * row_partition_numbers, 
+                                  const size_type num_rows,
+                                  const size_type num_partitions,
+                                  size_type * block_partition_offsets)
+{
+  // Shared array that holds the offset of this blocks partitions in 
+  // global memory
+  extern __shared__ size_type shared_partition_offsets[];
+
+  // Initialize array of this blocks offsets from global array
+  size_type partition_number= threadIdx.x;
+  while(partition_number < num_partitions)
+  {
+    shared_partition_offsets[partition_number] = block_partition_offsets[partition_number * gridDim.x + blockIdx.x];
+    partition_number += blockDim.x;
+  }
+  __syncthreads();
+
+  size_type row_number = threadIdx.x + blockIdx.x * blockDim.x;
+
+  // Get each row's partition number, and get it's output location by 
+  // incrementing block's offset counter for that partition number
+  // and store the row's output location in-place
+  while( row_number < num_rows )
+  {
+    // Get partition number of this row
+    const size_type partition_number = row_partition_numbers[row_number];
+
+    // Get output location based on partition number by incrementing the corresponding
+    // partition offset for this block
+    const size_type row_output_location = atomicAdd(&(shared_partition_offsets[partition_number]), size_type(1));
+
+    // Store the row's output location in-place
+    row_partition_numbers[row_number] = row_output_location;
+
+    row_number += blockDim.x * gridDim.x;
+  }
+}
+
+
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @brief Partitions an input gdf_table into a specified number of partitions.
+ * Each row is assigned a partition number in [0, number of partitions) by a
+ * row partitioner. A copy of the input table is created where the rows are
+ * rearranged such that rows with the same partition number are contiguous.
+ * 
+ * @Param[in] input_table The table to partition
+ * @Param[in] num_partitions The number of partitions that table will be rearranged into
+ * @Param[in] row_partitioner Functor mapping a row index to its partition number
+ * @Param[out] partition_offsets Preallocated host array the size of the number of 
+ * partitions. Where partition_offsets[i] indicates the starting position 
+ * of partition 'i'
+ * @Param[out] partitioned_output Preallocated gdf_columns to hold the rearrangement
+ * of the input columns into the desired number of partitions
+ * @tparam row_partitioner_type The type of the row partitioner, e.g., hash_row_partitioner
+ */
+/* ----------------------------------------------------------------------------*/
+template < typename row_partitioner_type,
+           typename size_type>
+gdf_error partition_gdf_table(gdf_table<size_type> const & input_table,
+                              const size_type num_partitions,
+                              row_partitioner_type row_partitioner,
+                              size_type * partition_offsets,
+                              gdf_table<size_type> & partitioned_output)
+{
+
+  const size_type num_rows = input_table.get_column_length();
+
+  constexpr int rows_per_block = PARTITION_BLOCK_SIZE * PARTITION_ROWS_PER_THREAD;
+  const size_type grid_size = (num_rows + rows_per_block - 1) / rows_per_block;
+
+  // Allocate array to hold which partition each row belongs to
+  size_type * row_partition_numbers{nullptr};
+  RMM_TRY( RMM_ALLOC((void**)&row_partition_numbers, num_rows * sizeof(size_type), 0) ); // TODO: non-default stream?
+  
+  // Array to hold the size of each partition computed by each block
+  //  i.e., { {block0 partition0 size, block1 partition0 size, ...}, 
+  //          {block0 partition1 size, block1 partition1 size, ...},
+  //          ...
+  //          {block0 partition(num_partitions-1) size, block1 partition(num_partitions -1) size, ...} }
+  size_type * block_partition_sizes{nullptr};
+  RMM_TRY(RMM_ALLOC((void**)&block_partition_sizes, (grid_size * num_partitions) * sizeof(size_type), 0) );
+
+  // Holds the total number of rows in each partition
+  size_type * global_partition_sizes{nullptr};
+  RMM_TRY( RMM_ALLOC((void**)&global_partition_sizes, num_partitions * sizeof(size_type), 0) );
+  CUDA_TRY( cudaMemsetAsync(global_partition_sizes, 0, num_partitions * sizeof(size_type)) );
+
+  // Computes which partition each row belongs to. Also computes the number of
+  // rows in each partition both for each thread block as well as across all blocks
+  compute_row_partition_numbers
+  <<<grid_size, PARTITION_BLOCK_SIZE, num_partitions * sizeof(size_type)>>>(num_rows,
+                                                                  num_partitions,
+                                                                  row_partitioner,
+                                                                  row_partition_numbers,
+                                                                  block_partition_sizes,
+                                                                  global_partition_sizes);
+
+  CUDA_CHECK_LAST();
+
+  cudaStream_t stream{0}; // TODO: non-default stream?
+  rmm_temp_allocator allocator(stream);
+  
+  // Compute exclusive scan of all blocks' partition sizes in-place to determine 
+  // the starting point for each blocks portion of each partition in the output
+  size_type * scanned_block_partition_sizes{block_partition_sizes};
+  thrust::exclusive_scan(thrust::cuda::par(allocator).on(stream),
+                         block_partition_sizes, 
+                         block_partition_sizes + (grid_size * num_partitions), 
+                         scanned_block_partition_sizes);
+  CUDA_CHECK_LAST();
+
+
+  // Compute exclusive scan of size of each partition to determine offset location
+  // of each partition in final output. This can be done independently on a separate stream
+  cudaStream_t s1{};
+  cudaStreamCreate(&s1);
+  size_type * scanned_global_partition_sizes{global_partition_sizes};
+  thrust::exclusive_scan(thrust::cuda::par(allocator).on(s1),
+                         global_partition_sizes, 
+                         global_partition_sizes + num_partitions,
+                         scanned_global_partition_sizes);
+  CUDA_CHECK_LAST();
+
+  // Copy the result of the exlusive scan to the output offsets array
+  // to indicate the starting point for each partition in the output
+  CUDA_TRY(cudaMemcpyAsync(partition_offsets, 
+                           scanned_global_partition_sizes, 
+                           num_partitions * sizeof(size_type),
+                           cudaMemcpyDeviceToHost,
+                           s1));
+
+  // Compute the output location for each row in-place based on it's 
+  // partition number such that each partition will be contiguous in memory
+  size_type * row_output_locations{row_partition_numbers};
+  compute_row_output_locations
+  <<<grid_size, PARTITION_BLOCK_SIZE, num_partitions * sizeof(size_type)>>>(row_output_locations,
+                                                                  num_rows,
+                                                                  num_partitions,
+                                                                  scanned_block_partition_sizes);
+
+  CUDA_CHECK_LAST();
+
+  // Creates the partitioned output table by scattering the rows of
+  // the input table to rows of the output table based on each rows
+  // output location
+  gdf_error gdf_error_code = input_table.scatter(partitioned_output,
+                                                 row_output_locations);
+
+  if(GDF_SUCCESS != gdf_error_code){
+    return gdf_error_code;
+  }
+
+  CUDA_CHECK_LAST();
+
+  RMM_TRY(RMM_FREE(row_partition_numbers, 0));
+  RMM_TRY(RMM_FREE(block_partition_sizes, 0));
+
+  cudaStreamSynchronize(s1);
+  cudaStreamDestroy(s1);
+  RMM_TRY(RMM_FREE(global_partition_sizes, 0));
+
+  return GDF_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @brief Partitions an input gdf_table into a specified number of partitions.
+ * A hash value is computed for each row in a sub-set of the columns of the 
+ * input table. Each hash value is placed in a bin from [0, number of partitions).
+ * A copy of the input table is created where the rows are rearranged such that
+ * rows with hash values in the same bin are contiguous.
+ * 
+ * @Param[in] input_table The table to partition
+ * @Param[in] table_to_hash Sub-table of the input table with only the columns 
+ * that will be hashed
+ * @Param[in] num_partitions The number of partitions that table will be rearranged into
+ * @Param[out] partition_offsets Preallocated array the size of the number of 
+ * partitions. Where partition_offsets[i] indicates the starting position 
+ * of partition 'i'
+ * @Param[out] partitioned_output Preallocated gdf_columns to hold the rearrangement
+ * of the input columns into the desired number of partitions
+ * @Param[in] seed The seed of the hash function
+ * @tparam hash_function The hash function that will be used to hash the rows
+ */
+/* ----------------------------------------------------------------------------*/
+template < template <typename> class hash_function,
+           typename size_type>
+gdf_error hash_partition_gdf_table(gdf_table<size_type> const & input_table,
+                                   gdf_table<size_type> const & table_to_hash,
+                                   const size_type num_partitions,
+                                   size_type * partition_offsets,
+                                   gdf_table<size_type> & partitioned_output,
+                                   uint32_t seed)
+{
+  return with_hash_row_partitioner<hash_function>(table_to_hash, num_partitions, seed,
+    [&](auto row_partitioner) {
+      return partition_gdf_table(input_table, num_partitions, row_partitioner,
+                                 partition_offsets, partitioned_output);
+    });
+}
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @brief Partitions an input gdf_table into num_partitions partitions, and each
+ * partition into num_sub_partitions sub-partitions, in a single pass.
+ *
+ * Each row is hashed twice, with the first and the second level seeds, and the
+ * rows are partitioned by their combined partition number (see
+ * two_level_row_partitioner). The offsets of the first level are read from the
+ * histogram of the sub-partitions, so the input is scattered only once.
+ * 
+ * @Param[in] input_table The table to partition
+ * @Param[in] table_to_hash Sub-table of the input table with only the columns 
+ * that will be hashed
+ * @Param[in] num_partitions The number of first level partitions
+ * @Param[in] num_sub_partitions The number of sub-partitions of each partition
+ * @Param[out] partition_offsets Preallocated array of num_partitions offsets
+ * @Param[out] sub_partition_offsets Preallocated array of
+ * num_partitions * num_sub_partitions offsets. Sub-partition s of partition p
+ * starts at sub_partition_offsets[p * num_sub_partitions + s]
+ * @Param[out] partitioned_output Preallocated gdf_columns to hold the rearrangement
+ * of the input columns
+ * @Param[in] seed The seed of the hash function of the first level
+ * @Param[in] sub_seed The seed of the hash function of the second level
+ * @tparam hash_function The hash function that will be used to hash the rows
+ */
+/* ----------------------------------------------------------------------------*/
+template < template <typename> class hash_function,
+           typename size_type>
+gdf_error two_level_hash_partition_gdf_table(gdf_table<size_type> const & input_table,
+                                             gdf_table<size_type> const & table_to_hash,
+                                             const size_type num_partitions,
+                                             const size_type num_sub_partitions,
+                                             size_type * partition_offsets,
+                                             size_type * sub_partition_offsets,
+                                             gdf_table<size_type> & partitioned_output,
+                                             uint32_t seed,
+                                             uint32_t sub_seed)
+{
+  gdf_error gdf_error_code = with_hash_row_partitioner<hash_function>(table_to_hash, num_partitions, seed,
+    [&](auto first_level) {
+      return with_hash_row_partitioner<hash_function>(table_to_hash, num_sub_partitions, sub_seed,
+        [&](auto second_level) {
+          using row_partitioner_type = two_level_row_partitioner<decltype(first_level),
+                                                                 decltype(second_level),
+                                                                 size_type>;
+          return partition_gdf_table(input_table,
+                                     num_partitions * num_sub_partitions,
+                                     row_partitioner_type(first_level, second_level, num_sub_partitions),
+                                     sub_partition_offsets,
+                                     partitioned_output);
+        });
+    });
+
+  if(GDF_SUCCESS != gdf_error_code){
+    return gdf_error_code;
+  }
+
+  // A partition starts at its first sub-partition
+  for(size_type p = 0; p < num_partitions; ++p)
+  {
+    partition_offsets[p] = sub_partition_offsets[p * num_sub_partitions];
+  }
+
+  return GDF_SUCCESS;
+}
+
+#endif // HASH_PARTITION_CUH
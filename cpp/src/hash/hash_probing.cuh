@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HASH_PROBING_CUH
+#define HASH_PROBING_CUH
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Table layout and probing scheme of concurrent_unordered_map.
+ *
+ * The slots of the table are grouped in buckets of bucket_size contiguous
+ * slots. A key hashes to a bucket, and the probe sequence visits the slots of
+ * that bucket and then the following buckets, wrapping around at the end of
+ * the table. The slots of a bucket are read together (one vectorized load per
+ * slot, issued back to back), so the cost of a probe is the number of buckets
+ * read rather than the number of slots.
+ *
+ * Since every probe sequence enters a bucket at its first slot, the occupied
+ * slots of a bucket are always a prefix of the bucket, and a bucket with an
+ * empty slot ends every probe sequence that reaches it. With buckets of 4 or 8
+ * slots, probe sequences stay short at 80-90% occupancy, where single slot
+ * linear probing degrades quickly.
+ *
+ * @tparam slots The number of slots in a bucket. bucketed_probing<1> is the
+ * classic linear probing.
+ */
+/* ----------------------------------------------------------------------------*/
+template <int slots>
+struct bucketed_probing
+{
+  static_assert(slots > 0, "A bucket must hold at least one slot");
+
+  static constexpr int bucket_size{slots};
+
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  The number of slots to allocate for a table of at least n slots,
+   * i.e., n rounded up to a whole number of buckets.
+   */
+  /* ----------------------------------------------------------------------------*/
+  template <typename size_type>
+  __host__ __device__ static constexpr size_type capacity(size_type n)
+  {
+    return ((n + slots - 1) / slots) * slots;
+  }
+
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  The first slot of the bucket a hash value maps to
+   *
+   * @Param hash_value The hash value of the key
+   * @Param table_size The number of slots in the table, a multiple of bucket_size
+   */
+  /* ----------------------------------------------------------------------------*/
+  template <typename size_type, typename hash_value_type>
+  __host__ __device__ static size_type first_slot(hash_value_type hash_value, size_type table_size)
+  {
+    return static_cast<size_type>(hash_value % (table_size / slots)) * slots;
+  }
+
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  The first slot of the bucket following the bucket starting at
+   * bucket_start
+   */
+  /* ----------------------------------------------------------------------------*/
+  template <typename size_type>
+  __host__ __device__ static size_type next_bucket(size_type bucket_start, size_type table_size)
+  {
+    bucket_start += slots;
+    return (bucket_start < table_size) ? bucket_start : 0;
+  }
+
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  The number of buckets read to find an entry stored in slot,
+   * whose key has the given hash value
+   */
+  /* ----------------------------------------------------------------------------*/
+  template <typename size_type, typename hash_value_type>
+  __host__ __device__ static size_type probe_length(size_type slot, hash_value_type hash_value, size_type table_size)
+  {
+    const size_type num_buckets = table_size / slots;
+    const size_type home_bucket = static_cast<size_type>(hash_value % num_buckets);
+    return ((slot / slots + num_buckets - home_bucket) % num_buckets) + 1;
+  }
+};
+
+template <int slots>
+constexpr int bucketed_probing<slots>::bucket_size;
+
+/// Single slot linear probing, the default layout of the hash tables
+using linear_probing = bucketed_probing<1>;
+
+#endif // HASH_PROBING_CUH
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HASH_TABLE_GROWTH_H
+#define HASH_TABLE_GROWTH_H
+
+#include <algorithm>
+#include <cstddef>
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Sizing policy for hash tables that start small and grow.
+ *
+ * A table of capacity c accepts new keys until it holds max_occupancy(c) of
+ * them. Past that point, inserts of new keys fail (insert returns end()) and
+ * the caller collects the failed rows in an overflow list. The host then
+ * allocates a table of next_size(c, n), rehashes the existing entries into it
+ * and resumes by inserting only the overflow rows. Inserts of keys that are
+ * already present never fail, so aggregation results are unaffected by the
+ * growth.
+ */
+/* ----------------------------------------------------------------------------*/
+struct hash_table_growth_policy
+{
+  /// Percentage of the capacity that may be filled before the table must grow
+  unsigned int max_occupancy_percent{50};
+
+  /// The capacity is multiplied by at least this factor when the table grows
+  unsigned int growth_factor{2};
+
+  /// Smallest capacity ever allocated
+  size_t min_size{1024};
+
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  The number of keys a table of the given capacity may hold
+   */
+  /* ----------------------------------------------------------------------------*/
+  size_t max_occupancy(size_t capacity) const
+  {
+    return std::max<size_t>(1, capacity * max_occupancy_percent / 100);
+  }
+
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  The capacity needed to hold num_keys keys without growing
+   */
+  /* ----------------------------------------------------------------------------*/
+  size_t size_for(size_t num_keys) const
+  {
+    size_t capacity = (num_keys * 100 + max_occupancy_percent - 1) / max_occupancy_percent;
+    return std::max(min_size, capacity);
+  }
+
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  The initial capacity of a table for num_rows input rows.
+   *
+   * @Param num_rows The number of rows that will be inserted, an upper bound on
+   * the number of distinct keys
+   * @Param cardinality_hint The expected number of distinct keys, or 0 if
+   * unknown. When unknown, the table is sized for num_rows and never grows.
+   */
+  /* ----------------------------------------------------------------------------*/
+  size_t initial_size(size_t num_rows, size_t cardinality_hint = 0) const
+  {
+    if (0 == cardinality_hint || cardinality_hint > num_rows) {
+      return size_for(num_rows);
+    }
+    return std::min(size_for(cardinality_hint), size_for(num_rows));
+  }
+
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  The capacity to grow to from current_size.
+   *
+   * Grows by growth_factor, but never beyond what is needed to hold every
+   * pending row as a distinct key, so that a small overflow does not double
+   * a large table.
+   *
+   * @Param current_size The current capacity
+   * @Param num_keys The number of keys already in the table
+   * @Param num_pending The number of rows that failed to insert. Rows may share
+   * keys, so this is an upper bound on the number of new keys.
+   */
+  /* ----------------------------------------------------------------------------*/
+  size_t next_size(size_t current_size, size_t num_keys, size_t num_pending) const
+  {
+    const size_t grown = std::max(current_size * growth_factor, size_for(num_keys));
+    const size_t needed = size_for(num_keys + num_pending);
+    return std::max(current_size + 1, std::min(grown, needed));
+  }
+};
+
+#endif // HASH_TABLE_GROWTH_H
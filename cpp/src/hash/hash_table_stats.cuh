@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HASH_TABLE_STATS_CUH
+#define HASH_TABLE_STATS_CUH
+
+#include <cuda_runtime.h>
+#include <type_traits>
+#include <thrust/device_vector.h>
+#include <thrust/sort.h>
+#include <thrust/unique.h>
+
+#include "cudf.h"
+#include "utilities/error_utils.h"
+#include "rmm/thrust_rmm_allocator.h"
+#include "hash_table_stats.h"
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Accumulates the probe lengths of the occupied slots of a hash table
+ * and optionally gathers the hash values of their keys.
+ *
+ * @Param hashtbl_values The slots of the table
+ * @Param table_size The number of slots
+ * @Param unused_key The key of empty slots
+ * @Param key_hasher Functor computing the hash value of a key, as used to insert it
+ * @Param[out] hash_values If not nullptr, receives the hash value of every entry
+ * @Param[in,out] counters The counters to accumulate into, zero initialized
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename Probing,
+          typename value_type,
+          typename size_type,
+          typename key_type,
+          typename key_hasher_type,
+          typename hash_value_type>
+__global__ void accumulate_hash_table_stats(const value_type * const __restrict__ hashtbl_values,
+                                            const size_type table_size,
+                                            const key_type unused_key,
+                                            key_hasher_type key_hasher,
+                                            hash_value_type * const hash_values,
+                                            hash_table_stats_counters * const counters)
+{
+  size_type i = threadIdx.x + blockIdx.x * blockDim.x;
+
+  while( i < table_size ){
+    const key_type key = hashtbl_values[i].first;
+    if( key != unused_key ){
+      const hash_value_type hash_value = key_hasher(key);
+      const unsigned long long length = Probing::probe_length(i, hash_value, table_size);
+
+      const unsigned long long entry_index = atomicAdd(&counters->num_entries, 1ull);
+      atomicAdd(&counters->total_probe_length, length);
+      atomicMax(&counters->max_probe_length, length);
+
+      if( nullptr != hash_values ){
+        hash_values[entry_index] = hash_value;
+      }
+    }
+    i += blockDim.x * gridDim.x;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Computes the statistics of a device hash table.
+ *
+ * @Param hashtbl_values The slots of the table, e.g., map.data()
+ * @Param table_size The number of slots
+ * @Param unused_key The key of empty slots
+ * @Param key_hasher Functor computing the hash value of a key, as used to insert it
+ * @Param count_collisions If true, the keys are distinct and
+ * num_hash_collisions is computed from their hash values. Otherwise
+ * num_hash_collisions is left to the caller and set to 0.
+ * @Param[out] stats The statistics of the table
+ * @Param stream The stream to compute on
+ * @tparam Probing The probing scheme of the table, see hash_probing.cuh
+ *
+ * @Returns GDF_SUCCESS, or the error of a failed allocation or kernel
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename Probing,
+          typename value_type,
+          typename size_type,
+          typename key_type,
+          typename key_hasher_type>
+gdf_error compute_hash_table_stats(const value_type * const hashtbl_values,
+                                   const size_type table_size,
+                                   const key_type unused_key,
+                                   key_hasher_type key_hasher,
+                                   bool count_collisions,
+                                   gdf_hash_table_stats * stats,
+                                   cudaStream_t stream = 0)
+{
+  using hash_value_type = typename std::decay<decltype(key_hasher(unused_key))>::type;
+
+  hash_table_stats_counters * d_counters{nullptr};
+  RMM_TRY( RMM_ALLOC((void**)&d_counters, sizeof(hash_table_stats_counters), stream) );
+  CUDA_TRY( cudaMemsetAsync(d_counters, 0, sizeof(hash_table_stats_counters), stream) );
+
+  // Every slot may be occupied
+  thrust::device_vector<hash_value_type, rmm_allocator<hash_value_type>> hash_values(
+      count_collisions ? table_size : 0);
+
+  constexpr int block_size{256};
+  const size_type grid_size{(table_size + block_size - 1) / block_size};
+  accumulate_hash_table_stats<Probing><<<grid_size, block_size, 0, stream>>>(
+      hashtbl_values, table_size, unused_key, key_hasher,
+      count_collisions ? hash_values.data().get() : nullptr,
+      d_counters);
+  CUDA_TRY( cudaGetLastError() );
+
+  hash_table_stats_counters counters;
+  CUDA_TRY( cudaMemcpyAsync(&counters, d_counters, sizeof(hash_table_stats_counters),
+                            cudaMemcpyDeviceToHost, stream) );
+  CUDA_TRY( cudaStreamSynchronize(stream) );
+  RMM_TRY( RMM_FREE(d_counters, stream) );
+
+  size_t num_hash_collisions{0};
+  if( count_collisions ){
+    rmm_temp_allocator allocator(stream);
+    auto exec = thrust::cuda::par(allocator).on(stream);
+    auto begin = hash_values.begin();
+    auto end = begin + counters.num_entries;
+    thrust::sort(exec, begin, end);
+    const auto distinct_end = thrust::unique(exec, begin, end);
+    num_hash_collisions = counters.num_entries - (distinct_end - begin);
+  }
+
+  set_hash_table_stats(stats, table_size, counters, num_hash_collisions);
+
+  return GDF_SUCCESS;
+}
+
+#endif // HASH_TABLE_STATS_CUH
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HASH_TABLE_STATS_H
+#define HASH_TABLE_STATS_H
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include "cudf.h"
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Counters accumulated over the occupied slots of a hash table,
+ * from which gdf_hash_table_stats is derived
+ */
+/* ----------------------------------------------------------------------------*/
+struct hash_table_stats_counters
+{
+  unsigned long long num_entries{0};
+  unsigned long long total_probe_length{0};
+  unsigned long long max_probe_length{0};
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Fills a gdf_hash_table_stats from the counters of a table
+ *
+ * @Param[out] stats The statistics to fill
+ * @Param table_size The number of slots in the table
+ * @Param counters The counters accumulated over the occupied slots
+ * @Param num_hash_collisions The number of unequal keys with equal hash values
+ */
+/* ----------------------------------------------------------------------------*/
+inline void set_hash_table_stats(gdf_hash_table_stats * stats,
+                                 size_t table_size,
+                                 hash_table_stats_counters const & counters,
+                                 size_t num_hash_collisions)
+{
+  stats->table_size = table_size;
+  stats->num_entries = counters.num_entries;
+  stats->load_factor = (0 == table_size) ? 0.0
+                       : static_cast<double>(counters.num_entries) / table_size;
+  stats->mean_probe_length = (0 == counters.num_entries) ? 0.0
+                             : static_cast<double>(counters.total_probe_length) / counters.num_entries;
+  stats->max_probe_length = counters.max_probe_length;
+  stats->num_hash_collisions = num_hash_collisions;
+  stats->build_side_swapped = 0;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The number of hash collisions among a set of distinct keys, given
+ * their hash values: the number of keys minus the number of distinct hash
+ * values. Sorts the hash values in place.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename hash_value_type>
+size_t count_hash_collisions(std::vector<hash_value_type> & hash_values)
+{
+  std::sort(hash_values.begin(), hash_values.end());
+  const auto distinct_end = std::unique(hash_values.begin(), hash_values.end());
+  return hash_values.size() - (distinct_end - hash_values.begin());
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Computes the statistics of a hash table on the host
+ *
+ * @Param table_size The number of slots in the table
+ * @Param key_at Functor returning the key in a slot
+ * @Param unused_key The key of empty slots
+ * @Param key_hasher Functor computing the hash value of a key, as used to insert it
+ * @Param[out] stats The statistics of the table
+ * @tparam Probing The probing scheme of the table, see hash_probing.cuh
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename Probing,
+          typename key_accessor_type,
+          typename key_type,
+          typename key_hasher_type>
+void compute_host_hash_table_stats(size_t table_size,
+                                   key_accessor_type key_at,
+                                   key_type unused_key,
+                                   key_hasher_type key_hasher,
+                                   gdf_hash_table_stats * stats)
+{
+  using hash_value_type = typename std::decay<decltype(key_hasher(unused_key))>::type;
+
+  hash_table_stats_counters counters;
+  std::vector<hash_value_type> hash_values;
+
+  for (size_t slot = 0; slot < table_size; ++slot) {
+    const key_type key = key_at(slot);
+    if (key == unused_key) continue;
+
+    const hash_value_type hash_value = key_hasher(key);
+    const unsigned long long length = Probing::probe_length(slot, hash_value, table_size);
+    ++counters.num_entries;
+    counters.total_probe_length += length;
+    counters.max_probe_length = std::max(counters.max_probe_length, length);
+    hash_values.push_back(hash_value);
+  }
+
+  set_hash_table_stats(stats, table_size, counters, count_hash_collisions(hash_values));
+}
+
+#endif // HASH_TABLE_STATS_H
@@ -22,26 +22,10 @@
 #include "join/joining.h"
 #include "dataframe/cudf_table.cuh"
 #include "hash/hash_functions.cuh"
-#include "utilities/int_fastdiv.h"
+#include "hash/hash_partition.cuh"
+#include "hash/hyperloglog_kernels.cuh"
 #include "utilities/nvtx/nvtx_utils.h"
 
-constexpr int BLOCK_SIZE = 256;
-constexpr int ROWS_PER_THREAD = 1;
-
-/* --------------------------------------------------------------------------*/
-/** 
- * @Synopsis  This function determines if a number is a power of 2.
- * 
- * @Param number The number to check.
- * 
- * @Returns True if the number is a power of 2.
- */
-/* ----------------------------------------------------------------------------*/
-template <typename T>
-bool is_power_two( T number )
-{
-  return (0 == (number & (number - 1)));
-}
 
 /* --------------------------------------------------------------------------*/
 /** 
@@ -53,17 +37,18 @@ template <template <typename> class hash_function,
          typename size_type>
 struct row_hasher
 {
-  row_hasher(gdf_table<size_type> const & table_to_hash)
-    : the_table{table_to_hash}
+  row_hasher(gdf_table<size_type> const & table_to_hash, uint32_t _seed = 0)
+    : the_table{table_to_hash}, seed{_seed}
   {}
 
   __device__
-  hash_value_type operator()(size_type row_index) const
+  hash_result_t<hash_function> operator()(size_type row_index) const
   {
-    return the_table.template hash_row<hash_function>(row_index);
+    return the_table.template hash_row<hash_function>(row_index, 0, seed);
   }
 
   gdf_table<size_type> const & the_table;
+  const uint32_t seed;
 };
 
 
@@ -75,12 +60,15 @@ struct row_hasher
  * @Param num_cols The number of columns in the input set
  * @Param input The list of columns whose rows will be hashed
  * @Param hash The hash function to use
- * @Param output The hash value of each row of the input
+ * @Param seed The seed of the hash function
+ * @Param output The hash value of each row of the input, GDF_INT64 for
+ * GDF_HASH_MURMUR3_64 and GDF_INT32 otherwise
  * 
  * @Returns   
  */
 /* ----------------------------------------------------------------------------*/
-gdf_error gdf_hash(int num_cols, gdf_column **input, gdf_hash_func hash, gdf_column *output)
+gdf_error gdf_hash(int num_cols, gdf_column **input, gdf_hash_func hash, uint32_t seed,
+                   gdf_column *output)
 {
   // Ensure inputs aren't null
   if((0 == num_cols)
@@ -90,9 +78,9 @@ gdf_error gdf_hash(int num_cols, gdf_column **input, gdf_hash_func hash, gdf_col
     return GDF_DATASET_EMPTY;
   }
 
-  // check that the output dtype is int32
-  // TODO: do we need to support int64 as well?
-  if (output->dtype != GDF_INT32) 
+  // check that the output dtype matches the width of the hash values
+  const gdf_dtype hash_dtype = (GDF_HASH_MURMUR3_64 == hash) ? GDF_INT64 : GDF_INT32;
+  if (output->dtype != hash_dtype) 
   {
     return GDF_UNSUPPORTED_DTYPE;
   }
@@ -120,6 +108,8 @@ gdf_error gdf_hash(int num_cols, gdf_column **input, gdf_hash_func hash, gdf_col
   // Wrap output buffer in Thrust device_ptr
   hash_value_type * p_output = static_cast<hash_value_type*>(output->data);
   thrust::device_ptr<hash_value_type> row_hash_values = thrust::device_pointer_cast(p_output);
+  hash_value64_type * p_output64 = static_cast<hash_value64_type*>(output->data);
+  thrust::device_ptr<hash_value64_type> row_hash_values64 = thrust::device_pointer_cast(p_output64);
 
   cudaStream_t stream{0};
   rmm_temp_allocator allocator(stream);
@@ -133,7 +123,15 @@ gdf_error gdf_hash(int num_cols, gdf_column **input, gdf_hash_func hash, gdf_col
         thrust::tabulate(exec,
                         row_hash_values, 
                          row_hash_values + num_rows, 
-                         row_hasher<MurmurHash3_32,size_type>(*input_table));
+                         row_hasher<MurmurHash3_32,size_type>(*input_table, seed));
+        break;
+      }
+    case GDF_HASH_MURMUR3_64:
+      {
+        thrust::tabulate(exec,
+                         row_hash_values64, 
+                         row_hash_values64 + num_rows, 
+                         row_hasher<MurmurHash3_64,size_type>(*input_table, seed));
         break;
       }
     case GDF_HASH_IDENTITY:
@@ -141,7 +139,7 @@ gdf_error gdf_hash(int num_cols, gdf_column **input, gdf_hash_func hash, gdf_col
         thrust::tabulate(exec,
                          row_hash_values, 
                          row_hash_values + num_rows, 
-                         row_hasher<IdentityHash,size_type>(*input_table));
+                         row_hasher<IdentityHash,size_type>(*input_table, seed));
         break;
       }
     default:
@@ -153,385 +151,119 @@ gdf_error gdf_hash(int num_cols, gdf_column **input, gdf_hash_func hash, gdf_col
   return GDF_SUCCESS;
 }
 
-
-/* --------------------------------------------------------------------------*/
-/** 
- * @Synopsis  Functor to map a hash value to a particular 'bin' or partition number
- * that uses the FAST modulo operation implemented in int_fastdiv from here:
- * https://github.com/milakov/int_fastdiv
- */
-/* ----------------------------------------------------------------------------*/
-template <typename hash_value_t,
-          typename size_type,
-          typename output_type>
-struct fast_modulo_partitioner
-{
-
-  fast_modulo_partitioner(int num_partitions) : fast_divisor{num_partitions}{}
-
-  __host__ __device__
-  output_type operator()(hash_value_t hash_value) const
-  {
-    // Using int_fastdiv casts 'hash_value' to an int, which can 
-    // result in negative modulos, requiring taking the absolute value
-    // Because of the casting it can also return results that are not
-    // the same as using the normal % operator
-    output_type partition_number = std::abs(hash_value % fast_divisor);
-
-    return partition_number;
-  }
-
-  const int_fastdiv fast_divisor;
-};
-
 /* --------------------------------------------------------------------------*/
 /** 
- * @Synopsis  Functor to map a hash value to a particular 'bin' or partition number
- * that uses the modulo operation.
- */
-/* ----------------------------------------------------------------------------*/
-template <typename hash_value_t,
-          typename size_type,
-          typename output_type>
-struct modulo_partitioner
-{
-  modulo_partitioner(size_type num_partitions) : divisor{num_partitions}{}
-
-  __host__ __device__
-  output_type operator()(hash_value_t hash_value) const 
-  {
-    return hash_value % divisor;
-  }
-
-  const size_type divisor;
-};
-
-
-/* --------------------------------------------------------------------------*/
-/** 
- * @Synopsis  Functor to map a hash value to a particular 'bin' or partition number
- * that uses bitshifts. Only works when num_partitions is a power of 2.
- *
- * For n % d, if d is a power of two, then it can be computed more efficiently via 
- * a single bitwise AND as:
- * n & (d - 1)
+ * @Synopsis  Estimates the number of distinct rows of a set of columns with a
+ * HyperLogLog sketch. Rows containing a NULL are not counted.
+ * 
+ * @Param num_cols The number of columns in the input set
+ * @Param input The columns whose distinct rows are counted
+ * @Param precision The precision of the sketch, 0 for the default
+ * @Param count Receives the estimated number of distinct rows
+ * 
+ * @Returns   
  */
 /* ----------------------------------------------------------------------------*/
-template <typename hash_value_t,
-          typename size_type,
-          typename output_type>
-struct bitwise_partitioner
+gdf_error gdf_approx_count_distinct(int num_cols, gdf_column **input, int precision,
+                                    size_t *count)
 {
-  bitwise_partitioner(size_type num_partitions) : divisor{(num_partitions - 1)}
+  if((0 == num_cols)
+     || (nullptr == input)
+     || (nullptr == count))
   {
-    assert( is_power_two(num_partitions) );
+    return GDF_DATASET_EMPTY;
   }
 
-  __host__ __device__
-  output_type operator()(hash_value_t hash_value) const 
+  if(0 == precision)
   {
-    return hash_value & (divisor);
+    precision = HLL_DEFAULT_PRECISION;
   }
+  GDF_REQUIRE((precision >= HLL_MIN_PRECISION) && (precision <= HLL_MAX_PRECISION), GDF_INVALID_API_CALL);
 
-  const size_type divisor;
-};
-
-/* --------------------------------------------------------------------------*/
-/** 
- * @brief Computes which partition each row of a gdf_table will belong to based
-   on hashing each row, and applying a partition function to the hash value. 
-   Records the size of each partition for each thread block as well as the global
-   size of each partition across all thread blocks.
- * 
- * @Param[in] the_table The table whose rows will be partitioned
- * @Param[in] num_rows The number of rows in the table
- * @Param[in] num_partitions The number of partitions to divide the rows into
- * @Param[in] the_partitioner The functor that maps a rows hash value to a partition number
- * @Param[out] row_partition_numbers Array that holds which partition each row belongs to
- * @Param[out] block_partition_sizes Array that holds the size of each partition for each block,
- * i.e., { {block0 partition0 size, block1 partition0 size, ...}, 
-         {block0 partition1 size, block1 partition1 size, ...},
-         ...
-         {block0 partition(num_partitions-1) size, block1 partition(num_partitions -1) size, ...} }
- * @Param[out] global_partition_sizes The number of rows in each partition.
- */
-/* ----------------------------------------------------------------------------*/
-template <template <typename> class hash_function,
-          typename partitioner_type,
-          typename size_type>
-__global__ 
-void compute_row_partition_numbers(gdf_table<size_type> const & the_table, 
-                                   const size_type num_rows,
-                                   const size_type num_partitions,
-                                   const partitioner_type the_partitioner,
-                                   size_type * row_partition_numbers,
-                                   size_type * block_partition_sizes,
-                                   size_type * global_partition_sizes)
-{
-  // Accumulate histogram of the size of each partition in shared memory
-  extern __shared__ size_type shared_partition_sizes[];
-
-  size_type row_number = threadIdx.x + blockIdx.x * blockDim.x;
-
-  // Initialize local histogram
-  size_type partition_number = threadIdx.x;
-  while(partition_number < num_partitions)
+  for(int i = 0; i < num_cols; ++i)
   {
-    shared_partition_sizes[partition_number] = 0;
-    partition_number += blockDim.x;
+    GDF_REQUIRE(nullptr != input[i], GDF_DATASET_EMPTY);
+    GDF_REQUIRE(input[0]->size == input[i]->size, GDF_COLUMN_SIZE_MISMATCH);
   }
 
-  __syncthreads();
-
-  // Compute the hash value for each row, store it to the array of hash values
-  // and compute the partition to which the hash value belongs and increment
-  // the shared memory counter for that partition
-  while( row_number < num_rows)
+  *count = 0;
+  if(0 == input[0]->size)
   {
-    // See here why template disambiguator is required: 
-    // https://stackoverflow.com/questions/4077110/template-disambiguator
-    const hash_value_type row_hash_value = the_table.template hash_row<hash_function>(row_number);
-
-    const size_type partition_number = the_partitioner(row_hash_value);
-
-    row_partition_numbers[row_number] = partition_number;
-
-    atomicAdd(&(shared_partition_sizes[partition_number]), size_type(1));
-
-    row_number += blockDim.x * gridDim.x;
+    return GDF_SUCCESS;
   }
 
-  __syncthreads();
+  using size_type = int64_t;
 
-  // Flush shared memory histogram to global memory
-  partition_number = threadIdx.x;
-  while(partition_number < num_partitions)
-  {
-    const size_type block_partition_size = shared_partition_sizes[partition_number];
+  PUSH_RANGE("LIBGDF_APPROX_COUNT_DISTINCT", GROUPBY_COLOR);
 
-    // Update global size of each partition
-    atomicAdd(&global_partition_sizes[partition_number], block_partition_size);
+  std::unique_ptr< gdf_table<size_type> > input_table{new gdf_table<size_type>(num_cols, input)};
 
-    // Record the size of this partition in this block
-    const size_type write_location = partition_number * gridDim.x + blockIdx.x;
-    block_partition_sizes[write_location] = block_partition_size;
-    partition_number += blockDim.x;
-  }
-}
+  hyperloglog_sketch sketch(precision);
+  gdf_error gdf_status = compute_hyperloglog_sketch(*input_table, sketch);
 
-/* --------------------------------------------------------------------------*/
-/** 
- * @Synopsis  Given an array of partition numbers, computes the final output location
-   for each element in the output such that all rows with the same partition are 
-   contiguous in memory.
- * 
- * @Param row_partition_numbers The array that records the partition number for each row
- * @Param num_rows The number of rows
- * @Param num_partitions THe number of partitions
- * @Param[out] block_partition_offsets Array that holds the offset of each partition for each thread block,
- * i.e., { {block0 partition0 offset, block1 partition0 offset, ...}, 
-         {block0 partition1 offset, block1 partition1 offset, ...},
-         ...
-         {block0 partition(num_partitions-1) offset, block1 partition(num_partitions -1) offset, ...} }
- */
-/* ----------------------------------------------------------------------------*/
-template <typename size_type>
-__global__ 
-void compute_row_output_locations(size_type * row_partition_numbers, 
-                                  const size_type num_rows,
-                                  const size_type num_partitions,
-                                  size_type * block_partition_offsets)
-{
-  // Shared array that holds the offset of this blocks partitions in 
-  // global memory
-  extern __shared__ size_type shared_partition_offsets[];
+  POP_RANGE();
 
-  // Initialize array of this blocks offsets from global array
-  size_type partition_number= threadIdx.x;
-  while(partition_number < num_partitions)
+  if(GDF_SUCCESS != gdf_status)
   {
-    shared_partition_offsets[partition_number] = block_partition_offsets[partition_number * gridDim.x + blockIdx.x];
-    partition_number += blockDim.x;
+    return gdf_status;
   }
-  __syncthreads();
 
-  size_type row_number = threadIdx.x + blockIdx.x * blockDim.x;
-
-  // Get each row's partition number, and get it's output location by 
-  // incrementing block's offset counter for that partition number
-  // and store the row's output location in-place
-  while( row_number < num_rows )
-  {
-    // Get partition number of this row
-    const size_type partition_number = row_partition_numbers[row_number];
+  *count = static_cast<size_t>(std::llround(sketch.estimate()));
 
-    // Get output location based on partition number by incrementing the corresponding
-    // partition offset for this block
-    const size_type row_output_location = atomicAdd(&(shared_partition_offsets[partition_number]), size_type(1));
-
-    // Store the row's output location in-place
-    row_partition_numbers[row_number] = row_output_location;
-
-    row_number += blockDim.x * gridDim.x;
-  }
+  return GDF_SUCCESS;
 }
 
 
-
 /* --------------------------------------------------------------------------*/
-/** 
- * @brief Partitions an input gdf_table into a specified number of partitions.
- * A hash value is computed for each row in a sub-set of the columns of the 
- * input table. Each hash value is placed in a bin from [0, number of partitions).
- * A copy of the input table is created where the rows are rearranged such that
- * rows with hash values in the same bin are contiguous.
- * 
- * @Param[in] input_table The table to partition
- * @Param[in] table_to_hash Sub-table of the input table with only the columns 
- * that will be hashed
- * @Param[in] num_partitions The number of partitions that table will be rearranged into
- * @Param[out] partition_offsets Preallocated array the size of the number of 
- * partitions. Where partition_offsets[i] indicates the starting position 
- * of partition 'i'
- * @Param[out] partitioned_output Preallocated gdf_columns to hold the rearrangement
- * of the input columns into the desired number of partitions
- * @tparam hash_function The hash function that will be used to hash the rows
+/**
+ * @brief Checks the arguments of the hash partition functions
+ *
+ * @Returns GDF_SUCCESS if the arguments are valid, otherwise the appropriate error code
  */
 /* ----------------------------------------------------------------------------*/
-template < template <typename> class hash_function,
-           typename size_type>
-gdf_error hash_partition_gdf_table(gdf_table<size_type> const & input_table,
-                                   gdf_table<size_type> const & table_to_hash,
-                                   const size_type num_partitions,
-                                   size_type * partition_offsets,
-                                   gdf_table<size_type> & partitioned_output)
+gdf_error validate_hash_partition_args(int num_input_cols,
+                                       gdf_column * input[],
+                                       int columns_to_hash[],
+                                       int num_cols_to_hash,
+                                       int num_partitions,
+                                       gdf_column * partitioned_output[],
+                                       int partition_offsets[])
 {
+  // Use int until gdf API is updated to use something other than int
+  // for ordinal variables
+  using size_type = int;
 
-  const size_type num_rows = table_to_hash.get_column_length();
-
-  constexpr int rows_per_block = BLOCK_SIZE * ROWS_PER_THREAD;
-  const size_type grid_size = (num_rows + rows_per_block - 1) / rows_per_block;
-
-  // Allocate array to hold which partition each row belongs to
-  size_type * row_partition_numbers{nullptr};
-  RMM_TRY( RMM_ALLOC((void**)&row_partition_numbers, num_rows * sizeof(hash_value_type), 0) ); // TODO: non-default stream?
-  
-  // Array to hold the size of each partition computed by each block
-  //  i.e., { {block0 partition0 size, block1 partition0 size, ...}, 
-  //          {block0 partition1 size, block1 partition1 size, ...},
-  //          ...
-  //          {block0 partition(num_partitions-1) size, block1 partition(num_partitions -1) size, ...} }
-  size_type * block_partition_sizes{nullptr};
-  RMM_TRY(RMM_ALLOC((void**)&block_partition_sizes, (grid_size * num_partitions) * sizeof(size_type), 0) );
-
-  // Holds the total number of rows in each partition
-  size_type * global_partition_sizes{nullptr};
-  RMM_TRY( RMM_ALLOC((void**)&global_partition_sizes, num_partitions * sizeof(size_type), 0) );
-  CUDA_TRY( cudaMemsetAsync(global_partition_sizes, 0, num_partitions * sizeof(size_type)) );
-
-  // If the number of partitions is a power of two, we can compute the partition 
-  // number of each row more efficiently with bitwise operations
-  if( true == is_power_two(num_partitions) )
-  {
-    // Determines how the mapping between hash value and partition number is computed
-    using partitioner_type = bitwise_partitioner<hash_value_type, size_type, size_type>;
-
-    // Computes which partition each row belongs to by hashing the row and performing
-    // a partitioning operator on the hash value. Also computes the number of
-    // rows in each partition both for each thread block as well as across all blocks
-    compute_row_partition_numbers<hash_function>
-    <<<grid_size, BLOCK_SIZE, num_partitions * sizeof(size_type)>>>(table_to_hash, 
-                                                                    num_rows,
-                                                                    num_partitions,
-                                                                    partitioner_type(num_partitions),
-                                                                    row_partition_numbers,
-                                                                    block_partition_sizes,
-                                                                    global_partition_sizes);
-
-  }
-  else
+  // Ensure all the inputs are non-zero and not null
+  if((0 == num_input_cols) 
+      || (0 == num_cols_to_hash)
+      || (0 == num_partitions)
+      || (nullptr == input) 
+      || (nullptr == partitioned_output)
+      || (nullptr == columns_to_hash)
+      || (nullptr == partition_offsets))
   {
-    // Determines how the mapping between hash value and partition number is computed
-    using partitioner_type = modulo_partitioner<hash_value_type, size_type, size_type>;
-
-    // Computes which partition each row belongs to by hashing the row and performing
-    // a partitioning operator on the hash value. Also computes the number of
-    // rows in each partition both for each thread block as well as across all blocks
-    compute_row_partition_numbers<hash_function>
-    <<<grid_size, BLOCK_SIZE, num_partitions * sizeof(size_type)>>>(table_to_hash, 
-                                                                    num_rows,
-                                                                    num_partitions,
-                                                                    partitioner_type(num_partitions),
-                                                                    row_partition_numbers,
-                                                                    block_partition_sizes,
-                                                                    global_partition_sizes);
+    return GDF_INVALID_API_CALL;
   }
 
+  const size_t num_rows{input[0]->size};
 
-  CUDA_CHECK_LAST();
-
-  cudaStream_t stream{0}; // TODO: non-default stream?
-  rmm_temp_allocator allocator(stream);
-  
-  // Compute exclusive scan of all blocks' partition sizes in-place to determine 
-  // the starting point for each blocks portion of each partition in the output
-  size_type * scanned_block_partition_sizes{block_partition_sizes};
-  thrust::exclusive_scan(thrust::cuda::par(allocator).on(stream),
-                         block_partition_sizes, 
-                         block_partition_sizes + (grid_size * num_partitions), 
-                         scanned_block_partition_sizes);
-  CUDA_CHECK_LAST();
-
-
-  // Compute exclusive scan of size of each partition to determine offset location
-  // of each partition in final output. This can be done independently on a separate stream
-  cudaStream_t s1{};
-  cudaStreamCreate(&s1);
-  size_type * scanned_global_partition_sizes{global_partition_sizes};
-  thrust::exclusive_scan(thrust::cuda::par(allocator).on(s1),
-                         global_partition_sizes, 
-                         global_partition_sizes + num_partitions,
-                         scanned_global_partition_sizes);
-  CUDA_CHECK_LAST();
-
-  // Copy the result of the exlusive scan to the output offsets array
-  // to indicate the starting point for each partition in the output
-  CUDA_TRY(cudaMemcpyAsync(partition_offsets, 
-                           scanned_global_partition_sizes, 
-                           num_partitions * sizeof(size_type),
-                           cudaMemcpyDeviceToHost,
-                           s1));
-
-  // Compute the output location for each row in-place based on it's 
-  // partition number such that each partition will be contiguous in memory
-  size_type * row_output_locations{row_partition_numbers};
-  compute_row_output_locations
-  <<<grid_size, BLOCK_SIZE, num_partitions * sizeof(size_type)>>>(row_output_locations,
-                                                                  num_rows,
-                                                                  num_partitions,
-                                                                  scanned_block_partition_sizes);
+  // TODO Check if the num_rows is > MAX_ROWS (MAX_INT)
 
-  CUDA_CHECK_LAST();
+  // check that the columns data are not null, have matching types,
+  // and the same number of rows
+  for (size_type i = 0; (num_rows > 0) && (i < num_input_cols); i++) {
+    if( (nullptr == input[i]->data) 
+        || (nullptr == partitioned_output[i]->data))
+      return GDF_DATASET_EMPTY;
 
-  // Creates the partitioned output table by scattering the rows of
-  // the input table to rows of the output table based on each rows
-  // output location
-  gdf_error gdf_error_code = input_table.scatter(partitioned_output,
-                                                 row_output_locations);
+    if(input[i]->dtype != partitioned_output[i]->dtype) 
+      return GDF_PARTITION_DTYPE_MISMATCH;
 
-  if(GDF_SUCCESS != gdf_error_code){
-    return gdf_error_code;
+    if((num_rows != input[i]->size) 
+        || (num_rows != partitioned_output[i]->size))
+      return GDF_COLUMN_SIZE_MISMATCH;
   }
 
-  CUDA_CHECK_LAST();
-
-  RMM_TRY(RMM_FREE(row_partition_numbers, 0));
-  RMM_TRY(RMM_FREE(block_partition_sizes, 0));
-
-  cudaStreamSynchronize(s1);
-  cudaStreamDestroy(s1);
-  RMM_TRY(RMM_FREE(global_partition_sizes, 0));
-
   return GDF_SUCCESS;
 }
 
@@ -552,6 +284,7 @@ gdf_error hash_partition_gdf_table(gdf_table<size_type> const & input_table,
  * partitions. Where partition_offsets[i] indicates the starting position 
  * of partition 'i'
  * @Param[in] hash The hash function to use
+ * @Param[in] seed The seed of the hash function
  *
  * @Returns  If the operation was successful, returns GDF_SUCCESS
  */
@@ -563,49 +296,28 @@ gdf_error gdf_hash_partition(int num_input_cols,
                              int num_partitions,
                              gdf_column * partitioned_output[],
                              int partition_offsets[],
-                             gdf_hash_func hash)
+                             gdf_hash_func hash,
+                             uint32_t seed)
 {
   // Use int until gdf API is updated to use something other than int
   // for ordinal variables
   using size_type = int;
 
-  // Ensure all the inputs are non-zero and not null
-  if((0 == num_input_cols) 
-      || (0 == num_cols_to_hash)
-      || (0 == num_partitions)
-      || (nullptr == input) 
-      || (nullptr == partitioned_output)
-      || (nullptr == columns_to_hash)
-      || (nullptr == partition_offsets))
+  gdf_error gdf_status = validate_hash_partition_args(num_input_cols, input,
+                                                      columns_to_hash, num_cols_to_hash,
+                                                      num_partitions, partitioned_output,
+                                                      partition_offsets);
+  if(GDF_SUCCESS != gdf_status)
   {
-    return GDF_INVALID_API_CALL;
+    return gdf_status;
   }
 
-  const size_t num_rows{input[0]->size};
-
   // If the input is empty, return immediately
-  if(0 == num_rows)
+  if(0 == input[0]->size)
   {
     return GDF_SUCCESS;
   }
 
-  // TODO Check if the num_rows is > MAX_ROWS (MAX_INT)
-
-  // check that the columns data are not null, have matching types,
-  // and the same number of rows
-  for (size_type i = 0; i < num_input_cols; i++) {
-    if( (nullptr == input[i]->data) 
-        || (nullptr == partitioned_output[i]->data))
-      return GDF_DATASET_EMPTY;
-
-    if(input[i]->dtype != partitioned_output[i]->dtype) 
-      return GDF_PARTITION_DTYPE_MISMATCH;
-
-    if((num_rows != input[i]->size) 
-        || (num_rows != partitioned_output[i]->size))
-      return GDF_COLUMN_SIZE_MISMATCH;
-  }
-
   PUSH_RANGE("LIBGDF_HASH_PARTITION", PARTITION_COLOR);
 
   // Wrap input and output columns in gdf_table
@@ -622,8 +334,6 @@ gdf_error gdf_hash_partition(int num_input_cols,
   std::unique_ptr< const gdf_table<size_type> > table_to_hash {new gdf_table<size_type>(num_cols_to_hash, 
                                                                                         gdf_columns_to_hash.data())};
 
-  gdf_error gdf_status{GDF_SUCCESS};
-
   switch(hash)
   {
     case GDF_HASH_MURMUR3:
@@ -632,7 +342,18 @@ gdf_error gdf_hash_partition(int num_input_cols,
                                                               *table_to_hash,
                                                               num_partitions,
                                                               partition_offsets,
-                                                              *output_table);
+                                                              *output_table,
+                                                              seed);
+        break;
+      }
+    case GDF_HASH_MURMUR3_64:
+      {
+        gdf_status = hash_partition_gdf_table<MurmurHash3_64>(*input_table, 
+                                                              *table_to_hash,
+                                                              num_partitions,
+                                                              partition_offsets,
+                                                              *output_table,
+                                                              seed);
         break;
       }
     case GDF_HASH_IDENTITY:
@@ -641,7 +362,8 @@ gdf_error gdf_hash_partition(int num_input_cols,
                                                             *table_to_hash,
                                                             num_partitions,
                                                             partition_offsets,
-                                                            *output_table);
+                                                            *output_table,
+                                                            seed);
         break;
       }
     default:
@@ -653,3 +375,130 @@ gdf_error gdf_hash_partition(int num_input_cols,
   return gdf_status;
 }
 
+/* --------------------------------------------------------------------------*/
+/**
+ * @brief Two-level hash partitioning: partitions the rows of the input columns
+ * with one seed, and the rows of each partition into sub-partitions with a second
+ * seed, in a single pass over the input.
+ *
+ * @Param[in] num_input_cols The number of columns in the input columns
+ * @Param[in] input[] The input set of columns
+ * @Param[in] columns_to_hash[] Indices of the columns in the input set to hash
+ * @Param[in] num_cols_to_hash The number of columns to hash
+ * @Param[in] num_partitions The number of first level partitions
+ * @Param[in] num_sub_partitions The number of sub-partitions of each partition
+ * @Param[out] partitioned_output Preallocated gdf_columns to hold the rearrangement
+ * of the input columns
+ * @Param[out] partition_offsets Preallocated array of num_partitions offsets
+ * @Param[out] sub_partition_offsets Preallocated array of num_partitions * num_sub_partitions
+ * offsets. Sub-partition s of partition p starts at sub_partition_offsets[p * num_sub_partitions + s]
+ * @Param[in] hash The hash function to use
+ * @Param[in] seed The seed of the hash function of the first level
+ * @Param[in] sub_seed The seed of the hash function of the second level, which
+ * must differ from seed
+ *
+ * @Returns  If the operation was successful, returns GDF_SUCCESS
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error gdf_hash_partition_two_level(int num_input_cols,
+                                       gdf_column * input[],
+                                       int columns_to_hash[],
+                                       int num_cols_to_hash,
+                                       int num_partitions,
+                                       int num_sub_partitions,
+                                       gdf_column * partitioned_output[],
+                                       int partition_offsets[],
+                                       int sub_partition_offsets[],
+                                       gdf_hash_func hash,
+                                       uint32_t seed,
+                                       uint32_t sub_seed)
+{
+  // Use int until gdf API is updated to use something other than int
+  // for ordinal variables
+  using size_type = int;
+
+  gdf_error gdf_status = validate_hash_partition_args(num_input_cols, input,
+                                                      columns_to_hash, num_cols_to_hash,
+                                                      num_partitions, partitioned_output,
+                                                      partition_offsets);
+  if(GDF_SUCCESS != gdf_status)
+  {
+    return gdf_status;
+  }
+
+  // With equal seeds, every row of a partition would land in the same sub-partition
+  if((0 == num_sub_partitions) || (nullptr == sub_partition_offsets) || (seed == sub_seed))
+  {
+    return GDF_INVALID_API_CALL;
+  }
+
+  // The histogram of the sub-partitions is accumulated in shared memory
+  int device{0};
+  int max_shared_memory{0};
+  CUDA_TRY( cudaGetDevice(&device) );
+  CUDA_TRY( cudaDeviceGetAttribute(&max_shared_memory, cudaDevAttrMaxSharedMemoryPerBlock, device) );
+  if(static_cast<size_t>(num_partitions) * num_sub_partitions * sizeof(size_type)
+     > static_cast<size_t>(max_shared_memory))
+  {
+    return GDF_INVALID_API_CALL;
+  }
+
+  // If the input is empty, return immediately
+  if(0 == input[0]->size)
+  {
+    return GDF_SUCCESS;
+  }
+
+  PUSH_RANGE("LIBGDF_HASH_PARTITION", PARTITION_COLOR);
+
+  // Wrap input and output columns in gdf_table
+  std::unique_ptr< const gdf_table<size_type> > input_table{new gdf_table<size_type>(num_input_cols, input)};
+  std::unique_ptr< gdf_table<size_type> > output_table{new gdf_table<size_type>(num_input_cols, partitioned_output)};
+
+  // Create vector of pointers to columns that will be hashed
+  std::vector<gdf_column *> gdf_columns_to_hash(num_cols_to_hash);
+  for(size_type i = 0; i < num_cols_to_hash; ++i)
+  {
+    gdf_columns_to_hash[i] = input[columns_to_hash[i]];
+  }
+  // Create a separate table of the columns to be hashed
+  std::unique_ptr< const gdf_table<size_type> > table_to_hash {new gdf_table<size_type>(num_cols_to_hash, 
+                                                                                        gdf_columns_to_hash.data())};
+
+  switch(hash)
+  {
+    case GDF_HASH_MURMUR3:
+      {
+        gdf_status = two_level_hash_partition_gdf_table<MurmurHash3_32>(*input_table, 
+                                                                        *table_to_hash,
+                                                                        num_partitions,
+                                                                        num_sub_partitions,
+                                                                        partition_offsets,
+                                                                        sub_partition_offsets,
+                                                                        *output_table,
+                                                                        seed,
+                                                                        sub_seed);
+        break;
+      }
+    case GDF_HASH_MURMUR3_64:
+      {
+        gdf_status = two_level_hash_partition_gdf_table<MurmurHash3_64>(*input_table, 
+                                                                        *table_to_hash,
+                                                                        num_partitions,
+                                                                        num_sub_partitions,
+                                                                        partition_offsets,
+                                                                        sub_partition_offsets,
+                                                                        *output_table,
+                                                                        seed,
+                                                                        sub_seed);
+        break;
+      }
+    // The identity hash ignores the seed, so it cannot spread the rows of a partition
+    default:
+      gdf_status = GDF_INVALID_HASH_FUNCTION;
+  }
+
+  POP_RANGE();
+
+  return gdf_status;
+}
@@ -0,0 +1,384 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HOST_CONCURRENT_UNORDERED_MAP_CUH
+#define HOST_CONCURRENT_UNORDERED_MAP_CUH
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "groupby/aggregation_operations.cuh"
+#include "hash_functions.cuh"
+#include "hash_probing.cuh"
+#include "hash_table_stats.h"
+#include "utilities/host_parallel.h"
+
+/**
+ * Host counterpart of concurrent_unordered_map.
+ *
+ * Same open-addressing layout and linear probing as the device map, with
+ * std::atomic compare-and-swap in place of atomicCAS, so that it can be filled
+ * concurrently from host threads (e.g. with cudf::detail::host_parallel_for).
+ *
+ * Does support concurrent insert, but not concurrent insert and probing.
+ * Like the device map, insert returns end() when the table is full or at its
+ * maximum occupancy, and the table can then be grown with rehash(). The
+ * Probing parameter selects the same table layouts as the device map.
+ */
+template <typename Key,
+          typename Element,
+          Key unused_key,
+          typename Hasher = default_hash<Key>,
+          typename Equality = std::equal_to<Key>,
+          bool count_collisions = false,
+          typename Probing = linear_probing>
+class host_concurrent_unordered_map
+{
+
+public:
+    using size_type = size_t;
+    using probing = Probing;
+    using hasher = Hasher;
+    using key_equal = Equality;
+    using key_type = Key;
+    using mapped_type = Element;
+    using value_type = std::pair<Key, Element>;
+
+    /// A hash table slot. Reading first/second converts the atomics to the
+    /// plain key and value.
+    struct bucket_type {
+        std::atomic<key_type> first;
+        std::atomic<mapped_type> second;
+    };
+
+    using iterator = bucket_type*;
+    using const_iterator = const bucket_type*;
+
+    explicit host_concurrent_unordered_map(size_type n,
+                                           const mapped_type unused_element,
+                                           const Hasher& hf = hasher(),
+                                           const Equality& eql = key_equal())
+        : m_hf(hf), m_equal(eql), m_unused_element(unused_element),
+          m_hashtbl_size(probing::capacity(n)), m_hashtbl_values(new bucket_type[m_hashtbl_size]),
+          m_collisions(0), m_occupancy(0), m_max_occupancy(m_hashtbl_size)
+    {
+        clear();
+    }
+
+    iterator begin() { return m_hashtbl_values.get(); }
+    const_iterator begin() const { return m_hashtbl_values.get(); }
+    iterator end() { return m_hashtbl_values.get() + m_hashtbl_size; }
+    const_iterator end() const { return m_hashtbl_values.get() + m_hashtbl_size; }
+    size_type size() const { return m_hashtbl_size; }
+    bucket_type* data() const { return m_hashtbl_values.get(); }
+
+    static constexpr key_type get_unused_key() { return unused_key; }
+
+    /// See concurrent_unordered_map::set_max_occupancy
+    void set_max_occupancy(size_type max_occupancy)
+    {
+        m_max_occupancy = std::min(max_occupancy, m_hashtbl_size);
+    }
+
+    size_type get_occupancy() const { return m_occupancy; }
+
+    // Generic update of a hash table value for any aggregator
+    template <typename aggregation_type>
+    void update_existing_value(std::atomic<mapped_type> & existing_value,
+                               value_type const & insert_pair,
+                               aggregation_type op)
+    {
+      const mapped_type insert_value = insert_pair.second;
+
+      mapped_type old_value = existing_value.load();
+
+      // Attempt to perform the aggregation with existing_value and store the
+      // result atomically. On failure old_value is reloaded by the exchange.
+      while (!existing_value.compare_exchange_weak(old_value,
+                                                   op(insert_value, old_value)))
+      {
+      }
+    }
+
+    // Specialization for COUNT aggregator
+    template <typename value_t>
+    void update_existing_value(std::atomic<mapped_type> & existing_value,
+                               value_type const & insert_pair,
+                               count_op<value_t> op)
+    {
+      count(existing_value, std::is_integral<mapped_type>{});
+    }
+
+    /* --------------------------------------------------------------------------*/
+    /**
+     * @Synopsis  Inserts a new (key, value) pair. If the key already exists in the map
+                  an aggregation operation is performed with the new value and existing value.
+     *
+     * @Param[in] x The new (key, value) pair to insert
+     * @Param[in] op The aggregation operation to perform
+     * @Param[in] keys_equal An optional functor for comparing two keys
+     * @Param[in] precomputed_hash Indicates if a precomputed hash value is being passed in to use
+     * to determine the write location of the new key
+     * @Param[in] precomputed_hash_value The precomputed hash value
+     * @tparam aggregation_type A functor for a binary operation that performs the aggregation
+     * @tparam comparison_type A functor for comparing two keys
+     *
+     * @Returns An iterator to the bucket of the key, or end() if the map is full
+     */
+    /* ----------------------------------------------------------------------------*/
+    template<typename aggregation_type,
+             class comparison_type = key_equal,
+             typename hash_value_type = typename Hasher::result_type>
+    iterator insert(const value_type& x,
+                    aggregation_type op,
+                    comparison_type keys_equal = key_equal(),
+                    bool precomputed_hash = false,
+                    hash_value_type precomputed_hash_value = 0)
+    {
+        const hash_value_type hash_value = precomputed_hash ? precomputed_hash_value
+                                                            : m_hf(x.first);
+        size_type current_index = probing::first_slot(hash_value, m_hashtbl_size);
+        const key_type insert_key = x.first;
+
+        for (size_type attempt = 0; attempt < m_hashtbl_size; ++attempt)
+        {
+          bucket_type& bucket = m_hashtbl_values[current_index];
+
+          // insert_key was not found before this empty bucket, so claiming it
+          // adds a new key. Fail if the map is at its maximum occupancy.
+          if ( keys_equal( unused_key, bucket.first.load() )
+               && m_occupancy.load() >= m_max_occupancy ) {
+            break;
+          }
+
+          // Try and set the key of the current bucket to insert_key. On failure
+          // old_key receives the key already in the bucket.
+          key_type old_key = unused_key;
+          bucket.first.compare_exchange_strong(old_key, insert_key);
+
+          // Either the bucket was empty and now holds insert_key, or insert_key
+          // was already there. In both cases aggregate into the value, which was
+          // initialized with the identity of the aggregation.
+          if ( keys_equal( unused_key, old_key ) ) {
+            ++m_occupancy;
+            update_existing_value(bucket.second, x, op);
+            return &bucket;
+          }
+          if ( keys_equal( insert_key, old_key ) ) {
+            update_existing_value(bucket.second, x, op);
+            return &bucket;
+          }
+
+          if (count_collisions) ++m_collisions;
+          current_index = (current_index + 1) % m_hashtbl_size;
+        }
+
+        return end();
+    }
+
+    /* --------------------------------------------------------------------------*/
+    /**
+     * @Synopsis  Inserts a (key, value) pair whose key is known not to be in the
+     * map, without aggregation. Ignores the maximum occupancy.
+     *
+     * @Returns An iterator to the inserted pair, or end() if the map is full
+     */
+    /* ----------------------------------------------------------------------------*/
+    template<typename hash_value_type = typename Hasher::result_type>
+    iterator insert_unique(const value_type& x,
+                           bool precomputed_hash = false,
+                           hash_value_type precomputed_hash_value = 0)
+    {
+        const hash_value_type hash_value = precomputed_hash ? precomputed_hash_value
+                                                            : m_hf(x.first);
+        size_type current_index = probing::first_slot(hash_value, m_hashtbl_size);
+
+        for (size_type attempt = 0; attempt < m_hashtbl_size; ++attempt)
+        {
+          bucket_type& bucket = m_hashtbl_values[current_index];
+          key_type old_key = unused_key;
+          if ( bucket.first.compare_exchange_strong(old_key, x.first) ) {
+            bucket.second.store(x.second);
+            ++m_occupancy;
+            return &bucket;
+          }
+          current_index = (current_index + 1) % m_hashtbl_size;
+        }
+
+        return end();
+    }
+
+    /* --------------------------------------------------------------------------*/
+    /**
+     * @Synopsis  Grows the map to new_size buckets, reinserting every entry from
+     * a set of host threads. The maximum occupancy is reset to new_size.
+     *
+     * @Param new_size The new number of buckets, at least get_occupancy(). Rounded
+     * up to a whole number of probing buckets.
+     * @Param key_hasher Functor computing the hash value of a key, for maps
+     * whose inserts use precomputed hash values
+     * @Param num_threads The number of threads, 0 for the default
+     */
+    /* ----------------------------------------------------------------------------*/
+    template <typename key_hasher_type = hasher>
+    void rehash(size_type new_size,
+                key_hasher_type key_hasher = key_hasher_type(),
+                unsigned int num_threads = 0)
+    {
+        std::unique_ptr<bucket_type[]> old_values(std::move(m_hashtbl_values));
+        const size_type old_size = m_hashtbl_size;
+        m_hashtbl_size = probing::capacity(new_size);
+        m_hashtbl_values.reset(new bucket_type[m_hashtbl_size]);
+        m_max_occupancy = m_hashtbl_size;
+        clear();
+
+        cudf::detail::host_parallel_for(old_size, [&](size_t i) {
+            const key_type key = old_values[i].first.load();
+            if ( !m_equal( unused_key, key ) ) {
+                insert_unique(std::make_pair(key, old_values[i].second.load()),
+                              true, key_hasher(key));
+            }
+        }, num_threads);
+    }
+
+    const_iterator find(const key_type& k) const
+    {
+        size_type hash_tbl_idx = probing::first_slot(m_hf(k), m_hashtbl_size);
+
+        for (size_type counter = 0; counter < m_hashtbl_size; ++counter)
+        {
+            const bucket_type& bucket = m_hashtbl_values[hash_tbl_idx];
+            const key_type tmp_val = bucket.first.load();
+            if ( m_equal( k, tmp_val ) ) {
+                return &bucket;
+            }
+            if ( m_equal( unused_key, tmp_val ) ) {
+                break;
+            }
+            hash_tbl_idx = (hash_tbl_idx+1)%m_hashtbl_size;
+        }
+
+        return end();
+    }
+
+    /* --------------------------------------------------------------------------*/
+    /**
+     * @Synopsis  The number of probing buckets find(k) reads, i.e., the number of
+     * (vectorized) reads the device map needs to find k or prove it absent.
+     */
+    /* ----------------------------------------------------------------------------*/
+    size_type probe_length(const key_type& k) const
+    {
+        constexpr int bucket_size{probing::bucket_size};
+        size_type bucket_start = probing::first_slot(m_hf(k), m_hashtbl_size);
+        size_type num_buckets = 0;
+
+        for (size_type counter = 0; counter < m_hashtbl_size; counter += bucket_size)
+        {
+            ++num_buckets;
+            for (int slot = 0; slot < bucket_size; ++slot)
+            {
+                const key_type tmp_val = m_hashtbl_values[bucket_start + slot].first.load();
+                if ( m_equal( k, tmp_val ) || m_equal( unused_key, tmp_val ) ) {
+                    return num_buckets;
+                }
+            }
+            bucket_start = probing::next_bucket(bucket_start, m_hashtbl_size);
+        }
+
+        return num_buckets;
+    }
+
+    void clear()
+    {
+        for (size_type i = 0; i < m_hashtbl_size; ++i) {
+            m_hashtbl_values[i].first.store(unused_key, std::memory_order_relaxed);
+            m_hashtbl_values[i].second.store(m_unused_element, std::memory_order_relaxed);
+        }
+        m_collisions = 0;
+        m_occupancy = 0;
+    }
+
+    /// See concurrent_unordered_map::get_num_collisions
+    unsigned long long get_num_collisions() const
+    {
+        return m_collisions;
+    }
+
+    /* --------------------------------------------------------------------------*/
+    /**
+     * @Synopsis  Computes the statistics of the map, as reported by the
+     * hash-based groupby
+     *
+     * @Param[out] stats The statistics of the map
+     * @Param key_hasher Functor computing the hash value of a key, for maps
+     * whose inserts use precomputed hash values
+     */
+    /* ----------------------------------------------------------------------------*/
+    template <typename key_hasher_type = hasher>
+    void get_stats(gdf_hash_table_stats * stats,
+                   key_hasher_type key_hasher = key_hasher_type()) const
+    {
+        compute_host_hash_table_stats<probing>(m_hashtbl_size,
+                                               [this](size_type i) { return m_hashtbl_values[i].first.load(); },
+                                               unused_key,
+                                               key_hasher,
+                                               stats);
+    }
+
+    void print()
+    {
+        for (size_type i = 0; i < m_hashtbl_size; ++i)
+        {
+            std::cout<<i<<": "<<m_hashtbl_values[i].first<<","<<m_hashtbl_values[i].second<<std::endl;
+        }
+    }
+
+private:
+    void count(std::atomic<mapped_type> & existing_value, std::true_type)
+    {
+      existing_value.fetch_add(static_cast<mapped_type>(1));
+    }
+
+    // std::atomic has no fetch_add for floating point types before C++20
+    void count(std::atomic<mapped_type> & existing_value, std::false_type)
+    {
+      mapped_type old_value = existing_value.load();
+      while (!existing_value.compare_exchange_weak(old_value, old_value + 1))
+      {
+      }
+    }
+
+    const hasher            m_hf;
+    const key_equal         m_equal;
+
+    const mapped_type       m_unused_element;
+
+    size_type   m_hashtbl_size;
+    std::unique_ptr<bucket_type[]> m_hashtbl_values;
+
+    std::atomic<unsigned long long> m_collisions;
+
+    std::atomic<size_type> m_occupancy;
+    size_type m_max_occupancy;
+};
+
+#endif //HOST_CONCURRENT_UNORDERED_MAP_CUH
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HOST_CONCURRENT_UNORDERED_MULTIMAP_CUH
+#define HOST_CONCURRENT_UNORDERED_MULTIMAP_CUH
+
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <utility>
+
+#include "hash_functions.cuh"
+
+/**
+ * Host counterpart of concurrent_unordered_multimap.
+ *
+ * Same open-addressing layout and linear probing as the device multimap, with
+ * std::atomic compare-and-swap in place of atomicCAS, so that it can be built
+ * and probed from host threads (e.g. with cudf::detail::host_parallel_for).
+ *
+ * Does support concurrent insert, but not concurrent insert and probing.
+ */
+template <typename Key,
+          typename Element,
+          typename size_type,
+          Key unused_key,
+          Element unused_element,
+          typename Hasher = default_hash<Key>,
+          typename Equality = std::equal_to<Key>,
+          bool count_collisions = false>
+class host_concurrent_unordered_multimap
+{
+
+public:
+    using hasher = Hasher;
+    using key_equal = Equality;
+    using key_type = Key;
+    using mapped_type = Element;
+    using value_type = std::pair<Key, Element>;
+
+    /// A hash table slot. Reading first/second converts the atomics to the
+    /// plain key and value.
+    struct bucket_type {
+        std::atomic<key_type> first;
+        std::atomic<mapped_type> second;
+    };
+
+    using iterator = bucket_type*;
+    using const_iterator = const bucket_type*;
+
+    explicit host_concurrent_unordered_multimap(size_type n,
+                                                const Hasher& hf = hasher(),
+                                                const Equality& eql = key_equal())
+        : m_hf(hf), m_equal(eql), m_hashtbl_size(n),
+          m_hashtbl_values(new bucket_type[n]), m_collisions(0)
+    {
+        clear();
+    }
+
+    iterator begin() { return m_hashtbl_values.get(); }
+    const_iterator begin() const { return m_hashtbl_values.get(); }
+    iterator end() { return m_hashtbl_values.get() + m_hashtbl_size; }
+    const_iterator end() const { return m_hashtbl_values.get() + m_hashtbl_size; }
+    size_type size() const { return m_hashtbl_size; }
+
+    static constexpr key_type get_unused_key() { return unused_key; }
+
+    /* --------------------------------------------------------------------------*/
+    /**
+     * @Synopsis  Inserts a (key, value) pair into the hash map
+     *
+     * @Param[in] x The (key, value) pair to insert
+     * @Param[in] precomputed_hash A flag indicating whether or not a precomputed
+     * hash value is passed in
+     * @Param[in] precomputed_hash_value A precomputed hash value to use for determing
+     * the write location of the key into the hash map instead of computing the
+     * the hash value directly from the key
+     * @Param[in] keys_are_equal An optional functor for comparing if two keys are equal
+     * @tparam hash_value_type The datatype of the hash value
+     * @tparam comparison_type The type of the key comparison functor
+     *
+     * @Returns An iterator to the newly inserted (key, value) pair, or end() if
+     * the map is full
+     */
+    /* ----------------------------------------------------------------------------*/
+    template < typename hash_value_type = typename Hasher::result_type,
+               typename comparison_type = key_equal>
+    iterator insert(const value_type& x,
+                    bool precomputed_hash = false,
+                    hash_value_type precomputed_hash_value = 0,
+                    comparison_type keys_are_equal = key_equal())
+    {
+        const hash_value_type hash_value = precomputed_hash ? precomputed_hash_value
+                                                            : m_hf(x.first);
+        size_type hash_tbl_idx = hash_value % m_hashtbl_size;
+
+        for (size_type attempt = 0; attempt < m_hashtbl_size; ++attempt)
+        {
+            bucket_type& bucket = m_hashtbl_values[hash_tbl_idx];
+
+            key_type old_key = unused_key;
+            bucket.first.compare_exchange_strong(old_key, x.first);
+            if ( keys_are_equal( unused_key, old_key ) )
+            {
+                bucket.second.store(x.second);
+                return &bucket;
+            }
+            if (count_collisions) ++m_collisions;
+
+            hash_tbl_idx = (hash_tbl_idx+1)%m_hashtbl_size;
+        }
+
+        return end();
+    }
+
+    /* --------------------------------------------------------------------------*/
+    /**
+     * @Synopsis Searches for a key in the hash map and returns an iterator to the first
+     * instance of the key in the map.
+     *
+     * @Param[in] the_key The key to search for
+     * @Param[in] precomputed_hash A flag indicating whether or not a precomputed
+     * hash value is passed in
+     * @Param[in] precomputed_hash_value A precomputed hash value to use instead of
+     * computing the hash value directly from the key
+     * @Param[in] keys_are_equal An optional functor for comparing if two keys are equal
+     *
+     * @Returns   An iterator to the first instance of the key in the map, or end()
+     */
+    /* ----------------------------------------------------------------------------*/
+    template < typename hash_value_type = typename Hasher::result_type,
+               typename comparison_type = key_equal>
+    const_iterator find(const key_type& the_key,
+                        bool precomputed_hash = false,
+                        hash_value_type precomputed_hash_value = 0,
+                        comparison_type keys_are_equal = key_equal()) const
+    {
+        const hash_value_type hash_value = precomputed_hash ? precomputed_hash_value
+                                                            : m_hf(the_key);
+        size_type hash_tbl_idx = hash_value % m_hashtbl_size;
+
+        for (size_type counter = 0; counter < m_hashtbl_size; ++counter)
+        {
+            const bucket_type& bucket = m_hashtbl_values[hash_tbl_idx];
+            const key_type tmp_val = bucket.first.load();
+            if ( keys_are_equal( the_key, tmp_val ) ) {
+                return &bucket;
+            }
+            if ( keys_are_equal( unused_key, tmp_val ) ) {
+                break;
+            }
+            hash_tbl_idx = (hash_tbl_idx+1)%m_hashtbl_size;
+        }
+
+        return end();
+    }
+
+    /* --------------------------------------------------------------------------*/
+    /**
+     * @Synopsis Calls f with the value of every instance of a key in the map, the
+     * host equivalent of the probe loop of the hash join.
+     *
+     * @Param[in] the_key The key to search for
+     * @Param[in] f The functor called with each matching value
+     * @Param[in] precomputed_hash A flag indicating whether or not a precomputed
+     * hash value is passed in
+     * @Param[in] precomputed_hash_value A precomputed hash value
+     * @Param[in] keys_are_equal An optional functor for comparing if two keys are equal
+     *
+     * @Returns   The number of matches
+     */
+    /* ----------------------------------------------------------------------------*/
+    template < typename Functor,
+               typename hash_value_type = typename Hasher::result_type,
+               typename comparison_type = key_equal>
+    size_type for_each_match(const key_type& the_key,
+                             Functor f,
+                             bool precomputed_hash = false,
+                             hash_value_type precomputed_hash_value = 0,
+                             comparison_type keys_are_equal = key_equal()) const
+    {
+        const hash_value_type hash_value = precomputed_hash ? precomputed_hash_value
+                                                            : m_hf(the_key);
+        size_type hash_tbl_idx = hash_value % m_hashtbl_size;
+        size_type matches = 0;
+
+        for (size_type counter = 0; counter < m_hashtbl_size; ++counter)
+        {
+            const bucket_type& bucket = m_hashtbl_values[hash_tbl_idx];
+            const key_type tmp_val = bucket.first.load();
+            if ( keys_are_equal( unused_key, tmp_val ) ) {
+                break;
+            }
+            if ( keys_are_equal( the_key, tmp_val ) ) {
+                f(bucket.second.load());
+                ++matches;
+            }
+            hash_tbl_idx = (hash_tbl_idx+1)%m_hashtbl_size;
+        }
+
+        return matches;
+    }
+
+    void clear()
+    {
+        for (size_type i = 0; i < m_hashtbl_size; ++i) {
+            m_hashtbl_values[i].first.store(unused_key, std::memory_order_relaxed);
+            m_hashtbl_values[i].second.store(unused_element, std::memory_order_relaxed);
+        }
+        m_collisions = 0;
+    }
+
+    unsigned long long get_num_collisions() const
+    {
+        return m_collisions;
+    }
+
+    void print()
+    {
+        for (size_type i = 0; i < m_hashtbl_size; ++i)
+        {
+            std::cout<<i<<": "<<m_hashtbl_values[i].first<<","<<m_hashtbl_values[i].second<<std::endl;
+        }
+    }
+
+private:
+    const hasher            m_hf;
+    const key_equal         m_equal;
+
+    size_type   m_hashtbl_size;
+    std::unique_ptr<bucket_type[]> m_hashtbl_values;
+
+    std::atomic<unsigned long long> m_collisions;
+};
+
+#endif //HOST_CONCURRENT_UNORDERED_MULTIMAP_CUH
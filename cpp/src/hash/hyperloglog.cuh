@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HYPERLOGLOG_CUH
+#define HYPERLOGLOG_CUH
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "hash/hash_functions.cuh"
+
+// The number of registers of a sketch is 2^precision
+constexpr int HLL_MIN_PRECISION{4};
+constexpr int HLL_MAX_PRECISION{18};
+
+// 16384 registers, a relative standard error of about 0.8%
+constexpr int HLL_DEFAULT_PRECISION{14};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Remixes a 64-bit hash value before it updates a sketch.
+ *
+ * The row hash values of several columns are combined with hash_combine,
+ * whose bits are not uniform enough for HyperLogLog, so they are remixed with
+ * the finalizer of MurmurHash3_64.
+ */
+/* ----------------------------------------------------------------------------*/
+__host__ __device__ __forceinline__
+uint64_t hll_mix(hash_value64_type hash)
+{
+  return MurmurHash3_64<uint64_t>{}.fmix64(hash);
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The register a remixed hash value updates: its top precision bits
+ */
+/* ----------------------------------------------------------------------------*/
+__host__ __device__ __forceinline__
+uint32_t hll_register_index(uint64_t mixed_hash, int precision)
+{
+  return static_cast<uint32_t>(mixed_hash >> (64 - precision));
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The rank of a remixed hash value: one plus the number of leading
+ * zeros of the bits below the register index, at most 65 - precision
+ */
+/* ----------------------------------------------------------------------------*/
+__host__ __device__ __forceinline__
+uint32_t hll_rank(uint64_t mixed_hash, int precision)
+{
+  // The sentinel bit bounds the rank when all the remaining bits are 0
+  const uint64_t remaining = (mixed_hash << precision) | (uint64_t{1} << (precision - 1));
+#ifdef __CUDA_ARCH__
+  return static_cast<uint32_t>(__clzll(static_cast<long long>(remaining))) + 1;
+#else
+  return static_cast<uint32_t>(__builtin_clzll(remaining)) + 1;
+#endif
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Estimates the number of distinct hash values added to a set of
+ * HyperLogLog registers.
+ *
+ * This is the estimate of Flajolet et al., with linear counting for small
+ * cardinalities. The hash values are 64-bit, so no correction is needed for
+ * large cardinalities.
+ *
+ * @Param registers The 2^precision registers
+ * @Param precision The precision of the sketch
+ *
+ * @Returns The estimated number of distinct hash values
+ */
+/* ----------------------------------------------------------------------------*/
+inline double hll_estimate(uint32_t const * registers, int precision)
+{
+  const size_t num_registers = size_t{1} << precision;
+  const double m = static_cast<double>(num_registers);
+
+  double alpha{0.7213 / (1.0 + 1.079 / m)};
+  if(16 == num_registers) alpha = 0.673;
+  if(32 == num_registers) alpha = 0.697;
+  if(64 == num_registers) alpha = 0.709;
+
+  double sum{0};
+  size_t num_zeros{0};
+  for(size_t i = 0; i < num_registers; ++i) {
+    sum += std::ldexp(1.0, -static_cast<int>(registers[i]));
+    if(0 == registers[i]) ++num_zeros;
+  }
+
+  const double estimate = alpha * m * m / sum;
+  if((estimate <= 2.5 * m) && (num_zeros > 0)) {
+    return m * std::log(m / static_cast<double>(num_zeros));
+  }
+  return estimate;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  A HyperLogLog sketch of a set of 64-bit hash values, to estimate
+ * its number of distinct values in a single pass and a fixed amount of memory.
+ *
+ * A hash value is remixed, its top precision bits select a register, and the
+ * register keeps the largest rank of the hash values it has seen. The
+ * registers are 32-bit so that the device can update them with atomicMax. The
+ * same functions update the registers on the host and on the device, so the
+ * accuracy can be tested on the host.
+ *
+ * Sketches of the same precision are merged by taking the maximum of every
+ * register: the merged sketch is the sketch of the union of their sets, e.g.,
+ * of the partitions of a table.
+ */
+/* ----------------------------------------------------------------------------*/
+class hyperloglog_sketch
+{
+public:
+
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  Creates an empty sketch
+   *
+   * @Param precision The sketch has 2^precision registers, and a relative
+   * standard error of about 1.04 / sqrt(2^precision). Clamped to
+   * [HLL_MIN_PRECISION, HLL_MAX_PRECISION].
+   */
+  /* ----------------------------------------------------------------------------*/
+  explicit hyperloglog_sketch(int precision = HLL_DEFAULT_PRECISION)
+    : m_precision{std::min(std::max(precision, HLL_MIN_PRECISION), HLL_MAX_PRECISION)},
+      m_registers(size_t{1} << m_precision, 0)
+  {}
+
+  int precision() const { return m_precision; }
+
+  size_t num_registers() const { return m_registers.size(); }
+
+  uint32_t * registers() { return m_registers.data(); }
+
+  uint32_t const * registers() const { return m_registers.data(); }
+
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  Adds a hash value to the sketch
+   */
+  /* ----------------------------------------------------------------------------*/
+  void add(hash_value64_type hash)
+  {
+    const uint64_t mixed_hash = hll_mix(hash);
+    uint32_t & reg = m_registers[hll_register_index(mixed_hash, m_precision)];
+    reg = std::max(reg, hll_rank(mixed_hash, m_precision));
+  }
+
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  Merges another sketch into this one
+   *
+   * @Returns False if the sketches have different precisions, in which case
+   * this sketch is unchanged
+   */
+  /* ----------------------------------------------------------------------------*/
+  bool merge(hyperloglog_sketch const & other)
+  {
+    if(other.m_precision != m_precision) {
+      return false;
+    }
+    for(size_t i = 0; i < m_registers.size(); ++i) {
+      m_registers[i] = std::max(m_registers[i], other.m_registers[i]);
+    }
+    return true;
+  }
+
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  The estimated number of distinct hash values added to the sketch
+   */
+  /* ----------------------------------------------------------------------------*/
+  double estimate() const
+  {
+    return hll_estimate(m_registers.data(), m_precision);
+  }
+
+private:
+  int m_precision;
+  std::vector<uint32_t> m_registers;
+};
+
+#endif // HYPERLOGLOG_CUH
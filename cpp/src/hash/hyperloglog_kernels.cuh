@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HYPERLOGLOG_KERNELS_CUH
+#define HYPERLOGLOG_KERNELS_CUH
+
+#include <thrust/copy.h>
+#include <thrust/device_vector.h>
+
+#include "cudf.h"
+#include "dataframe/cudf_table.cuh"
+#include "hash/hash_functions.cuh"
+#include "hash/hyperloglog.cuh"
+#include "rmm/thrust_rmm_allocator.h"
+#include "utilities/error_utils.h"
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Adds the 64-bit hash value of every row of a table to a set of
+ * HyperLogLog registers. Rows containing a NULL are skipped.
+ *
+ * @Param the_table The table whose rows are hashed
+ * @Param num_rows The number of rows of the table
+ * @Param registers The 2^precision registers of the sketch
+ * @Param precision The precision of the sketch
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename size_type>
+__global__ void build_hyperloglog_sketch(gdf_table<size_type> const & the_table,
+                                         const size_type num_rows,
+                                         uint32_t * const registers,
+                                         const int precision)
+{
+  size_type i = threadIdx.x + blockIdx.x * blockDim.x;
+
+  while(i < num_rows){
+    if(the_table.is_row_valid(i)){
+      const uint64_t mixed_hash = hll_mix(the_table.template hash_row<MurmurHash3_64>(i));
+      const uint32_t register_index = hll_register_index(mixed_hash, precision);
+      const uint32_t rank = hll_rank(mixed_hash, precision);
+
+      // The registers quickly reach the common ranks, so most rows only read
+      // their register and do not need an atomic
+      if(rank > registers[register_index]){
+        atomicMax(registers + register_index, rank);
+      }
+    }
+    i += blockDim.x * gridDim.x;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Adds the rows of a table to a HyperLogLog sketch, i.e., merges
+ * the sketch of the table into it. Rows containing a NULL are not counted.
+ *
+ * @Param the_table The table whose distinct rows are estimated
+ * @Param sketch The sketch to update
+ *
+ * @Returns GDF_SUCCESS, or GDF_CUDA_ERROR
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename size_type>
+gdf_error compute_hyperloglog_sketch(gdf_table<size_type> const & the_table,
+                                     hyperloglog_sketch & sketch)
+{
+  const size_type num_rows = the_table.get_column_length();
+  if(0 == num_rows){
+    return GDF_SUCCESS;
+  }
+
+  thrust::device_vector<uint32_t, rmm_allocator<uint32_t>> d_registers(sketch.registers(),
+                                                                       sketch.registers() + sketch.num_registers());
+
+  constexpr int block_size{256};
+  const int grid_size = static_cast<int>((num_rows + block_size - 1) / block_size);
+
+  build_hyperloglog_sketch<<<grid_size, block_size>>>(the_table,
+                                                       num_rows,
+                                                       d_registers.data().get(),
+                                                       sketch.precision());
+  CUDA_TRY(cudaGetLastError());
+
+  thrust::copy(d_registers.begin(), d_registers.end(), sketch.registers());
+
+  return GDF_SUCCESS;
+}
+
+#endif // HYPERLOGLOG_KERNELS_CUH
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CHUNKED_PROBE_H
+#define CHUNKED_PROBE_H
+
+#include <algorithm>
+#include <cstddef>
+
+#include "cudf.h"
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The number of rows of the probe chunks of a chunked join.
+ *
+ * A chunk starts at a multiple of the returned number of rows, which is a
+ * multiple of align so that the validity bitmask of a chunk starts on a byte.
+ * A request larger than the probe table is clamped to a single chunk, so the
+ * rounding cannot overflow.
+ *
+ * @Param chunk_rows The requested number of rows, 0 for a single chunk
+ * @Param num_probe_rows The number of rows of the probe table
+ * @Param align The alignment of the chunk boundaries, in rows
+ */
+/* ----------------------------------------------------------------------------*/
+inline size_t probe_chunk_rows(size_t chunk_rows, size_t num_probe_rows,
+                               size_t align = GDF_VALID_BITSIZE)
+{
+  const size_t all_rows = std::max<size_t>(1, num_probe_rows);
+  if ((0 == chunk_rows) || (chunk_rows > all_rows)) chunk_rows = all_rows;
+  return ((chunk_rows + align - 1) / align) * align;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Drives a chunked probe: probes a prebuilt join hash table with
+ * successive row ranges of the probe table and hands the result of each range
+ * to a consumer before probing the next one, so the output of the whole probe
+ * table never exists at once.
+ *
+ * The driver is independent of where the hash table lives: probe_chunk may
+ * probe a device join hash table or a host_join_hash_table.
+ *
+ * @Param num_probe_rows The number of rows of the probe table
+ * @Param chunk_rows The number of rows of a chunk, see probe_chunk_rows
+ * @Param[in,out] result The result of a chunk, reused by every chunk
+ * @Param probe_chunk Callable as probe_chunk(begin, end, result), which joins
+ * the probe rows [begin, end) and stores their output in result. Returns a
+ * gdf_error.
+ * @Param consume Callable as consume(begin, end, result), which is handed the
+ * output of the probe rows [begin, end). Returns a gdf_error, and stops the
+ * probe if not GDF_SUCCESS.
+ *
+ * @Returns GDF_SUCCESS, or the first error returned by probe_chunk or consume
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename result_type, typename probe_function, typename consume_function>
+gdf_error probe_in_chunks(size_t num_probe_rows,
+                          size_t chunk_rows,
+                          result_type & result,
+                          probe_function probe_chunk,
+                          consume_function consume)
+{
+  chunk_rows = probe_chunk_rows(chunk_rows, num_probe_rows);
+
+  for (size_t begin = 0; begin < num_probe_rows; begin += chunk_rows) {
+    const size_t end = std::min(num_probe_rows, begin + chunk_rows);
+
+    gdf_error gdf_error_code = probe_chunk(begin, end, result);
+    if (GDF_SUCCESS != gdf_error_code) return gdf_error_code;
+
+    gdf_error_code = consume(begin, end, result);
+    if (GDF_SUCCESS != gdf_error_code) return gdf_error_code;
+  }
+
+  return GDF_SUCCESS;
+}
+
+#endif // CHUNKED_PROBE_H
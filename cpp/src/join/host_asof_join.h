@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HOST_ASOF_JOIN_H
+#define HOST_ASOF_JOIN_H
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host implementation of the as-of join, the reference of gdf_asof_join.
+ *
+ * Every left row is matched with the last right row whose by key is equal and
+ * whose on value is less than or equal to its own. Among right rows of equal
+ * by key and on value, the one with the largest index is matched.
+ *
+ * @Param left_on The on value of each left row
+ * @Param right_on The on value of each right row
+ * @Param left_by The by key of each left row, e.g., a std::tuple of the by
+ * columns, or empty if there are no by columns
+ * @Param right_by The by key of each right row, or empty
+ * @Param tolerance The largest difference of the on values of a match,
+ * negative for no limit
+ *
+ * @Returns The index of the matched right row of every left row, or -1
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename on_type, typename by_type, typename size_type = int>
+std::vector<size_type> host_asof_join(std::vector<on_type> const & left_on,
+                                      std::vector<on_type> const & right_on,
+                                      std::vector<by_type> const & left_by,
+                                      std::vector<by_type> const & right_by,
+                                      int64_t tolerance)
+{
+  const bool has_by = !left_by.empty() || !right_by.empty();
+  auto by_of = [has_by](std::vector<by_type> const & by, size_t row) {
+    return has_by ? by[row] : by_type{};
+  };
+
+  // The right rows in the order of (by, on, row index)
+  std::vector<size_type> right_order(right_on.size());
+  std::iota(right_order.begin(), right_order.end(), 0);
+  std::sort(right_order.begin(), right_order.end(), [&](size_type a, size_type b) {
+    return std::make_tuple(by_of(right_by, a), right_on[a], a)
+           < std::make_tuple(by_of(right_by, b), right_on[b], b);
+  });
+
+  std::vector<size_type> right_result(left_on.size(), -1);
+  for (size_t i = 0; i < left_on.size(); ++i) {
+    const auto left_key = std::make_tuple(by_of(left_by, i), left_on[i]);
+
+    // One past the last right row whose (by, on) is less than or equal
+    auto upper = std::upper_bound(right_order.begin(), right_order.end(), left_key,
+                                  [&](decltype(left_key) const & key, size_type row) {
+                                    return key < std::make_tuple(by_of(right_by, row), right_on[row]);
+                                  });
+    if (upper == right_order.begin()) continue;
+
+    const size_type candidate = *(upper - 1);
+    if (has_by && !(by_of(right_by, candidate) == by_of(left_by, i))) continue;
+
+    const int64_t distance = static_cast<int64_t>(left_on[i]) - static_cast<int64_t>(right_on[candidate]);
+    if ((tolerance < 0) || (distance <= tolerance)) right_result[i] = candidate;
+  }
+
+  return right_result;
+}
+
+#endif // HOST_ASOF_JOIN_H
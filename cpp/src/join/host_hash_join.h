@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HOST_HASH_JOIN_H
+#define HOST_HASH_JOIN_H
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "cudf.h"
+#include "hash/hash_probing.cuh"
+#include "hash/hash_table_stats.h"
+#include "hash/host_concurrent_unordered_multimap.cuh"
+#include "join/join_build_side.h"
+#include "utilities/host_parallel.h"
+
+constexpr int HostJoinNoneValue = -1;
+
+/// The occupancy of the host multimap, in percent
+constexpr int64_t HostJoinOccupancy = 50;
+
+/// The host multimap of the build keys, mapping each key to its build row indices.
+/// The largest key_type value marks the empty slots, and cannot be a key.
+template <typename key_type, typename size_type = int>
+using host_join_multimap_t = host_concurrent_unordered_multimap<key_type,
+                                                                size_type,
+                                                                size_type,
+                                                                std::numeric_limits<key_type>::max(),
+                                                                std::numeric_limits<size_type>::max()>;
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Builds the host multimap of a set of build keys, at 50% occupancy
+ *
+ * @Param build_keys The key of each build row
+ * @Param num_threads The number of host threads, 0 for the default
+ *
+ * @Returns The map of each key to the indices of its build rows
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename key_type, typename size_type = int>
+std::unique_ptr<host_join_multimap_t<key_type, size_type>>
+host_build_join_map(std::vector<key_type> const & build_keys, unsigned int num_threads = 0)
+{
+  const size_type map_size = std::max<size_type>(1, (build_keys.size() * 100) / HostJoinOccupancy);
+  std::unique_ptr<host_join_multimap_t<key_type, size_type>> build_map(
+      new host_join_multimap_t<key_type, size_type>(map_size));
+
+  cudf::detail::host_parallel_for(build_keys.size(), [&](size_t i) {
+    build_map->insert(std::make_pair(build_keys[i], static_cast<size_type>(i)));
+  }, num_threads);
+
+  return build_map;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host implementation of the exactly sized hash join.
+ *
+ * The first pass counts the output rows of every probe row, the exclusive scan
+ * of the counts gives the output offset of each probe row and the output size,
+ * and the second pass writes the output rows of each probe row from its offset.
+ * The output is allocated once, no shared write counter is needed, and the
+ * output is in probe row order whatever the number of threads.
+ *
+ * @Param build_map The multimap of the build keys
+ * @Param probe_keys The key of each probe row
+ * @Param[out] output_probe The probe row index of each output row
+ * @Param[out] output_build The build row index of each output row, or
+ * HostJoinNoneValue for a probe row of a left join without a match
+ * @Param num_threads The number of host threads, 0 for the default
+ * @tparam left_join If true, a probe row without a match has one output row,
+ * otherwise it has none
+ */
+/* ----------------------------------------------------------------------------*/
+template <bool left_join, typename map_type, typename key_type, typename size_type>
+void host_hash_join(map_type const & build_map,
+                    std::vector<key_type> const & probe_keys,
+                    std::vector<size_type> & output_probe,
+                    std::vector<size_type> & output_build,
+                    unsigned int num_threads = 0)
+{
+  const size_t num_probe_rows = probe_keys.size();
+
+  // First pass: count the output rows of every probe row
+  std::vector<size_type> row_output_offsets(num_probe_rows + 1, 0);
+  cudf::detail::host_parallel_for(num_probe_rows, [&](size_t i) {
+    size_type num_matches = build_map.for_each_match(probe_keys[i], [](size_type) {});
+    if (left_join && (0 == num_matches)) num_matches = 1;
+    row_output_offsets[i] = num_matches;
+  }, num_threads);
+
+  // Exclusive scan of the counts
+  size_type output_size{0};
+  for (size_t i = 0; i <= num_probe_rows; ++i) {
+    const size_type count = row_output_offsets[i];
+    row_output_offsets[i] = output_size;
+    output_size += count;
+  }
+
+  output_probe.resize(output_size);
+  output_build.resize(output_size);
+
+  // Second pass: write the output rows of every probe row from its offset
+  cudf::detail::host_parallel_for(num_probe_rows, [&](size_t i) {
+    size_type output_index = row_output_offsets[i];
+    build_map.for_each_match(probe_keys[i], [&](size_type build_row) {
+      output_probe[output_index] = static_cast<size_type>(i);
+      output_build[output_index] = build_row;
+      ++output_index;
+    });
+    if (left_join && (output_index == row_output_offsets[i])) {
+      output_probe[output_index] = static_cast<size_type>(i);
+      output_build[output_index] = static_cast<size_type>(HostJoinNoneValue);
+    }
+  }, num_threads);
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host counterpart of the gdf_join_hash_table handle: a multimap
+ * built once on a set of build keys and probed with any number of probe key
+ * sets, e.g., successive batches of a fact table.
+ *
+ * The map holds the build keys, so the build keys need not outlive it.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename key_type, typename size_type = int>
+class host_join_hash_table
+{
+public:
+  using map_type = host_join_multimap_t<key_type, size_type>;
+
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  Builds the map of a set of build keys
+   *
+   * @Param build_keys The key of each build row
+   * @Param num_threads The number of host threads, 0 for the default
+   */
+  /* ----------------------------------------------------------------------------*/
+  explicit host_join_hash_table(std::vector<key_type> const & build_keys,
+                                unsigned int num_threads = 0)
+    : build_map(host_build_join_map<key_type, size_type>(build_keys, num_threads)),
+      build_num_rows(build_keys.size())
+  {
+  }
+
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  Joins a set of probe keys with the build keys, see host_hash_join
+   *
+   * @Param probe_keys The key of each probe row
+   * @Param left_join If true, a probe row without a match has one output row
+   * whose build index is HostJoinNoneValue
+   * @Param[out] output_probe The probe row index of each output row
+   * @Param[out] output_build The build row index of each output row
+   * @Param num_threads The number of host threads, 0 for the default
+   */
+  /* ----------------------------------------------------------------------------*/
+  void probe(std::vector<key_type> const & probe_keys,
+             bool left_join,
+             std::vector<size_type> & output_probe,
+             std::vector<size_type> & output_build,
+             unsigned int num_threads = 0) const
+  {
+    if (left_join) {
+      host_hash_join<true>(*build_map, probe_keys, output_probe, output_build, num_threads);
+    } else {
+      host_hash_join<false>(*build_map, probe_keys, output_probe, output_build, num_threads);
+    }
+  }
+
+  size_t num_build_rows() const { return build_num_rows; }
+
+private:
+  std::unique_ptr<map_type> build_map;
+  size_t build_num_rows;
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Host inner join that builds the multimap on the cheaper side.
+ *
+ * The map is built on the right keys and probed with the left keys, unless the
+ * cost hook finds building it on the left keys cheaper, in which case the
+ * sides are swapped and the output columns flipped back. Either way,
+ * output_left and output_right hold the left and right row of every output row.
+ *
+ * @Param left_keys The key of each left row
+ * @Param right_keys The key of each right row
+ * @Param[out] output_left The left row index of each output row
+ * @Param[out] output_right The right row index of each output row
+ * @Param[out] stats If not nullptr, receives the statistics of the multimap and
+ * the side it was built on. The map compares keys, not hash values, so
+ * num_hash_collisions is 0.
+ * @Param left_distinct_keys The number of distinct left keys, or 0 if unknown
+ * @Param right_distinct_keys The number of distinct right keys, or 0 if unknown
+ * @Param build_side_cost The cost hook, default_join_build_side_cost if nullptr
+ * @Param num_threads The number of host threads, 0 for the default
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename key_type, typename size_type = int>
+void host_inner_hash_join(std::vector<key_type> const & left_keys,
+                          std::vector<key_type> const & right_keys,
+                          std::vector<size_type> & output_left,
+                          std::vector<size_type> & output_right,
+                          gdf_hash_table_stats * stats = nullptr,
+                          size_t left_distinct_keys = 0,
+                          size_t right_distinct_keys = 0,
+                          join_build_side_cost_fn build_side_cost = nullptr,
+                          unsigned int num_threads = 0)
+{
+  using map_type = host_join_multimap_t<key_type, size_type>;
+
+  join_side_info left_info;
+  left_info.num_rows = left_keys.size();
+  left_info.num_distinct_keys = left_distinct_keys;
+  join_side_info right_info;
+  right_info.num_rows = right_keys.size();
+  right_info.num_distinct_keys = right_distinct_keys;
+
+  const bool swap_sides = join_build_on_left(left_info, right_info,
+                                             sizeof(typename map_type::value_type),
+                                             HostJoinOccupancy,
+                                             build_side_cost);
+
+  std::vector<key_type> const & build_keys = swap_sides ? left_keys : right_keys;
+  std::vector<key_type> const & probe_keys = swap_sides ? right_keys : left_keys;
+
+  auto build_map = host_build_join_map<key_type, size_type>(build_keys, num_threads);
+  host_hash_join<false>(*build_map, probe_keys,
+                        swap_sides ? output_right : output_left,
+                        swap_sides ? output_left : output_right,
+                        num_threads);
+
+  if (nullptr != stats) {
+    compute_host_hash_table_stats<linear_probing>(build_map->size(),
+        [&build_map](size_t i) { return build_map->begin()[i].first.load(); },
+        map_type::get_unused_key(),
+        typename map_type::hasher(),
+        stats);
+    stats->num_hash_collisions = 0;
+    stats->build_side_swapped = swap_sides ? 1 : 0;
+  }
+}
+
+#endif // HOST_HASH_JOIN_H
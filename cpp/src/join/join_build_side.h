@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JOIN_BUILD_SIDE_H
+#define JOIN_BUILD_SIDE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "cudf.h"
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  What is known about one side of a join when choosing the side the
+ * hash table is built on
+ */
+/* ----------------------------------------------------------------------------*/
+struct join_side_info
+{
+  size_t num_rows{0};           ///< The number of rows of the side
+  size_t num_distinct_keys{0};  ///< The number of distinct keys, or 0 if unknown
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The memory of the join multimap built on num_build_rows rows.
+ *
+ * @Param num_build_rows The number of rows inserted in the multimap
+ * @Param entry_size The size of a slot, i.e., sizeof(multimap_type::value_type)
+ * @Param occupancy_percent The target occupancy of the multimap
+ *
+ * @Returns The size in bytes of the slots of the multimap
+ */
+/* ----------------------------------------------------------------------------*/
+inline size_t join_hash_table_memory(size_t num_build_rows,
+                                     size_t entry_size,
+                                     int64_t occupancy_percent)
+{
+  const size_t num_slots = std::max<size_t>(1, (num_build_rows * 100) / occupancy_percent);
+  return num_slots * entry_size;
+}
+
+/// Cost hook of a candidate build side, the public gdf_join_build_side_cost.
+/// Returns the cost of building the hash table on a side and probing it with
+/// the other side, lower is better.
+typedef gdf_join_build_side_cost join_build_side_cost_fn;
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The default cost of a build side, in bytes of hash table touched.
+ *
+ * Building writes every slot of the multimap (they are initialized, then
+ * filled), and a probe reads one slot per build row sharing its key before
+ * reaching an empty slot. When the number of distinct build keys is known, the
+ * mean number of build rows per key is the expected length of that run;
+ * otherwise every key is assumed to be unique. With no key statistics, the
+ * cheaper side is always the smaller one. The distinct keys of the probe side
+ * do not change the cost.
+ */
+/* ----------------------------------------------------------------------------*/
+inline double default_join_build_side_cost(size_t build_rows,
+                                           size_t build_distinct_keys,
+                                           size_t probe_rows,
+                                           size_t probe_distinct_keys,
+                                           size_t entry_size,
+                                           int64_t occupancy_percent)
+{
+  const double build_cost = static_cast<double>(
+      join_hash_table_memory(build_rows, entry_size, occupancy_percent));
+
+  double rows_per_key{1.0};
+  if (build_distinct_keys > 0 && build_rows > 0) {
+    rows_per_key = std::max(1.0, static_cast<double>(build_rows) / build_distinct_keys);
+  }
+  const double probe_cost = static_cast<double>(probe_rows) * rows_per_key * entry_size;
+
+  return build_cost + probe_cost;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Chooses the side of an inner join the hash table is built on.
+ *
+ * The hash table is built on the right side unless building it on the left
+ * side is strictly cheaper, so that ties keep the order of the inputs.
+ *
+ * @Param left What is known about the left side
+ * @Param right What is known about the right side
+ * @Param entry_size The size of a slot of the multimap
+ * @Param occupancy_percent The target occupancy of the multimap
+ * @Param cost The cost hook, default_join_build_side_cost if nullptr
+ *
+ * @Returns true if the hash table should be built on the left side, in which
+ * case the sides are swapped and the output indices flipped
+ */
+/* ----------------------------------------------------------------------------*/
+inline bool join_build_on_left(join_side_info const & left,
+                               join_side_info const & right,
+                               size_t entry_size,
+                               int64_t occupancy_percent,
+                               join_build_side_cost_fn cost = nullptr)
+{
+  if (nullptr == cost) cost = default_join_build_side_cost;
+  return cost(left.num_rows, left.num_distinct_keys, right.num_rows, right.num_distinct_keys,
+              entry_size, occupancy_percent)
+         < cost(right.num_rows, right.num_distinct_keys, left.num_rows, left.num_distinct_keys,
+                entry_size, occupancy_percent);
+}
+
+#endif // JOIN_BUILD_SIDE_H
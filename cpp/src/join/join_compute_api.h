@@ -20,13 +20,17 @@
 #include "join_kernels.cuh"
 
 #include "dataframe/cudf_table.cuh"
+#include "hash/hash_probing.cuh"
+#include "hash/hash_table_stats.cuh"
 #include "rmm/rmm.h"
 #include "utilities/error_utils.h"
 
 #include <thrust/copy.h>
+#include <thrust/count.h>
 #include <thrust/execution_policy.h>
 #include <thrust/functional.h>
 #include <thrust/iterator/counting_iterator.h>
+#include <thrust/scan.h>
 
 // TODO for Arrow integration:
 //   1) replace mgpu::context_t with a new CudaComputeContext class (see the design doc)
@@ -197,13 +201,15 @@ gdf_error append_full_join_indices(
  * @Param probe_table The left hand table
  * @Param hash_table A hash table built on the build table that maps the index
  * of every row to the hash value of that row.
+ * @tparam hash_function The row hash function the hash table was built with
  * 
  * @Returns An estimate of the size of the output of the join operation
  */
 /* ----------------------------------------------------------------------------*/
 template <JoinType join_type,
           typename multimap_type,
-          typename size_type>
+          typename size_type,
+          template <typename> class hash_function = default_hash>
 gdf_error estimate_join_output_size(gdf_table<size_type> const & build_table,
                                     gdf_table<size_type> const & probe_table,
                                     multimap_type const & hash_table,
@@ -277,7 +283,8 @@ gdf_error estimate_join_output_size(gdf_table<size_type> const & build_table,
                              multimap_type,
                              size_type,
                              block_size,
-                             DEFAULT_CUDA_CACHE_SIZE>
+                             DEFAULT_CUDA_CACHE_SIZE,
+                             hash_function>
     <<<probe_grid_size, block_size>>>(&hash_table,
                                       build_table,
                                       probe_table,
@@ -322,41 +329,18 @@ gdf_error estimate_join_output_size(gdf_table<size_type> const & build_table,
 
 /* --------------------------------------------------------------------------*/
 /**
-* @Synopsis  Performs a hash-based join between two sets of gdf_tables.
-*
-* @Param joined_output The output of the join operation
-* @Param left_table The left table to join
-* @Param right_table The right table to join
-* @Param flip_results Flag that indicates whether the left and right tables have been
-* switched, indicating that the output indices should also be flipped
-* @tparam join_type The type of join to be performed
-* @tparam hash_value_type The data type to be used for the Keys in the hash table
-* @tparam output_index_type The data type to be used for the output indices
-* @tparam size_type The data type used for size calculations, e.g. size of hash table
+* @Synopsis  The hash table of the hash-based joins: a multimap from the hash value
+* of a build row to its row index.
 *
-* @Returns  cudaSuccess upon successful completion of the join. Otherwise returns
-* the appropriate CUDA error code
+* The LEGACY allocator allocates the hash table array with normal cudaMalloc,
+* the non-legacy allocator uses managed memory
 */
 /* ----------------------------------------------------------------------------*/
-template<JoinType join_type,
-         typename output_index_type,
-         typename size_type>
-gdf_error compute_hash_join(
-                            gdf_column * const output_l, 
-                            gdf_column * const output_r,
-                            gdf_table<size_type> const & left_table,
-                            gdf_table<size_type> const & right_table,
-                            bool flip_results = false)
-{
-  gdf_error gdf_error_code{GDF_SUCCESS};
-
-  gdf_column_view(output_l, nullptr, nullptr, 0, N_GDF_TYPES);
-  gdf_column_view(output_r, nullptr, nullptr, 0, N_GDF_TYPES);
-
-  // The LEGACY allocator allocates the hash table array with normal cudaMalloc,
-  // the non-legacy allocator uses managed memory
 #ifdef HT_LEGACY_ALLOCATOR
-  using multimap_type = concurrent_unordered_multimap<hash_value_type,
+template <typename hash_value_type,
+          typename output_index_type,
+          typename size_type>
+using join_multimap_t = concurrent_unordered_multimap<hash_value_type,
                                                       output_index_type,
                                                       size_type,
                                                       std::numeric_limits<hash_value_type>::max(),
@@ -365,31 +349,34 @@ gdf_error compute_hash_join(
                                                       equal_to<hash_value_type>,
                                                       legacy_allocator< thrust::pair<hash_value_type, output_index_type> > >;
 #else
-  using multimap_type = concurrent_unordered_multimap<hash_value_type,
+template <typename hash_value_type,
+          typename output_index_type,
+          typename size_type>
+using join_multimap_t = concurrent_unordered_multimap<hash_value_type,
                                                       output_index_type,
                                                       size_type,
                                                       std::numeric_limits<hash_value_type>::max(),
                                                       std::numeric_limits<output_index_type>::max()>;
 #endif
-  //If FULL_JOIN is selected then we process as LEFT_JOIN till we need to take care of unmatched indices
-  constexpr JoinType base_join_type = (join_type == JoinType::FULL_JOIN)? JoinType::LEFT_JOIN : join_type;
 
-  // Hash table will be built on the right table
-  gdf_table<size_type> const & build_table{right_table};
+/* --------------------------------------------------------------------------*/
+/**
+* @Synopsis  Inserts the valid rows of the build table into a join hash table.
+*
+* @Param hash_table The hash table, sized for the build table
+* @Param build_table The table to build the hash table on
+* @tparam hash_function The row hash function, whose values are the keys of the hash table
+*
+* @Returns GDF_SUCCESS, or GDF_HASH_TABLE_INSERT_FAILURE if the table is too small
+*/
+/* ----------------------------------------------------------------------------*/
+template <typename multimap_type,
+          typename size_type,
+          template <typename> class hash_function = default_hash>
+gdf_error build_join_hash_table(multimap_type * hash_table,
+                                gdf_table<size_type> const & build_table)
+{
   const size_type build_table_num_rows{build_table.get_column_length()};
-  
-  // Probe with the left table
-  gdf_table<size_type> const & probe_table{left_table};
-  const size_type probe_table_num_rows{probe_table.get_column_length()};
-
-  // Calculate size of hash map based on the desired occupancy
-  size_type hash_table_size{(build_table_num_rows * 100) / DEFAULT_HASH_TABLE_OCCUPANCY};
-
-  // It's possible that the hash table size will be zero, in which case
-  // we still need to allocate something.
-  hash_table_size = std::max(hash_table_size, size_type(1));
- 
-  std::unique_ptr<multimap_type> hash_table(new multimap_type(hash_table_size));
 
   // FIXME: use GPU device id from the context?
   // but moderngpu only provides cudaDeviceProp
@@ -398,6 +385,11 @@ gdf_error compute_hash_join(
 
   CUDA_TRY( cudaDeviceSynchronize() );
 
+  if(0 == build_table_num_rows)
+  {
+    return GDF_SUCCESS;
+  }
+
   // Allocate a gdf_error for the device to hold error code returned from
   // the build kernel and intialize with GDF_SUCCESS
   // Use Page Locked memory to avoid overhead of memcpys
@@ -406,106 +398,235 @@ gdf_error compute_hash_join(
   *d_gdf_error_code = GDF_SUCCESS;
 
   constexpr int block_size{DEFAULT_CUDA_BLOCK_SIZE};
+  const size_type build_grid_size{(build_table_num_rows + block_size - 1)/block_size};
+  build_hash_table<multimap_type, size_type, hash_function>
+  <<<build_grid_size, block_size>>>(hash_table,
+                                    build_table,
+                                    build_table_num_rows,
+                                    d_gdf_error_code);
+
+  // Device synch is required to ensure d_gdf_error_code 
+  // has been written
+  CUDA_TRY( cudaDeviceSynchronize() );
 
-  // build the hash table
-  if(build_table_num_rows > 0)
-  {
-    const size_type build_grid_size{(build_table_num_rows + block_size - 1)/block_size};
-    build_hash_table<<<build_grid_size, block_size>>>(hash_table.get(),
-                                                      build_table,
-                                                      build_table_num_rows,
-                                                      d_gdf_error_code);
-    
-    // Device synch is required to ensure d_gdf_error_code 
-    // has been written
-    CUDA_TRY( cudaDeviceSynchronize() );
-  }
+  const gdf_error gdf_error_code{*d_gdf_error_code};
 
-  // Check error code from the kernel
-  gdf_error_code = *d_gdf_error_code;
-  if(GDF_SUCCESS != gdf_error_code){
-    return gdf_error_code;
-  }
+  // Free the device error code
+  CUDA_TRY( cudaFreeHost(d_gdf_error_code) );
 
+  return gdf_error_code;
+}
 
-  size_type estimated_join_output_size{0};
-  gdf_error_code = estimate_join_output_size<base_join_type, multimap_type>(build_table, probe_table, *hash_table, &estimated_join_output_size);
+/* --------------------------------------------------------------------------*/
+/**
+* @Synopsis  Probes a prebuilt join hash table with a probe table and gathers the
+* joined pairs of row indices.
+*
+* The hash table is not modified, so a table built once may be probed with any
+* number of probe tables.
+*
+* @Param hash_table The multimap of the row hash values of build_table
+* @Param build_table The table the hash table was built on
+* @Param probe_table The table to probe the hash table with
+* @Param output_l The probe row indices of the joined rows, or the build row
+* indices if flip_results is true
+* @Param output_r The build row indices of the joined rows, or the probe row
+* indices if flip_results is true
+* @Param flip_results Flag that indicates whether the output indices should be
+* flipped
+* @Param hash_table_stats If not nullptr, its num_hash_collisions receives the
+* number of probed pairs of rows with equal hash values and unequal rows
+* @Param exact_output_size See compute_hash_join
+* @tparam join_type The type of join to be performed
+* @tparam output_index_type The data type to be used for the output indices
+* @tparam size_type The data type used for size calculations
+* @tparam hash_function The row hash function the hash table is keyed on
+*
+* @Returns  GDF_SUCCESS upon successful completion of the probe. Otherwise returns
+* the appropriate error code
+*/
+/* ----------------------------------------------------------------------------*/
+template<JoinType join_type,
+         typename output_index_type,
+         typename size_type,
+         template <typename> class hash_function = default_hash>
+gdf_error probe_join_hash_table(
+                            join_multimap_t<hash_result_t<hash_function>, output_index_type, size_type> const * hash_table,
+                            gdf_table<size_type> const & build_table,
+                            gdf_table<size_type> const & probe_table,
+                            gdf_column * const output_l,
+                            gdf_column * const output_r,
+                            bool flip_results = false,
+                            gdf_hash_table_stats * hash_table_stats = nullptr,
+                            bool exact_output_size = false)
+{
+  gdf_error gdf_error_code{GDF_SUCCESS};
 
-  if(GDF_SUCCESS != gdf_error_code){
-    return gdf_error_code;
-  }
+  gdf_column_view(output_l, nullptr, nullptr, 0, N_GDF_TYPES);
+  gdf_column_view(output_r, nullptr, nullptr, 0, N_GDF_TYPES);
 
-  // If the estimated output size is zero, return immediately
-  if(0 == estimated_join_output_size){
-    return GDF_SUCCESS;
+  using hash_value_type = hash_result_t<hash_function>;
+  using multimap_type = join_multimap_t<hash_value_type, output_index_type, size_type>;
+
+  //If FULL_JOIN is selected then we process as LEFT_JOIN till we need to take care of unmatched indices
+  constexpr JoinType base_join_type = (join_type == JoinType::FULL_JOIN)? JoinType::LEFT_JOIN : join_type;
+
+  const size_type build_table_num_rows{build_table.get_column_length()};
+  const size_type probe_table_num_rows{probe_table.get_column_length()};
+
+  constexpr int block_size{DEFAULT_CUDA_BLOCK_SIZE};
+
+  // Device counter of the probed pairs of rows with equal hash values and unequal rows
+  unsigned long long *d_hash_collisions{nullptr};
+  if(nullptr != hash_table_stats){
+    RMM_TRY( RMM_ALLOC((void**)&d_hash_collisions, sizeof(unsigned long long), 0) );
+    CUDA_TRY( cudaMemsetAsync(d_hash_collisions, 0, sizeof(unsigned long long), 0) );
   }
 
-  // Because we are approximating the number of joined elements, our approximation 
-  // might be incorrect and we might have underestimated the number of joined elements. 
-  // As such we will need to de-allocate memory and re-allocate memory to ensure 
-  // that the final output is correct.
+  size_type estimated_join_output_size{0};
   size_type h_actual_found{0};
   output_index_type *output_l_ptr{nullptr};
   output_index_type *output_r_ptr{nullptr};
-  bool cont = true;
 
-  // Allocate device global counter used by threads to determine output write location
-  size_type *d_global_write_index{nullptr};
-  RMM_TRY( RMM_ALLOC((void**)&d_global_write_index, sizeof(size_type), 0) ); // TODO non-default stream?
- 
-  // Because we only have an estimate of the output size, we may need to probe the
-  // hash table multiple times until we've found an output buffer size that is large enough
-  // to hold the output
-  while(cont)
+  const size_type probe_grid_size{(probe_table_num_rows + block_size -1)/block_size};
+
+  if(exact_output_size)
   {
-    output_l_ptr = nullptr;
-    output_r_ptr = nullptr;
+    // Count the output rows of every probe row. The exclusive scan of the counts
+    // is the offset of the output rows of each probe row, and its last element
+    // the output size
+    Vector<size_type> row_output_offsets(probe_table_num_rows + 1, 0);
 
-    // Allocate temporary device buffer for join output
-    RMM_TRY( RMM_ALLOC((void**)&output_l_ptr, estimated_join_output_size*sizeof(output_index_type), 0) );
-    RMM_TRY( RMM_ALLOC((void**)&output_r_ptr, estimated_join_output_size*sizeof(output_index_type), 0) );
-    CUDA_TRY( cudaMemsetAsync(d_global_write_index, 0, sizeof(size_type), 0) );
+    count_join_output_rows<base_join_type, multimap_type, size_type, hash_function>
+    <<<probe_grid_size, block_size>>> (hash_table,
+                                       build_table,
+                                       probe_table,
+                                       probe_table_num_rows,
+                                       row_output_offsets.data().get());
+    CUDA_TRY( cudaGetLastError() );
 
-    const size_type probe_grid_size{(probe_table_num_rows + block_size -1)/block_size};
-    
-    // Do the probe of the hash table with the probe table and generate the output for the join
-    probe_hash_table<base_join_type,
-                     multimap_type,
-                     hash_value_type,
-                     size_type,
-                     output_index_type,
-                     block_size,
-                     DEFAULT_CUDA_CACHE_SIZE>
-    <<<probe_grid_size, block_size>>> (hash_table.get(),
+    rmm_temp_allocator allocator(0);
+    thrust::exclusive_scan(thrust::cuda::par(allocator).on(0),
+                           row_output_offsets.begin(),
+                           row_output_offsets.end(),
+                           row_output_offsets.begin());
+
+    h_actual_found = row_output_offsets.back();
+    estimated_join_output_size = h_actual_found;
+
+    if(0 == h_actual_found){
+      if(nullptr != d_hash_collisions){
+        RMM_TRY( RMM_FREE(d_hash_collisions, 0) );
+      }
+      return GDF_SUCCESS;
+    }
+
+    RMM_TRY( RMM_ALLOC((void**)&output_l_ptr, h_actual_found*sizeof(output_index_type), 0) );
+    RMM_TRY( RMM_ALLOC((void**)&output_r_ptr, h_actual_found*sizeof(output_index_type), 0) );
+
+    write_join_output<base_join_type, multimap_type, size_type, output_index_type, hash_function>
+    <<<probe_grid_size, block_size>>> (hash_table,
                                        build_table,
                                        probe_table,
-                                       probe_table.get_column_length(),
+                                       probe_table_num_rows,
+                                       row_output_offsets.data().get(),
                                        output_l_ptr,
                                        output_r_ptr,
-                                       d_global_write_index,
-                                       estimated_join_output_size,
-                                       flip_results);
-
+                                       flip_results,
+                                       d_hash_collisions);
     CUDA_TRY( cudaGetLastError() );
+  }
+  else
+  {
+    gdf_error_code = estimate_join_output_size<base_join_type, multimap_type, size_type, hash_function>(build_table, probe_table, *hash_table, &estimated_join_output_size);
 
-    CUDA_TRY( cudaMemcpy(&h_actual_found, d_global_write_index, sizeof(size_type), cudaMemcpyDeviceToHost));
+    if(GDF_SUCCESS != gdf_error_code){
+      return gdf_error_code;
+    }
 
-    // The estimate was too small. Double the estimate and try again
-    if(estimated_join_output_size < h_actual_found){
-      cont = true;
-      estimated_join_output_size *= 2;
-      // Free the old buffers to prevent a memory leak on the new allocation
-      RMM_TRY( RMM_FREE(output_l_ptr, 0) );
-      RMM_TRY( RMM_FREE(output_r_ptr, 0) );
+    // If the estimated output size is zero, return immediately
+    if(0 == estimated_join_output_size){
+      if(nullptr != d_hash_collisions){
+        RMM_TRY( RMM_FREE(d_hash_collisions, 0) );
+      }
+      return GDF_SUCCESS;
     }
-    else
+
+    // Because we are approximating the number of joined elements, our approximation 
+    // might be incorrect and we might have underestimated the number of joined elements. 
+    // As such we will need to de-allocate memory and re-allocate memory to ensure 
+    // that the final output is correct.
+    bool cont = true;
+
+    // Allocate device global counter used by threads to determine output write location
+    size_type *d_global_write_index{nullptr};
+    RMM_TRY( RMM_ALLOC((void**)&d_global_write_index, sizeof(size_type), 0) ); // TODO non-default stream?
+
+    // Because we only have an estimate of the output size, we may need to probe the
+    // hash table multiple times until we've found an output buffer size that is large enough
+    // to hold the output
+    while(cont)
     {
-      cont = false;
+      output_l_ptr = nullptr;
+      output_r_ptr = nullptr;
+
+      // Allocate temporary device buffer for join output
+      RMM_TRY( RMM_ALLOC((void**)&output_l_ptr, estimated_join_output_size*sizeof(output_index_type), 0) );
+      RMM_TRY( RMM_ALLOC((void**)&output_r_ptr, estimated_join_output_size*sizeof(output_index_type), 0) );
+      CUDA_TRY( cudaMemsetAsync(d_global_write_index, 0, sizeof(size_type), 0) );
+      if(nullptr != d_hash_collisions){
+        CUDA_TRY( cudaMemsetAsync(d_hash_collisions, 0, sizeof(unsigned long long), 0) );
+      }
+
+      // Do the probe of the hash table with the probe table and generate the output for the join
+      probe_hash_table<base_join_type,
+                       multimap_type,
+                       hash_value_type,
+                       size_type,
+                       output_index_type,
+                       block_size,
+                       DEFAULT_CUDA_CACHE_SIZE,
+                       hash_function>
+      <<<probe_grid_size, block_size>>> (hash_table,
+                                         build_table,
+                                         probe_table,
+                                         probe_table.get_column_length(),
+                                         output_l_ptr,
+                                         output_r_ptr,
+                                         d_global_write_index,
+                                         estimated_join_output_size,
+                                         flip_results,
+                                         0,
+                                         d_hash_collisions);
+
+      CUDA_TRY( cudaGetLastError() );
+
+      CUDA_TRY( cudaMemcpy(&h_actual_found, d_global_write_index, sizeof(size_type), cudaMemcpyDeviceToHost));
+
+      // The estimate was too small. Double the estimate and try again
+      if(estimated_join_output_size < h_actual_found){
+        cont = true;
+        estimated_join_output_size *= 2;
+        // Free the old buffers to prevent a memory leak on the new allocation
+        RMM_TRY( RMM_FREE(output_l_ptr, 0) );
+        RMM_TRY( RMM_FREE(output_r_ptr, 0) );
+      }
+      else
+      {
+        cont = false;
+      }
     }
+
+    RMM_TRY( RMM_FREE(d_global_write_index, 0) );
   }
 
   // free memory used for the counters
-  RMM_TRY( RMM_FREE(d_global_write_index, 0) );
+  if(nullptr != d_hash_collisions){
+    unsigned long long h_hash_collisions{0};
+    CUDA_TRY( cudaMemcpy(&h_hash_collisions, d_hash_collisions, sizeof(unsigned long long), cudaMemcpyDeviceToHost) );
+    hash_table_stats->num_hash_collisions = h_hash_collisions;
+    RMM_TRY( RMM_FREE(d_hash_collisions, 0) );
+  }
 
   if (join_type == JoinType::FULL_JOIN) {
       append_full_join_indices(
@@ -532,9 +653,6 @@ gdf_error compute_hash_join(
       output_r_ptr = copy_output_r_ptr;
   }
 
-  // Free the device error code
-  CUDA_TRY( cudaFreeHost(d_gdf_error_code) );
-
   // Deduce the type of the output gdf_columns
   gdf_dtype dtype;
   switch(sizeof(output_index_type))
@@ -549,3 +667,190 @@ gdf_error compute_hash_join(
 
   return gdf_error_code;
 }
+
+/* --------------------------------------------------------------------------*/
+/**
+* @Synopsis  Performs a hash-based join between two sets of gdf_tables.
+*
+* @Param joined_output The output of the join operation
+* @Param left_table The left table to join
+* @Param right_table The right table to join
+* @Param flip_results Flag that indicates whether the left and right tables have been
+* switched, indicating that the output indices should also be flipped
+* @Param hash_table_stats If not nullptr, receives the statistics of the hash table
+* built on the right table. The hash collisions are counted while probing.
+* @Param exact_output_size If true, the output is sized exactly by a first pass that
+* counts the output rows of every probe row, and the second pass writes the rows of
+* each probe row from the exclusive scan of the counts, in probe row order. Otherwise
+* the output size is estimated from a sample, and the probe is repeated with a
+* larger buffer if the estimate was too small.
+* @tparam join_type The type of join to be performed
+* @tparam output_index_type The data type to be used for the output indices
+* @tparam size_type The data type used for size calculations, e.g. size of hash table
+* @tparam hash_function The row hash function. The keys of the hash table are its
+* values, so MurmurHash3_64 keys the table on 64-bit hash values.
+*
+* @Returns  cudaSuccess upon successful completion of the join. Otherwise returns
+* the appropriate CUDA error code
+*/
+/* ----------------------------------------------------------------------------*/
+template<JoinType join_type,
+         typename output_index_type,
+         typename size_type,
+         template <typename> class hash_function = default_hash>
+gdf_error compute_hash_join(
+                            gdf_column * const output_l, 
+                            gdf_column * const output_r,
+                            gdf_table<size_type> const & left_table,
+                            gdf_table<size_type> const & right_table,
+                            bool flip_results = false,
+                            gdf_hash_table_stats * hash_table_stats = nullptr,
+                            bool exact_output_size = false)
+{
+  gdf_error gdf_error_code{GDF_SUCCESS};
+
+  gdf_column_view(output_l, nullptr, nullptr, 0, N_GDF_TYPES);
+  gdf_column_view(output_r, nullptr, nullptr, 0, N_GDF_TYPES);
+
+  using hash_value_type = hash_result_t<hash_function>;
+  using multimap_type = join_multimap_t<hash_value_type, output_index_type, size_type>;
+
+  // Hash table will be built on the right table
+  gdf_table<size_type> const & build_table{right_table};
+  const size_type build_table_num_rows{build_table.get_column_length()};
+  
+  // Probe with the left table
+  gdf_table<size_type> const & probe_table{left_table};
+
+  // Calculate size of hash map based on the desired occupancy
+  size_type hash_table_size{(build_table_num_rows * 100) / DEFAULT_HASH_TABLE_OCCUPANCY};
+
+  // It's possible that the hash table size will be zero, in which case
+  // we still need to allocate something.
+  hash_table_size = std::max(hash_table_size, size_type(1));
+ 
+  std::unique_ptr<multimap_type> hash_table(new multimap_type(hash_table_size));
+
+  // build the hash table
+  gdf_error_code = build_join_hash_table<multimap_type, size_type, hash_function>(hash_table.get(), build_table);
+  if(GDF_SUCCESS != gdf_error_code){
+    return gdf_error_code;
+  }
+
+  // The keys of the multimap are the row hash values, and the probe sequence
+  // of a key starts at key % size
+  if(nullptr != hash_table_stats){
+    gdf_error_code = compute_hash_table_stats<linear_probing>(hash_table->data(),
+                                                              hash_table_size,
+                                                              multimap_type::get_unused_key(),
+                                                              thrust::identity<hash_value_type>(),
+                                                              false,
+                                                              hash_table_stats);
+    if(GDF_SUCCESS != gdf_error_code){
+      return gdf_error_code;
+    }
+  }
+
+  return probe_join_hash_table<join_type, output_index_type, size_type, hash_function>(
+                            hash_table.get(),
+                            build_table,
+                            probe_table,
+                            output_l,
+                            output_r,
+                            flip_results,
+                            hash_table_stats,
+                            exact_output_size);
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+* @Synopsis  Performs a hash-based left semi-join or left anti-join between two
+* gdf_tables: selects the rows of the left table that have (semi) or do not
+* have (anti) an equal row in the right table.
+*
+* The hash table is built on the right table, and each left row stops probing
+* at its first match. A left row is selected at most once, so the output is
+* bounded by the left table and is computed in a single pass. The output is
+* in increasing order of the left row indices.
+*
+* @Param output_l The selected left row indices
+* @Param left_table The left table to select the rows of
+* @Param right_table The right table to search the rows in
+* @tparam anti_join If true, selects the left rows without a match. A left row
+* with a NULL never has a match, so an anti-join selects it.
+* @tparam output_index_type The data type to be used for the output indices
+* @tparam size_type The data type used for size calculations
+* @tparam hash_function The row hash function the hash table is keyed on
+*
+* @Returns GDF_SUCCESS upon successful completion, otherwise the appropriate error code
+*/
+/* ----------------------------------------------------------------------------*/
+template<bool anti_join,
+         typename output_index_type,
+         typename size_type,
+         template <typename> class hash_function = default_hash>
+gdf_error compute_hash_existence_join(gdf_column * const output_l,
+                                      gdf_table<size_type> const & left_table,
+                                      gdf_table<size_type> const & right_table)
+{
+  using hash_value_type = hash_result_t<hash_function>;
+  using multimap_type = join_multimap_t<hash_value_type, output_index_type, size_type>;
+
+  const size_type left_table_num_rows{left_table.get_column_length()};
+  const size_type right_table_num_rows{right_table.get_column_length()};
+
+  // Whether each left row is selected
+  Vector<bool> selected(left_table_num_rows, anti_join);
+
+  if(right_table_num_rows > 0)
+  {
+    // Calculate size of hash map based on the desired occupancy
+    const size_type hash_table_size{(right_table_num_rows * 100) / DEFAULT_HASH_TABLE_OCCUPANCY};
+    std::unique_ptr<multimap_type> hash_table(new multimap_type(hash_table_size));
+
+    gdf_error gdf_error_code = build_join_hash_table<multimap_type, size_type, hash_function>(hash_table.get(),
+                                                                                           right_table);
+    if(GDF_SUCCESS != gdf_error_code){
+      return gdf_error_code;
+    }
+
+    constexpr int block_size{DEFAULT_CUDA_BLOCK_SIZE};
+    const size_type probe_grid_size{(left_table_num_rows + block_size - 1)/block_size};
+    probe_hash_table_existence<anti_join, multimap_type, size_type, hash_function>
+    <<<probe_grid_size, block_size>>>(hash_table.get(),
+                                      right_table,
+                                      left_table,
+                                      left_table_num_rows,
+                                      selected.data().get());
+    CUDA_TRY( cudaGetLastError() );
+  }
+
+  // Compact the selected row indices
+  const size_type output_size = thrust::count(thrust::device, selected.begin(), selected.end(), true);
+
+  output_index_type * output_l_ptr{nullptr};
+  if(output_size > 0)
+  {
+    RMM_TRY( RMM_ALLOC((void**)&output_l_ptr, output_size*sizeof(output_index_type), 0) );
+    thrust::copy_if(thrust::device,
+                    thrust::make_counting_iterator(output_index_type{0}),
+                    thrust::make_counting_iterator(static_cast<output_index_type>(left_table_num_rows)),
+                    selected.begin(),
+                    output_l_ptr,
+                    thrust::identity<bool>());
+    CUDA_TRY( cudaGetLastError() );
+  }
+
+  // Deduce the type of the output gdf_column
+  gdf_dtype dtype;
+  switch(sizeof(output_index_type))
+  {
+    case 1 : dtype = GDF_INT8;  break;
+    case 2 : dtype = GDF_INT16; break;
+    case 4 : dtype = GDF_INT32; break;
+    case 8 : dtype = GDF_INT64; break;
+  }
+  gdf_column_view(output_l, output_l_ptr, nullptr, output_size, dtype);
+
+  return GDF_SUCCESS;
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JOIN_HASH_TABLE_CUH
+#define JOIN_HASH_TABLE_CUH
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "cudf.h"
+#include "dataframe/cudf_table.cuh"
+#include "join_compute_api.h"
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  A join hash table built once on a set of build columns and probed
+ * with any number of probe tables, the implementation behind the
+ * gdf_join_hash_table handle.
+ *
+ * The handle keeps a copy of the build gdf_column structs, but not of their
+ * data, which must stay valid until the handle is freed.
+ *
+ * @tparam size_type The data type used for size calculations
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename size_type>
+class join_hash_table
+{
+public:
+  virtual ~join_hash_table() = default;
+
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  Probes the hash table with a probe table
+   *
+   * @Param probe_table The table to probe with, of the dtypes of the build columns
+   * @Param join_type INNER_JOIN or LEFT_JOIN, where a probe row without a match
+   * has one output row whose build index is -1
+   * @Param probe_result The probe row indices of the joined rows
+   * @Param build_result The build row indices of the joined rows
+   * @Param hash_table_stats If not nullptr, receives the number of hash collisions
+   * of this probe
+   * @Param exact_output_size See compute_hash_join
+   *
+   * @Returns GDF_SUCCESS, or the error code of the probe
+   */
+  /* ----------------------------------------------------------------------------*/
+  virtual gdf_error probe(gdf_table<size_type> const & probe_table,
+                          JoinType join_type,
+                          gdf_column * probe_result,
+                          gdf_column * build_result,
+                          gdf_hash_table_stats * hash_table_stats,
+                          bool exact_output_size) const = 0;
+
+  size_type num_build_rows() const { return build_table->get_column_length(); }
+
+  int num_columns() const { return static_cast<int>(build_columns.size()); }
+
+  gdf_dtype column_dtype(int i) const { return build_columns[i].dtype; }
+
+protected:
+  join_hash_table(gdf_column ** columns, int num_cols)
+    : build_columns(num_cols), build_column_ptrs(num_cols)
+  {
+    for(int i = 0; i < num_cols; ++i) {
+      build_columns[i] = *columns[i];
+      build_column_ptrs[i] = &build_columns[i];
+    }
+    build_table.reset(new gdf_table<size_type>(num_cols, build_column_ptrs.data()));
+  }
+
+  std::vector<gdf_column> build_columns;
+  std::vector<gdf_column*> build_column_ptrs;
+  std::unique_ptr<gdf_table<size_type>> build_table;
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The device join hash table, a join multimap of the row hash values
+ * of the build columns.
+ *
+ * @tparam output_index_type The data type used for the output indices
+ * @tparam size_type The data type used for size calculations
+ * @tparam hash_function The row hash function the hash table is keyed on
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename output_index_type,
+          typename size_type,
+          template <typename> class hash_function = default_hash>
+class device_join_hash_table : public join_hash_table<size_type>
+{
+public:
+  using hash_value_type = hash_result_t<hash_function>;
+  using multimap_type = join_multimap_t<hash_value_type, output_index_type, size_type>;
+
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  Builds the hash table of a set of build columns
+   *
+   * @Param columns The build columns
+   * @Param num_cols The number of build columns
+   * @Param[out] table The new hash table
+   * @Param hash_table_stats If not nullptr, receives the statistics of the hash table
+   *
+   * @Returns GDF_SUCCESS, or the error code of the build, in which case table is
+   * not set
+   */
+  /* ----------------------------------------------------------------------------*/
+  static gdf_error create(gdf_column ** columns,
+                          int num_cols,
+                          std::unique_ptr<join_hash_table<size_type>> * table,
+                          gdf_hash_table_stats * hash_table_stats = nullptr)
+  {
+    std::unique_ptr<device_join_hash_table> new_table(new device_join_hash_table(columns, num_cols));
+
+    const size_type build_table_num_rows{new_table->num_build_rows()};
+
+    // Calculate size of hash map based on the desired occupancy
+    const size_type hash_table_size{std::max(size_type(1),
+        static_cast<size_type>((build_table_num_rows * 100) / DEFAULT_HASH_TABLE_OCCUPANCY))};
+    new_table->hash_table.reset(new multimap_type(hash_table_size));
+
+    gdf_error gdf_error_code = build_join_hash_table<multimap_type, size_type, hash_function>(
+        new_table->hash_table.get(), *new_table->build_table);
+    if(GDF_SUCCESS != gdf_error_code){
+      return gdf_error_code;
+    }
+
+    if(nullptr != hash_table_stats){
+      gdf_error_code = compute_hash_table_stats<linear_probing>(new_table->hash_table->data(),
+                                                                hash_table_size,
+                                                                multimap_type::get_unused_key(),
+                                                                thrust::identity<hash_value_type>(),
+                                                                false,
+                                                                hash_table_stats);
+      if(GDF_SUCCESS != gdf_error_code){
+        return gdf_error_code;
+      }
+    }
+
+    table->reset(new_table.release());
+    return GDF_SUCCESS;
+  }
+
+  gdf_error probe(gdf_table<size_type> const & probe_table,
+                  JoinType join_type,
+                  gdf_column * probe_result,
+                  gdf_column * build_result,
+                  gdf_hash_table_stats * hash_table_stats,
+                  bool exact_output_size) const override
+  {
+    if(JoinType::LEFT_JOIN == join_type){
+      return probe_join_hash_table<JoinType::LEFT_JOIN, output_index_type, size_type, hash_function>(
+          hash_table.get(), *this->build_table, probe_table, probe_result, build_result,
+          false, hash_table_stats, exact_output_size);
+    }
+    if(JoinType::INNER_JOIN == join_type){
+      return probe_join_hash_table<JoinType::INNER_JOIN, output_index_type, size_type, hash_function>(
+          hash_table.get(), *this->build_table, probe_table, probe_result, build_result,
+          false, hash_table_stats, exact_output_size);
+    }
+    return GDF_INVALID_API_CALL;
+  }
+
+private:
+  device_join_hash_table(gdf_column ** columns, int num_cols)
+    : join_hash_table<size_type>(columns, num_cols) {}
+
+  std::unique_ptr<multimap_type> hash_table;
+};
+
+#endif // JOIN_HASH_TABLE_CUH
@@ -41,11 +41,13 @@ enum class JoinType {
 * @Param[in] build_table The table to build the hash table on
 * @Param[in] build_table_num_rows The number of rows in the build table
 * @tparam multimap_type The type of the hash table
+* @tparam hash_function The row hash function, whose values are the keys of the hash table
 * 
 */
 /* ----------------------------------------------------------------------------*/
 template<typename multimap_type,
-         typename size_type>
+         typename size_type,
+         template <typename> class hash_function = default_hash>
 __global__ void build_hash_table( multimap_type * const multi_map,
                                   gdf_table<size_type> const & build_table,
                                   const size_type build_table_num_rows,
@@ -60,7 +62,8 @@ __global__ void build_hash_table( multimap_type * const multi_map,
       if (build_table.is_row_valid(i)) {
 
         // Compute the hash value of this row
-        const hash_value_type row_hash_value{build_table.hash_row(i)};
+        const typename multimap_type::key_type row_hash_value{
+          build_table.template hash_row<hash_function>(i)};
 
         // Insert the (row hash value, row index) into the map
         // using the row hash value to determine the location in the 
@@ -122,6 +125,7 @@ __inline__ __device__ void add_pair_to_cache(const output_index_type first,
   @tparam multimap_type The datatype of the hash table
   @tparam block_size The number of threads in a thread block for the kernel
   @tparam output_cache_size The size of the shared memory cache for caching the join output results
+  @tparam hash_function The row hash function, whose values are the keys of the hash table
 * 
 */
 /* ----------------------------------------------------------------------------*/
@@ -129,7 +133,8 @@ template< JoinType join_type,
           typename multimap_type,
           typename size_type,
           int block_size,
-          int output_cache_size>
+          int output_cache_size,
+          template <typename> class hash_function = default_hash>
 __global__ void compute_join_output_size( multimap_type const * const multi_map,
                                           gdf_table<size_type> const & build_table,
                                           gdf_table<size_type> const & probe_table,
@@ -158,11 +163,11 @@ __global__ void compute_join_output_size( multimap_type const * const multi_map,
     // Search the hash map for the hash value of the probe row using the row's
     // hash value to determine the location where to search for the row in the hash map
     // Only probe the hash table if the probe row is valid
-    hash_value_type probe_row_hash_value{0};
+    typename multimap_type::key_type probe_row_hash_value{0};
     if(probe_table.is_row_valid(probe_row_index))
     {
       // Search the hash map for the hash value of the probe row
-      probe_row_hash_value = probe_table.hash_row(probe_row_index);
+      probe_row_hash_value = probe_table.template hash_row<hash_function>(probe_row_index);
       found = multi_map->find(probe_row_hash_value,
                               true,
                               probe_row_hash_value);
@@ -249,11 +254,14 @@ __global__ void compute_join_output_size( multimap_type const * const multi_map,
  * @Param[in,out] current_idx A global counter used by threads to coordinate writes to the global output
  * @Param[in] max_size The maximum size of the output
  * @Param[in] offset An optional offset
+ * @Param[in,out] hash_collisions If not nullptr, counts the (probe row, build row)
+ * pairs with equal hash values and unequal rows
  * @tparam join_type The type of join to be performed
  * @tparam multimap_type The type of the hash table
  * @tparam output_index_type The datatype used for the indices in the output arrays
  * @tparam block_size The number of threads per block for this kernel
  * @tparam output_cache_size The side of the shared memory buffer to cache join output results
+ * @tparam hash_function The row hash function, whose values are the keys of the hash table
  * 
  */
 /* ----------------------------------------------------------------------------*/
@@ -263,7 +271,8 @@ template< JoinType join_type,
           typename size_type,
           typename output_index_type,
           size_type block_size,
-          size_type output_cache_size>
+          size_type output_cache_size,
+          template <typename> class hash_function = default_hash>
 __global__ void probe_hash_table( multimap_type const * const multi_map,
                                   gdf_table<size_type> const & build_table,
                                   gdf_table<size_type> const & probe_table,
@@ -273,7 +282,8 @@ __global__ void probe_hash_table( multimap_type const * const multi_map,
                                   size_type* current_idx,
                                   const size_type max_size,
                                   bool flip_results,
-                                  const output_index_type offset = 0)
+                                  const output_index_type offset = 0,
+                                  unsigned long long * hash_collisions = nullptr)
 {
   constexpr int num_warps = block_size/warp_size;
   __shared__ size_type current_idx_shared[num_warps];
@@ -313,11 +323,11 @@ __global__ void probe_hash_table( multimap_type const * const multi_map,
     // hash value to determine the location where to search for the row in the hash map
 
     // Only probe the hash table if the probe row is valid
-    hash_value_type probe_row_hash_value{0};
+    key_type probe_row_hash_value{0};
     if(probe_table.is_row_valid(probe_row_index))
     {
       // Search the hash map for the hash value of the probe row
-      probe_row_hash_value = probe_table.hash_row(probe_row_index);
+      probe_row_hash_value = probe_table.template hash_row<hash_function>(probe_row_index);
       found = multi_map->find(probe_row_hash_value,
                                    true,
                                    probe_row_hash_value);
@@ -356,6 +366,10 @@ __global__ void probe_hash_table( multimap_type const * const multi_map,
             const output_index_type probe_index{offset + probe_row_index};
             add_pair_to_cache(probe_index, found->second, current_idx_shared, warp_id, join_shared_l[warp_id], join_shared_r[warp_id]);
           }
+          else if( nullptr != hash_collisions )
+          {
+            atomicAdd(hash_collisions, 1ull);
+          }
           // Continue searching for matching rows until you hit an empty hash map entry
           ++found;
           // If you hit the end of the hash map, wrap around to the beginning
@@ -455,6 +469,259 @@ __global__ void probe_hash_table( multimap_type const * const multi_map,
   }
 }
 
+/* --------------------------------------------------------------------------*/
+/** 
+* @Synopsis  Calls f with the build row index of every build row equal to a probe
+  row, in the order of the hash table entries.
+* 
+* @Param[in] multi_map The hash table built on the build table
+* @Param[in] build_table The build table
+* @Param[in] probe_table The probe table
+* @Param[in] probe_row_index The probe row to search for
+* @Param[in] f The functor called with each matching build row index
+* @Param[in,out] hash_collisions If not nullptr, counts the build rows with the
+  hash value of the probe row that are not equal to it
+* @tparam hash_function The row hash function, whose values are the keys of the hash table
+* 
+* @Returns The number of matching build rows
+*/
+/* ----------------------------------------------------------------------------*/
+template< typename multimap_type,
+          typename size_type,
+          template <typename> class hash_function,
+          typename match_function>
+__device__ size_type for_each_join_match( multimap_type const * const multi_map,
+                                          gdf_table<size_type> const & build_table,
+                                          gdf_table<size_type> const & probe_table,
+                                          const size_type probe_row_index,
+                                          match_function f,
+                                          unsigned long long * hash_collisions = nullptr)
+{
+  using key_type = typename multimap_type::key_type;
+
+  size_type num_matches{0};
+
+  // A row with a NULL value cannot match any other row
+  if(false == probe_table.is_row_valid(probe_row_index))
+    return num_matches;
+
+  const auto unused_key = multi_map->get_unused_key();
+  const auto end = multi_map->end();
+
+  const key_type probe_row_hash_value{
+    probe_table.template hash_row<hash_function>(probe_row_index)};
+
+  auto found = multi_map->find(probe_row_hash_value,
+                               true,
+                               probe_row_hash_value);
+
+  // Search the entries until an empty hash table entry
+  while( (end != found) && (unused_key != found->first) )
+  {
+    if( found->first == probe_row_hash_value )
+    {
+      if( true == probe_table.rows_equal(build_table, probe_row_index, found->second) )
+      {
+        f(found->second);
+        ++num_matches;
+      }
+      else if( nullptr != hash_collisions )
+      {
+        atomicAdd(hash_collisions, 1ull);
+      }
+    }
+    ++found;
+    // If you hit the end of the hash map, wrap around to the beginning
+    if(end == found)
+      found = multi_map->begin();
+  }
+
+  return num_matches;
+}
+
+/* --------------------------------------------------------------------------*/
+/** 
+* @Synopsis  First pass of the exactly sized join: counts the output rows of each
+  probe row. A probe row of a left join without a match has one output row.
+* 
+* @Param[in] multi_map The hash table built on the build table
+* @Param[in] build_table The build table
+* @Param[in] probe_table The probe table
+* @Param[in] probe_table_num_rows The number of rows in the probe table
+* @Param[out] row_output_counts The number of output rows of each probe row
+  @tparam join_type The type of join to be performed
+  @tparam multimap_type The datatype of the hash table
+  @tparam hash_function The row hash function, whose values are the keys of the hash table
+* 
+*/
+/* ----------------------------------------------------------------------------*/
+template< JoinType join_type,
+          typename multimap_type,
+          typename size_type,
+          template <typename> class hash_function = default_hash>
+__global__ void count_join_output_rows( multimap_type const * const multi_map,
+                                        gdf_table<size_type> const & build_table,
+                                        gdf_table<size_type> const & probe_table,
+                                        const size_type probe_table_num_rows,
+                                        size_type * const row_output_counts)
+{
+  size_type probe_row_index = threadIdx.x + blockIdx.x * blockDim.x;
+
+  while( probe_row_index < probe_table_num_rows )
+  {
+    size_type num_matches = for_each_join_match<multimap_type, size_type, hash_function>(
+        multi_map, build_table, probe_table, probe_row_index,
+        [] __device__ (size_type) {});
+
+    if( (join_type == JoinType::LEFT_JOIN) && (0 == num_matches) )
+      num_matches = 1;
+
+    row_output_counts[probe_row_index] = num_matches;
+
+    probe_row_index += blockDim.x * gridDim.x;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/** 
+* @Synopsis  Second pass of the exactly sized join: writes the output rows of each
+  probe row from its output offset, so that the output is in probe row order and
+  no global counter is needed.
+* 
+* @Param[in] multi_map The hash table built on the build table
+* @Param[in] build_table The build table
+* @Param[in] probe_table The probe table
+* @Param[in] probe_table_num_rows The number of rows in the probe table
+* @Param[in] row_output_offsets The exclusive scan of the counts of count_join_output_rows
+* @Param[out] join_output_l The left result of the join operation
+* @Param[out] join_output_r The right result of the join operation
+* @Param[in] flip_results Whether the probe table is the right table
+* @Param[in,out] hash_collisions If not nullptr, counts the (probe row, build row)
+  pairs with equal hash values and unequal rows
+  @tparam join_type The type of join to be performed
+  @tparam multimap_type The datatype of the hash table
+  @tparam output_index_type The datatype used for the indices in the output arrays
+  @tparam hash_function The row hash function, whose values are the keys of the hash table
+* 
+*/
+/* ----------------------------------------------------------------------------*/
+template< JoinType join_type,
+          typename multimap_type,
+          typename size_type,
+          typename output_index_type,
+          template <typename> class hash_function = default_hash>
+__global__ void write_join_output( multimap_type const * const multi_map,
+                                   gdf_table<size_type> const & build_table,
+                                   gdf_table<size_type> const & probe_table,
+                                   const size_type probe_table_num_rows,
+                                   size_type const * const row_output_offsets,
+                                   output_index_type * join_output_l,
+                                   output_index_type * join_output_r,
+                                   bool flip_results,
+                                   unsigned long long * hash_collisions = nullptr)
+{
+  output_index_type * const output_probe = flip_results ? join_output_r : join_output_l;
+  output_index_type * const output_build = flip_results ? join_output_l : join_output_r;
+
+  size_type probe_row_index = threadIdx.x + blockIdx.x * blockDim.x;
+
+  while( probe_row_index < probe_table_num_rows )
+  {
+    size_type output_index = row_output_offsets[probe_row_index];
+
+    const size_type num_matches = for_each_join_match<multimap_type, size_type, hash_function>(
+        multi_map, build_table, probe_table, probe_row_index,
+        [&] __device__ (size_type build_row_index) {
+          output_probe[output_index] = static_cast<output_index_type>(probe_row_index);
+          output_build[output_index] = static_cast<output_index_type>(build_row_index);
+          ++output_index;
+        },
+        hash_collisions);
+
+    // If performing a LEFT join and no match was found, insert a Null into the output
+    if( (join_type == JoinType::LEFT_JOIN) && (0 == num_matches) )
+    {
+      output_probe[output_index] = static_cast<output_index_type>(probe_row_index);
+      output_build[output_index] = static_cast<output_index_type>(JoinNoneValue);
+    }
+
+    probe_row_index += blockDim.x * gridDim.x;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/** 
+* @Synopsis  Probes the hash map with the probe table to find whether each probe
+  row has an equal row in the build table. The search of a row stops at its
+  first match.
+* 
+* @Param[in] multi_map The hash table built on the build table
+* @Param[in] build_table The build table
+* @Param[in] probe_table The probe table
+* @Param[in] probe_table_num_rows The number of rows in the probe table
+* @Param[out] probe_row_selected For each probe row, whether it has a match, or
+  whether it has none if anti_join is true
+* @tparam anti_join Selects the probe rows without a match rather than with one
+* @tparam multimap_type The type of the hash table
+* @tparam hash_function The row hash function, whose values are the keys of the hash table
+* 
+*/
+/* ----------------------------------------------------------------------------*/
+template< bool anti_join,
+          typename multimap_type,
+          typename size_type,
+          template <typename> class hash_function = default_hash>
+__global__ void probe_hash_table_existence( multimap_type const * const multi_map,
+                                            gdf_table<size_type> const & build_table,
+                                            gdf_table<size_type> const & probe_table,
+                                            const size_type probe_table_num_rows,
+                                            bool * const probe_row_selected)
+{
+  using key_type = typename multimap_type::key_type;
+
+  const auto unused_key = multi_map->get_unused_key();
+  const auto end = multi_map->end();
+
+  size_type probe_row_index = threadIdx.x + blockIdx.x * blockDim.x;
+
+  while( probe_row_index < probe_table_num_rows )
+  {
+    bool found_match = false;
+
+    // A row with a NULL value cannot match any other row
+    if(probe_table.is_row_valid(probe_row_index))
+    {
+      const key_type probe_row_hash_value{
+        probe_table.template hash_row<hash_function>(probe_row_index)};
+
+      auto found = multi_map->find(probe_row_hash_value,
+                                   true,
+                                   probe_row_hash_value);
+
+      // Search the entries until the first equal row or an empty hash table entry
+      while( (end != found) && (unused_key != found->first) && (false == found_match) )
+      {
+        if( (found->first == probe_row_hash_value) &&
+            (true == probe_table.rows_equal(build_table, probe_row_index, found->second)) )
+        {
+          found_match = true;
+        }
+        else
+        {
+          ++found;
+          // If you hit the end of the hash map, wrap around to the beginning
+          if(end == found)
+            found = multi_map->begin();
+        }
+      }
+    }
+
+    probe_row_selected[probe_row_index] = (found_match != anti_join);
+
+    probe_row_index += blockDim.x * gridDim.x;
+  }
+}
+
 /*
    // TODO This kernel still needs to be updated to work with an arbitrary number of columns
 template<
@@ -19,13 +19,23 @@
 #include <set>
 #include <vector>
 
+#include <thrust/for_each.h>
+#include <thrust/sequence.h>
+#include <thrust/transform.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
+
 #include "cudf.h"
 #include "rmm/rmm.h"
 #include "utilities/error_utils.h"
 #include "dataframe/cudf_table.cuh"
+#include "hash/hash_partition.cuh"
+#include "sqls/sqls_rtti_comp.h"
 #include "utilities/nvtx/nvtx_utils.h"
 
 #include "joining.h"
+#include "join_hash_table.cuh"
+#include "chunked_probe.h"
 
 using namespace mgpu;
 
@@ -43,25 +53,421 @@ constexpr output_index_type MAX_JOIN_SIZE{std::numeric_limits<output_index_type>
  * @Param rightcol The right set of columns to join
  * @Param l_result The join computed indices of the left table
  * @Param r_result The join computed indices of the right table
+ * @Param hash_table_stats If not nullptr, receives the statistics of the hash table
+ * @Param exact_output_size If true, size the output exactly with a counting pass
+ * instead of estimating it
+ * @Param left_distinct_keys The number of distinct keys of the left table, 0 if unknown
+ * @Param right_distinct_keys The number of distinct keys of the right table, 0 if unknown
+ * @Param build_side_cost The cost hook choosing the build side of an inner join,
+ * default_join_build_side_cost if nullptr
  * @tparam join_type The type of join to be performed
  * @tparam size_type The data type used for size calculations
+ * @tparam hash_function The row hash function the hash table is keyed on,
+ * MurmurHash3_64 keys it on 64-bit row hash values
  * 
  * @Returns Upon successful computation, returns GDF_SUCCESS. Otherwise returns appropriate error code 
  */
 /* ----------------------------------------------------------------------------*/
 template <JoinType join_type, 
-          typename size_type>
+          typename size_type,
+          template <typename> class hash_function = default_hash>
 gdf_error hash_join(size_type num_cols, gdf_column **leftcol, gdf_column **rightcol,
-                    gdf_column *l_result, gdf_column *r_result)
+                    gdf_column *l_result, gdf_column *r_result,
+                    gdf_hash_table_stats *hash_table_stats = nullptr,
+                    bool exact_output_size = false,
+                    size_t left_distinct_keys = 0,
+                    size_t right_distinct_keys = 0,
+                    join_build_side_cost_fn build_side_cost = nullptr)
 {
   // Wrap the set of gdf_columns in a gdf_table class
   std::unique_ptr< gdf_table<size_type> > left_table(new gdf_table<size_type>(num_cols, leftcol));
   std::unique_ptr< gdf_table<size_type> > right_table(new gdf_table<size_type>(num_cols, rightcol));
 
-  return join_hash<join_type, output_index_type>(*left_table, 
-                                                        *right_table, 
-                                                        l_result, 
-                                                        r_result);
+  return join_hash<join_type, output_index_type, hash_function>(*left_table, 
+                                                                *right_table, 
+                                                                l_result, 
+                                                                r_result,
+                                                                false,
+                                                                hash_table_stats,
+                                                                exact_output_size,
+                                                                left_distinct_keys,
+                                                                right_distinct_keys,
+                                                                build_side_cost);
+}
+
+// Seed of the hash function that assigns rows to the partitions of a partitioned
+// join. It differs from the seed of the hash table of a partition, so the rows
+// of a partition are spread over the whole table.
+constexpr uint32_t JOIN_PARTITION_SEED{1};
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  The number of partitions of a partitioned hash join.
+ *
+ * By default, a partition holds as many build rows as keep its hash table in
+ * half of the L2 cache, leaving the other half to the rows streaming through.
+ * The number of partitions is a power of two, to compute the partition of a
+ * row with a bitwise AND, and is bounded by the shared memory histogram of
+ * the partitioning kernel.
+ * 
+ * @Param build_table_num_rows The number of rows of the build table
+ * @Param max_partition_rows The largest number of build rows in a partition,
+ * or 0 to size the partitions for the L2 cache
+ * @Param num_partitions The number of partitions
+ * @tparam hash_value_type The type of the keys of the hash table
+ * @tparam index_type The type of the values of the hash table
+ * 
+ * @Returns GDF_SUCCESS, or the error of a failed device query
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename hash_value_type,
+          typename index_type,
+          typename size_type>
+gdf_error compute_num_join_partitions(const size_type build_table_num_rows,
+                                      size_t max_partition_rows,
+                                      int * num_partitions)
+{
+  int device{0};
+  int l2_size{0};
+  int max_shared_memory{0};
+  CUDA_TRY( cudaGetDevice(&device) );
+  CUDA_TRY( cudaDeviceGetAttribute(&l2_size, cudaDevAttrL2CacheSize, device) );
+  CUDA_TRY( cudaDeviceGetAttribute(&max_shared_memory, cudaDevAttrMaxSharedMemoryPerBlock, device) );
+
+  if(0 == max_partition_rows)
+  {
+    const size_t entry_size{sizeof(thrust::pair<hash_value_type, index_type>)};
+    max_partition_rows = (static_cast<size_t>(l2_size) / 2) * DEFAULT_HASH_TABLE_OCCUPANCY / (100 * entry_size);
+    max_partition_rows = std::max(max_partition_rows, size_t{1});
+  }
+
+  const size_t min_partitions{(build_table_num_rows + max_partition_rows - 1) / max_partition_rows};
+  const size_t max_partitions{static_cast<size_t>(max_shared_memory) / sizeof(int)};
+
+  size_t partitions{1};
+  while((partitions < min_partitions) && (2 * partitions <= max_partitions))
+  {
+    partitions *= 2;
+  }
+  *num_partitions = static_cast<int>(partitions);
+
+  return GDF_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Hash partitions the row indices of a table, such that the rows of
+ * partition p are row_indices[partition_offsets[p], partition_offsets[p + 1]).
+ * 
+ * @Param num_cols The number of columns to hash
+ * @Param cols The columns to hash
+ * @Param num_partitions The number of partitions
+ * @Param[out] row_indices The row indices of the table, ordered by partition
+ * @Param[out] partition_offsets The num_partitions + 1 offsets of the partitions
+ * @tparam hash_function The hash function that assigns the rows to the partitions
+ * 
+ * @Returns GDF_SUCCESS upon successful partitioning, otherwise the appropriate error code
+ */
+/* ----------------------------------------------------------------------------*/
+template <template <typename> class hash_function>
+gdf_error partition_join_rows(int num_cols, gdf_column **cols,
+                              const int num_partitions,
+                              Vector<output_index_type> & row_indices,
+                              std::vector<int> & partition_offsets)
+{
+  // The partitioning kernels keep a histogram of int counters in shared memory
+  using partition_size_type = int;
+
+  const partition_size_type num_rows = cols[0]->size;
+
+  // Partition a column of row indices by the hash values of the columns
+  Vector<output_index_type> input_row_indices(num_rows);
+  thrust::sequence(thrust::device, input_row_indices.begin(), input_row_indices.end());
+  row_indices.resize(num_rows);
+
+  gdf_dtype index_dtype{(8 == sizeof(output_index_type)) ? GDF_INT64 : GDF_INT32};
+  gdf_column input_column{};
+  gdf_column output_column{};
+  gdf_column_view(&input_column, input_row_indices.data().get(), nullptr, num_rows, index_dtype);
+  gdf_column_view(&output_column, row_indices.data().get(), nullptr, num_rows, index_dtype);
+  gdf_column * input_columns[] = {&input_column};
+  gdf_column * output_columns[] = {&output_column};
+
+  std::unique_ptr< gdf_table<partition_size_type> > table_to_hash(new gdf_table<partition_size_type>(num_cols, cols));
+  std::unique_ptr< gdf_table<partition_size_type> > input_table(new gdf_table<partition_size_type>(1, input_columns));
+  std::unique_ptr< gdf_table<partition_size_type> > output_table(new gdf_table<partition_size_type>(1, output_columns));
+
+  partition_offsets.assign(num_partitions + 1, num_rows);
+  gdf_error gdf_error_code = hash_partition_gdf_table<hash_function>(*input_table,
+                                                                     *table_to_hash,
+                                                                     num_partitions,
+                                                                     partition_offsets.data(),
+                                                                     *output_table,
+                                                                     JOIN_PARTITION_SEED);
+  CUDA_TRY( cudaDeviceSynchronize() );
+
+  return gdf_error_code;
+}
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  The rows of one side of a partitioned join: the row indices of the
+ * table ordered by partition, and buffers that hold the columns of one partition.
+ */
+/* ----------------------------------------------------------------------------*/
+struct join_partitions
+{
+  Vector<output_index_type> row_indices;
+  std::vector<int> offsets;
+
+  std::vector<Vector<char>> data;
+  std::vector<Vector<gdf_valid_type>> valids;
+  std::vector<gdf_column> partition_columns;
+  std::vector<gdf_column*> partition_column_pointers;
+
+  int partition_size(int p) const { return offsets[p + 1] - offsets[p]; }
+
+  output_index_type const * partition_rows(int p) const { return row_indices.data().get() + offsets[p]; }
+
+  /* --------------------------------------------------------------------------*/
+  /** 
+   * @Synopsis  Allocates the buffers of the columns of a partition, large enough
+   * for the largest partition
+   */
+  /* ----------------------------------------------------------------------------*/
+  gdf_error allocate_partition_columns(int num_cols, gdf_column **cols)
+  {
+    int max_partition_size{0};
+    for(size_t p = 0; p + 1 < offsets.size(); ++p)
+    {
+      max_partition_size = std::max(max_partition_size, partition_size(p));
+    }
+
+    data.resize(num_cols);
+    valids.resize(num_cols);
+    partition_columns.resize(num_cols);
+    partition_column_pointers.resize(num_cols);
+    for(int i = 0; i < num_cols; ++i)
+    {
+      int col_width{0};
+      gdf_error gdf_error_code = get_column_byte_width(cols[i], &col_width);
+      if(GDF_SUCCESS != gdf_error_code) return gdf_error_code;
+
+      data[i].resize(static_cast<size_t>(max_partition_size) * col_width);
+      if(nullptr != cols[i]->valid)
+      {
+        valids[i].resize(gdf_get_num_chars_bitmask(max_partition_size));
+      }
+      gdf_column_view(&partition_columns[i], data[i].data().get(),
+                      (nullptr != cols[i]->valid) ? valids[i].data().get() : nullptr,
+                      max_partition_size, cols[i]->dtype);
+      partition_column_pointers[i] = &partition_columns[i];
+    }
+    return GDF_SUCCESS;
+  }
+
+  /* --------------------------------------------------------------------------*/
+  /** 
+   * @Synopsis  Gathers the rows of partition p of the table into the buffers
+   * of the partition columns
+   */
+  /* ----------------------------------------------------------------------------*/
+  template <typename size_type>
+  gdf_error gather_partition(gdf_table<size_type> & table, int p)
+  {
+    const int num_rows = partition_size(p);
+    for(size_t i = 0; i < partition_columns.size(); ++i)
+    {
+      partition_columns[i].size = num_rows;
+      // The gathered validity bits are OR-ed into the mask
+      if(nullptr != partition_columns[i].valid)
+      {
+        CUDA_TRY( cudaMemset(partition_columns[i].valid, 0, gdf_get_num_chars_bitmask(num_rows)) );
+      }
+    }
+    std::unique_ptr< gdf_table<size_type> > partition_table(
+        new gdf_table<size_type>(partition_column_pointers.size(), partition_column_pointers.data()));
+    return table.gather(partition_rows(p), *partition_table);
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Maps the row indices of a partition to the row indices of the table,
+ * leaving JoinNoneValue unchanged
+ */
+/* ----------------------------------------------------------------------------*/
+struct partition_row_to_table_row
+{
+  output_index_type const * partition_rows;
+
+  __device__
+  output_index_type operator()(output_index_type partition_row) const
+  {
+    return (partition_row < 0) ? partition_row : partition_rows[partition_row];
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis Computes the Join result between two tables using the radix-partitioned
+ * hash-based implementation.
+ *
+ * Both tables are hash partitioned on the join columns, with enough partitions
+ * for the hash table of each partition of the build table to stay in the L2
+ * cache. Matching rows fall in the same partition, so each pair of partitions is
+ * joined independently with the hash join, and the probes of a partition hit the
+ * cache rather than device memory. The row indices of the partitions are mapped
+ * back to the row indices of the tables, and the output is ordered by partition.
+ * 
+ * @Param num_cols The number of columns to join
+ * @Param leftcol The left set of columns to join
+ * @Param rightcol The right set of columns to join
+ * @Param l_result The join computed indices of the left table
+ * @Param r_result The join computed indices of the right table
+ * @Param max_partition_rows The largest number of build rows in a partition, or 0
+ * to size the partitions for the L2 cache
+ * @tparam join_type The type of join to be performed
+ * @tparam size_type The data type used for size calculations
+ * @tparam hash_function The row hash function of the partitioning and the hash tables
+ * 
+ * @Returns Upon successful computation, returns GDF_SUCCESS. Otherwise returns appropriate error code 
+ */
+/* ----------------------------------------------------------------------------*/
+template <JoinType join_type, 
+          typename size_type,
+          template <typename> class hash_function = default_hash>
+gdf_error partitioned_hash_join(size_type num_cols, gdf_column **leftcol, gdf_column **rightcol,
+                                gdf_column *l_result, gdf_column *r_result,
+                                size_t max_partition_rows)
+{
+  const size_type left_num_rows{leftcol[0]->size};
+  const size_type right_num_rows{rightcol[0]->size};
+
+  // The hash table is built on the right table, or on the smaller table of an inner join
+  const size_type build_num_rows = (JoinType::INNER_JOIN == join_type) ?
+                                   std::min(left_num_rows, right_num_rows) : right_num_rows;
+
+  int num_partitions{1};
+  gdf_error gdf_error_code = compute_num_join_partitions<hash_result_t<hash_function>, output_index_type>(
+      build_num_rows, max_partition_rows, &num_partitions);
+  if(GDF_SUCCESS != gdf_error_code) return gdf_error_code;
+
+  // A single partition is the hash join
+  if((1 == num_partitions) || (0 == left_num_rows) || (0 == right_num_rows))
+  {
+    return hash_join<join_type, size_type, hash_function>(num_cols, leftcol, rightcol, l_result, r_result);
+  }
+
+  join_partitions left_partitions;
+  join_partitions right_partitions;
+  gdf_error_code = partition_join_rows<hash_function>(num_cols, leftcol, num_partitions,
+                                                      left_partitions.row_indices,
+                                                      left_partitions.offsets);
+  if(GDF_SUCCESS != gdf_error_code) return gdf_error_code;
+  gdf_error_code = partition_join_rows<hash_function>(num_cols, rightcol, num_partitions,
+                                                      right_partitions.row_indices,
+                                                      right_partitions.offsets);
+  if(GDF_SUCCESS != gdf_error_code) return gdf_error_code;
+
+  gdf_error_code = left_partitions.allocate_partition_columns(num_cols, leftcol);
+  if(GDF_SUCCESS != gdf_error_code) return gdf_error_code;
+  gdf_error_code = right_partitions.allocate_partition_columns(num_cols, rightcol);
+  if(GDF_SUCCESS != gdf_error_code) return gdf_error_code;
+
+  std::unique_ptr< gdf_table<size_type> > left_table(new gdf_table<size_type>(num_cols, leftcol));
+  std::unique_ptr< gdf_table<size_type> > right_table(new gdf_table<size_type>(num_cols, rightcol));
+
+  // The join of each pair of partitions, in row indices of the tables
+  std::vector<Vector<output_index_type>> partition_l_results(num_partitions);
+  std::vector<Vector<output_index_type>> partition_r_results(num_partitions);
+  size_t output_size{0};
+
+  for(int p = 0; p < num_partitions; ++p)
+  {
+    const int left_partition_size = left_partitions.partition_size(p);
+    const int right_partition_size = right_partitions.partition_size(p);
+    output_index_type const * const left_rows = left_partitions.partition_rows(p);
+    output_index_type const * const right_rows = right_partitions.partition_rows(p);
+
+    Vector<output_index_type> & l_rows = partition_l_results[p];
+    Vector<output_index_type> & r_rows = partition_r_results[p];
+
+    if((0 == left_partition_size) || (0 == right_partition_size))
+    {
+      // Without rows on one side, only the outer rows of the other side remain
+      const bool keep_left = (0 < left_partition_size) && (JoinType::INNER_JOIN != join_type);
+      const bool keep_right = (0 < right_partition_size) && (JoinType::FULL_JOIN == join_type);
+      if(keep_left)
+      {
+        l_rows.assign(thrust::device_pointer_cast(left_rows),
+                      thrust::device_pointer_cast(left_rows + left_partition_size));
+        r_rows.assign(left_partition_size, JoinNoneValue);
+      }
+      else if(keep_right)
+      {
+        l_rows.assign(right_partition_size, JoinNoneValue);
+        r_rows.assign(thrust::device_pointer_cast(right_rows),
+                      thrust::device_pointer_cast(right_rows + right_partition_size));
+      }
+    }
+    else
+    {
+      gdf_error_code = left_partitions.gather_partition(*left_table, p);
+      if(GDF_SUCCESS != gdf_error_code) return gdf_error_code;
+      gdf_error_code = right_partitions.gather_partition(*right_table, p);
+      if(GDF_SUCCESS != gdf_error_code) return gdf_error_code;
+
+      gdf_column partition_l_result{};
+      gdf_column partition_r_result{};
+      gdf_error_code = hash_join<join_type, size_type, hash_function>(num_cols,
+                                                                      left_partitions.partition_column_pointers.data(),
+                                                                      right_partitions.partition_column_pointers.data(),
+                                                                      &partition_l_result,
+                                                                      &partition_r_result);
+      if(GDF_SUCCESS != gdf_error_code) return gdf_error_code;
+
+      output_index_type * const l_ptr = static_cast<output_index_type*>(partition_l_result.data);
+      output_index_type * const r_ptr = static_cast<output_index_type*>(partition_r_result.data);
+      l_rows.resize(partition_l_result.size);
+      r_rows.resize(partition_r_result.size);
+      thrust::transform(thrust::device, l_ptr, l_ptr + partition_l_result.size, l_rows.begin(),
+                        partition_row_to_table_row{left_rows});
+      thrust::transform(thrust::device, r_ptr, r_ptr + partition_r_result.size, r_rows.begin(),
+                        partition_row_to_table_row{right_rows});
+      if(nullptr != l_ptr) { RMM_TRY( RMM_FREE(l_ptr, 0) ); }
+      if(nullptr != r_ptr) { RMM_TRY( RMM_FREE(r_ptr, 0) ); }
+    }
+
+    output_size += l_rows.size();
+  }
+
+  if(output_size >= static_cast<size_t>(MAX_JOIN_SIZE)) return GDF_COLUMN_SIZE_TOO_BIG;
+
+  // Concatenate the joins of the partitions
+  output_index_type * output_l_ptr{nullptr};
+  output_index_type * output_r_ptr{nullptr};
+  if(output_size > 0)
+  {
+    RMM_TRY( RMM_ALLOC((void**)&output_l_ptr, output_size * sizeof(output_index_type), 0) );
+    RMM_TRY( RMM_ALLOC((void**)&output_r_ptr, output_size * sizeof(output_index_type), 0) );
+  }
+  size_t output_offset{0};
+  for(int p = 0; p < num_partitions; ++p)
+  {
+    thrust::copy(thrust::device, partition_l_results[p].begin(), partition_l_results[p].end(),
+                 output_l_ptr + output_offset);
+    thrust::copy(thrust::device, partition_r_results[p].begin(), partition_r_results[p].end(),
+                 output_r_ptr + output_offset);
+    output_offset += partition_l_results[p].size();
+  }
+  CUDA_CHECK_LAST();
+
+  gdf_dtype dtype{(8 == sizeof(output_index_type)) ? GDF_INT64 : GDF_INT32};
+  gdf_column_view(l_result, output_l_ptr, nullptr, output_size, dtype);
+  gdf_column_view(r_result, output_r_ptr, nullptr, output_size, dtype);
+
+  return GDF_SUCCESS;
 }
 
 template <JoinType join_type>
@@ -97,6 +503,17 @@ struct SortJoin<JoinType::LEFT_JOIN> {
       }
 };
 
+template <>
+struct SortJoin<JoinType::FULL_JOIN> {
+  template<typename launch_arg_t = mgpu::empty_t,
+    typename a_it, typename b_it, typename comp_t>
+    std::pair<gdf_column, gdf_column>
+    operator()(a_it a, int a_count, b_it b, int b_count,
+               comp_t comp, context_t& context) {
+        return full_join(a, a_count, b, b_count, comp, context);
+      }
+};
+
 template <JoinType join_type, typename T>
 gdf_error sort_join_typed(gdf_column *leftcol, gdf_column *rightcol,
                           gdf_column *left_result, gdf_column *right_result,
@@ -104,8 +521,6 @@ gdf_error sort_join_typed(gdf_column *leftcol, gdf_column *rightcol,
 {
   using namespace mgpu;
   gdf_error err = GDF_SUCCESS;
-  GDF_REQUIRE(!leftcol->valid  || !leftcol->null_count , GDF_VALIDITY_UNSUPPORTED);
-  GDF_REQUIRE(!rightcol->valid || !rightcol->null_count, GDF_VALIDITY_UNSUPPORTED);
 
   rmm_mgpu_context_t context(false);
   SortJoin<join_type> sort_based_join;
@@ -121,11 +536,126 @@ gdf_error sort_join_typed(gdf_column *leftcol, gdf_column *rightcol,
 
 /* --------------------------------------------------------------------------*/
 /** 
- * @Synopsis  Computes the join operation between a single left and single right column
- using the sort based implementation.
+ * @Synopsis  Maps the comparison type of a column for the sort based join. Dates
+ and timestamps compare as the integers they are stored as.
+ */
+/* ----------------------------------------------------------------------------*/
+inline gdf_dtype sort_join_comparison_type(gdf_dtype dtype)
+{
+  switch(dtype){
+    case GDF_DATE32:    return GDF_INT32;
+    case GDF_DATE64:    return GDF_INT64;
+    case GDF_TIMESTAMP: return GDF_INT64;
+    default:            return dtype;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Computes the sort based join of two sets of columns, comparing the
+ rows lexicographically.
+ 
+ If the rows are not known to be sorted, the row order of each table is computed
+ with a multi-column sort, and the merge reads the rows through it. The join is then
+ computed on the sorted positions, which are mapped back to row indices.
  * 
- * @Param leftcol The left column to join
- * @Param rightcol The right column to join
+ * @Param num_cols The number of columns to join
+ * @Param leftcol The left set of columns to join
+ * @Param rightcol The right set of columns to join
+ * @Param left_result The join computed indices of the left table
+ * @Param right_result The join computed indices of the right table
+ * @Param ctxt Structure that determines various run parameters, such as if the inputs
+ are already sorted.
+ * @tparam join_type The type of join to perform
+ * 
+ * @Returns GDF_SUCCESS upon succesful completion of the join, otherwise returns 
+ appropriate error code.
+ */
+/* ----------------------------------------------------------------------------*/
+template <JoinType join_type>
+gdf_error sort_join_multi(int num_cols, gdf_column **leftcol, gdf_column **rightcol,
+                          gdf_column *left_result, gdf_column *right_result,
+                          gdf_context *ctxt)
+{
+  using namespace mgpu;
+  using size_type = output_index_type;
+
+  const size_type left_size = leftcol[0]->size;
+  const size_type right_size = rightcol[0]->size;
+
+  std::vector<void*> host_left_columns(num_cols);
+  std::vector<void*> host_right_columns(num_cols);
+  std::vector<int> host_types(num_cols);
+  for(int i = 0; i < num_cols; ++i) {
+    host_left_columns[i] = leftcol[i]->data;
+    host_right_columns[i] = rightcol[i]->data;
+    host_types[i] = sort_join_comparison_type(leftcol[i]->dtype);
+    switch(host_types[i]){
+      case GDF_INT8: case GDF_INT16: case GDF_INT32: case GDF_INT64:
+      case GDF_FLOAT32: case GDF_FLOAT64: break;
+      default: return GDF_UNSUPPORTED_DTYPE;
+    }
+  }
+  Vector<void*> left_columns(host_left_columns);
+  Vector<void*> right_columns(host_right_columns);
+  Vector<int> types(host_types);
+
+  // Sort the rows of each table, unless they already are
+  Vector<size_type> left_order;
+  Vector<size_type> right_order;
+  if(0 == ctxt->flag_sorted) {
+    left_order.resize(left_size);
+    right_order.resize(right_size);
+    multi_col_order_by<size_type>(left_size, num_cols, left_columns.data().get(),
+                                  types.data().get(), left_order.data().get());
+    multi_col_order_by<size_type>(right_size, num_cols, right_columns.data().get(),
+                                  types.data().get(), right_order.data().get());
+  }
+
+  join_rows_less<size_type> comp{left_columns.data().get(),
+                                 right_columns.data().get(),
+                                 types.data().get(),
+                                 num_cols,
+                                 left_order.empty() ? nullptr : left_order.data().get(),
+                                 right_order.empty() ? nullptr : right_order.data().get()};
+
+  rmm_mgpu_context_t context(false);
+  SortJoin<join_type> sort_based_join;
+  auto output = sort_based_join(thrust::make_counting_iterator<int>(0), left_size,
+                                thrust::make_transform_iterator(thrust::make_counting_iterator<int>(0),
+                                                                encode_right_row{}),
+                                right_size,
+                                comp, context);
+  CUDA_CHECK_LAST();
+
+  // Map the sorted positions back to row indices. -1 marks a missing row
+  if(0 == ctxt->flag_sorted) {
+    size_type * l_data = static_cast<size_type*>(output.first.data);
+    size_type * r_data = static_cast<size_type*>(output.second.data);
+    thrust::transform(thrust::device, l_data, l_data + output.first.size, l_data,
+                      sorted_position_to_row<size_type>{left_order.data().get()});
+    thrust::transform(thrust::device, r_data, r_data + output.second.size, r_data,
+                      sorted_position_to_row<size_type>{right_order.data().get()});
+    CUDA_CHECK_LAST();
+  }
+
+  *left_result = output.first;
+  *right_result = output.second;
+
+  return GDF_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Computes the join operation between two sets of columns using the sort
+ based implementation.
+ 
+ A single column whose rows are sorted is merged directly on its values. Otherwise
+ the rows are compared lexicographically, and sorted first if ctxt->flag_sorted is 0.
+ * 
+ * @Param num_cols The number of columns to join
+ * @Param leftcol The left set of columns to join
+ * @Param rightcol The right set of columns to join
  * @Param left_result The join computed indices of the left table
  * @Param right_result The join computed indices of the right table
  * @Param ctxt Structure that determines various run parameters, such as if the inputs
@@ -137,35 +667,167 @@ gdf_error sort_join_typed(gdf_column *leftcol, gdf_column *rightcol,
  */
 /* ----------------------------------------------------------------------------*/
 template <JoinType join_type>
-gdf_error sort_join(gdf_column *leftcol, gdf_column *rightcol,
+gdf_error sort_join(int num_cols, gdf_column **leftcol, gdf_column **rightcol,
                     gdf_column *l_result, gdf_column *r_result,
                     gdf_context *ctxt)
 {
 
   if(GDF_SORT != ctxt->flag_method) return GDF_INVALID_API_CALL;
 
-  switch ( leftcol->dtype ){
-    case GDF_INT8:      return sort_join_typed<join_type, int8_t>(leftcol, rightcol, l_result, r_result, ctxt);
-    case GDF_INT16:     return sort_join_typed<join_type,int16_t>(leftcol, rightcol, l_result, r_result, ctxt);
-    case GDF_INT32:     return sort_join_typed<join_type,int32_t>(leftcol, rightcol, l_result, r_result, ctxt);
-    case GDF_INT64:     return sort_join_typed<join_type,int64_t>(leftcol, rightcol, l_result, r_result, ctxt);
-    case GDF_FLOAT32:   return sort_join_typed<join_type,int32_t>(leftcol, rightcol, l_result, r_result, ctxt);
-    case GDF_FLOAT64:   return sort_join_typed<join_type,int64_t>(leftcol, rightcol, l_result, r_result, ctxt);
-    case GDF_DATE32:    return sort_join_typed<join_type,int32_t>(leftcol, rightcol, l_result, r_result, ctxt);
-    case GDF_DATE64:    return sort_join_typed<join_type,int64_t>(leftcol, rightcol, l_result, r_result, ctxt);
-    case GDF_TIMESTAMP: return sort_join_typed<join_type,int64_t>(leftcol, rightcol, l_result, r_result, ctxt);
+  for(int i = 0; i < num_cols; ++i) {
+    GDF_REQUIRE(!leftcol[i]->valid  || !leftcol[i]->null_count , GDF_VALIDITY_UNSUPPORTED);
+    GDF_REQUIRE(!rightcol[i]->valid || !rightcol[i]->null_count, GDF_VALIDITY_UNSUPPORTED);
+  }
+
+  if((1 < num_cols) || (0 == ctxt->flag_sorted)) {
+    return sort_join_multi<join_type>(num_cols, leftcol, rightcol, l_result, r_result, ctxt);
+  }
+
+  gdf_column *leftcol0 = leftcol[0];
+  gdf_column *rightcol0 = rightcol[0];
+  switch ( leftcol0->dtype ){
+    case GDF_INT8:      return sort_join_typed<join_type, int8_t>(leftcol0, rightcol0, l_result, r_result, ctxt);
+    case GDF_INT16:     return sort_join_typed<join_type,int16_t>(leftcol0, rightcol0, l_result, r_result, ctxt);
+    case GDF_INT32:     return sort_join_typed<join_type,int32_t>(leftcol0, rightcol0, l_result, r_result, ctxt);
+    case GDF_INT64:     return sort_join_typed<join_type,int64_t>(leftcol0, rightcol0, l_result, r_result, ctxt);
+    case GDF_FLOAT32:   return sort_join_typed<join_type,  float>(leftcol0, rightcol0, l_result, r_result, ctxt);
+    case GDF_FLOAT64:   return sort_join_typed<join_type, double>(leftcol0, rightcol0, l_result, r_result, ctxt);
+    case GDF_DATE32:    return sort_join_typed<join_type,int32_t>(leftcol0, rightcol0, l_result, r_result, ctxt);
+    case GDF_DATE64:    return sort_join_typed<join_type,int64_t>(leftcol0, rightcol0, l_result, r_result, ctxt);
+    case GDF_TIMESTAMP: return sort_join_typed<join_type,int64_t>(leftcol0, rightcol0, l_result, r_result, ctxt);
     default: return GDF_UNSUPPORTED_DTYPE;
   }
 }
 
-template
-gdf_error sort_join<JoinType::INNER_JOIN>(gdf_column *leftcol, gdf_column *rightcol,
-                                          gdf_column *l_result, gdf_column *r_result,
-                                          gdf_context *ctxt);
-template
-gdf_error sort_join<JoinType::LEFT_JOIN>(gdf_column *leftcol, gdf_column *rightcol,
-                                         gdf_column *l_result, gdf_column *r_result,
-                                         gdf_context *ctxt);
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Computes the as-of join of two tables with the sort based merge
+ machinery: every left row is matched with the last right row whose by columns are
+ equal and whose on value is less than or equal to its own.
+ 
+ The rows of each table are ordered by (by..., on), and sorted first if
+ ctxt->flag_sorted is 0. The right rows are then ordered by row index among equal
+ keys, so the last of equal right rows is the one with the largest index, as it is
+ for physically sorted rows. The upper bound of every left row among the right
+ rows, found with a sorted search, is one past its candidate right row.
+ * 
+ * @Param left_on The ordered column of the left table
+ * @Param right_on The ordered column of the right table
+ * @Param left_by The equality columns of the left table
+ * @Param right_by The equality columns of the right table
+ * @Param num_by_cols The number of equality columns
+ * @Param tolerance The largest distance of a match, negative for none
+ * @Param left_result The index of every left row, in order
+ * @Param right_result The matched right row of every left row, or -1
+ * @Param ctxt Structure that determines various run parameters, such as if the inputs
+ are already sorted.
+ * 
+ * @Returns GDF_SUCCESS upon succesful completion of the join, otherwise returns 
+ appropriate error code.
+ */
+/* ----------------------------------------------------------------------------*/
+gdf_error asof_join(gdf_column *left_on, gdf_column *right_on,
+                    gdf_column **left_by, gdf_column **right_by, int num_by_cols,
+                    int64_t tolerance,
+                    gdf_column *left_result, gdf_column *right_result,
+                    gdf_context *ctxt)
+{
+  using namespace mgpu;
+  using size_type = output_index_type;
+
+  const size_type left_size = left_on->size;
+  const size_type right_size = right_on->size;
+  const int num_cols = num_by_cols + 1;
+
+  // The by columns, then the on column
+  std::vector<void*> host_left_columns(num_cols);
+  std::vector<void*> host_right_columns(num_cols);
+  std::vector<int> host_types(num_cols);
+  for(int i = 0; i < num_by_cols; ++i) {
+    host_left_columns[i] = left_by[i]->data;
+    host_right_columns[i] = right_by[i]->data;
+    host_types[i] = sort_join_comparison_type(left_by[i]->dtype);
+    switch(host_types[i]){
+      case GDF_INT8: case GDF_INT16: case GDF_INT32: case GDF_INT64:
+      case GDF_FLOAT32: case GDF_FLOAT64: break;
+      default: return GDF_UNSUPPORTED_DTYPE;
+    }
+  }
+  host_left_columns[num_by_cols] = left_on->data;
+  host_right_columns[num_by_cols] = right_on->data;
+  host_types[num_by_cols] = sort_join_comparison_type(left_on->dtype);
+  if((GDF_INT32 != host_types[num_by_cols]) && (GDF_INT64 != host_types[num_by_cols]))
+    return GDF_UNSUPPORTED_DTYPE;
+
+  Vector<void*> left_columns(host_left_columns);
+  Vector<void*> right_columns(host_right_columns);
+  Vector<int> types(host_types);
+
+  // Sort the rows of each table, unless they already are. The row index of the
+  // right rows breaks the ties of equal right keys.
+  Vector<size_type> left_order;
+  Vector<size_type> right_order;
+  if(0 == ctxt->flag_sorted) {
+    left_order.resize(left_size);
+    multi_col_order_by<size_type>(left_size, num_cols, left_columns.data().get(),
+                                  types.data().get(), left_order.data().get());
+
+    Vector<size_type> right_row_index(right_size);
+    thrust::sequence(thrust::device, right_row_index.begin(), right_row_index.end());
+    host_right_columns.push_back(right_row_index.data().get());
+    host_types.push_back(GDF_INT32);
+    Vector<void*> right_sort_columns(host_right_columns);
+    Vector<int> right_sort_types(host_types);
+
+    right_order.resize(right_size);
+    multi_col_order_by<size_type>(right_size, num_cols + 1, right_sort_columns.data().get(),
+                                  right_sort_types.data().get(), right_order.data().get());
+  }
+
+  join_rows_less<size_type> comp{left_columns.data().get(),
+                                 right_columns.data().get(),
+                                 types.data().get(),
+                                 num_cols,
+                                 left_order.empty() ? nullptr : left_order.data().get(),
+                                 right_order.empty() ? nullptr : right_order.data().get()};
+
+  // One past the last right row less than or equal to each left row
+  rmm_mgpu_context_t context(false);
+  mem_t<int> upper(left_size, context);
+  sorted_search<bounds_upper>(thrust::make_counting_iterator<int>(0), left_size,
+                              thrust::make_transform_iterator(thrust::make_counting_iterator<int>(0),
+                                                              encode_right_row{}),
+                              right_size,
+                              upper.data(), comp, context);
+  CUDA_CHECK_LAST();
+
+  size_type * l_ptr{nullptr};
+  size_type * r_ptr{nullptr};
+  RMM_TRY( RMM_ALLOC((void**)&l_ptr, left_size * sizeof(size_type), 0) );
+  RMM_TRY( RMM_ALLOC((void**)&r_ptr, left_size * sizeof(size_type), 0) );
+
+  join_rows_less<size_type> by_less = comp;
+  by_less.num_columns = num_by_cols;
+
+  thrust::sequence(thrust::device, l_ptr, l_ptr + left_size);
+  thrust::for_each(thrust::device,
+                   thrust::make_counting_iterator<int>(0),
+                   thrust::make_counting_iterator<int>(left_size),
+                   asof_last_preceding<size_type>{by_less,
+                                                  left_on->data,
+                                                  right_on->data,
+                                                  host_types[num_by_cols],
+                                                  upper.data(),
+                                                  tolerance,
+                                                  r_ptr});
+  CUDA_CHECK_LAST();
+
+  gdf_dtype dtype{(8 == sizeof(size_type)) ? GDF_INT64 : GDF_INT32};
+  gdf_column_view(left_result, l_ptr, nullptr, left_size, dtype);
+  gdf_column_view(right_result, r_ptr, nullptr, left_size, dtype);
+
+  return GDF_SUCCESS;
+}
 
 /* --------------------------------------------------------------------------*/
 /**
@@ -346,21 +1008,46 @@ gdf_error join_call( int num_cols, gdf_column **leftcol, gdf_column **rightcol,
   {
     case GDF_HASH:
       {
-        gdf_error_code =  hash_join<join_type, size_type>(num_cols, leftcol, rightcol, left_result, right_result);
+        if(1 == join_context->flag_hash_64bit)
+        {
+          gdf_error_code =  hash_join<join_type, size_type, MurmurHash3_64>(num_cols, leftcol, rightcol,
+                                                                            left_result, right_result,
+                                                                            join_context->hash_table_stats,
+                                                                            1 == join_context->flag_exact_join_size,
+                                                                            join_context->join_left_distinct_keys,
+                                                                            join_context->join_right_distinct_keys,
+                                                                            join_context->join_build_side_cost);
+        }
+        else
+        {
+          gdf_error_code =  hash_join<join_type, size_type>(num_cols, leftcol, rightcol, left_result, right_result,
+                                                              join_context->hash_table_stats,
+                                                              1 == join_context->flag_exact_join_size,
+                                                              join_context->join_left_distinct_keys,
+                                                              join_context->join_right_distinct_keys,
+                                                              join_context->join_build_side_cost);
+        }
         break;
       }
-    case GDF_SORT:
+    case GDF_HASH_PARTITIONED:
       {
-        // Sort based joins only support single column joins
-        if(1 == num_cols)
+        if(1 == join_context->flag_hash_64bit)
         {
-          gdf_error_code =  sort_join<join_type>(leftcol[0], rightcol[0], left_result, right_result, join_context);
+          gdf_error_code =  partitioned_hash_join<join_type, size_type, MurmurHash3_64>(num_cols, leftcol, rightcol,
+                                                                                        left_result, right_result,
+                                                                                        join_context->max_partition_rows);
         }
         else
         {
-          gdf_error_code =  GDF_JOIN_TOO_MANY_COLUMNS;
+          gdf_error_code =  partitioned_hash_join<join_type, size_type>(num_cols, leftcol, rightcol,
+                                                                          left_result, right_result,
+                                                                          join_context->max_partition_rows);
         }
-
+        break;
+      }
+    case GDF_SORT:
+      {
+        gdf_error_code =  sort_join<join_type>(num_cols, leftcol, rightcol, left_result, right_result, join_context);
         break;
       }
     default:
@@ -651,3 +1338,421 @@ gdf_error gdf_full_join(
                      right_indices,
                      join_context);
 }
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Computes the left semi-join or left anti-join of two sets of columns
+ * 
+ * @Param left_cols The columns of the left dataframe
+ * @Param left_join_cols The indices of the left columns to join on
+ * @Param right_cols The columns of the right dataframe
+ * @Param right_join_cols The indices of the right columns to join on
+ * @Param num_cols_to_join The number of columns to join on
+ * @Param left_indices The indices of the selected left rows
+ * @Param join_context A structure that determines various run parameters
+ * @tparam anti_join If true, selects the left rows without a match in the right dataframe
+ * 
+ * @Returns GDF_SUCCESS upon succesfull compute, otherwise returns appropriate error code
+ */
+/* ----------------------------------------------------------------------------*/
+template <bool anti_join>
+gdf_error existence_join_call(gdf_column **left_cols,
+                              int left_join_cols[],
+                              gdf_column **right_cols,
+                              int right_join_cols[],
+                              int num_cols_to_join,
+                              gdf_column * left_indices,
+                              gdf_context *join_context)
+{
+  using size_type = int64_t;
+
+  if((nullptr == left_cols) || (nullptr == right_cols)
+     || (nullptr == left_join_cols) || (nullptr == right_join_cols)
+     || (0 == num_cols_to_join))
+    return GDF_DATASET_EMPTY;
+
+  if((nullptr == left_indices) || (nullptr == join_context))
+    return GDF_INVALID_API_CALL;
+
+  if(GDF_HASH != join_context->flag_method)
+    return GDF_UNSUPPORTED_METHOD;
+
+  //get column pointers to join on
+  std::vector<gdf_column*> ljoincol;
+  std::vector<gdf_column*> rjoincol;
+  for (int i = 0; i < num_cols_to_join; ++i) {
+    ljoincol.push_back(left_cols[ left_join_cols[i] ]);
+    rjoincol.push_back(right_cols[ right_join_cols[i] ]);
+  }
+
+  const auto left_col_size = ljoincol[0]->size;
+  const auto right_col_size = rjoincol[0]->size;
+
+  // Check that the number of rows does not exceed the maximum
+  if(left_col_size >= MAX_JOIN_SIZE) return GDF_COLUMN_SIZE_TOO_BIG;
+  if(right_col_size >= MAX_JOIN_SIZE) return GDF_COLUMN_SIZE_TOO_BIG;
+
+  // check that the columns data are not null, have matching types, 
+  // and the same number of rows
+  for (int i = 0; i < num_cols_to_join; i++) {
+    if((right_col_size > 0) && (nullptr == rjoincol[i]->data)) return GDF_DATASET_EMPTY;
+    if((left_col_size > 0) && (nullptr == ljoincol[i]->data)) return GDF_DATASET_EMPTY;
+    if(rjoincol[i]->dtype != ljoincol[i]->dtype) return GDF_JOIN_DTYPE_MISMATCH;
+    if(left_col_size != ljoincol[i]->size) return GDF_COLUMN_SIZE_MISMATCH;
+    if(right_col_size != rjoincol[i]->size) return GDF_COLUMN_SIZE_MISMATCH;
+  }
+
+  gdf_dtype dtype{(8 == sizeof(output_index_type)) ? GDF_INT64 : GDF_INT32};
+
+  // If the left frame is empty, nothing is selected
+  if(0 == left_col_size) {
+    gdf_column_view(left_indices, nullptr, nullptr, 0, dtype);
+    return GDF_SUCCESS;
+  }
+
+  PUSH_RANGE("LIBGDF_JOIN", JOIN_COLOR);
+
+  // Wrap the set of gdf_columns in a gdf_table class
+  std::unique_ptr< gdf_table<size_type> > left_table(new gdf_table<size_type>(num_cols_to_join, ljoincol.data()));
+  std::unique_ptr< gdf_table<size_type> > right_table(new gdf_table<size_type>(num_cols_to_join, rjoincol.data()));
+
+  gdf_error gdf_error_code{GDF_SUCCESS};
+  if(1 == join_context->flag_hash_64bit)
+  {
+    gdf_error_code = compute_hash_existence_join<anti_join, output_index_type, size_type, MurmurHash3_64>(
+        left_indices, *left_table, *right_table);
+  }
+  else
+  {
+    gdf_error_code = compute_hash_existence_join<anti_join, output_index_type, size_type>(
+        left_indices, *left_table, *right_table);
+  }
+
+  POP_RANGE();
+
+  return gdf_error_code;
+}
+
+gdf_error gdf_left_semi_join(gdf_column **left_cols,
+                             int left_join_cols[],
+                             gdf_column **right_cols,
+                             int right_join_cols[],
+                             int num_cols_to_join,
+                             gdf_column * left_indices,
+                             gdf_context *join_context) {
+    return existence_join_call<false>(left_cols, left_join_cols,
+                                      right_cols, right_join_cols,
+                                      num_cols_to_join,
+                                      left_indices,
+                                      join_context);
+}
+
+gdf_error gdf_left_anti_join(gdf_column **left_cols,
+                             int left_join_cols[],
+                             gdf_column **right_cols,
+                             int right_join_cols[],
+                             int num_cols_to_join,
+                             gdf_column * left_indices,
+                             gdf_context *join_context) {
+    return existence_join_call<true>(left_cols, left_join_cols,
+                                     right_cols, right_join_cols,
+                                     num_cols_to_join,
+                                     left_indices,
+                                     join_context);
+}
+
+using join_hash_table_type = join_hash_table<int64_t>;
+
+gdf_join_hash_table* cffi_wrap(join_hash_table_type* obj){
+    return reinterpret_cast<gdf_join_hash_table*>(obj);
+}
+
+join_hash_table_type* cffi_unwrap(gdf_join_hash_table* hdl){
+    return reinterpret_cast<join_hash_table_type*>(hdl);
+}
+
+gdf_error gdf_join_build(gdf_column **build_cols,
+                         int num_cols,
+                         gdf_join_hash_table **hash_table,
+                         gdf_context *join_context)
+{
+  using size_type = int64_t;
+
+  if((nullptr == build_cols) || (0 >= num_cols))
+    return GDF_DATASET_EMPTY;
+
+  if((nullptr == hash_table) || (nullptr == join_context))
+    return GDF_INVALID_API_CALL;
+
+  if(GDF_HASH != join_context->flag_method)
+    return GDF_UNSUPPORTED_METHOD;
+
+  const auto build_col_size = build_cols[0]->size;
+  if(build_col_size >= MAX_JOIN_SIZE) return GDF_COLUMN_SIZE_TOO_BIG;
+
+  for (int i = 0; i < num_cols; i++) {
+    if((build_col_size > 0) && (nullptr == build_cols[i]->data)) return GDF_DATASET_EMPTY;
+    if(build_col_size != build_cols[i]->size) return GDF_COLUMN_SIZE_MISMATCH;
+  }
+
+  PUSH_RANGE("LIBGDF_JOIN", JOIN_COLOR);
+
+  std::unique_ptr<join_hash_table_type> table;
+  gdf_error gdf_error_code{GDF_SUCCESS};
+  if(1 == join_context->flag_hash_64bit)
+  {
+    gdf_error_code = device_join_hash_table<output_index_type, size_type, MurmurHash3_64>::create(
+        build_cols, num_cols, &table, join_context->hash_table_stats);
+  }
+  else
+  {
+    gdf_error_code = device_join_hash_table<output_index_type, size_type>::create(
+        build_cols, num_cols, &table, join_context->hash_table_stats);
+  }
+
+  POP_RANGE();
+
+  if(GDF_SUCCESS == gdf_error_code)
+  {
+    *hash_table = cffi_wrap(table.release());
+  }
+  return gdf_error_code;
+}
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Checks that a set of probe columns can probe a join hash table
+ * 
+ * @Returns GDF_SUCCESS if the columns match the build columns of the table,
+ * otherwise an appropriate error code
+ */
+/* ----------------------------------------------------------------------------*/
+static gdf_error check_probe_columns(join_hash_table_type const * table,
+                                     gdf_column **probe_cols,
+                                     int num_cols)
+{
+  if(num_cols != table->num_columns()) return GDF_COLUMN_SIZE_MISMATCH;
+
+  const auto probe_col_size = probe_cols[0]->size;
+  if(probe_col_size >= MAX_JOIN_SIZE) return GDF_COLUMN_SIZE_TOO_BIG;
+
+  for (int i = 0; i < num_cols; i++) {
+    if((probe_col_size > 0) && (nullptr == probe_cols[i]->data)) return GDF_DATASET_EMPTY;
+    if(table->column_dtype(i) != probe_cols[i]->dtype) return GDF_JOIN_DTYPE_MISMATCH;
+    if(probe_col_size != probe_cols[i]->size) return GDF_COLUMN_SIZE_MISMATCH;
+  }
+  return GDF_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Probes a join hash table with a set of checked probe columns
+ * 
+ * @Returns GDF_SUCCESS upon succesfull compute, otherwise returns appropriate error code
+ */
+/* ----------------------------------------------------------------------------*/
+static gdf_error probe_columns(join_hash_table_type const * table,
+                               gdf_column **probe_cols,
+                               int num_cols,
+                               JoinType join_type,
+                               gdf_column * probe_indices,
+                               gdf_column * build_indices,
+                               gdf_context *join_context)
+{
+  using size_type = int64_t;
+
+  // If the probe table is empty, or the build table is empty for an inner
+  // join, the output is empty
+  if((0 == probe_cols[0]->size) ||
+     ((JoinType::INNER_JOIN == join_type) && (0 == table->num_build_rows()))) {
+    gdf_dtype dtype{(8 == sizeof(output_index_type)) ? GDF_INT64 : GDF_INT32};
+    gdf_column_view(probe_indices, nullptr, nullptr, 0, dtype);
+    gdf_column_view(build_indices, nullptr, nullptr, 0, dtype);
+    return GDF_SUCCESS;
+  }
+
+  std::unique_ptr< gdf_table<size_type> > probe_table(new gdf_table<size_type>(num_cols, probe_cols));
+
+  return table->probe(*probe_table, join_type,
+                      probe_indices, build_indices,
+                      join_context->hash_table_stats,
+                      1 == join_context->flag_exact_join_size);
+}
+
+gdf_error gdf_join_probe(gdf_join_hash_table *hash_table,
+                         gdf_column **probe_cols,
+                         int num_cols,
+                         int left_join,
+                         gdf_column * probe_indices,
+                         gdf_column * build_indices,
+                         gdf_context *join_context)
+{
+  if((nullptr == probe_cols) || (0 >= num_cols))
+    return GDF_DATASET_EMPTY;
+
+  if((nullptr == hash_table) || (nullptr == probe_indices)
+     || (nullptr == build_indices) || (nullptr == join_context))
+    return GDF_INVALID_API_CALL;
+
+  join_hash_table_type const * table = cffi_unwrap(hash_table);
+
+  const gdf_error check_error = check_probe_columns(table, probe_cols, num_cols);
+  if(GDF_SUCCESS != check_error) return check_error;
+
+  PUSH_RANGE("LIBGDF_JOIN", JOIN_COLOR);
+
+  const gdf_error gdf_error_code = probe_columns(table, probe_cols, num_cols,
+                                                 (0 != left_join) ? JoinType::LEFT_JOIN : JoinType::INNER_JOIN,
+                                                 probe_indices, build_indices, join_context);
+
+  POP_RANGE();
+
+  return gdf_error_code;
+}
+
+gdf_error gdf_join_probe_chunked(gdf_join_hash_table *hash_table,
+                                 gdf_column **probe_cols,
+                                 int num_cols,
+                                 int left_join,
+                                 gdf_size_type chunk_rows,
+                                 gdf_join_chunk_callback callback,
+                                 void *user_data,
+                                 gdf_context *join_context)
+{
+  if((nullptr == probe_cols) || (0 >= num_cols))
+    return GDF_DATASET_EMPTY;
+
+  if((nullptr == hash_table) || (nullptr == callback) || (nullptr == join_context))
+    return GDF_INVALID_API_CALL;
+
+  join_hash_table_type const * table = cffi_unwrap(hash_table);
+
+  const gdf_error check_error = check_probe_columns(table, probe_cols, num_cols);
+  if(GDF_SUCCESS != check_error) return check_error;
+
+  const JoinType join_type = (0 != left_join) ? JoinType::LEFT_JOIN : JoinType::INNER_JOIN;
+
+  // The columns of a chunk are views of rows of the probe columns
+  std::vector<gdf_column> chunk_columns(num_cols);
+  std::vector<gdf_column*> chunk_column_ptrs(num_cols);
+  for(int i = 0; i < num_cols; ++i) chunk_column_ptrs[i] = &chunk_columns[i];
+
+  // The output of the current chunk, freed before the next chunk is probed
+  struct chunk_output
+  {
+    gdf_column probe_indices;
+    gdf_column build_indices;
+  } output{};
+
+  auto free_output = [&output]() -> gdf_error {
+    if(nullptr != output.probe_indices.data) RMM_TRY( RMM_FREE(output.probe_indices.data, 0) );
+    if(nullptr != output.build_indices.data) RMM_TRY( RMM_FREE(output.build_indices.data, 0) );
+    output.probe_indices.data = nullptr;
+    output.build_indices.data = nullptr;
+    return GDF_SUCCESS;
+  };
+
+  auto probe_chunk = [&](size_t begin, size_t end, chunk_output & result) -> gdf_error {
+    for(int i = 0; i < num_cols; ++i) {
+      gdf_column const & column = *probe_cols[i];
+      int width{0};
+      GDF_REQUIRE(GDF_SUCCESS == get_column_byte_width(probe_cols[i], &width), GDF_UNSUPPORTED_DTYPE);
+      // The chunks start on a byte of the validity bitmask. The null count of
+      // a chunk is the one of the whole column, the join does not use it.
+      chunk_columns[i] = column;
+      chunk_columns[i].data = static_cast<char*>(column.data) + begin * width;
+      chunk_columns[i].valid = (nullptr == column.valid) ? nullptr
+                               : column.valid + begin / GDF_VALID_BITSIZE;
+      chunk_columns[i].size = end - begin;
+    }
+    return probe_columns(table, chunk_column_ptrs.data(), num_cols, join_type,
+                         &result.probe_indices, &result.build_indices, join_context);
+  };
+
+  auto consume = [&](size_t begin, size_t end, chunk_output & result) -> gdf_error {
+    const gdf_error callback_error = callback(begin, end,
+                                              &result.probe_indices, &result.build_indices,
+                                              user_data);
+    const gdf_error free_error = free_output();
+    return (GDF_SUCCESS != callback_error) ? callback_error : free_error;
+  };
+
+  PUSH_RANGE("LIBGDF_JOIN", JOIN_COLOR);
+
+  const gdf_error gdf_error_code = probe_in_chunks(probe_cols[0]->size, chunk_rows, output,
+                                                   probe_chunk, consume);
+
+  POP_RANGE();
+
+  if(GDF_SUCCESS != gdf_error_code) free_output();
+
+  return gdf_error_code;
+}
+
+gdf_error gdf_join_hash_table_free(gdf_join_hash_table *hash_table)
+{
+  delete cffi_unwrap(hash_table);
+  return GDF_SUCCESS;
+}
+
+gdf_error gdf_asof_join(gdf_column *left_on,
+                        gdf_column *right_on,
+                        gdf_column **left_by,
+                        gdf_column **right_by,
+                        int num_by_cols,
+                        int64_t tolerance,
+                        gdf_column * left_indices,
+                        gdf_column * right_indices,
+                        gdf_context *join_context)
+{
+  if((nullptr == left_on) || (nullptr == right_on))
+    return GDF_DATASET_EMPTY;
+
+  if((num_by_cols < 0) || ((num_by_cols > 0) && ((nullptr == left_by) || (nullptr == right_by))))
+    return GDF_INVALID_API_CALL;
+
+  if((nullptr == left_indices) || (nullptr == right_indices) || (nullptr == join_context))
+    return GDF_INVALID_API_CALL;
+
+  const auto left_col_size = left_on->size;
+  const auto right_col_size = right_on->size;
+
+  // Check that the number of rows does not exceed the maximum
+  if(left_col_size >= MAX_JOIN_SIZE) return GDF_COLUMN_SIZE_TOO_BIG;
+  if(right_col_size >= MAX_JOIN_SIZE) return GDF_COLUMN_SIZE_TOO_BIG;
+
+  std::vector<gdf_column*> left_cols(left_by, left_by + num_by_cols);
+  std::vector<gdf_column*> right_cols(right_by, right_by + num_by_cols);
+  left_cols.push_back(left_on);
+  right_cols.push_back(right_on);
+
+  // check that the columns data are not null, have matching types, 
+  // the same number of rows, and no nulls
+  for (size_t i = 0; i < left_cols.size(); i++) {
+    if((right_col_size > 0) && (nullptr == right_cols[i]->data)) return GDF_DATASET_EMPTY;
+    if((left_col_size > 0) && (nullptr == left_cols[i]->data)) return GDF_DATASET_EMPTY;
+    if(right_cols[i]->dtype != left_cols[i]->dtype) return GDF_JOIN_DTYPE_MISMATCH;
+    if(left_col_size != left_cols[i]->size) return GDF_COLUMN_SIZE_MISMATCH;
+    if(right_col_size != right_cols[i]->size) return GDF_COLUMN_SIZE_MISMATCH;
+    GDF_REQUIRE(!left_cols[i]->valid  || !left_cols[i]->null_count , GDF_VALIDITY_UNSUPPORTED);
+    GDF_REQUIRE(!right_cols[i]->valid || !right_cols[i]->null_count, GDF_VALIDITY_UNSUPPORTED);
+  }
+
+  gdf_dtype dtype{(8 == sizeof(output_index_type)) ? GDF_INT64 : GDF_INT32};
+
+  // If the left table is empty, the output is empty
+  if(0 == left_col_size) {
+    gdf_column_view(left_indices, nullptr, nullptr, 0, dtype);
+    gdf_column_view(right_indices, nullptr, nullptr, 0, dtype);
+    return GDF_SUCCESS;
+  }
+
+  PUSH_RANGE("LIBGDF_JOIN", JOIN_COLOR);
+
+  const gdf_error gdf_error_code = asof_join(left_on, right_on, left_by, right_by, num_by_cols,
+                                             tolerance, left_indices, right_indices, join_context);
+
+  POP_RANGE();
+
+  return gdf_error_code;
+}
@@ -25,6 +25,7 @@
 #include "dataframe/cudf_table.cuh"
 
 #include "sort_join.cuh"
+#include "join_build_side.h"
 #include "join_compute_api.h"
 
 class rmm_mgpu_context_t; // forward decl
@@ -37,40 +38,86 @@ class rmm_mgpu_context_t; // forward decl
   * @Param right_table The right table to be joined
   * @Param flip_indices Flag that indicates whether the left and right tables have been
   * flipped, meaning the output indices should also be flipped.
+  * @Param hash_table_stats If not nullptr, receives the statistics of the hash table
+  * @Param exact_output_size If true, size the output exactly with a counting pass
+  * instead of estimating it
+  * @Param left_distinct_keys The number of distinct keys of the left table, 0 if unknown
+  * @Param right_distinct_keys The number of distinct keys of the right table, 0 if unknown
+  * @Param build_side_cost The cost hook choosing the build side of an inner join,
+  * default_join_build_side_cost if nullptr. The side the table was built on is
+  * reported in hash_table_stats.
   * @tparam join_type The type of join to be performed
   * @tparam output_index_type The datatype used for the output indices
+  * @tparam hash_function The row hash function the hash table is keyed on
   *
   * @Returns
   */
  /* ----------------------------------------------------------------------------*/
 template<JoinType join_type,
          typename output_index_type,
+         template <typename> class hash_function = default_hash,
          typename size_type>
 gdf_error join_hash(gdf_table<size_type> const & left_table,
                     gdf_table<size_type> const & right_table,
                     gdf_column * const output_l,
                     gdf_column * const output_r,
-                    bool flip_indices = false)
+                    bool flip_indices = false,
+                    gdf_hash_table_stats * hash_table_stats = nullptr,
+                    bool exact_output_size = false,
+                    size_t left_distinct_keys = 0,
+                    size_t right_distinct_keys = 0,
+                    join_build_side_cost_fn build_side_cost = nullptr)
 {
-
   // Hash table is built on the right table.
-  // For inner joins, doesn't matter which table is build/probe, so we want
-  // to build the hash table on the smaller table.
-  if((join_type == JoinType::INNER_JOIN) &&
-     (right_table.get_column_length() > left_table.get_column_length()))
+  // For inner joins, doesn't matter which table is build/probe, so the cost
+  // hook decides whether building it on the left table is cheaper.
+  bool swap_sides{false};
+  if(join_type == JoinType::INNER_JOIN)
   {
-    return join_hash<join_type, output_index_type>(right_table, 
-                                                   left_table, 
-                                                   output_l, 
-                                                   output_r, 
-                                                   true);
+    using hash_value_type = hash_result_t<hash_function>;
+    using multimap_type = join_multimap_t<hash_value_type, output_index_type, size_type>;
+
+    join_side_info left_info;
+    left_info.num_rows = left_table.get_column_length();
+    left_info.num_distinct_keys = left_distinct_keys;
+    join_side_info right_info;
+    right_info.num_rows = right_table.get_column_length();
+    right_info.num_distinct_keys = right_distinct_keys;
+
+    swap_sides = join_build_on_left(left_info, right_info,
+                                    sizeof(typename multimap_type::value_type),
+                                    DEFAULT_HASH_TABLE_OCCUPANCY,
+                                    build_side_cost);
   }
 
-  return compute_hash_join<join_type, output_index_type>(output_l,
+  gdf_error gdf_error_code{GDF_SUCCESS};
+  if(swap_sides)
+  {
+    gdf_error_code = compute_hash_join<join_type, output_index_type, size_type, hash_function>(output_l,
+                                                         output_r,
+                                                         right_table,
+                                                         left_table,
+                                                         !flip_indices,
+                                                         hash_table_stats,
+                                                         exact_output_size);
+  }
+  else
+  {
+    gdf_error_code = compute_hash_join<join_type, output_index_type, size_type, hash_function>(output_l,
                                                          output_r, 
                                                          left_table, 
                                                          right_table, 
-                                                         flip_indices);
+                                                         flip_indices,
+                                                         hash_table_stats,
+                                                         exact_output_size);
+  }
+
+  if((GDF_SUCCESS == gdf_error_code) && (nullptr != hash_table_stats))
+  {
+    hash_table_stats->build_side_swapped = swap_sides ? 1 : 0;
+  }
+
+  return gdf_error_code;
 }
 
 // Overload Modern GPU memory allocation and free to use RMM
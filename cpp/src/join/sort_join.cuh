@@ -245,3 +245,155 @@ full_join(a_it a, int a_count, b_it b, int b_count,
     return output;
 }
 
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Encodes the rows of the right table as negative values, so that
+ * the merge of the left and right row positions compares rows of the proper table.
+ * Right position j is encoded as -(j + 1).
+ */
+/* ----------------------------------------------------------------------------*/
+struct encode_right_row
+{
+  __host__ __device__ __forceinline__
+  int operator()(int j) const { return -(j + 1); }
+};
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Lexicographic comparator of the rows of two sets of columns, used to
+ * merge the sorted rows of the left and right tables.
+ *
+ * A non-negative value i is the i-th row of the left table in sorted order and
+ * a negative value -(j + 1) is the j-th row of the right table in sorted order.
+ * If the rows of a table are not physically sorted, its order holds the row
+ * index of each sorted position.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename size_type>
+struct join_rows_less
+{
+  void * const * left_columns;
+  void * const * right_columns;
+  int const * types;          // The gdf_dtype of each column, dates mapped to ints
+  int num_columns;
+  size_type const * left_order;  // nullptr if the left rows are sorted
+  size_type const * right_order; // nullptr if the right rows are sorted
+
+  template <typename col_type>
+  __device__ __forceinline__
+  static int compare(void const * a_column, size_type a_row,
+                     void const * b_column, size_type b_row)
+  {
+    const col_type a = static_cast<col_type const *>(a_column)[a_row];
+    const col_type b = static_cast<col_type const *>(b_column)[b_row];
+    return (a < b) ? -1 : ((b < a) ? 1 : 0);
+  }
+
+  __device__ __forceinline__
+  void locate(int position, void * const * & columns, size_type & row) const
+  {
+    if(position >= 0) {
+      columns = left_columns;
+      row = (nullptr == left_order) ? position : left_order[position];
+    } else {
+      columns = right_columns;
+      row = (nullptr == right_order) ? (-position - 1) : right_order[-position - 1];
+    }
+  }
+
+  __device__
+  bool operator()(int a, int b) const
+  {
+    void * const * a_columns;
+    void * const * b_columns;
+    size_type a_row, b_row;
+    locate(a, a_columns, a_row);
+    locate(b, b_columns, b_row);
+
+    for(int i = 0; i < num_columns; ++i)
+    {
+      int result{0};
+      switch(types[i])
+      {
+        case GDF_INT8:    result = compare<int8_t >(a_columns[i], a_row, b_columns[i], b_row); break;
+        case GDF_INT16:   result = compare<int16_t>(a_columns[i], a_row, b_columns[i], b_row); break;
+        case GDF_INT32:   result = compare<int32_t>(a_columns[i], a_row, b_columns[i], b_row); break;
+        case GDF_INT64:   result = compare<int64_t>(a_columns[i], a_row, b_columns[i], b_row); break;
+        case GDF_FLOAT32: result = compare<float  >(a_columns[i], a_row, b_columns[i], b_row); break;
+        case GDF_FLOAT64: result = compare<double >(a_columns[i], a_row, b_columns[i], b_row); break;
+        default: break;
+      }
+      if(0 != result) return result < 0;
+    }
+    return false;
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Maps a position of the joined indices in sorted order to the index
+ * of its row. Negative values mark a missing row and are kept as is.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename size_type>
+struct sorted_position_to_row
+{
+  size_type const * order;
+
+  __device__ __forceinline__
+  size_type operator()(size_type position) const
+  {
+    return (position < 0) ? position : order[position];
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/** 
+ * @Synopsis  Selects the right row of each left row of an as-of join, from the
+ * upper bound of the left row among the sorted right rows.
+ *
+ * The right row just before the upper bound is the last right row less than
+ * or equal to the left row in the order of the (by..., on) columns. It is the
+ * match if its by columns equal those of the left row, and if its on value
+ * precedes the left one by at most tolerance.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename size_type>
+struct asof_last_preceding
+{
+  join_rows_less<size_type> by_less; // Compares the by columns only
+  void const * left_on;
+  void const * right_on;
+  int on_type;                       // GDF_INT32 or GDF_INT64
+  int const * upper;                 // Upper bound of each sorted left position
+  int64_t tolerance;                 // Negative for no tolerance
+  size_type * right_result;          // The matched right row of each left row
+
+  __device__ __forceinline__
+  int64_t on_value(void const * column, size_type row) const
+  {
+    return (GDF_INT32 == on_type) ? static_cast<int64_t>(static_cast<int32_t const *>(column)[row])
+                                  : static_cast<int64_t const *>(column)[row];
+  }
+
+  __device__
+  void operator()(int left_position) const
+  {
+    const size_type left_row = (nullptr == by_less.left_order) ? left_position
+                               : by_less.left_order[left_position];
+    size_type match{-1};
+
+    const int right_position = upper[left_position] - 1;
+    if(right_position >= 0) {
+      const int encoded_right = encode_right_row{}(right_position);
+      if(!by_less(left_position, encoded_right) && !by_less(encoded_right, left_position)) {
+        const size_type right_row = (nullptr == by_less.right_order) ? right_position
+                                    : by_less.right_order[right_position];
+        const int64_t distance = on_value(left_on, left_row) - on_value(right_on, right_row);
+        if((tolerance < 0) || (distance <= tolerance)) match = right_row;
+      }
+    }
+    right_result[left_row] = match;
+  }
+};
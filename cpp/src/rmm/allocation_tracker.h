@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** ---------------------------------------------------------------------------*
+ * @brief Allocation tracker used to detect leaks, double frees and frees of
+ * unknown pointers.
+ *
+ * The tracker only does bookkeeping: it never touches the memory it tracks, so
+ * it can be driven by any memory resource (device, pool or host).
+ *
+ * Note: assumes at least C++11
+ * ---------------------------------------------------------------------------**/
+
+#ifndef ALLOCATION_TRACKER_H
+#define ALLOCATION_TRACKER_H
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "memory.h"
+
+namespace rmm
+{
+    class AllocationTracker
+    {
+    public:
+        /// Number of freed pointers remembered to tell a double free apart
+        /// from a free of a pointer that was never allocated.
+        static constexpr size_t default_free_history = 4096;
+
+        /// Maximum number of invalid free records kept for the report.
+        static constexpr size_t max_invalid_frees = 1024;
+
+        /// Information recorded for each outstanding allocation
+        struct Allocation {
+            void* ptr;
+            size_t size;
+            cudaStream_t stream;
+            std::string filename;
+            unsigned int line;
+        };
+
+        typedef enum {
+            DoubleFree = 0,
+            UnknownFree
+        } InvalidFree_t;
+
+        /// Information recorded for each rejected free
+        struct InvalidFree {
+            InvalidFree_t kind;
+            void* ptr;
+            cudaStream_t stream;
+            std::string filename;
+            unsigned int line;
+        };
+
+        explicit AllocationTracker(size_t free_history = default_free_history)
+        : free_history(free_history) {}
+
+        /** ---------------------------------------------------------------------------*
+         * @brief Record a successful allocation.
+         *
+         * @param ptr The allocated pointer
+         * @param size The size of the allocation in bytes
+         * @param stream The stream the allocation was made on
+         * @param filename The source file of the caller (may be null)
+         * @param line The source line of the caller
+         * ---------------------------------------------------------------------------**/
+        void record_alloc(void* ptr, size_t size, cudaStream_t stream,
+                          const char* filename, unsigned int line)
+        {
+            if (nullptr == ptr) return;
+            std::lock_guard<std::mutex> guard(tracker_mutex);
+            // The allocator may legitimately hand out a previously freed address
+            forget_freed(ptr);
+            auto& a = allocations[ptr];
+            outstanding_bytes -= a.size;
+            a = Allocation{ptr, size, stream, filename ? filename : "", line};
+            outstanding_bytes += size;
+        }
+
+        /** ---------------------------------------------------------------------------*
+         * @brief Check that a pointer may be freed, without recording the free.
+         *
+         * Must be called before the memory is released to the underlying
+         * resource, so that invalid frees can be rejected. The free is recorded
+         * by record_free once the release succeeds, so that an allocation stays
+         * outstanding if it fails.
+         *
+         * @param ptr The pointer being freed
+         * @param stream The stream the free is issued on
+         * @param filename The source file of the caller (may be null)
+         * @param line The source line of the caller
+         * @return rmmError_t RMM_SUCCESS if ptr is an outstanding allocation,
+         *                    RMM_ERROR_INVALID_ARGUMENT on a double free or a
+         *                    free of an unknown pointer.
+         * ---------------------------------------------------------------------------**/
+        rmmError_t check_free(void* ptr, cudaStream_t stream,
+                              const char* filename, unsigned int line)
+        {
+            if (nullptr == ptr) return RMM_SUCCESS;
+            std::lock_guard<std::mutex> guard(tracker_mutex);
+            return check_outstanding(ptr, stream, filename, line);
+        }
+
+        /** ---------------------------------------------------------------------------*
+         * @brief Check that a pointer may be freed and record the free.
+         *
+         * @param ptr The pointer that was freed
+         * @param stream The stream the free was issued on
+         * @param filename The source file of the caller (may be null)
+         * @param line The source line of the caller
+         * @return rmmError_t RMM_SUCCESS if ptr was an outstanding allocation,
+         *                    RMM_ERROR_INVALID_ARGUMENT on a double free or a
+         *                    free of an unknown pointer.
+         * ---------------------------------------------------------------------------**/
+        rmmError_t record_free(void* ptr, cudaStream_t stream,
+                               const char* filename, unsigned int line)
+        {
+            if (nullptr == ptr) return RMM_SUCCESS;
+            std::lock_guard<std::mutex> guard(tracker_mutex);
+            rmmError_t result = check_outstanding(ptr, stream, filename, line);
+            if (RMM_SUCCESS != result) return result;
+            auto it = allocations.find(ptr);
+            outstanding_bytes -= it->second.size;
+            allocations.erase(it);
+            remember_freed(ptr);
+            return RMM_SUCCESS;
+        }
+
+        /// Number of allocations that have not been freed
+        size_t outstanding_count() {
+            std::lock_guard<std::mutex> guard(tracker_mutex);
+            return allocations.size();
+        }
+
+        /// Total size in bytes of the allocations that have not been freed
+        size_t outstanding_size() {
+            std::lock_guard<std::mutex> guard(tracker_mutex);
+            return outstanding_bytes;
+        }
+
+        size_t double_free_count() {
+            std::lock_guard<std::mutex> guard(tracker_mutex);
+            return num_double_frees;
+        }
+
+        size_t unknown_free_count() {
+            std::lock_guard<std::mutex> guard(tracker_mutex);
+            return num_unknown_frees;
+        }
+
+        /// Copy of the outstanding allocations
+        std::vector<Allocation> outstanding() {
+            std::lock_guard<std::mutex> guard(tracker_mutex);
+            std::vector<Allocation> result;
+            result.reserve(allocations.size());
+            for (auto const& a : allocations) result.push_back(a.second);
+            return result;
+        }
+
+        /** ---------------------------------------------------------------------------*
+         * @brief Write a human-readable report of the outstanding allocations and
+         * rejected frees.
+         *
+         * @param out The stream to write the report to
+         * ---------------------------------------------------------------------------**/
+        void report(std::ostream &out) {
+            std::lock_guard<std::mutex> guard(tracker_mutex);
+            out << "RMM leak report: " << allocations.size()
+                << " outstanding allocation(s), " << outstanding_bytes
+                << " bytes\n";
+            for (auto const& a : allocations) {
+                auto const& alloc = a.second;
+                out << "  leak: " << alloc.ptr << ", " << alloc.size
+                    << " bytes, stream " << alloc.stream << ", allocated at "
+                    << location(alloc.filename, alloc.line) << "\n";
+            }
+            out << "RMM invalid frees: " << num_double_frees << " double free(s), "
+                << num_unknown_frees << " free(s) of unknown pointers\n";
+            for (auto const& f : invalid_frees) {
+                out << "  " << (DoubleFree == f.kind ? "double free" : "unknown free")
+                    << ": " << f.ptr << ", stream " << f.stream << ", freed at "
+                    << location(f.filename, f.line) << "\n";
+            }
+        }
+
+        void clear() {
+            std::lock_guard<std::mutex> guard(tracker_mutex);
+            allocations.clear();
+            recently_freed.clear();
+            freed_order.clear();
+            invalid_frees.clear();
+            outstanding_bytes = 0;
+            num_double_frees = 0;
+            num_unknown_frees = 0;
+        }
+
+    private:
+        rmmError_t check_outstanding(void* ptr, cudaStream_t stream,
+                                     const char* filename, unsigned int line) {
+            if (allocations.count(ptr)) return RMM_SUCCESS;
+            InvalidFree_t kind = recently_freed.count(ptr) ? DoubleFree
+                                                           : UnknownFree;
+            if (DoubleFree == kind) ++num_double_frees;
+            else                    ++num_unknown_frees;
+            if (invalid_frees.size() < max_invalid_frees)
+                invalid_frees.push_back(InvalidFree{kind, ptr, stream,
+                                                    filename ? filename : "",
+                                                    line});
+            return RMM_ERROR_INVALID_ARGUMENT;
+        }
+
+        static std::string location(std::string const& filename, unsigned int line) {
+            if (filename.empty()) return "<unknown>";
+            return filename + ":" + std::to_string(line);
+        }
+
+        void remember_freed(void* ptr) {
+            if (0 == free_history) return;
+            if (freed_order.size() == free_history) {
+                recently_freed.erase(freed_order.front());
+                freed_order.pop_front();
+            }
+            recently_freed.insert(ptr);
+            freed_order.push_back(ptr);
+        }
+
+        void forget_freed(void* ptr) {
+            // The stale entry left in freed_order can at worst evict the pointer
+            // early, which turns a later double free into an unknown free.
+            // Both are rejected, so this is harmless.
+            recently_freed.erase(ptr);
+        }
+
+        size_t free_history;
+        std::unordered_map<void*, Allocation> allocations;
+        std::unordered_set<void*> recently_freed;
+        std::deque<void*> freed_order;
+        std::vector<InvalidFree> invalid_frees;
+        size_t outstanding_bytes{0};
+        size_t num_double_frees{0};
+        size_t num_unknown_frees{0};
+        std::mutex tracker_mutex;
+    };
+}
+
+#endif // ALLOCATION_TRACKER_H
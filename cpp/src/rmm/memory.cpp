@@ -23,6 +23,7 @@
 
 #include "rmm.h"
 #include "memory_manager.h"
+#include "stream_ordered_pool.h"
 #include <fstream>
 #include <sstream>
 #include <cstddef>
@@ -109,6 +110,92 @@ namespace rmm
     {
         return Manager::getOptions().allocation_mode == PoolAllocation;
     }
+
+    inline bool useStreamOrderedPool()
+    {
+        return Manager::getOptions().allocation_mode == StreamOrderedPoolAllocation;
+    }
+
+    /// StreamOrderedPool backend using cudaMalloc and CUDA events
+    struct CudaStreamBackend
+    {
+        typedef cudaStream_t stream_type;
+        typedef cudaEvent_t event_type;
+
+        rmmError_t allocate(void **ptr, size_t size) {
+            RMM_CHECK_CUDA( cudaMalloc(ptr, size) );
+            return RMM_SUCCESS;
+        }
+
+        rmmError_t deallocate(void *ptr) {
+            RMM_CHECK_CUDA( cudaFree(ptr) );
+            return RMM_SUCCESS;
+        }
+
+        rmmError_t create_event(event_type *event) {
+            RMM_CHECK_CUDA( cudaEventCreateWithFlags(event, cudaEventDisableTiming) );
+            return RMM_SUCCESS;
+        }
+
+        rmmError_t destroy_event(event_type event) {
+            RMM_CHECK_CUDA( cudaEventDestroy(event) );
+            return RMM_SUCCESS;
+        }
+
+        rmmError_t record_event(event_type event, stream_type stream) {
+            RMM_CHECK_CUDA( cudaEventRecord(event, stream) );
+            return RMM_SUCCESS;
+        }
+
+        bool event_completed(event_type event) {
+            return cudaSuccess == cudaEventQuery(event);
+        }
+
+        rmmError_t stream_wait_event(stream_type stream, event_type event) {
+            RMM_CHECK_CUDA( cudaStreamWaitEvent(stream, event, 0) );
+            return RMM_SUCCESS;
+        }
+    };
+
+    inline StreamOrderedPool<CudaStreamBackend>& streamOrderedPool()
+    {
+        static StreamOrderedPool<CudaStreamBackend> pool;
+        return pool;
+    }
+
+    inline bool trackAllocations()
+    {
+        return Manager::getOptions().enable_leak_tracking;
+    }
+
+    /// Allocate with the configured allocation mode
+    inline rmmError_t allocate(void **ptr, size_t size, cudaStream_t stream)
+    {
+        if (usePoolAllocator())
+        {
+            RMM_CHECK( Manager::getInstance().registerStream(stream) );
+            RMM_CHECK_CNMEM( cnmemMalloc(ptr, size, stream) );
+        }
+        else if (useStreamOrderedPool())
+            RMM_CHECK( streamOrderedPool().allocate(ptr, size, stream) );
+        else
+            RMM_CHECK_CUDA(cudaMalloc(ptr, size));
+        return RMM_SUCCESS;
+    }
+
+    /// Allocate, invoking the out of memory callback and retrying for as long
+    /// as it releases memory
+    inline rmmError_t allocateWithRetry(void **ptr, size_t size, cudaStream_t stream)
+    {
+        rmmError_t result = allocate(ptr, size, stream);
+        while (RMM_ERROR_OUT_OF_MEMORY == result &&
+               Manager::getInstance().onOutOfMemory(size))
+        {
+            cudaGetLastError(); // clear the allocation error before retrying
+            result = allocate(ptr, size, stream);
+        }
+        return result;
+    }
 };
 
 #ifndef GETNAME
@@ -158,8 +245,19 @@ rmmError_t rmmInitialize(rmmOptions_t *options)
 // Shutdown memory manager.
 rmmError_t rmmFinalize()
 {
+    if (rmm::trackAllocations())
+    {
+        rmm::AllocationTracker &tracker = rmm::Manager::getTracker();
+        if (tracker.outstanding_count() > 0 ||
+            tracker.double_free_count() > 0 ||
+            tracker.unknown_free_count() > 0)
+            tracker.report(std::cerr);
+    }
+
     if (rmm::usePoolAllocator())
         RMM_CHECK_CNMEM( cnmemFinalize() );
+    else if (rmm::useStreamOrderedPool())
+        RMM_CHECK( rmm::streamOrderedPool().release() );
     
     rmm::Manager::getInstance().finalize();
     
@@ -178,14 +276,10 @@ rmmError_t rmmAlloc(void **ptr, size_t size, cudaStream_t stream, const char* fi
     if (!ptr) 
         return RMM_ERROR_INVALID_ARGUMENT;
 
-    if (rmm::usePoolAllocator())
-    {
-        RMM_CHECK( rmm::Manager::getInstance().registerStream(stream) );
-        RMM_CHECK_CNMEM( cnmemMalloc(ptr, size, stream) );
-    }
-    else
-        RMM_CHECK_CUDA(cudaMalloc(ptr, size));
+    RMM_CHECK( rmm::allocateWithRetry(ptr, size, stream) );
 
+    if (rmm::trackAllocations())
+        rmm::Manager::getTracker().record_alloc(*ptr, size, stream, file, line);
 
     log.setPointer(*ptr);
     return RMM_SUCCESS;
@@ -203,17 +297,29 @@ rmmError_t rmmRealloc(void **ptr, size_t new_size, cudaStream_t stream, const ch
     if (!ptr) 
     	return RMM_ERROR_INVALID_ARGUMENT;
 
+    if (rmm::trackAllocations())
+        RMM_CHECK( rmm::Manager::getTracker().check_free(*ptr, stream, file, line) );
+
     if (rmm::usePoolAllocator())
     {
         RMM_CHECK( rmm::Manager::getInstance().registerStream(stream) );
         RMM_CHECK_CNMEM( cnmemFree(*ptr, stream) );
-        RMM_CHECK_CNMEM( cnmemMalloc(ptr, new_size, stream) );
     }
+    else if (rmm::useStreamOrderedPool())
+        RMM_CHECK( rmm::streamOrderedPool().deallocate(*ptr, stream) );
     else
-    {
         RMM_CHECK_CUDA(cudaFree(*ptr));
-	    RMM_CHECK_CUDA(cudaMalloc(ptr, new_size));
-    }
+
+    // The old block is released: record the free only now, so that a failed
+    // free leaves it outstanding
+    if (rmm::trackAllocations())
+        RMM_CHECK( rmm::Manager::getTracker().record_free(*ptr, stream, file, line) );
+
+    RMM_CHECK( rmm::allocateWithRetry(ptr, new_size, stream) );
+
+    if (rmm::trackAllocations())
+        rmm::Manager::getTracker().record_alloc(*ptr, new_size, stream, file, line);
+
     log.setPointer(*ptr);
     return RMM_SUCCESS;
 }
@@ -222,10 +328,21 @@ rmmError_t rmmRealloc(void **ptr, size_t new_size, cudaStream_t stream, const ch
 rmmError_t rmmFree(void *ptr, cudaStream_t stream, const char* file, unsigned int line)
 {
     rmm::LogIt log(rmm::Logger::Free, ptr, 0, stream, file, line);
+
+    // Reject double frees and frees of unknown pointers before they can
+    // corrupt the pool
+    if (rmm::trackAllocations())
+        RMM_CHECK( rmm::Manager::getTracker().check_free(ptr, stream, file, line) );
+
     if (rmm::usePoolAllocator())
         RMM_CHECK_CNMEM( cnmemFree(ptr, stream) );
+    else if (rmm::useStreamOrderedPool())
+        RMM_CHECK( rmm::streamOrderedPool().deallocate(ptr, stream) );
     else
         RMM_CHECK_CUDA(cudaFree(ptr));
+
+    if (rmm::trackAllocations())
+        RMM_CHECK( rmm::Manager::getTracker().record_free(ptr, stream, file, line) );
 	return RMM_SUCCESS;
 }
 
@@ -253,6 +370,8 @@ rmmError_t rmmGetInfo(size_t *freeSize, size_t *totalSize, cudaStream_t stream)
         RMM_CHECK( rmm::Manager::getInstance().registerStream(stream) );
         RMM_CHECK_CNMEM( cnmemMemGetInfo(freeSize, totalSize, stream) );
     }
+    else if (rmm::useStreamOrderedPool())
+        rmm::streamOrderedPool().get_info(freeSize, totalSize);
     else
         RMM_CHECK_CUDA(cudaMemGetInfo(freeSize, totalSize));
 	return RMM_SUCCESS;
@@ -296,3 +415,34 @@ rmmError_t rmmGetLog(char *buffer, size_t buffer_size)
     return RMM_SUCCESS;
 }
 
+// Get the number and total size of outstanding allocations
+rmmError_t rmmGetOutstandingAllocations(size_t *count, size_t *size)
+{
+    if (!rmm::trackAllocations())
+        return RMM_ERROR_NOT_INITIALIZED;
+    if (!count || !size)
+        return RMM_ERROR_INVALID_ARGUMENT;
+    *count = rmm::Manager::getTracker().outstanding_count();
+    *size = rmm::Manager::getTracker().outstanding_size();
+    return RMM_SUCCESS;
+}
+
+// Write the leak report to specified path/filename
+rmmError_t rmmWriteLeakReport(const char* filename)
+{
+    if (!rmm::trackAllocations())
+        return RMM_ERROR_NOT_INITIALIZED;
+    std::ofstream report(filename);
+    if (!report)
+        return RMM_ERROR_IO;
+    rmm::Manager::getTracker().report(report);
+    return report ? RMM_SUCCESS : RMM_ERROR_IO;
+}
+
+// Set the callback invoked when an allocation runs out of memory
+rmmError_t rmmSetOutOfMemoryCallback(rmmOutOfMemoryCallback_t callback,
+                                     void *user_data)
+{
+    rmm::Manager::getInstance().setOutOfMemoryCallback(callback, user_data);
+    return RMM_SUCCESS;
+}
@@ -45,6 +45,9 @@ typedef enum
 {
   CudaDefaultAllocation = 0,  //< Use cudaMalloc for allocation
   PoolAllocation,             //< Use pool suballocation strategy
+  StreamOrderedPoolAllocation,//< Use a stream-ordered pool that reuses blocks
+                              //< freed on other streams once their events
+                              //< complete
 } rmmAllocationMode_t;
 
 typedef struct
@@ -53,8 +56,20 @@ typedef struct
   size_t initial_pool_size;            //< When pool suballocation is enabled, 
                                        //< this is the initial pool size in bytes
   bool enable_logging;                 //< Enable logging memory manager events
+  bool enable_leak_tracking;           //< Track outstanding allocations to report
+                                       //< leaks, double frees and frees of
+                                       //< unknown pointers
 } rmmOptions_t;
 
+/** ---------------------------------------------------------------------------*
+ * @brief Callback invoked when an allocation fails for lack of memory.
+ * 
+ * The callback should try to release at least size bytes of device memory
+ * (e.g. by spilling buffers to host memory) and return true if it released
+ * any memory, in which case the allocation is retried.
+ * --------------------------------------------------------------------------**/
+typedef bool (*rmmOutOfMemoryCallback_t)(size_t size, void *user_data);
+
 /** ---------------------------------------------------------------------------*
  * @brief Initialize memory manager state and storage.
  * 
@@ -67,6 +82,9 @@ rmmError_t rmmInitialize(rmmOptions_t *options);
 /** ---------------------------------------------------------------------------*
  * @brief Shutdown memory manager.
  * 
+ * When leak tracking is enabled, a report of the allocations that are still
+ * outstanding and of any rejected frees is written to stderr.
+ * 
  * @return rmmError_t RMM_SUCCESS, or RMM_NOT_INITIALIZED if rmmInitialize() has
  *                    not been called, or RMM_ERROR_CUDA_ERROR on any CUDA error.
  * ---------------------------------------------------------------------------**/
@@ -123,7 +141,9 @@ rmmError_t rmmRealloc(void **ptr, size_t new_size, cudaStream_t stream,
  * @param[in] line The line number of the call to this function, for tracking
  * @return rmmError_t RMM_SUCCESS, or RMM_ERROR_NOT_INITIALIZED if rmmInitialize
  *                    has not been called,or RMM_ERROR_CUDA_ERROR on any CUDA
- *                    error.
+ *                    error. When leak tracking is enabled, returns
+ *                    RMM_ERROR_INVALID_ARGUMENT without freeing anything if
+ *                    ptr was already freed or was never allocated by RMM.
  * --------------------------------------------------------------------------**/
 rmmError_t rmmFree(void *ptr, cudaStream_t stream,
                    const char* file, unsigned int line);
@@ -153,7 +173,9 @@ rmmError_t rmmGetAllocationOffset(offset_t *offset,
  *        with the stream.
  * 
  * Returns in *free and *total, respectively, the free and total amount of
- * memory available for allocation by the device in bytes.
+ * memory available for allocation by the device in bytes. With the
+ * stream-ordered pool these are the bytes of the pool's free blocks, over all
+ * streams, and the bytes the pool holds from the device.
  * 
  * @param[out] freeSize The free memory in bytes available to the manager
  *                      associated with stream
@@ -191,3 +213,45 @@ size_t rmmLogSize();
  * @return rmmError_t RMM_SUCCESS, or RMM_IO_ERROR on any failure.
  * --------------------------------------------------------------------------**/
 rmmError_t rmmGetLog(char* buffer, size_t buffer_size);
+
+/** ---------------------------------------------------------------------------*
+ * @brief Get the number and total size of outstanding allocations.
+ * 
+ * Only available when leak tracking is enabled in the rmmOptions_t passed to
+ * rmmInitialize().
+ * 
+ * @param[out] count The number of allocations that have not been freed
+ * @param[out] size The total size in bytes of these allocations
+ * @return rmmError_t RMM_SUCCESS, RMM_ERROR_INVALID_ARGUMENT if an output is
+ *                    null, or RMM_ERROR_NOT_INITIALIZED if leak tracking is
+ *                    not enabled.
+ * --------------------------------------------------------------------------**/
+rmmError_t rmmGetOutstandingAllocations(size_t *count, size_t *size);
+
+/** ---------------------------------------------------------------------------*
+ * @brief Write the leak report to specified path/filename
+ * 
+ * The report lists each outstanding allocation with its size, stream and the
+ * file:line it was allocated at, followed by any double frees or frees of
+ * unknown pointers that were rejected. Note: will overwrite the specified file.
+ * 
+ * @param filename The full path and filename to write.
+ * @return rmmError_t RMM_SUCCESS, RMM_ERROR_NOT_INITIALIZED if leak tracking is
+ *                    not enabled, or RMM_ERROR_IO on output failure.
+ * --------------------------------------------------------------------------**/
+rmmError_t rmmWriteLeakReport(const char* filename);
+
+/** ---------------------------------------------------------------------------*
+ * @brief Set the callback invoked when an allocation runs out of memory.
+ * 
+ * When rmmAlloc or rmmRealloc fails with RMM_ERROR_OUT_OF_MEMORY, the callback
+ * is invoked with the requested size, and the allocation is retried for as long
+ * as the callback reports that it released memory. Pass a null callback to
+ * remove it.
+ * 
+ * @param[in] callback The callback, or null
+ * @param[in] user_data Opaque pointer passed to every invocation of callback
+ * @return rmmError_t RMM_SUCCESS
+ * --------------------------------------------------------------------------**/
+rmmError_t rmmSetOutOfMemoryCallback(rmmOutOfMemoryCallback_t callback,
+                                     void *user_data);
@@ -33,6 +33,7 @@
 
 #include "memory.h"
 #include "cnmem.h"
+#include "allocation_tracker.h"
 
 /** ---------------------------------------------------------------------------*
  * @brief Macro wrapper for CNMEM API calls to return appropriate RMM errors.
@@ -119,15 +120,44 @@ namespace rmm
 
         static Logger& getLogger() { return getInstance().logger; }
 
+        static AllocationTracker& getTracker() { return getInstance().tracker; }
+
         static void setOptions(const rmmOptions_t &options) { 
             getInstance().options = options; 
         }
         static rmmOptions_t getOptions() { return getInstance().options; }
 
+        void setOutOfMemoryCallback(rmmOutOfMemoryCallback_t callback,
+                                    void *user_data) {
+            std::lock_guard<std::mutex> guard(callback_mutex);
+            oom_callback = callback;
+            oom_callback_data = user_data;
+        }
+
+        /** ---------------------------------------------------------------------------*
+         * @brief Invoke the out of memory callback, if any.
+         * 
+         * @param size The size of the failed allocation
+         * @return bool true if the callback released memory and the allocation
+         *              should be retried
+         * ---------------------------------------------------------------------------**/
+        bool onOutOfMemory(size_t size) {
+            rmmOutOfMemoryCallback_t callback;
+            void *user_data;
+            {
+                std::lock_guard<std::mutex> guard(callback_mutex);
+                callback = oom_callback;
+                user_data = oom_callback_data;
+            }
+            // Invoked unlocked: the callback typically frees memory through RMM
+            return callback && callback(size, user_data);
+        }
+
         void finalize() {
             std::lock_guard<std::mutex> guard(streams_mutex);
             registered_streams.clear();
             logger.clear();
+            tracker.clear();
         }
 
         /** ---------------------------------------------------------------------------*
@@ -150,7 +180,7 @@ namespace rmm
         }
 
     private:
-        Manager() : options({ CudaDefaultAllocation, false, 0 }) {}
+        Manager() : options({ CudaDefaultAllocation, 0, false, false }) {}
         ~Manager() = default;
         Manager(const Manager&) = delete;
         Manager& operator=(const Manager&) = delete;
@@ -158,6 +188,11 @@ namespace rmm
         std::mutex streams_mutex;
         std::set<cudaStream_t> registered_streams;
         Logger logger;
+        AllocationTracker tracker;
+
+        std::mutex callback_mutex;
+        rmmOutOfMemoryCallback_t oom_callback{nullptr};
+        void *oom_callback_data{nullptr};
 
         rmmOptions_t options;
     };    
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** ---------------------------------------------------------------------------*
+ * @brief Stream-ordered memory pool with event-based cross-stream reuse.
+ *
+ * A block freed on a stream is immediately reusable by later allocations on
+ * the same stream, because work on a stream executes in order. When the block
+ * is freed an event is recorded on the freeing stream. An allocation on
+ * another stream can then reuse the block without growing the pool:
+ *
+ *  1. a free block of the same stream is reused directly;
+ *  2. otherwise a block of another stream whose event has completed is reused
+ *     directly;
+ *  3. otherwise the allocating stream is made to wait on the event of a
+ *     pending block of another stream, which is then reused;
+ *  4. otherwise the pool grows by allocating from the backend. On failure all
+ *     free blocks whose events have completed are returned to the backend and
+ *     the allocation is retried once.
+ *
+ * Blocks are never split: a free block is only reused for a request of at
+ * least half its size, which bounds the waste to 2x.
+ *
+ * The pool is parameterized on a Backend providing the raw allocation and the
+ * stream/event primitives, so the bookkeeping can be tested with simulated
+ * streams and events on the host. The Backend must provide:
+ *
+ *   typedef ... stream_type;
+ *   typedef ... event_type;
+ *   rmmError_t allocate(void **ptr, size_t size);
+ *   rmmError_t deallocate(void *ptr);
+ *   rmmError_t create_event(event_type *event);
+ *   rmmError_t destroy_event(event_type event);
+ *   rmmError_t record_event(event_type event, stream_type stream);
+ *   bool event_completed(event_type event);
+ *   rmmError_t stream_wait_event(stream_type stream, event_type event);
+ *
+ * Note: assumes at least C++11
+ * ---------------------------------------------------------------------------**/
+
+#ifndef STREAM_ORDERED_POOL_H
+#define STREAM_ORDERED_POOL_H
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+#include "memory.h"
+
+namespace rmm
+{
+    template <typename Backend>
+    class StreamOrderedPool
+    {
+    public:
+        using stream_type = typename Backend::stream_type;
+        using event_type = typename Backend::event_type;
+
+        /// Allocation sizes are rounded up to a multiple of this
+        static constexpr size_t allocation_alignment = 256;
+
+        /// Counters describing how allocations were satisfied
+        struct Stats {
+            size_t same_stream_reuses{0};   //< reused a block freed on the same stream
+            size_t cross_stream_reuses{0};  //< reused a completed block of another stream
+            size_t cross_stream_waits{0};   //< reused a pending block after a stream wait
+            size_t backend_allocations{0};  //< grew the pool
+            size_t pool_size{0};            //< bytes currently held from the backend
+        };
+
+        explicit StreamOrderedPool(Backend backend = Backend()) : backend(backend) {}
+
+        ~StreamOrderedPool() { release(); }
+
+        StreamOrderedPool(const StreamOrderedPool&) = delete;
+        StreamOrderedPool& operator=(const StreamOrderedPool&) = delete;
+
+        /** ---------------------------------------------------------------------------*
+         * @brief Allocate a block usable in stream order on stream.
+         *
+         * @param[out] ptr Returned pointer
+         * @param[in] size The size in bytes of the allocation
+         * @param[in] stream The stream the allocation will be used on
+         * @return rmmError_t RMM_SUCCESS, RMM_ERROR_INVALID_ARGUMENT if ptr is null,
+         *                    or the backend error if the pool cannot grow.
+         * ---------------------------------------------------------------------------**/
+        rmmError_t allocate(void **ptr, size_t size, stream_type stream)
+        {
+            if (!ptr) return RMM_ERROR_INVALID_ARGUMENT;
+            size = align(size);
+            std::lock_guard<std::mutex> guard(pool_mutex);
+
+            // 1. same stream: stream order makes the block safe to reuse
+            auto own = free_blocks.find(stream);
+            if (own != free_blocks.end()) {
+                auto b = find_fit(own->second, size);
+                if (b != own->second.end()) {
+                    ++stats.same_stream_reuses;
+                    *ptr = take(own, b);
+                    return RMM_SUCCESS;
+                }
+            }
+
+            // 2. another stream, once the work preceding its free has completed
+            for (auto s = free_blocks.begin(); s != free_blocks.end(); ++s) {
+                if (s->first == stream) continue;
+                for (auto b = find_fit(s->second, size);
+                     b != s->second.end() && fits(b->first, size); ++b) {
+                    if (backend.event_completed(b->second.event)) {
+                        ++stats.cross_stream_reuses;
+                        *ptr = take(s, b);
+                        return RMM_SUCCESS;
+                    }
+                }
+            }
+
+            // 3. another stream, ordering the allocating stream after the free
+            for (auto s = free_blocks.begin(); s != free_blocks.end(); ++s) {
+                if (s->first == stream) continue;
+                auto b = find_fit(s->second, size);
+                if (b != s->second.end()) {
+                    rmmError_t error = backend.stream_wait_event(stream, b->second.event);
+                    if (RMM_SUCCESS != error) return error;
+                    ++stats.cross_stream_waits;
+                    *ptr = take(s, b);
+                    return RMM_SUCCESS;
+                }
+            }
+
+            // 4. grow the pool
+            rmmError_t error = backend.allocate(ptr, size);
+            if (RMM_ERROR_OUT_OF_MEMORY == error) {
+                release_completed();
+                error = backend.allocate(ptr, size);
+            }
+            if (RMM_SUCCESS != error) return error;
+
+            event_type event;
+            error = backend.create_event(&event);
+            if (RMM_SUCCESS != error) {
+                backend.deallocate(*ptr);
+                return error;
+            }
+            ++stats.backend_allocations;
+            stats.pool_size += size;
+            allocated[*ptr] = Block{*ptr, size, event};
+            return RMM_SUCCESS;
+        }
+
+        /** ---------------------------------------------------------------------------*
+         * @brief Return a block to the pool in stream order on stream.
+         *
+         * The block becomes immediately available to allocations on stream, and
+         * to allocations on other streams once the work enqueued on stream before
+         * this call has completed.
+         *
+         * @param[in] ptr The pointer to free
+         * @param[in] stream The stream the block was last used on
+         * @return rmmError_t RMM_SUCCESS, or RMM_ERROR_INVALID_ARGUMENT if ptr was
+         *                    not allocated by this pool.
+         * ---------------------------------------------------------------------------**/
+        rmmError_t deallocate(void *ptr, stream_type stream)
+        {
+            if (!ptr) return RMM_SUCCESS;
+            std::lock_guard<std::mutex> guard(pool_mutex);
+            auto it = allocated.find(ptr);
+            if (it == allocated.end()) return RMM_ERROR_INVALID_ARGUMENT;
+            Block block = it->second;
+            rmmError_t error = backend.record_event(block.event, stream);
+            if (RMM_SUCCESS != error) return error;
+            allocated.erase(it);
+            free_blocks[stream].emplace(block.size, block);
+            return RMM_SUCCESS;
+        }
+
+        /// Return all free blocks to the backend. Outstanding allocations are
+        /// not affected.
+        rmmError_t release()
+        {
+            std::lock_guard<std::mutex> guard(pool_mutex);
+            rmmError_t result = RMM_SUCCESS;
+            for (auto& s : free_blocks) {
+                for (auto& b : s.second) {
+                    rmmError_t error = destroy(b.second);
+                    if (RMM_SUCCESS != error) result = error;
+                }
+            }
+            free_blocks.clear();
+            return result;
+        }
+
+        /// Size of an outstanding allocation, or 0 if ptr was not allocated by
+        /// this pool.
+        size_t allocation_size(void *ptr) {
+            std::lock_guard<std::mutex> guard(pool_mutex);
+            auto it = allocated.find(ptr);
+            return it == allocated.end() ? 0 : it->second.size;
+        }
+
+        /// Number of free blocks held by the pool over all streams
+        size_t free_block_count() {
+            std::lock_guard<std::mutex> guard(pool_mutex);
+            size_t count = 0;
+            for (auto const& s : free_blocks) count += s.second.size();
+            return count;
+        }
+
+        /// Bytes held by the pool in free blocks over all streams, and bytes
+        /// held by the pool from the backend
+        void get_info(size_t *free_size, size_t *total_size) {
+            std::lock_guard<std::mutex> guard(pool_mutex);
+            size_t free_bytes = 0;
+            for (auto const& s : free_blocks)
+                for (auto const& b : s.second) free_bytes += b.first;
+            if (free_size) *free_size = free_bytes;
+            if (total_size) *total_size = stats.pool_size;
+        }
+
+        Stats get_stats() {
+            std::lock_guard<std::mutex> guard(pool_mutex);
+            return stats;
+        }
+
+        Backend& get_backend() { return backend; }
+
+    private:
+        struct Block {
+            void* ptr;
+            size_t size;
+            event_type event;   //< recorded on the freeing stream
+        };
+
+        // Free blocks of one stream, ordered by size for best fit
+        using FreeList = std::multimap<size_t, Block>;
+        using FreeLists = std::map<stream_type, FreeList>;
+
+        static size_t align(size_t size) {
+            return allocation_alignment *
+                   ((size + allocation_alignment - 1) / allocation_alignment);
+        }
+
+        static bool fits(size_t block_size, size_t size) {
+            return block_size / 2 <= size;
+        }
+
+        static typename FreeList::iterator find_fit(FreeList& list, size_t size) {
+            auto b = list.lower_bound(size);
+            if (b != list.end() && !fits(b->first, size)) return list.end();
+            return b;
+        }
+
+        void* take(typename FreeLists::iterator s, typename FreeList::iterator b)
+        {
+            Block block = b->second;
+            s->second.erase(b);
+            if (s->second.empty()) free_blocks.erase(s);
+            allocated[block.ptr] = block;
+            return block.ptr;
+        }
+
+        rmmError_t destroy(Block const& block) {
+            stats.pool_size -= block.size;
+            rmmError_t error = backend.destroy_event(block.event);
+            rmmError_t dealloc_error = backend.deallocate(block.ptr);
+            return RMM_SUCCESS != error ? error : dealloc_error;
+        }
+
+        void release_completed() {
+            for (auto s = free_blocks.begin(); s != free_blocks.end(); ) {
+                for (auto b = s->second.begin(); b != s->second.end(); ) {
+                    if (backend.event_completed(b->second.event)) {
+                        destroy(b->second);
+                        b = s->second.erase(b);
+                    }
+                    else ++b;
+                }
+                if (s->second.empty()) s = free_blocks.erase(s);
+                else ++s;
+            }
+        }
+
+        Backend backend;
+        FreeLists free_blocks;
+        std::unordered_map<void*, Block> allocated;
+        Stats stats;
+        std::mutex pool_mutex;
+    };
+
+    template <typename Backend>
+    constexpr size_t StreamOrderedPool<Backend>::allocation_alignment;
+}
+
+#endif // STREAM_ORDERED_POOL_H
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** ---------------------------------------------------------------------------*
+ * @brief Spilling of gdf_columns to pinned host memory under memory pressure
+ *
+ * @file spill.cpp
+ * ---------------------------------------------------------------------------**/
+
+#include "cudf.h"
+#include "utilities/cudf_utils.h"
+#include "utilities/error_utils.h"
+#include "rmm/rmm.h"
+#include "spill/spill_manager.h"
+#include <cuda_runtime_api.h>
+
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+  /// SpillManager backend: device memory from RMM, pinned host memory
+  struct CudaSpillBackend
+  {
+    gdf_error device_allocate(void **ptr, size_t size) {
+      RMM_TRY( RMM_ALLOC(ptr, size, 0) );
+      return GDF_SUCCESS;
+    }
+
+    gdf_error device_free(void *ptr) {
+      RMM_TRY( RMM_FREE(ptr, 0) );
+      return GDF_SUCCESS;
+    }
+
+    gdf_error host_allocate(void **ptr, size_t size) {
+      CUDA_TRY( cudaMallocHost(ptr, size) );
+      return GDF_SUCCESS;
+    }
+
+    gdf_error host_free(void *ptr) {
+      CUDA_TRY( cudaFreeHost(ptr) );
+      return GDF_SUCCESS;
+    }
+
+    gdf_error copy_to_host(void *dst, const void *src, size_t size) {
+      CUDA_TRY( cudaMemcpy(dst, src, size, cudaMemcpyDeviceToHost) );
+      return GDF_SUCCESS;
+    }
+
+    gdf_error copy_to_device(void *dst, const void *src, size_t size) {
+      CUDA_TRY( cudaMemcpy(dst, src, size, cudaMemcpyHostToDevice) );
+      return GDF_SUCCESS;
+    }
+  };
+
+  using spill_manager = cudf::SpillManager<CudaSpillBackend>;
+
+  /// The spill manager buffers of a registered column
+  struct spillable_column {
+    gdf_spill_handle data;
+    gdf_spill_handle valid;   //< 0 if the column has no validity mask
+  };
+
+  spill_manager& get_spill_manager()
+  {
+    static spill_manager manager;
+    return manager;
+  }
+
+  std::mutex columns_mutex;
+  std::unordered_map<gdf_spill_handle, spillable_column> columns;
+
+  bool find_column(gdf_spill_handle handle, spillable_column *column)
+  {
+    std::lock_guard<std::mutex> guard(columns_mutex);
+    auto it = columns.find(handle);
+    if (it == columns.end()) return false;
+    *column = it->second;
+    return true;
+  }
+
+  bool spill_on_out_of_memory(size_t size, void *)
+  {
+    return get_spill_manager().spill(size) > 0;
+  }
+
+  /// Map spill manager errors of the C API to the documented codes
+  gdf_error memory_error(gdf_error error)
+  {
+    return (GDF_SUCCESS == error || GDF_INVALID_API_CALL == error)
+           ? error : GDF_MEMORYMANAGER_ERROR;
+  }
+}
+
+gdf_error gdf_spill_enable(int enable)
+{
+  RMM_TRY( rmmSetOutOfMemoryCallback(enable ? spill_on_out_of_memory : nullptr,
+                                     nullptr) );
+  return GDF_SUCCESS;
+}
+
+gdf_error gdf_spill_register(gdf_column *column, gdf_spill_handle *handle)
+{
+  GDF_REQUIRE(nullptr != column && nullptr != handle, GDF_INVALID_API_CALL);
+  GDF_REQUIRE(nullptr != column->data, GDF_DATASET_EMPTY);
+
+  int byte_width = 0;
+  gdf_error result = get_column_byte_width(column, &byte_width);
+  if (GDF_SUCCESS != result) return result;
+
+  spill_manager& manager = get_spill_manager();
+  spillable_column buffers{0, 0};
+  result = manager.register_buffer(column->data, byte_width * column->size,
+                                   &buffers.data);
+  if (GDF_SUCCESS != result) return result;
+  if (nullptr != column->valid) {
+    result = manager.register_buffer(column->valid,
+                                     gdf_get_num_chars_bitmask(column->size),
+                                     &buffers.valid);
+    if (GDF_SUCCESS != result) {
+      void *data = nullptr;
+      manager.unregister(buffers.data, &data);
+      return result;
+    }
+  }
+
+  std::lock_guard<std::mutex> guard(columns_mutex);
+  *handle = buffers.data;
+  columns[*handle] = buffers;
+  return GDF_SUCCESS;
+}
+
+gdf_error gdf_spill_acquire(gdf_spill_handle handle, gdf_column *column)
+{
+  GDF_REQUIRE(nullptr != column, GDF_INVALID_API_CALL);
+  spillable_column buffers;
+  GDF_REQUIRE(find_column(handle, &buffers), GDF_INVALID_API_CALL);
+
+  spill_manager& manager = get_spill_manager();
+  void *data = nullptr, *valid = nullptr;
+  gdf_error result = manager.acquire(buffers.data, &data);
+  if (GDF_SUCCESS != result) return memory_error(result);
+  if (0 != buffers.valid) {
+    result = manager.acquire(buffers.valid, &valid);
+    if (GDF_SUCCESS != result) {
+      manager.release(buffers.data);
+      return memory_error(result);
+    }
+  }
+  column->data = data;
+  column->valid = static_cast<gdf_valid_type*>(valid);
+  return GDF_SUCCESS;
+}
+
+gdf_error gdf_spill_release(gdf_spill_handle handle)
+{
+  spillable_column buffers;
+  GDF_REQUIRE(find_column(handle, &buffers), GDF_INVALID_API_CALL);
+
+  spill_manager& manager = get_spill_manager();
+  gdf_error result = manager.release(buffers.data);
+  if (GDF_SUCCESS != result) return result;
+  if (0 != buffers.valid) return manager.release(buffers.valid);
+  return GDF_SUCCESS;
+}
+
+gdf_error gdf_spill_unregister(gdf_spill_handle handle, gdf_column *column)
+{
+  GDF_REQUIRE(nullptr != column, GDF_INVALID_API_CALL);
+  spillable_column buffers;
+  GDF_REQUIRE(find_column(handle, &buffers), GDF_INVALID_API_CALL);
+
+  // Unregister both buffers at once, so that a failure leaves the column
+  // registered as a whole
+  spill_manager& manager = get_spill_manager();
+  gdf_spill_handle handles[2] = {buffers.data, buffers.valid};
+  void *device_ptrs[2] = {nullptr, nullptr};
+  gdf_error result = manager.unregister(handles, (0 != buffers.valid) ? 2 : 1,
+                                        device_ptrs);
+  if (GDF_SUCCESS != result) return memory_error(result);
+
+  {
+    std::lock_guard<std::mutex> guard(columns_mutex);
+    columns.erase(handle);
+  }
+  column->data = device_ptrs[0];
+  column->valid = static_cast<gdf_valid_type*>(device_ptrs[1]);
+  return GDF_SUCCESS;
+}
@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** ---------------------------------------------------------------------------*
+ * @brief Spill manager for device buffers.
+ *
+ * Buffers registered with the manager are "spillable": while no one holds them
+ * (see acquire/release) they may be copied to host memory and their device
+ * memory freed to make room for other allocations. Device-resident buffers are
+ * kept in least recently used order, and spill() evicts the coldest unpinned
+ * buffers first. A spilled buffer is copied back to the device the next time
+ * it is acquired, so it may live at a different device address afterwards.
+ *
+ * The manager is parameterized on a Backend providing the memory primitives,
+ * so the policy and bookkeeping can be tested with host memory. The Backend
+ * must provide:
+ *
+ *   gdf_error device_allocate(void **ptr, size_t size);
+ *   gdf_error device_free(void *ptr);
+ *   gdf_error host_allocate(void **ptr, size_t size);
+ *   gdf_error host_free(void *ptr);
+ *   gdf_error copy_to_host(void *dst, const void *src, size_t size);
+ *   gdf_error copy_to_device(void *dst, const void *src, size_t size);
+ *
+ * The manager is reentrant: device_allocate may itself trigger spill() (e.g.
+ * through the RMM out of memory callback) while a buffer is being unspilled.
+ *
+ * Note: assumes at least C++11
+ * ---------------------------------------------------------------------------**/
+
+#ifndef SPILL_MANAGER_H
+#define SPILL_MANAGER_H
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "cudf/types.h"
+
+namespace cudf
+{
+    template <typename Backend>
+    class SpillManager
+    {
+    public:
+        using handle_type = gdf_spill_handle;
+
+        struct Stats {
+            size_t device_bytes{0};     //< bytes of registered buffers on the device
+            size_t host_bytes{0};       //< bytes of registered buffers spilled to host
+            size_t spill_count{0};      //< number of buffers spilled
+            size_t unspill_count{0};    //< number of buffers copied back to the device
+        };
+
+        explicit SpillManager(Backend backend = Backend()) : backend(backend) {}
+
+        ~SpillManager() {
+            for (auto& b : buffers) {
+                if (b.second.host_ptr) backend.host_free(b.second.host_ptr);
+            }
+        }
+
+        SpillManager(const SpillManager&) = delete;
+        SpillManager& operator=(const SpillManager&) = delete;
+
+        /** ---------------------------------------------------------------------------*
+         * @brief Make a device buffer spillable.
+         *
+         * The manager takes ownership of the buffer until it is unregistered.
+         *
+         * @param[in] device_ptr The device buffer
+         * @param[in] size The size of the buffer in bytes
+         * @param[out] handle The handle to acquire the buffer with
+         * @return gdf_error GDF_SUCCESS, or GDF_DATASET_EMPTY if device_ptr is null
+         * ---------------------------------------------------------------------------**/
+        gdf_error register_buffer(void *device_ptr, size_t size, handle_type *handle)
+        {
+            if (nullptr == device_ptr) return GDF_DATASET_EMPTY;
+            std::lock_guard<std::recursive_mutex> guard(manager_mutex);
+            *handle = ++last_handle;
+            Buffer& b = buffers[*handle];
+            b.device_ptr = device_ptr;
+            b.size = size;
+            b.lru_position = lru.insert(lru.end(), *handle);
+            stats.device_bytes += size;
+            return GDF_SUCCESS;
+        }
+
+        /** ---------------------------------------------------------------------------*
+         * @brief Get the device pointer of a buffer and pin it on the device.
+         *
+         * Unspills the buffer if needed. The buffer cannot be spilled until a
+         * matching release(). Acquires may be nested.
+         *
+         * @param[in] handle The buffer handle
+         * @param[out] device_ptr The device address of the buffer
+         * @return gdf_error GDF_SUCCESS, GDF_INVALID_API_CALL if handle is unknown,
+         *                   or the backend error if the buffer cannot be unspilled
+         * ---------------------------------------------------------------------------**/
+        gdf_error acquire(handle_type handle, void **device_ptr)
+        {
+            std::lock_guard<std::recursive_mutex> guard(manager_mutex);
+            auto it = buffers.find(handle);
+            if (it == buffers.end()) return GDF_INVALID_API_CALL;
+            gdf_error error = unspill(handle);
+            if (GDF_SUCCESS != error) return error;
+            Buffer& b = buffers[handle];
+            ++b.pin_count;
+            touch(b);
+            *device_ptr = b.device_ptr;
+            return GDF_SUCCESS;
+        }
+
+        /** ---------------------------------------------------------------------------*
+         * @brief Unpin a buffer previously acquired, making it spillable again.
+         *
+         * @param[in] handle The buffer handle
+         * @return gdf_error GDF_SUCCESS, or GDF_INVALID_API_CALL if handle is unknown
+         *                   or not acquired
+         * ---------------------------------------------------------------------------**/
+        gdf_error release(handle_type handle)
+        {
+            std::lock_guard<std::recursive_mutex> guard(manager_mutex);
+            auto it = buffers.find(handle);
+            if (it == buffers.end() || 0 == it->second.pin_count)
+                return GDF_INVALID_API_CALL;
+            --it->second.pin_count;
+            return GDF_SUCCESS;
+        }
+
+        /** ---------------------------------------------------------------------------*
+         * @brief Stop managing a buffer and return its ownership to the caller.
+         *
+         * Unspills the buffer if needed.
+         *
+         * @param[in] handle The buffer handle
+         * @param[out] device_ptr The device address of the buffer
+         * @return gdf_error GDF_SUCCESS, GDF_INVALID_API_CALL if handle is unknown
+         *                   or still acquired, or the backend error if the buffer
+         *                   cannot be unspilled
+         * ---------------------------------------------------------------------------**/
+        gdf_error unregister(handle_type handle, void **device_ptr)
+        {
+            return unregister(&handle, 1, device_ptr);
+        }
+
+        /** ---------------------------------------------------------------------------*
+         * @brief Stop managing several buffers at once, or none of them.
+         *
+         * Unspills every buffer, pinning each one so that unspilling the next
+         * cannot spill it again, before any of them is unregistered. On failure
+         * all the buffers remain registered.
+         *
+         * @param[in] handles The distinct buffer handles
+         * @param[in] count The number of handles
+         * @param[out] device_ptrs The device addresses of the buffers
+         * @return gdf_error GDF_SUCCESS, GDF_INVALID_API_CALL if a handle is unknown
+         *                   or still acquired, or the backend error if a buffer
+         *                   cannot be unspilled
+         * ---------------------------------------------------------------------------**/
+        gdf_error unregister(handle_type const *handles, size_t count, void **device_ptrs)
+        {
+            std::lock_guard<std::recursive_mutex> guard(manager_mutex);
+            for (size_t i = 0; i < count; ++i) {
+                auto it = buffers.find(handles[i]);
+                if (it == buffers.end() || it->second.pin_count > 0)
+                    return GDF_INVALID_API_CALL;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                gdf_error error = unspill(handles[i]);
+                if (GDF_SUCCESS != error) {
+                    while (i-- > 0) --buffers[handles[i]].pin_count;
+                    return error;
+                }
+                ++buffers[handles[i]].pin_count;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                Buffer& b = buffers[handles[i]];
+                device_ptrs[i] = b.device_ptr;
+                stats.device_bytes -= b.size;
+                lru.erase(b.lru_position);
+                buffers.erase(handles[i]);
+            }
+            return GDF_SUCCESS;
+        }
+
+        /** ---------------------------------------------------------------------------*
+         * @brief Spill least recently used unpinned buffers to host memory until at
+         * least size bytes of device memory have been freed.
+         *
+         * @param[in] size The number of bytes of device memory to free
+         * @return size_t The number of bytes actually freed, which may be smaller
+         *                than size (or zero) if there is nothing left to spill.
+         * ---------------------------------------------------------------------------**/
+        size_t spill(size_t size)
+        {
+            std::lock_guard<std::recursive_mutex> guard(manager_mutex);
+            size_t freed = 0;
+            for (auto l = lru.begin(); l != lru.end() && freed < size; ) {
+                Buffer& b = buffers[*l];
+                if (b.pin_count > 0 || nullptr == b.device_ptr) { ++l; continue; }
+
+                void *host_ptr = nullptr;
+                if (GDF_SUCCESS != backend.host_allocate(&host_ptr, b.size)) break;
+                if (GDF_SUCCESS != backend.copy_to_host(host_ptr, b.device_ptr, b.size) ||
+                    GDF_SUCCESS != backend.device_free(b.device_ptr)) {
+                    backend.host_free(host_ptr);
+                    ++l;
+                    continue;
+                }
+                b.host_ptr = host_ptr;
+                b.device_ptr = nullptr;
+                l = lru.erase(l);
+                b.lru_position = lru.end();
+                stats.device_bytes -= b.size;
+                stats.host_bytes += b.size;
+                ++stats.spill_count;
+                freed += b.size;
+            }
+            return freed;
+        }
+
+        /// Whether the buffer currently lives in host memory
+        bool is_spilled(handle_type handle) {
+            std::lock_guard<std::recursive_mutex> guard(manager_mutex);
+            auto it = buffers.find(handle);
+            return it != buffers.end() && nullptr != it->second.host_ptr;
+        }
+
+        Stats get_stats() {
+            std::lock_guard<std::recursive_mutex> guard(manager_mutex);
+            return stats;
+        }
+
+        Backend& get_backend() { return backend; }
+
+    private:
+        struct Buffer {
+            void *device_ptr{nullptr};  //< null while spilled
+            void *host_ptr{nullptr};    //< null while on the device
+            size_t size{0};
+            int pin_count{0};
+            std::list<handle_type>::iterator lru_position;
+        };
+
+        /// Move a device-resident buffer to the most recently used position
+        void touch(Buffer& b) {
+            lru.splice(lru.end(), lru, b.lru_position);
+        }
+
+        /// Copy a spilled buffer back to the device. device_allocate may spill
+        /// other buffers, but never this one since it is not device-resident.
+        gdf_error unspill(handle_type handle)
+        {
+            if (nullptr == buffers[handle].host_ptr) return GDF_SUCCESS;
+            size_t size = buffers[handle].size;
+
+            void *device_ptr = nullptr;
+            gdf_error error = backend.device_allocate(&device_ptr, size);
+            // Make room ourselves in case the backend has no out of memory hook
+            if (GDF_SUCCESS != error && spill(size) > 0)
+                error = backend.device_allocate(&device_ptr, size);
+            if (GDF_SUCCESS != error) return error;
+
+            Buffer& b = buffers[handle];
+            error = backend.copy_to_device(device_ptr, b.host_ptr, size);
+            if (GDF_SUCCESS != error) {
+                backend.device_free(device_ptr);
+                return error;
+            }
+            backend.host_free(b.host_ptr);
+            b.host_ptr = nullptr;
+            b.device_ptr = device_ptr;
+            b.lru_position = lru.insert(lru.end(), handle);
+            stats.host_bytes -= size;
+            stats.device_bytes += size;
+            ++stats.unspill_count;
+            return GDF_SUCCESS;
+        }
+
+        Backend backend;
+        std::unordered_map<handle_type, Buffer> buffers;
+        std::list<handle_type> lru;     //< device-resident buffers, coldest first
+        handle_type last_handle{0};
+        Stats stats;
+        std::recursive_mutex manager_mutex;
+    };
+}
+
+#endif // SPILL_MANAGER_H
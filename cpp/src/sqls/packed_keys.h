@@ -0,0 +1,356 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PACKED_KEYS_H
+#define PACKED_KEYS_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "cudf.h"
+#include "utilities/cudf_utils.h"
+
+// The packed key of a row is a single unsigned integer of at most this many bits
+constexpr int MAX_PACKED_KEY_BITS{64};
+
+// Every column is at least 8 bits wide, so a packed key has at most this many columns
+constexpr int MAX_PACKED_KEY_COLUMNS{MAX_PACKED_KEY_BITS / 8};
+
+// Whether the keys of this many rows can be radix sorted: cub's radix sort
+// takes the number of items as an int
+inline bool radix_sortable_rows(size_t num_rows)
+{
+  return num_rows <= static_cast<size_t>(std::numeric_limits<int>::max());
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Maps a value to an unsigned integer of the same width whose
+ * unsigned order is the order of the values, so that the value can be radix
+ * sorted as unsigned bits.
+ *
+ * The sign bit of a signed integer is flipped. The bits of a positive float
+ * get their sign bit set, and all the bits of a negative float are flipped.
+ * -0.0 is normalized like 0.0, as they are equal, and every NaN to the same
+ * value, which is greater than infinity.
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename T>
+__host__ __device__ __forceinline__
+typename std::enable_if<std::is_integral<T>::value, uint64_t>::type
+normalize_key(T value)
+{
+  using unsigned_type = typename std::make_unsigned<T>::type;
+  constexpr unsigned_type sign_bit = std::is_signed<T>::value
+                                     ? static_cast<unsigned_type>(unsigned_type{1} << (8 * sizeof(T) - 1))
+                                     : unsigned_type{0};
+  return static_cast<unsigned_type>(static_cast<unsigned_type>(value) ^ sign_bit);
+}
+
+template <typename T>
+__host__ __device__ __forceinline__
+typename std::enable_if<std::is_floating_point<T>::value, uint64_t>::type
+normalize_key(T value)
+{
+  using bits_type = typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type;
+  constexpr bits_type sign_bit{bits_type{1} << (8 * sizeof(T) - 1)};
+
+  if (value != value) {
+    value = T(NAN);
+  }
+  else if (value == T{0}) {
+    value = T{0};
+  }
+
+  bits_type bits;
+  memcpy(&bits, &value, sizeof(T));
+  return (bits & sign_bit) ? static_cast<bits_type>(~bits) : static_cast<bits_type>(bits | sign_bit);
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The number of bits of a column of the given dtype in a packed
+ * key, or 0 if the dtype cannot be packed
+ */
+/* ----------------------------------------------------------------------------*/
+__host__ __device__
+inline int packed_key_bits(gdf_dtype dtype)
+{
+  switch (dtype) {
+    case GDF_INT8:    return 8;
+    case GDF_INT16:   return 16;
+    case GDF_INT32:   return 32;
+    case GDF_INT64:   return 64;
+    case GDF_FLOAT32: return 32;
+    case GDF_FLOAT64: return 64;
+    default:          return 0;
+  }
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  How the key columns of a table are packed into a single unsigned
+ * integer per row.
+ *
+ * The normalized value of every column is shifted into its own bits, the
+ * first column in the most significant ones, so that the order of the packed
+ * keys is the lexicographic order of the rows, and equal packed keys are
+ * equal rows. The key occupies the low total_bits bits, the only bits a radix
+ * sort of the keys needs to sort.
+ */
+/* ----------------------------------------------------------------------------*/
+struct packed_key_layout
+{
+  int num_columns{0};
+  int total_bits{0};
+  void const * columns[MAX_PACKED_KEY_COLUMNS]; ///< The data of every column
+  gdf_dtype dtypes[MAX_PACKED_KEY_COLUMNS];     ///< The dtype of every column
+  int shifts[MAX_PACKED_KEY_COLUMNS];           ///< The position of the lowest bit of every column
+
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  The packed key of a row
+   */
+  /* ----------------------------------------------------------------------------*/
+  __host__ __device__
+  uint64_t pack(size_t row) const
+  {
+    uint64_t key{0};
+    for (int c = 0; c < num_columns; ++c) {
+      uint64_t value{0};
+      switch (dtypes[c]) {
+        case GDF_INT8:    value = normalize_key(static_cast<int8_t const *>(columns[c])[row]); break;
+        case GDF_INT16:   value = normalize_key(static_cast<int16_t const *>(columns[c])[row]); break;
+        case GDF_INT32:   value = normalize_key(static_cast<int32_t const *>(columns[c])[row]); break;
+        case GDF_INT64:   value = normalize_key(static_cast<int64_t const *>(columns[c])[row]); break;
+        case GDF_FLOAT32: value = normalize_key(static_cast<float const *>(columns[c])[row]); break;
+        case GDF_FLOAT64: value = normalize_key(static_cast<double const *>(columns[c])[row]); break;
+        default: break;
+      }
+      key |= value << shifts[c];
+    }
+    return key;
+  }
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Computes how the key columns of a table are packed
+ *
+ * @Param num_columns The number of key columns
+ * @Param columns The key columns
+ * @Param[out] layout Receives the layout of the packed keys
+ *
+ * @Returns False if the columns cannot be packed: there are no columns, a
+ * column has an unsupported dtype or NULLs, or the columns are wider than
+ * MAX_PACKED_KEY_BITS in total
+ */
+/* ----------------------------------------------------------------------------*/
+inline bool make_packed_key_layout(int num_columns,
+                                   gdf_column const * columns,
+                                   packed_key_layout & layout)
+{
+  if ((num_columns <= 0) || (num_columns > MAX_PACKED_KEY_COLUMNS)) {
+    return false;
+  }
+
+  int total_bits{0};
+  for (int c = 0; c < num_columns; ++c) {
+    const int bits = packed_key_bits(columns[c].dtype);
+    if ((0 == bits) || ((nullptr != columns[c].valid) && (columns[c].null_count > 0))) {
+      return false;
+    }
+    total_bits += bits;
+  }
+  if (total_bits > MAX_PACKED_KEY_BITS) {
+    return false;
+  }
+
+  layout.num_columns = num_columns;
+  layout.total_bits = total_bits;
+  int shift{total_bits};
+  for (int c = 0; c < num_columns; ++c) {
+    shift -= packed_key_bits(columns[c].dtype);
+    layout.columns[c] = columns[c].data;
+    layout.dtypes[c] = columns[c].dtype;
+    layout.shifts[c] = shift;
+  }
+  return true;
+}
+
+// An ORDER BY sorts the rows on keys of this many columns at most
+constexpr int MAX_NORMALIZED_KEY_COLUMNS{32};
+
+// The normalized key of a row is split into words of this many bits
+constexpr int NORMALIZED_KEY_WORD_BITS{64};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  How the sort columns of an ORDER BY are normalized into a key of
+ * one or more unsigned 64 bit words per row.
+ *
+ * Every column takes the next bits of the key, the first column the most
+ * significant bits of the first word, so that the order of the keys, compared
+ * word by word, is the order of the rows. A column with NULLs starts with a
+ * NULL bit: 0 for the rows sorted first, NULL or not depending on
+ * nulls_first, and the value bits of a NULL are 0. The value bits of a
+ * descending column are flipped. A column may straddle two words.
+ *
+ * The key occupies the high total_bits bits of its words, so the low bits of
+ * the last word need not be sorted.
+ */
+/* ----------------------------------------------------------------------------*/
+struct normalized_key_layout
+{
+  int num_columns{0};
+  int total_bits{0};
+  void const * columns[MAX_NORMALIZED_KEY_COLUMNS];          ///< The data of every column
+  gdf_valid_type const * valids[MAX_NORMALIZED_KEY_COLUMNS]; ///< The validity of every column, nullptr for no NULL bit
+  gdf_dtype dtypes[MAX_NORMALIZED_KEY_COLUMNS];              ///< The dtype of every column
+  bool descending[MAX_NORMALIZED_KEY_COLUMNS];               ///< Whether every column is sorted descending
+  bool nulls_first[MAX_NORMALIZED_KEY_COLUMNS];              ///< Whether the NULLs of every column are sorted first
+  int offsets[MAX_NORMALIZED_KEY_COLUMNS];                   ///< The position of the first bit of every column, from the most significant bit of the key
+
+  __host__ __device__
+  int num_words() const
+  {
+    return (total_bits + NORMALIZED_KEY_WORD_BITS - 1) / NORMALIZED_KEY_WORD_BITS;
+  }
+
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  The bits of a field of the key that fall into one of its words
+   *
+   * @Param field The value of the field, in its low field_bits bits
+   * @Param field_bits The width of the field
+   * @Param offset The position of the first bit of the field in the key
+   * @Param word The index of the word
+   */
+  /* ----------------------------------------------------------------------------*/
+  __host__ __device__
+  static uint64_t word_bits(uint64_t field, int field_bits, int offset, int word)
+  {
+    const int begin = offset - word * NORMALIZED_KEY_WORD_BITS;
+    if ((begin >= NORMALIZED_KEY_WORD_BITS) || (begin + field_bits <= 0)) {
+      return 0;
+    }
+    // The shift of the lowest bit of the field; the bits shifted out to the
+    // left belong to the previous word, those shifted out to the right to the
+    // next word
+    const int shift = NORMALIZED_KEY_WORD_BITS - (begin + field_bits);
+    return (shift >= 0) ? (field << shift) : (field >> -shift);
+  }
+
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  A word of the normalized key of a row
+   */
+  /* ----------------------------------------------------------------------------*/
+  __host__ __device__
+  uint64_t key_word(size_t row, int word) const
+  {
+    uint64_t key{0};
+    for (int c = 0; c < num_columns; ++c) {
+      const int value_bits = packed_key_bits(dtypes[c]);
+      const int null_bits = (nullptr != valids[c]) ? 1 : 0;
+      const int begin = offsets[c] - word * NORMALIZED_KEY_WORD_BITS;
+      if ((begin >= NORMALIZED_KEY_WORD_BITS) || (begin + null_bits + value_bits <= 0)) {
+        continue;
+      }
+
+      const bool valid = gdf_is_valid(valids[c], static_cast<gdf_index_type>(row));
+      if (null_bits) {
+        key |= word_bits((valid == nulls_first[c]) ? 1 : 0, 1, offsets[c], word);
+      }
+      if (!valid) {
+        continue;
+      }
+
+      uint64_t value{0};
+      switch (dtypes[c]) {
+        case GDF_INT8:    value = normalize_key(static_cast<int8_t const *>(columns[c])[row]); break;
+        case GDF_INT16:   value = normalize_key(static_cast<int16_t const *>(columns[c])[row]); break;
+        case GDF_INT32:   value = normalize_key(static_cast<int32_t const *>(columns[c])[row]); break;
+        case GDF_INT64:   value = normalize_key(static_cast<int64_t const *>(columns[c])[row]); break;
+        case GDF_FLOAT32: value = normalize_key(static_cast<float const *>(columns[c])[row]); break;
+        case GDF_FLOAT64: value = normalize_key(static_cast<double const *>(columns[c])[row]); break;
+        default: break;
+      }
+      if (descending[c]) {
+        value ^= ~uint64_t{0} >> (NORMALIZED_KEY_WORD_BITS - value_bits);
+      }
+      key |= word_bits(value, value_bits, offsets[c] + null_bits, word);
+    }
+    return key;
+  }
+
+};
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Computes how the sort columns of an ORDER BY are normalized
+ *
+ * @Param num_columns The number of sort columns
+ * @Param columns The sort columns
+ * @Param descending Whether every column is sorted descending, or nullptr to
+ * sort every column ascending
+ * @Param nulls_first Whether the NULLs of every column are sorted first, or
+ * nullptr to sort every NULL last
+ * @Param ignore_nulls Sorts NULLs by their underlying data, without a NULL bit
+ * @Param[out] layout Receives the layout of the normalized keys
+ *
+ * @Returns False if the columns cannot be normalized: there are no columns or
+ * more than MAX_NORMALIZED_KEY_COLUMNS, or a column has an unsupported dtype
+ */
+/* ----------------------------------------------------------------------------*/
+inline bool make_normalized_key_layout(int num_columns,
+                                       gdf_column const * columns,
+                                       bool const * descending,
+                                       bool const * nulls_first,
+                                       bool ignore_nulls,
+                                       normalized_key_layout & layout)
+{
+  if ((num_columns <= 0) || (num_columns > MAX_NORMALIZED_KEY_COLUMNS)) {
+    return false;
+  }
+  for (int c = 0; c < num_columns; ++c) {
+    if (0 == packed_key_bits(columns[c].dtype)) {
+      return false;
+    }
+  }
+
+  layout.num_columns = num_columns;
+  int offset{0};
+  for (int c = 0; c < num_columns; ++c) {
+    // A column without NULLs needs no NULL bit
+    const bool has_nulls = !ignore_nulls && (nullptr != columns[c].valid) && (columns[c].null_count > 0);
+    layout.columns[c] = columns[c].data;
+    layout.valids[c] = has_nulls ? columns[c].valid : nullptr;
+    layout.dtypes[c] = columns[c].dtype;
+    layout.descending[c] = (nullptr != descending) && descending[c];
+    layout.nulls_first[c] = (nullptr != nulls_first) && nulls_first[c];
+    layout.offsets[c] = offset;
+    offset += (has_nulls ? 1 : 0) + packed_key_bits(columns[c].dtype);
+  }
+  layout.total_bits = offset;
+  return true;
+}
+
+#endif // PACKED_KEYS_H
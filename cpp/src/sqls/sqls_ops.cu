@@ -8,7 +8,9 @@
 #include "rmm/thrust_rmm_allocator.h"
 #include "groupby/groupby.cuh"
 #include "groupby/aggregation_operations.cuh"
+#include "groupby/partial_aggregation.h"
 #include "utilities/nvtx/nvtx_utils.h"
+#include "utilities/type_dispatcher.hpp"
 
 #include "sqls_rtti_comp.h"
 
@@ -1080,6 +1082,249 @@ gdf_error gdf_group_by_avg(size_t nrows,     //in: # rows
   return GDF_SUCCESS;
 }
 
+//aggregates the rows sorted by packed key (see packed_keys_order_by);
+//dispatched on the type of the aggregated column,
+//or of the output column for COUNT and COUNT_DISTINCT;
+//
+struct packed_keys_aggregate
+{
+  //average of a group, from its sum and count;
+  //
+  template<typename T>
+  struct divide_by_count
+  {
+    __device__ T operator()(IndexT n, T sum) const
+    {
+      return sum/static_cast<T>(n);
+    }
+  };
+
+  template<typename T,
+           typename std::enable_if_t<std::is_arithmetic<T>::value>* = nullptr>
+  gdf_error operator()(size_t nrows,
+                       const uint64_t* d_keys,
+                       const IndexT* d_indx,
+                       gdf_column const& agg_in,
+                       gdf_agg_op op,
+                       IndexT* d_kout,
+                       gdf_column& c_vout,
+                       size_t* new_sz)
+  {
+    T* d_vout = static_cast<T*>(c_vout.data);
+
+    if( (GDF_COUNT == op) || (GDF_COUNT_DISTINCT == op) )
+      {
+        *new_sz = packed_keys_group_by(nrows, d_keys, d_indx,
+                                       thrust::make_constant_iterator<T>(1),
+                                       thrust::plus<T>(),
+                                       d_kout, d_vout);
+        if( GDF_COUNT_DISTINCT == op )
+          {
+            T distinct_count = static_cast<T>(*new_sz);
+            CUDA_TRY( cudaMemcpy(d_vout, &distinct_count, sizeof(T), cudaMemcpyHostToDevice) );
+            *new_sz = 1;
+          }
+        return GDF_SUCCESS;
+      }
+
+    //the values get read in sorted order without being gathered first;
+    //
+    auto vals = thrust::make_permutation_iterator(static_cast<const T*>(agg_in.data), d_indx);
+
+    switch( op )
+      {
+      case GDF_SUM:
+        *new_sz = packed_keys_group_by(nrows, d_keys, d_indx, vals, thrust::plus<T>(), d_kout, d_vout);
+        break;
+      case GDF_MIN:
+        *new_sz = packed_keys_group_by(nrows, d_keys, d_indx, vals, thrust::minimum<T>(), d_kout, d_vout);
+        break;
+      case GDF_MAX:
+        *new_sz = packed_keys_group_by(nrows, d_keys, d_indx, vals, thrust::maximum<T>(), d_kout, d_vout);
+        break;
+      case GDF_AVG:
+        {
+          Vector<IndexT> d_cout(nrows, 0);
+          packed_keys_group_by(nrows, d_keys, d_indx,
+                               thrust::make_constant_iterator<IndexT>(1),
+                               thrust::plus<IndexT>(),
+                               d_kout, d_cout.data().get());
+          *new_sz = packed_keys_group_by(nrows, d_keys, d_indx, vals, thrust::plus<T>(), d_kout, d_vout);
+
+          cudaStream_t stream = 0; // TODO: non-default stream
+          rmm_temp_allocator allocator(stream);
+          thrust::transform(thrust::cuda::par(allocator).on(stream),
+                            d_cout.begin(), d_cout.begin() + *new_sz,
+                            d_vout,
+                            d_vout,
+                            divide_by_count<T>());
+        }
+        break;
+      default:
+        return GDF_INVALID_API_CALL;
+      }
+    return GDF_SUCCESS;
+  }
+
+  template<typename T,
+           typename std::enable_if_t<!std::is_arithmetic<T>::value>* = nullptr>
+  gdf_error operator()(size_t nrows,
+                       const uint64_t* d_keys,
+                       const IndexT* d_indx,
+                       gdf_column const& agg_in,
+                       gdf_agg_op op,
+                       IndexT* d_kout,
+                       gdf_column& c_vout,
+                       size_t* new_sz)
+  {
+    return GDF_UNSUPPORTED_DTYPE;
+  }
+};
+
+//group-by on keys packed into 64 bits,
+//with a single radix sort for any aggregation;
+//
+gdf_error gdf_group_by_packed_keys(size_t nrows,                    //in: # rows
+                                   packed_key_layout const& layout, //in: how the key columns are packed
+                                   int flag_sorted,                 //in: flag specififying if rows are pre-sorted (1) or not (0)
+                                   gdf_column const& agg_in,        //in: column to aggregate
+                                   gdf_agg_op op,                   //in: aggregation operation
+                                   IndexT* d_indx,                  //out: device-side array of row indices after sorting
+                                   IndexT* d_kout,                  //out: device-side array of rows after group-by
+                                   gdf_column& c_vout,              //out: aggregated column
+                                   size_t* new_sz)                  //out: host-side # rows of c_vout
+{
+  Vector<uint64_t> d_keys(nrows);
+  CUDA_TRY( packed_keys_order_by(nrows, layout, d_keys.data().get(), d_indx, flag_sorted) );
+
+  const gdf_dtype dtype = ((GDF_COUNT == op) || (GDF_COUNT_DISTINCT == op)) ? c_vout.dtype : agg_in.dtype;
+  return cudf::type_dispatcher(dtype, packed_keys_aggregate(),
+                               nrows, d_keys.data().get(), d_indx, agg_in, op, d_kout, c_vout, new_sz);
+}
+
+//quantile of the sorted values of a group,
+//at position q * (count - 1) in the group;
+//
+template<typename T>
+struct group_quantile
+{
+  const T* d_vals;          //values, sorted within their group
+  const IndexT* d_offsets;  //position of the first value of every group
+  const int64_t* d_counts;  //# values of every group
+  double q;
+  gdf_quantile_method method;
+
+  __device__ double operator()(size_t group) const
+  {
+    const T* vals = d_vals + d_offsets[group];
+    const double pos = q * static_cast<double>(d_counts[group] - 1);
+    const size_t lo = static_cast<size_t>(pos);
+    const double fract_pos = pos - static_cast<double>(lo);
+    const size_t hi = (fract_pos > 0) ? lo + 1 : lo;
+
+    const double y0 = static_cast<double>(vals[lo]);
+    const double y1 = static_cast<double>(vals[hi]);
+    switch( method )
+      {
+      case GDF_QUANT_LOWER:    return y0;
+      case GDF_QUANT_HIGHER:   return y1;
+      case GDF_QUANT_MIDPOINT: return (y0 + y1)/2.0;
+      case GDF_QUANT_NEAREST:  return (fract_pos < 0.5 ? y0 : y1);
+      default:                 return y0 + fract_pos*(y1 - y0);
+      }
+  }
+};
+
+//computes a quantile of the values of every group
+//(MEDIAN is the 0.5 quantile), from the rows sorted
+//by key and the # rows of every group;
+//the values get sorted within their group,
+//so the groups stay in key order;
+//
+struct group_quantiles
+{
+  template<typename T,
+           typename std::enable_if_t<std::is_arithmetic<T>::value>* = nullptr>
+  gdf_error operator()(size_t nrows,
+                       gdf_column const& agg_in,
+                       const IndexT* d_indx,
+                       const int64_t* d_counts,
+                       size_t n_group,
+                       double q,
+                       gdf_quantile_method method,
+                       double* d_result)
+  {
+    cudaStream_t stream = 0; // TODO: non-default stream
+    rmm_temp_allocator allocator(stream);
+    auto exec = thrust::cuda::par(allocator).on(stream);
+
+    Vector<IndexT> d_offsets(n_group);
+    thrust::exclusive_scan(exec, d_counts, d_counts + n_group, d_offsets.begin());
+
+    //the upper bound of a position in the offsets
+    //is one more than its group: it sorts the same;
+    //
+    Vector<IndexT> d_groups(nrows);
+    thrust::upper_bound(exec,
+                        d_offsets.begin(), d_offsets.end(),
+                        thrust::make_counting_iterator<IndexT>(0),
+                        thrust::make_counting_iterator<IndexT>(nrows),
+                        d_groups.begin());
+
+    Vector<T> d_vals(nrows);
+    thrust::gather(exec,
+                   d_indx, d_indx + nrows,
+                   static_cast<const T*>(agg_in.data),
+                   d_vals.begin());
+
+    auto sort_first = thrust::make_zip_iterator(thrust::make_tuple(d_groups.begin(), d_vals.begin()));
+    thrust::sort(exec, sort_first, sort_first + nrows);
+
+    thrust::transform(exec,
+                      thrust::make_counting_iterator<size_t>(0),
+                      thrust::make_counting_iterator<size_t>(n_group),
+                      d_result,
+                      group_quantile<T>{d_vals.data().get(), d_offsets.data().get(), d_counts, q, method});
+    return GDF_SUCCESS;
+  }
+
+  template<typename T,
+           typename std::enable_if_t<!std::is_arithmetic<T>::value>* = nullptr>
+  gdf_error operator()(size_t nrows,
+                       gdf_column const& agg_in,
+                       const IndexT* d_indx,
+                       const int64_t* d_counts,
+                       size_t n_group,
+                       double q,
+                       gdf_quantile_method method,
+                       double* d_result)
+  {
+    return GDF_UNSUPPORTED_DTYPE;
+  }
+};
+
+//converts a column of doubles to the type of a column;
+//
+struct copy_converted
+{
+  template<typename T,
+           typename std::enable_if_t<std::is_arithmetic<T>::value>* = nullptr>
+  gdf_error operator()(const double* d_in, size_t n, gdf_column& c_out)
+  {
+    cudaStream_t stream = 0; // TODO: non-default stream
+    rmm_temp_allocator allocator(stream);
+    thrust::copy(thrust::cuda::par(allocator).on(stream), d_in, d_in + n, static_cast<T*>(c_out.data));
+    return GDF_SUCCESS;
+  }
+
+  template<typename T,
+           typename std::enable_if_t<!std::is_arithmetic<T>::value>* = nullptr>
+  gdf_error operator()(const double* d_in, size_t n, gdf_column& c_out)
+  {
+    return GDF_UNSUPPORTED_DTYPE;
+  }
+};
+
 gdf_error gdf_group_by_single(int ncols,                    // # columns
                               gdf_column** cols,            //input cols
                               gdf_column* col_agg,          //column to aggregate on
@@ -1088,7 +1333,9 @@ gdf_error gdf_group_by_single(int ncols,                    // # columns
                                                             //(multi-gather based on indices, which are needed anyway)
                               gdf_column* out_col_agg,      //aggregation result
                               gdf_context* ctxt,            //struct with additional info: bool is_sorted, flag_sort_or_hash, bool flag_count_distinct
-                              gdf_agg_op op)                //aggregation operation
+                              gdf_agg_op op,                //aggregation operation
+                              double quantile = 0.5,        //quantile of GDF_MEDIAN, in [0,1]
+                              gdf_quantile_method quantile_method = GDF_QUANT_LINEAR) //interpolation of GDF_MEDIAN
 {
   CUDA_TRY(cudaDeviceSynchronize());
   
@@ -1100,10 +1347,21 @@ gdf_error gdf_group_by_single(int ncols,                    // # columns
   {
     return GDF_DATASET_EMPTY;
   }
+  bool has_nulls = (col_agg->valid && col_agg->null_count);
   for (int i = 0; i < ncols; ++i) {
-	GDF_REQUIRE(!cols[i]->valid || !cols[i]->null_count, GDF_VALIDITY_UNSUPPORTED);
+    has_nulls = has_nulls || (cols[i]->valid && cols[i]->null_count);
+  }
+
+  // NULLs are only supported by the hash-based groupby of gdf_group_by
+  if( has_nulls )
+  {
+    GDF_REQUIRE(GDF_HASH == ctxt->flag_method, GDF_VALIDITY_UNSUPPORTED);
+    GDF_REQUIRE(nullptr != out_col_values, GDF_DATASET_EMPTY);
+    if( nullptr != out_col_indices ) {
+      out_col_indices->size = 0;
+    }
+    return gdf_group_by(ncols, cols, 1, &col_agg, &op, out_col_values, &out_col_agg, ctxt);
   }
-  GDF_REQUIRE(!col_agg->valid || !col_agg->null_count, GDF_VALIDITY_UNSUPPORTED);
 
   // If there are no rows in the input, set the output rows to 0 
   // and return immediately with success
@@ -1162,118 +1420,161 @@ gdf_error gdf_group_by_single(int ncols,                    // # columns
 
       Vector<IndexT> d_sort(nrows, 0);
       IndexT* ptr_d_sort = d_sort.data().get();
-      
-      gdf_column c_agg_p;
-      c_agg_p.dtype = col_agg->dtype;
-      c_agg_p.size = nrows;
-      Vector<char> d_agg_p(nrows * dtype_size(c_agg_p.dtype));//purpose: avoids a switch-case on type;
-      c_agg_p.data = d_agg_p.data().get();
 
-      switch( op )
+      //MEDIAN sorts the values within the groups of a COUNT;
+      //
+      const bool is_quantile = (GDF_MEDIAN == op);
+      const gdf_agg_op sort_op = is_quantile ? GDF_COUNT : op;
+
+      Vector<int64_t> d_group_sizes(is_quantile ? nrows : 0);
+      gdf_column c_group_sizes{};
+      c_group_sizes.data = d_group_sizes.data().get();
+      c_group_sizes.size = nrows;
+      c_group_sizes.dtype = GDF_INT64;
+      gdf_column* c_vout = is_quantile ? &c_group_sizes : out_col_agg;
+      
+      //keys of at most 64 bits get radix sorted once
+      //as packed integers, for any aggregation,
+      //when cub can sort that many rows;
+      //
+      packed_key_layout layout;
+      if( radix_sortable_rows(nrows) && make_packed_key_layout(ncols, h_columns, layout) )
         {
-        case GDF_SUM:
-          gdf_group_by_sum(nrows,
-                           h_columns,
-                           static_cast<size_t>(ncols),
-                           ctxt->flag_sorted,
-                           *col_agg,
-                           d_col_data, //allocated
-                           d_col_types,//allocated
-                           ptr_d_sort, //allocated
-                           c_agg_p,    //allocated
-                           ptr_d_indx, //allocated (or, passed in)
-                           *out_col_agg,
-                           &n_group);
-          break;
-          
-        case GDF_MIN:
-          gdf_group_by_min(nrows,
-                           h_columns,
-                           static_cast<size_t>(ncols),
-                           ctxt->flag_sorted,
-                           *col_agg,
-                           d_col_data, //allocated
-                           d_col_types,//allocated
-                           ptr_d_sort, //allocated
-                           c_agg_p,    //allocated
-                           ptr_d_indx, //allocated (or, passed in)
-                           *out_col_agg,
-                           &n_group);
-          break;
-
-        case GDF_MAX:
-          gdf_group_by_max(nrows,
-                           h_columns,
-                           static_cast<size_t>(ncols),
-                           ctxt->flag_sorted,
-                           *col_agg,
-                           d_col_data, //allocated
-                           d_col_types,//allocated
-                           ptr_d_sort, //allocated
-                           c_agg_p,    //allocated
-                           ptr_d_indx, //allocated (or, passed in)
-                           *out_col_agg,
-                           &n_group);
-          break;
-
-        case GDF_AVG:
-          {
-            Vector<IndexT> d_cout(nrows, 0);
-            IndexT* ptr_d_cout = d_cout.data().get();
-            
-            gdf_group_by_avg(nrows,
-                             h_columns,
-                             static_cast<size_t>(ncols),
-                             ctxt->flag_sorted,
-                             *col_agg,
-                             d_col_data, //allocated
-                             d_col_types,//allocated
-                             ptr_d_sort, //allocated
-                             ptr_d_cout, //allocated
-                             c_agg_p,    //allocated
-                             ptr_d_indx, //allocated (or, passed in)
-                             *out_col_agg,
-                             &n_group);
-          }
-          break;
-        case GDF_COUNT_DISTINCT:
-          {
-            assert( out_col_agg );
-            assert( out_col_agg->size >= 1);
+          gdf_error_code = gdf_group_by_packed_keys(nrows,
+                                                    layout,
+                                                    ctxt->flag_sorted,
+                                                    *col_agg,
+                                                    sort_op,
+                                                    ptr_d_sort, //allocated
+                                                    ptr_d_indx, //allocated (or, passed in)
+                                                    *c_vout,
+                                                    &n_group);
+        }
+      else
+        {
+          gdf_column c_agg_p;
+          c_agg_p.dtype = col_agg->dtype;
+          c_agg_p.size = nrows;
+          Vector<char> d_agg_p(nrows * dtype_size(c_agg_p.dtype));//purpose: avoids a switch-case on type;
+          c_agg_p.data = d_agg_p.data().get();
 
-            gdf_group_by_count(nrows,
+          switch( sort_op )
+            {
+            case GDF_SUM:
+              gdf_group_by_sum(nrows,
                                h_columns,
                                static_cast<size_t>(ncols),
                                ctxt->flag_sorted,
+                               *col_agg,
                                d_col_data, //allocated
                                d_col_types,//allocated
                                ptr_d_sort, //allocated
+                               c_agg_p,    //allocated
                                ptr_d_indx, //allocated (or, passed in)
-                               *out_col_agg, //passed in
-                               &n_group,
-                               true);
-            
-          }
-          break;
-        case GDF_COUNT:
-          {
-            assert( out_col_agg );
+                               *c_vout,
+                               &n_group);
+              break;
+          
+            case GDF_MIN:
+              gdf_group_by_min(nrows,
+                               h_columns,
+                               static_cast<size_t>(ncols),
+                               ctxt->flag_sorted,
+                               *col_agg,
+                               d_col_data, //allocated
+                               d_col_types,//allocated
+                               ptr_d_sort, //allocated
+                               c_agg_p,    //allocated
+                               ptr_d_indx, //allocated (or, passed in)
+                               *c_vout,
+                               &n_group);
+              break;
 
-            gdf_group_by_count(nrows,
+            case GDF_MAX:
+              gdf_group_by_max(nrows,
                                h_columns,
                                static_cast<size_t>(ncols),
                                ctxt->flag_sorted,
+                               *col_agg,
                                d_col_data, //allocated
                                d_col_types,//allocated
                                ptr_d_sort, //allocated
+                               c_agg_p,    //allocated
                                ptr_d_indx, //allocated (or, passed in)
-                               *out_col_agg, //passed in
+                               *c_vout,
                                &n_group);
+              break;
+
+            case GDF_AVG:
+              {
+                Vector<IndexT> d_cout(nrows, 0);
+                IndexT* ptr_d_cout = d_cout.data().get();
             
-          }
-          break;
-        default: // To eliminate error for unhandled enumerant N_GDF_AGG_OPS
-          gdf_error_code = GDF_INVALID_API_CALL;
+                gdf_group_by_avg(nrows,
+                                 h_columns,
+                                 static_cast<size_t>(ncols),
+                                 ctxt->flag_sorted,
+                                 *col_agg,
+                                 d_col_data, //allocated
+                                 d_col_types,//allocated
+                                 ptr_d_sort, //allocated
+                                 ptr_d_cout, //allocated
+                                 c_agg_p,    //allocated
+                                 ptr_d_indx, //allocated (or, passed in)
+                                 *c_vout,
+                                 &n_group);
+              }
+              break;
+            case GDF_COUNT_DISTINCT:
+              {
+                assert( out_col_agg );
+                assert( out_col_agg->size >= 1);
+
+                gdf_group_by_count(nrows,
+                                   h_columns,
+                                   static_cast<size_t>(ncols),
+                                   ctxt->flag_sorted,
+                                   d_col_data, //allocated
+                                   d_col_types,//allocated
+                                   ptr_d_sort, //allocated
+                                   ptr_d_indx, //allocated (or, passed in)
+                                   *c_vout, //passed in
+                                   &n_group,
+                                   true);
+            
+              }
+              break;
+            case GDF_COUNT:
+              {
+                assert( out_col_agg );
+
+                gdf_group_by_count(nrows,
+                                   h_columns,
+                                   static_cast<size_t>(ncols),
+                                   ctxt->flag_sorted,
+                                   d_col_data, //allocated
+                                   d_col_types,//allocated
+                                   ptr_d_sort, //allocated
+                                   ptr_d_indx, //allocated (or, passed in)
+                                   *c_vout, //passed in
+                                   &n_group);
+            
+              }
+              break;
+            default: // To eliminate error for unhandled enumerant N_GDF_AGG_OPS
+              gdf_error_code = GDF_INVALID_API_CALL;
+            }
+        }
+
+      if( is_quantile && (GDF_SUCCESS == gdf_error_code) )
+        {
+          Vector<double> d_quantiles(n_group);
+          gdf_error_code = cudf::type_dispatcher(col_agg->dtype, group_quantiles(),
+                                                 nrows, *col_agg, ptr_d_sort, d_group_sizes.data().get(),
+                                                 n_group, quantile, quantile_method, d_quantiles.data().get());
+          if( GDF_SUCCESS == gdf_error_code )
+            gdf_error_code = cudf::type_dispatcher(out_col_agg->dtype, copy_converted(),
+                                                   d_quantiles.data().get(), n_group, *out_col_agg);
         }
 
       if( out_col_values )
@@ -1305,7 +1606,10 @@ gdf_error gdf_group_by_single(int ncols,                    // # columns
                                              col_agg,
                                              out_col_values,
                                              out_col_agg,
-                                             sort_result);
+                                             sort_result,
+                                             ctxt->cardinality_hint,
+                                             ctxt->hash_table_stats,
+                                             ctxt->groupby_strategy);
             break;
           }
         case GDF_MIN:
@@ -1315,7 +1619,10 @@ gdf_error gdf_group_by_single(int ncols,                    // # columns
                                              col_agg,
                                              out_col_values,
                                              out_col_agg,
-                                             sort_result);
+                                             sort_result,
+                                             ctxt->cardinality_hint,
+                                             ctxt->hash_table_stats,
+                                             ctxt->groupby_strategy);
             break;
           }
         case GDF_SUM:
@@ -1325,7 +1632,10 @@ gdf_error gdf_group_by_single(int ncols,                    // # columns
                                              col_agg,
                                              out_col_values,
                                              out_col_agg,
-                                             sort_result);
+                                             sort_result,
+                                             ctxt->cardinality_hint,
+                                             ctxt->hash_table_stats,
+                                             ctxt->groupby_strategy);
             break;
           }
         case GDF_COUNT:
@@ -1335,7 +1645,10 @@ gdf_error gdf_group_by_single(int ncols,                    // # columns
                                                col_agg,
                                                out_col_values,
                                                out_col_agg,
-                                               sort_result);
+                                               sort_result,
+                                               ctxt->cardinality_hint,
+                                               ctxt->hash_table_stats,
+                                               ctxt->groupby_strategy);
             break;
           }
         case GDF_AVG:
@@ -1344,7 +1657,10 @@ gdf_error gdf_group_by_single(int ncols,                    // # columns
                                          cols,
                                          col_agg,
                                          out_col_values,
-                                         out_col_agg);
+                                         out_col_agg,
+                                         ctxt->cardinality_hint,
+                                         ctxt->hash_table_stats,
+                                         ctxt->groupby_strategy);
             break;
           }
         default:
@@ -1381,6 +1697,18 @@ gdf_error gdf_order_by(size_t nrows,     //in: # rows
   //
   GDF_REQUIRE(!cols->valid || !cols->null_count, GDF_VALIDITY_UNSUPPORTED);
   soa_col_info(cols, ncols, d_cols, d_types);
+
+  //radix sort the normalized keys when the columns have them
+  //and cub can sort that many rows,
+  //otherwise compare the rows through LesserRTTI;
+  //
+  normalized_key_layout layout;
+  if( radix_sortable_rows(nrows) &&
+      make_normalized_key_layout(static_cast<int>(ncols), cols, nullptr, nullptr, true, layout) )
+    {
+      CUDA_TRY( normalized_keys_order_by(nrows, layout, d_indx) );
+      return GDF_SUCCESS;
+    }
   
   multi_col_order_by(nrows,
                      ncols,
@@ -1391,6 +1719,41 @@ gdf_error gdf_order_by(size_t nrows,     //in: # rows
   return GDF_SUCCESS;
 }
 
+gdf_error gdf_order_by_asc_desc(size_t nrows,
+                                gdf_column* cols,
+                                size_t ncols,
+                                order_by_type* orders,
+                                gdf_null_order* null_orders,
+                                size_t* d_indx)
+{
+  GDF_REQUIRE(nullptr != cols && nullptr != d_indx, GDF_DATASET_EMPTY);
+  GDF_REQUIRE(ncols > 0, GDF_DATASET_EMPTY);
+  GDF_REQUIRE(ncols <= static_cast<size_t>(MAX_NORMALIZED_KEY_COLUMNS), GDF_COLUMN_SIZE_TOO_BIG);
+  GDF_REQUIRE(radix_sortable_rows(nrows), GDF_COLUMN_SIZE_TOO_BIG);
+  for(size_t c = 0; c < ncols; ++c)
+    {
+      GDF_REQUIRE(0 != packed_key_bits(cols[c].dtype), GDF_UNSUPPORTED_DTYPE);
+      GDF_REQUIRE(static_cast<size_t>(cols[c].size) == nrows, GDF_COLUMN_SIZE_MISMATCH);
+    }
+
+  if( 0 == nrows )
+    return GDF_SUCCESS;
+
+  bool descending[MAX_NORMALIZED_KEY_COLUMNS];
+  bool nulls_first[MAX_NORMALIZED_KEY_COLUMNS];
+  for(size_t c = 0; c < ncols; ++c)
+    {
+      descending[c] = (nullptr != orders) && (GDF_ORDER_DESC == orders[c]);
+      nulls_first[c] = (nullptr != null_orders) && (GDF_NULLS_FIRST == null_orders[c]);
+    }
+
+  normalized_key_layout layout;
+  make_normalized_key_layout(static_cast<int>(ncols), cols, descending, nulls_first, false, layout);
+  CUDA_TRY( normalized_keys_order_by(nrows, layout, d_indx) );
+
+  return GDF_SUCCESS;
+}
+
 //apparent duplication of info between
 //gdf_column array and two arrays:
 //           d_cols = data slice of gdf_column array;
@@ -1486,4 +1849,347 @@ gdf_error gdf_group_by_count(int ncols,                    // # columns
     return gdf_group_by_single(ncols, cols, col_agg, out_col_indices, out_col_values, out_col_agg, ctxt, GDF_COUNT);
 }
 
+gdf_error gdf_group_by_quantile(int ncols,                    // # columns
+                                gdf_column** cols,            //input cols
+                                gdf_column* col_agg,          //column to aggregate on
+                                gdf_column* out_col_indices,  //if not null return indices of re-ordered rows
+                                gdf_column** out_col_values,  //if not null return the grouped-by columns
+                                gdf_column* out_col_agg,      //aggregation result
+                                double q,                     //requested quantile in [0,1]
+                                gdf_quantile_method method,   //interpolation between the values around the quantile
+                                gdf_context* ctxt)            //struct with additional info: bool is_sorted, flag_sort_or_hash
+{
+  GDF_REQUIRE(nullptr != ctxt, GDF_DATASET_EMPTY);
+  GDF_REQUIRE(GDF_SORT == ctxt->flag_method, GDF_UNSUPPORTED_METHOD);
+  GDF_REQUIRE((q >= 0.0) && (q <= 1.0), GDF_INVALID_API_CALL);
+  GDF_REQUIRE((method >= GDF_QUANT_LINEAR) && (method < N_GDF_QUANT_METHODS), GDF_INVALID_API_CALL);
+
+  return gdf_group_by_single(ncols, cols, col_agg, out_col_indices, out_col_values, out_col_agg, ctxt, GDF_MEDIAN, q, method);
+}
+
+gdf_error gdf_group_by(int ncols,                    // # columns
+                       gdf_column** cols,            //input cols
+                       int num_aggs,                 // # aggregation columns
+                       gdf_column** col_aggs,        //columns to aggregate on
+                       gdf_agg_op* agg_ops,          //aggregation operation of each column to aggregate on
+                       gdf_column** out_col_values,  //grouped-by columns
+                       gdf_column** out_col_aggs,    //aggregation results, one per column to aggregate on
+                       gdf_context* ctxt)            //struct with additional info: bool is_sorted, flag_sort_or_hash, flag_sort_result
+{
+  if((0 == ncols)
+     || (nullptr == cols)
+     || (num_aggs <= 0)
+     || (nullptr == col_aggs)
+     || (nullptr == agg_ops)
+     || (nullptr == out_col_values)
+     || (nullptr == out_col_aggs)
+     || (nullptr == ctxt))
+  {
+    return GDF_DATASET_EMPTY;
+  }
+
+  const gdf_size_type nrows = cols[0]->size;
+  bool has_nulls = false;
+  for (int i = 0; i < ncols; ++i) {
+    GDF_REQUIRE(nrows == cols[i]->size, GDF_COLUMN_SIZE_MISMATCH);
+    has_nulls = has_nulls || (cols[i]->valid && cols[i]->null_count);
+  }
+  for (int a = 0; a < num_aggs; ++a) {
+    GDF_REQUIRE(nullptr != out_col_aggs[a], GDF_DATASET_EMPTY);
+    GDF_REQUIRE(nrows == col_aggs[a]->size, GDF_COLUMN_SIZE_MISMATCH);
+    has_nulls = has_nulls || (col_aggs[a]->valid && col_aggs[a]->null_count);
+  }
+
+  // The sort-based groupby computes one aggregation at a time. Its groups are
+  // sorted, so every call produces them in the same order. It does not support NULLs.
+  if( ctxt->flag_method == GDF_SORT )
+    {
+      GDF_REQUIRE(false == has_nulls, GDF_VALIDITY_UNSUPPORTED);
+
+      for (int a = 0; a < num_aggs; ++a) {
+        switch (agg_ops[a])
+          {
+          case GDF_SUM:
+          case GDF_MIN:
+          case GDF_MAX:
+          case GDF_AVG:
+          case GDF_COUNT:
+          case GDF_COUNT_DISTINCT:
+          case GDF_MEDIAN:
+            break;
+          default:
+            return GDF_UNSUPPORTED_METHOD;
+          }
+      }
+
+      for (int a = 0; a < num_aggs; ++a) {
+        gdf_context agg_ctxt = *ctxt;
+        agg_ctxt.flag_distinct = (GDF_COUNT_DISTINCT == agg_ops[a]);
+        gdf_error gdf_error_code = gdf_group_by_single(ncols, cols, col_aggs[a], nullptr,
+                                                       (0 == a) ? out_col_values : nullptr,
+                                                       out_col_aggs[a], &agg_ctxt, agg_ops[a]);
+        if (GDF_SUCCESS != gdf_error_code) return gdf_error_code;
+      }
+      return GDF_SUCCESS;
+    }
+
+  if( ctxt->flag_method != GDF_HASH )
+    {
+      return GDF_UNSUPPORTED_METHOD;
+    }
+
+  for (int a = 0; a < num_aggs; ++a) {
+    switch (agg_ops[a])
+      {
+      case GDF_SUM:
+      case GDF_MIN:
+      case GDF_MAX:
+      case GDF_AVG:
+      case GDF_COUNT:
+      case GDF_VAR:
+      case GDF_STD:
+      case GDF_FIRST:
+      case GDF_LAST:
+        break;
+      default:
+        return GDF_UNSUPPORTED_METHOD;
+      }
+  }
+
+  // If there are no rows in the input, set the output rows to 0
+  // and return immediately with success
+  if (0 == nrows)
+    {
+      for (int i = 0; i < ncols; ++i) {
+        if (nullptr != out_col_values[i]) out_col_values[i]->size = 0;
+      }
+      for (int a = 0; a < num_aggs; ++a) {
+        out_col_aggs[a]->size = 0;
+        out_col_aggs[a]->null_count = 0;
+      }
+      return GDF_SUCCESS;
+    }
+
+  CUDA_TRY(cudaDeviceSynchronize());
+
+  PUSH_RANGE("LIBGDF_GROUPBY", GROUPBY_COLOR);
+
+  gdf_error gdf_error_code = gdf_group_by_hash_multi(ncols,
+                                                     cols,
+                                                     num_aggs,
+                                                     col_aggs,
+                                                     agg_ops,
+                                                     out_col_values,
+                                                     out_col_aggs,
+                                                     1 == ctxt->flag_sort_result,
+                                                     1 == ctxt->flag_groupby_include_nulls,
+                                                     ctxt->cardinality_hint,
+                                                     ctxt->hash_table_stats);
+
+  POP_RANGE();
+
+  return gdf_error_code;
+}
+
+//M2 of a group from its sample variance;
+//0 for a group of a single value, whose VAR is NULL;
+//
+struct m2_from_variance
+{
+  __device__ double operator()(double variance, int64_t count) const
+  {
+    return (count > 1) ? variance * static_cast<double>(count - 1) : 0.0;
+  }
+};
+
+int gdf_group_by_num_partial_columns(gdf_agg_op op)
+{
+  return static_cast<int>(partial_aggregation_ops(op).size());
+}
+
+gdf_error gdf_group_by_partial(int ncols,                    // # columns
+                               gdf_column** cols,            //input cols
+                               int num_aggs,                 // # aggregation columns
+                               gdf_column** col_aggs,        //columns to aggregate on
+                               gdf_agg_op* agg_ops,          //aggregation operation of each column to aggregate on
+                               gdf_column** out_col_values,  //grouped-by columns
+                               gdf_column** out_col_partials,//partial aggregate columns of every aggregation, in order
+                               gdf_context* ctxt)            //struct with additional info: flag_sort_or_hash, flag_sort_result
+{
+  if((nullptr == col_aggs)
+     || (nullptr == agg_ops)
+     || (nullptr == out_col_partials)
+     || (nullptr == ctxt))
+  {
+    return GDF_DATASET_EMPTY;
+  }
+  GDF_REQUIRE(GDF_HASH == ctxt->flag_method, GDF_UNSUPPORTED_METHOD);
+
+  //every aggregation is expanded into the aggregations
+  //computing its partial aggregate columns;
+  //
+  std::vector<gdf_column*> partial_cols;
+  std::vector<gdf_agg_op> partial_ops;
+  for (int a = 0; a < num_aggs; ++a) {
+    const std::vector<gdf_agg_op> ops = partial_aggregation_ops(agg_ops[a]);
+    GDF_REQUIRE(false == ops.empty(), GDF_UNSUPPORTED_METHOD);
+
+    const size_t first = partial_ops.size();
+    for (size_t i = 0; i < ops.size(); ++i) {
+      GDF_REQUIRE(nullptr != out_col_partials[first + i], GDF_DATASET_EMPTY);
+      partial_cols.push_back(col_aggs[a]);
+      partial_ops.push_back(ops[i]);
+    }
+
+    if ((GDF_AVG == agg_ops[a]) || (GDF_VAR == agg_ops[a]) || (GDF_STD == agg_ops[a]))
+      GDF_REQUIRE(GDF_INT64 == out_col_partials[first + partial_count_column(agg_ops[a])]->dtype, GDF_UNSUPPORTED_DTYPE);
+    if ((GDF_VAR == agg_ops[a]) || (GDF_STD == agg_ops[a]))
+      GDF_REQUIRE(GDF_FLOAT64 == out_col_partials[first + 2]->dtype, GDF_UNSUPPORTED_DTYPE);
+  }
+
+  //the VAR from which the M2 of VAR and STD is computed is NULL
+  //for a group of a single value: an M2 column without a validity mask
+  //gets a scratch mask for the groupby;
+  //
+  std::vector<gdf_column*> partial_outs(out_col_partials, out_col_partials + partial_ops.size());
+  std::vector<gdf_column> m2_columns(num_aggs);
+  std::vector<Vector<gdf_valid_type>> m2_masks(num_aggs);
+  size_t first = 0;
+  for (int a = 0; a < num_aggs; ++a) {
+    if (((GDF_VAR == agg_ops[a]) || (GDF_STD == agg_ops[a])) && (nullptr == partial_outs[first + 2]->valid))
+      {
+        GDF_REQUIRE(nullptr != col_aggs[a], GDF_DATASET_EMPTY);
+        m2_masks[a].resize(gdf_get_num_chars_bitmask(col_aggs[a]->size));
+        m2_columns[a] = *partial_outs[first + 2];
+        m2_columns[a].valid = m2_masks[a].data().get();
+        partial_outs[first + 2] = &m2_columns[a];
+      }
+    first += partial_aggregation_ops(agg_ops[a]).size();
+  }
+
+  gdf_error gdf_error_code = gdf_group_by(ncols, cols,
+                                          static_cast<int>(partial_ops.size()), partial_cols.data(),
+                                          partial_ops.data(), out_col_values, partial_outs.data(), ctxt);
+  if (GDF_SUCCESS != gdf_error_code) return gdf_error_code;
+
+  //the M2 of VAR and STD replaces their VAR;
+  //it is never NULL, so that every group with a mean is merged;
+  //
+  cudaStream_t stream = 0; // TODO: non-default stream
+  rmm_temp_allocator allocator(stream);
+  auto exec = thrust::cuda::par(allocator).on(stream);
+
+  first = 0;
+  for (int a = 0; a < num_aggs; ++a) {
+    if ((GDF_VAR == agg_ops[a]) || (GDF_STD == agg_ops[a]))
+      {
+        gdf_column* c_count = out_col_partials[first];
+        gdf_column* c_m2 = out_col_partials[first + 2];
+        c_m2->size = partial_outs[first + 2]->size;
+        double* d_m2 = static_cast<double*>(c_m2->data);
+        thrust::transform(exec,
+                          d_m2, d_m2 + c_m2->size,
+                          static_cast<const int64_t*>(c_count->data),
+                          d_m2,
+                          m2_from_variance{});
+        if ((nullptr != c_m2->valid) && (c_m2->size > 0))
+          CUDA_TRY(cudaMemset(c_m2->valid, 0xff, gdf_get_num_chars_bitmask(c_m2->size)));
+        c_m2->null_count = 0;
+      }
+    first += partial_aggregation_ops(agg_ops[a]).size();
+  }
+  CUDA_TRY(cudaGetLastError());
+
+  return GDF_SUCCESS;
+}
+
+gdf_error gdf_group_by_merge(int ncols,                    // # columns
+                             gdf_column** cols,            //grouped-by columns of the partial aggregates
+                             int num_aggs,                 // # aggregations
+                             gdf_column** col_partials,    //partial aggregate columns of every aggregation, in order
+                             gdf_agg_op* agg_ops,          //aggregation operation of each aggregation
+                             gdf_column** out_col_values,  //grouped-by columns
+                             gdf_column** out_col_aggs,    //aggregation results, one per aggregation
+                             gdf_context* ctxt)            //struct with additional info: flag_sort_or_hash, flag_sort_result
+{
+  if((0 == ncols)
+     || (nullptr == cols)
+     || (num_aggs <= 0)
+     || (nullptr == col_partials)
+     || (nullptr == agg_ops)
+     || (nullptr == out_col_values)
+     || (nullptr == out_col_aggs)
+     || (nullptr == ctxt))
+  {
+    return GDF_DATASET_EMPTY;
+  }
+  GDF_REQUIRE(GDF_HASH == ctxt->flag_method, GDF_UNSUPPORTED_METHOD);
+
+  const gdf_size_type nrows = cols[0]->size;
+  for (int i = 0; i < ncols; ++i) {
+    GDF_REQUIRE(nrows == cols[i]->size, GDF_COLUMN_SIZE_MISMATCH);
+  }
+
+  //the partial aggregates of AVG, VAR and STD
+  //are weighted by their COUNT column;
+  //
+  std::vector<aggregation_info> aggregations(num_aggs);
+  int first = 0;
+  for (int a = 0; a < num_aggs; ++a) {
+    const gdf_agg_op op = agg_ops[a];
+    const int num_partials = gdf_group_by_num_partial_columns(op);
+    GDF_REQUIRE(num_partials > 0, GDF_UNSUPPORTED_METHOD);
+    GDF_REQUIRE(nullptr != out_col_aggs[a], GDF_DATASET_EMPTY);
+    for (int i = first; i < first + num_partials; ++i) {
+      GDF_REQUIRE(nullptr != col_partials[i], GDF_DATASET_EMPTY);
+      GDF_REQUIRE(nrows == col_partials[i]->size, GDF_COLUMN_SIZE_MISMATCH);
+    }
+
+    aggregations[a] = make_aggregation_info(col_partials[first + partial_value_column(op)], merge_aggregation_op(op));
+    if ((GDF_AVG == op) || (GDF_VAR == op) || (GDF_STD == op))
+      {
+        gdf_column const* c_count = col_partials[first + partial_count_column(op)];
+        GDF_REQUIRE(GDF_INT64 == c_count->dtype, GDF_UNSUPPORTED_DTYPE);
+        aggregations[a].input_counts = static_cast<const int64_t*>(c_count->data);
+      }
+    if ((GDF_VAR == op) || (GDF_STD == op))
+      {
+        gdf_column const* c_m2 = col_partials[first + 2];
+        GDF_REQUIRE(GDF_FLOAT64 == c_m2->dtype, GDF_UNSUPPORTED_DTYPE);
+        aggregations[a].input_m2s = static_cast<const double*>(c_m2->data);
+      }
+    first += num_partials;
+  }
+
+  // If there are no rows in the input, set the output rows to 0
+  // and return immediately with success
+  if (0 == nrows)
+    {
+      for (int i = 0; i < ncols; ++i) {
+        if (nullptr != out_col_values[i]) out_col_values[i]->size = 0;
+      }
+      for (int a = 0; a < num_aggs; ++a) {
+        out_col_aggs[a]->size = 0;
+        out_col_aggs[a]->null_count = 0;
+      }
+      return GDF_SUCCESS;
+    }
+
+  CUDA_TRY(cudaDeviceSynchronize());
+
+  PUSH_RANGE("LIBGDF_GROUPBY", GROUPBY_COLOR);
+
+  gdf_error gdf_error_code = gdf_group_by_hash_aggregations(ncols,
+                                                            cols,
+                                                            aggregations,
+                                                            out_col_values,
+                                                            out_col_aggs,
+                                                            1 == ctxt->flag_sort_result,
+                                                            1 == ctxt->flag_groupby_include_nulls,
+                                                            ctxt->cardinality_hint,
+                                                            ctxt->hash_table_stats);
 
+  POP_RANGE();
+
+  return gdf_error_code;
+}
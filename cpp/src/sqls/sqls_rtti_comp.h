@@ -19,11 +19,20 @@
 #include <thrust/iterator/counting_iterator.h>
 #include <thrust/iterator/constant_iterator.h>
 #include <thrust/reduce.h>
+#include <thrust/scan.h>
 #include <thrust/distance.h>
 #include <thrust/advance.h>
 #include <thrust/gather.h>
+#include <thrust/transform.h>
+#include <thrust/functional.h>
+#include <thrust/iterator/permutation_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
+#include <thrust/iterator/discard_iterator.h>
+
+#include <cub/device/device_radix_sort.cuh>
 
 #include "rmm/thrust_rmm_allocator.h"
+#include "packed_keys.h"
 
 //for int<n>_t:
 //
@@ -661,3 +670,217 @@ size_t multi_col_group_by_avg_sort(size_t         nrows,
 
   return new_sz;
 }
+
+//###########################################################################
+//#                       Normalized-keys ORDER-BY:                         #
+//###########################################################################
+//Version for sort columns of fixed width dtypes (see packed_keys.h):
+//the sort columns of every row get normalized into a key
+//of one or more 64 bit words, with their ASC / DESC order
+//and the order of their NULLs, which are radix sorted
+//instead of a comparison sort through LesserRTTI;
+//
+//the words are sorted from the last to the first one,
+//each pass a stable radix sort of the rows in the order
+//of the previous passes (LSD), so a key of one word
+//is a single radix sort;
+//
+//args:
+//Input:
+// nrows    = # rows;
+// layout   = how the sort columns are normalized;
+// stream   = cudaStream to work in;
+//
+//Output:
+// d_indx   = vector of indices re-ordered after sorting;
+//Return:
+// cudaSuccess, cudaErrorInvalidValue if nrows is not radix_sortable_rows,
+// or the error of the radix sort;
+//
+template<typename IndexT>
+cudaError_t normalized_keys_order_by(size_t                       nrows,
+                                     normalized_key_layout const& layout,
+                                     IndexT*                      d_indx,
+                                     cudaStream_t                 stream = NULL)
+{
+  if( !radix_sortable_rows(nrows) )
+    return cudaErrorInvalidValue;
+
+  rmm_temp_allocator allocator(stream);
+  thrust::sequence(thrust::cuda::par(allocator).on(stream), d_indx, d_indx+nrows, 0);
+
+  thrust::device_vector<uint64_t, rmm_allocator<uint64_t>> d_keys(nrows);
+  thrust::device_vector<uint64_t, rmm_allocator<uint64_t>> d_keys_alt(nrows);
+  thrust::device_vector<IndexT, rmm_allocator<IndexT>> d_indx_alt(nrows);
+  cub::DoubleBuffer<uint64_t> keys(d_keys.data().get(), d_keys_alt.data().get());
+  cub::DoubleBuffer<IndexT> indx(d_indx, d_indx_alt.data().get());
+
+  size_t storage_bytes = 0;
+  cudaError_t status = cub::DeviceRadixSort::SortPairs(nullptr, storage_bytes,
+                                                       keys, indx, static_cast<int>(nrows),
+                                                       0, NORMALIZED_KEY_WORD_BITS, stream);
+  if( cudaSuccess != status )
+    return status;
+
+  thrust::device_vector<char, rmm_allocator<char>> d_storage(storage_bytes);
+
+  const int num_words = layout.num_words();
+  for(int word = num_words - 1; word >= 0; --word)
+    {
+      //the words of the rows in the order of the previous passes;
+      //
+      thrust::transform(thrust::cuda::par(allocator).on(stream),
+                        indx.Current(), indx.Current() + nrows,
+                        keys.Current(),
+                        [layout, word] __device__ (IndexT row) {
+                          return layout.key_word(row, word);
+                        });
+
+      //the low bits of the last word are not part of the key;
+      //
+      const int begin_bit = (word == num_words - 1)
+                            ? num_words * NORMALIZED_KEY_WORD_BITS - layout.total_bits
+                            : 0;
+      status = cub::DeviceRadixSort::SortPairs(d_storage.data().get(), storage_bytes,
+                                               keys, indx, static_cast<int>(nrows),
+                                               begin_bit, NORMALIZED_KEY_WORD_BITS, stream);
+      if( cudaSuccess != status )
+        return status;
+    }
+
+  if( indx.Current() != d_indx )
+    thrust::copy(thrust::cuda::par(allocator).on(stream),
+                 indx.Current(), indx.Current() + nrows, d_indx);
+  return cudaSuccess;
+}
+
+//###########################################################################
+//#                    Packed-keys ORDER-BY and Group-By:                   #
+//###########################################################################
+//Version for keys that fit in 64 bits (see packed_keys.h):
+//the key columns of every row get packed into a single
+//unsigned integer, which is sorted with a radix sort
+//instead of a comparison sort through LesserRTTI;
+//
+//args:
+//Input:
+// nrows    = # rows;
+// layout   = how the key columns are packed;
+// sorted   = the rows are already sorted by key;
+// stream   = cudaStream to work in;
+//
+//Output:
+// d_keys   = packed keys, sorted;
+// d_indx   = vector of indices re-ordered after sorting;
+//Return:
+// cudaSuccess, cudaErrorInvalidValue if nrows is not radix_sortable_rows,
+// or the error of the radix sort;
+//
+template<typename IndexT>
+cudaError_t packed_keys_order_by(size_t                   nrows,
+                                 packed_key_layout const& layout,
+                                 uint64_t*                d_keys,
+                                 IndexT*                  d_indx,
+                                 bool                     sorted = false,
+                                 cudaStream_t             stream = NULL)
+{
+  if( !radix_sortable_rows(nrows) )
+    return cudaErrorInvalidValue;
+
+  rmm_temp_allocator allocator(stream);
+
+  thrust::transform(thrust::cuda::par(allocator).on(stream),
+                    thrust::make_counting_iterator<size_t>(0),
+                    thrust::make_counting_iterator<size_t>(nrows),
+                    d_keys,
+                    [layout] __device__ (size_t row) {
+                      return layout.pack(row);
+                    });
+  thrust::sequence(thrust::cuda::par(allocator).on(stream), d_indx, d_indx+nrows, 0);
+
+  if( sorted )
+    return cudaSuccess;
+
+  thrust::device_vector<uint64_t, rmm_allocator<uint64_t>> d_keys_alt(nrows);
+  thrust::device_vector<IndexT, rmm_allocator<IndexT>> d_indx_alt(nrows);
+  cub::DoubleBuffer<uint64_t> keys(d_keys, d_keys_alt.data().get());
+  cub::DoubleBuffer<IndexT> indx(d_indx, d_indx_alt.data().get());
+
+  //only the bits of the packed key get sorted,
+  //so narrow keys take fewer passes;
+  //
+  size_t storage_bytes = 0;
+  cudaError_t status = cub::DeviceRadixSort::SortPairs(nullptr, storage_bytes,
+                                                       keys, indx, static_cast<int>(nrows),
+                                                       0, layout.total_bits, stream);
+  if( cudaSuccess != status )
+    return status;
+
+  thrust::device_vector<char, rmm_allocator<char>> d_storage(storage_bytes);
+  status = cub::DeviceRadixSort::SortPairs(d_storage.data().get(), storage_bytes,
+                                           keys, indx, static_cast<int>(nrows),
+                                           0, layout.total_bits, stream);
+  if( cudaSuccess != status )
+    return status;
+
+  //keys and indices always end up in the same buffer of their pair;
+  //
+  if( keys.Current() != d_keys )
+    {
+      thrust::copy(thrust::cuda::par(allocator).on(stream),
+                   keys.Current(), keys.Current() + nrows, d_keys);
+      thrust::copy(thrust::cuda::par(allocator).on(stream),
+                   indx.Current(), indx.Current() + nrows, d_indx);
+    }
+  return cudaSuccess;
+}
+
+//group-by on sorted packed keys is a reduce_by_key
+//comparing the packed keys only;
+//
+//Input:
+// nrows    = # rows;
+// d_keys   = sorted packed keys;
+// d_indx   = indices of the rows in sorted order;
+// vals     = iterator over the values to aggregate, in sorted order;
+// fctr     = functor to perform the aggregation;
+// stream   = cudaStream to work in;
+//Output:
+// d_kout   = index of the first row of every group;
+// d_vout   = aggregated values;
+//Return:
+// ret      = # rows after aggregation;
+//
+template<typename ValsIter,
+         typename ValsT,
+         typename IndexT,
+         typename Reducer>
+size_t packed_keys_group_by(size_t          nrows,
+                            const uint64_t* d_keys,
+                            const IndexT*   d_indx,
+                            ValsIter        vals,
+                            Reducer         fctr,
+                            IndexT*         d_kout,
+                            ValsT*          d_vout,
+                            cudaStream_t    stream = NULL)
+{
+  rmm_temp_allocator allocator(stream);
+
+  auto keys_first = thrust::make_zip_iterator(thrust::make_tuple(d_keys, d_indx));
+  auto kout_first = thrust::make_zip_iterator(thrust::make_tuple(thrust::make_discard_iterator(), d_kout));
+
+  auto ret =
+    thrust::reduce_by_key(thrust::cuda::par(allocator).on(stream),
+                          keys_first, keys_first + nrows,
+                          vals,
+                          kout_first,
+                          d_vout,
+                          [] __device__ (thrust::tuple<uint64_t, IndexT> key1,
+                                         thrust::tuple<uint64_t, IndexT> key2) {
+                            return thrust::get<0>(key1) == thrust::get<0>(key2);
+                          },
+                          fctr);
+
+  size_t new_sz = thrust::distance(d_vout, ret.second);
+  return new_sz;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HOST_PARALLEL_H
+#define HOST_PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace cudf {
+namespace detail {
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Number of threads used by host_parallel_for when none is given
+ */
+/* ----------------------------------------------------------------------------*/
+inline unsigned int default_host_threads()
+{
+  unsigned int n = std::thread::hardware_concurrency();
+  return n > 0 ? n : 1;
+}
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Calls f(i) for every i in [0, n) from a set of host threads, the
+ * host analogue of a grid-stride kernel launch.
+ *
+ * Each thread processes a contiguous block of indices. Returns once all calls
+ * have completed.
+ *
+ * @Param n The number of indices
+ * @Param f The functor to call with each index
+ * @Param num_threads The number of threads to use, 0 for default_host_threads()
+ */
+/* ----------------------------------------------------------------------------*/
+template <typename Functor>
+void host_parallel_for(size_t n, Functor f, unsigned int num_threads = 0)
+{
+  if (0 == num_threads) num_threads = default_host_threads();
+  num_threads = static_cast<unsigned int>(std::min<size_t>(num_threads, n));
+
+  if (num_threads <= 1) {
+    for (size_t i = 0; i < n; ++i) f(i);
+    return;
+  }
+
+  const size_t block = (n + num_threads - 1) / num_threads;
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (unsigned int t = 0; t < num_threads; ++t) {
+    const size_t begin = t * block;
+    const size_t end = std::min(n, begin + block);
+    threads.emplace_back([begin, end, &f]() {
+      for (size_t i = begin; i < end; ++i) f(i);
+    });
+  }
+  for (auto& t : threads) t.join();
+}
+
+} // namespace detail
+} // namespace cudf
+
+#endif // HOST_PARALLEL_H
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <groupby/aggregation_operations.cuh>
+
+// The moments functors are __host__ __device__, so they are checked on the host
+
+namespace {
+
+// The two-pass sample variance, as a reference
+double two_pass_variance(std::vector<double> const & values)
+{
+  double mean{0};
+  for (double v : values) mean += v;
+  mean /= values.size();
+  double m2{0};
+  for (double v : values) m2 += (v - mean) * (v - mean);
+  return m2 / (values.size() - 1);
+}
+
+moments add_all(std::vector<double> const & values, size_t begin, size_t end)
+{
+  moments result{};
+  for (size_t i = begin; i < end; ++i) result = welford_op{}(values[i], result);
+  return result;
+}
+
+std::vector<double> random_values(size_t size, double offset)
+{
+  std::default_random_engine generator;
+  std::uniform_real_distribution<double> distribution(-10, 10);
+  std::vector<double> values(size);
+  for (auto & v : values) v = offset + distribution(generator);
+  return values;
+}
+
+}  // namespace
+
+TEST(AggregationOperationsTest, WelfordMatchesTwoPass)
+{
+  const std::vector<double> values = random_values(1000, 0);
+  const moments result = add_all(values, 0, values.size());
+  EXPECT_EQ(1000, result.count);
+  EXPECT_NEAR(two_pass_variance(values), result.variance(), 1e-9);
+}
+
+TEST(AggregationOperationsTest, MergeOfPartsMatchesTheWhole)
+{
+  const std::vector<double> values = random_values(1000, 0);
+  const moments whole = add_all(values, 0, values.size());
+  for (size_t split : {size_t{1}, size_t{10}, size_t{500}, size_t{999}}) {
+    const moments first = add_all(values, 0, split);
+    const moments second = add_all(values, split, values.size());
+    for (moments merged : {welford_op{}(first, second), welford_op{}(second, first)}) {
+      EXPECT_EQ(whole.count, merged.count);
+      EXPECT_NEAR(whole.mean, merged.mean, 1e-12);
+      EXPECT_NEAR(whole.variance(), merged.variance(), 1e-9);
+    }
+  }
+}
+
+TEST(AggregationOperationsTest, EmptyMomentsAreTheIdentity)
+{
+  const moments some = add_all(random_values(10, 0), 0, 10);
+  for (moments merged : {welford_op{}(moments{}, some), welford_op{}(some, moments{})}) {
+    EXPECT_EQ(some.count, merged.count);
+    EXPECT_EQ(some.mean, merged.mean);
+    EXPECT_EQ(some.m2, merged.m2);
+  }
+  const moments empty = welford_op{}(moments{}, moments{});
+  EXPECT_EQ(0, empty.count);
+  EXPECT_EQ(0, empty.m2);
+}
+
+TEST(AggregationOperationsTest, VarianceOfValuesFarFromZero)
+{
+  // The squares of the values are 1e18: their sum cancels out a variance of ~33
+  const std::vector<double> values = random_values(1000, 1e9);
+  std::vector<double> centered(values);
+  for (auto & v : centered) v -= 1e9;
+  const double expected = two_pass_variance(centered);
+
+  EXPECT_NEAR(expected, add_all(values, 0, values.size()).variance(), 1e-6 * expected);
+
+  double sum{0}, sum_of_squares{0};
+  for (double v : values) {
+    sum += v - values[0];
+    sum_of_squares += (v - values[0]) * (v - values[0]);
+  }
+  const moments shifted = moments_from_shifted_sums(values.size(), values[0], sum, sum_of_squares);
+  EXPECT_NEAR(expected, shifted.variance(), 1e-6 * expected);
+  EXPECT_NEAR(1e9, shifted.mean, 10);
+}
+
+TEST(AggregationOperationsTest, ShiftedSumsOfConstantValues)
+{
+  // The variance of equal values is exactly 0, never negative
+  const moments result = moments_from_shifted_sums(3, 2.5, 0, 0);
+  EXPECT_EQ(2.5, result.mean);
+  EXPECT_EQ(0, result.variance());
+  EXPECT_EQ(0, moments_from_shifted_sums(0, 0, 0, 0).count);
+}
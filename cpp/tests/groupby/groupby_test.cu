@@ -455,6 +455,51 @@ TYPED_TEST(GroupTest, EmptyInput)
     this->compare_gdf_result(reference_map);
 }
 
+TYPED_TEST(GroupTest, SharedMemoryFewGroups)
+{
+    const size_t num_keys = 16;
+    const size_t num_values_per_key = 1<<12;
+    const size_t max_key = num_keys*2;
+    const size_t max_val = 1000;
+    this->ctxt.groupby_strategy = GDF_GROUPBY_SHARED_MEMORY;
+    this->create_input(num_keys, num_values_per_key, max_key, max_val);
+    auto reference_map = this->compute_reference_solution();
+    this->create_gdf_output_buffers(num_keys, num_values_per_key);
+    this->compute_gdf_result();
+    this->compare_gdf_result(reference_map);
+}
+
+TYPED_TEST(GroupTest, SharedMemoryBlockTablesFull)
+{
+    // More groups than a thread block table holds, so rows spill to the global table
+    const size_t num_keys = 1<<12;
+    const size_t num_values_per_key = 16;
+    const size_t max_key = num_keys*2;
+    const size_t max_val = 1000;
+    this->ctxt.groupby_strategy = GDF_GROUPBY_SHARED_MEMORY;
+    this->create_input(num_keys, num_values_per_key, max_key, max_val);
+    auto reference_map = this->compute_reference_solution();
+    this->create_gdf_output_buffers(num_keys, num_values_per_key);
+    this->compute_gdf_result();
+    this->compare_gdf_result(reference_map);
+}
+
+TYPED_TEST(GroupTest, SharedMemoryCardinalityHintTooLow)
+{
+    // The global table grows while the partial aggregates are merged
+    const size_t num_keys = 1<<12;
+    const size_t num_values_per_key = 16;
+    const size_t max_key = num_keys*2;
+    const size_t max_val = 1000;
+    this->ctxt.groupby_strategy = GDF_GROUPBY_SHARED_MEMORY;
+    this->ctxt.cardinality_hint = 10;
+    this->create_input(num_keys, num_values_per_key, max_key, max_val);
+    auto reference_map = this->compute_reference_solution();
+    this->create_gdf_output_buffers(num_keys, num_values_per_key);
+    this->compute_gdf_result();
+    this->compare_gdf_result(reference_map);
+}
+
 // Create a new derived class from JoinTest so we can do a new Typed Test set of tests
 template <class test_parameters>
 struct GroupValidTest : public GroupTest<test_parameters>
@@ -0,0 +1,396 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <groupby/host_groupby.h>
+
+// The host groupby does not need a GPU, so there is no need for the GdfTest fixture
+template <class T>
+class HostGroupbyTest : public ::testing::Test
+{
+public:
+  using value_type = T;
+  using key_type = int64_t;
+
+  std::vector<key_type> keys;
+  std::vector<std::vector<value_type>> values;
+  std::vector<gdf_agg_op> ops{GDF_SUM, GDF_MIN, GDF_MAX, GDF_COUNT, GDF_AVG};
+
+  // Empty unless set by set_nulls
+  std::vector<bool> key_valid;
+  std::vector<std::vector<bool>> value_valid;
+  bool include_null_keys{false};
+
+  void create_input(int num_rows, int max_key)
+  {
+    std::default_random_engine generator;
+    std::uniform_int_distribution<int> key_distribution(0, max_key);
+    std::uniform_int_distribution<int> value_distribution(-1000, 1000);
+    keys.resize(num_rows);
+    for (auto & k : keys) k = key_distribution(generator);
+    values.assign(ops.size(), std::vector<value_type>(num_rows));
+    for (auto & column : values) {
+      for (auto & v : column) v = static_cast<value_type>(value_distribution(generator));
+    }
+  }
+
+  // Makes one in every null_period keys and values NULL, at random
+  void set_nulls(int null_period)
+  {
+    std::default_random_engine generator(1);
+    std::uniform_int_distribution<int> null_distribution(0, null_period - 1);
+    key_valid.resize(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) key_valid[i] = (0 != null_distribution(generator));
+    value_valid.assign(ops.size(), std::vector<bool>(keys.size()));
+    for (auto & column : value_valid) {
+      for (size_t i = 0; i < column.size(); ++i) column[i] = (0 != null_distribution(generator));
+    }
+  }
+
+  bool is_key_valid(size_t row) const { return key_valid.empty() || key_valid[row]; }
+
+  bool is_value_valid(size_t a, size_t row) const { return value_valid.empty() || value_valid[a][row]; }
+
+  // Computes every aggregation of every group with a std::map, in key order,
+  // the NULL key first
+  host_groupby_result<key_type, value_type> compute_reference_solution()
+  {
+    host_groupby_result<key_type, value_type> result;
+    result.aggregates.resize(ops.size());
+    result.aggregate_valid.resize(ops.size());
+
+    std::map<std::pair<bool, key_type>, std::vector<size_t>> groups;
+    for (size_t i = 0; i < keys.size(); ++i) {
+      if (is_key_valid(i)) {
+        groups[std::make_pair(true, keys[i])].push_back(i);
+      }
+      else if (include_null_keys) {
+        groups[std::make_pair(false, key_type{})].push_back(i);
+      }
+    }
+
+    for (auto const & group : groups) {
+      result.keys.push_back(group.first.second);
+      result.key_valid.push_back(group.first.first);
+      for (size_t a = 0; a < ops.size(); ++a) {
+        std::vector<value_type> group_values;
+        for (size_t row : group.second) {
+          if (is_value_valid(a, row)) group_values.push_back(values[a][row]);
+        }
+        value_type sum{0};
+        for (value_type v : group_values) sum += v;
+        const value_type count = static_cast<value_type>(group_values.size());
+        const bool valid = (GDF_COUNT == ops[a]) || !group_values.empty();
+
+        value_type aggregate{};
+        if (valid) {
+          switch (ops[a]) {
+            case GDF_SUM: aggregate = sum; break;
+            case GDF_MIN: aggregate = *std::min_element(group_values.begin(), group_values.end()); break;
+            case GDF_MAX: aggregate = *std::max_element(group_values.begin(), group_values.end()); break;
+            case GDF_COUNT: aggregate = count; break;
+            case GDF_AVG: aggregate = sum / count; break;
+            default: break;
+          }
+        }
+        result.aggregates[a].push_back(aggregate);
+        result.aggregate_valid[a].push_back(valid);
+      }
+    }
+    return result;
+  }
+
+  // Sorts the groups of a result by key, the NULL key first
+  static host_groupby_result<key_type, value_type>
+  sort_groups(host_groupby_result<key_type, value_type> const & result)
+  {
+    std::vector<size_t> order(result.keys.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&result](size_t l, size_t r) {
+      return std::make_pair(result.key_valid[l], result.keys[l])
+             < std::make_pair(result.key_valid[r], result.keys[r]);
+    });
+
+    host_groupby_result<key_type, value_type> sorted;
+    sorted.aggregates.resize(result.aggregates.size());
+    sorted.aggregate_valid.resize(result.aggregates.size());
+    for (size_t i : order) {
+      sorted.keys.push_back(result.keys[i]);
+      sorted.key_valid.push_back(result.key_valid[i]);
+      for (size_t a = 0; a < result.aggregates.size(); ++a) {
+        sorted.aggregates[a].push_back(result.aggregates[a][i]);
+        sorted.aggregate_valid[a].push_back(result.aggregate_valid[a][i]);
+      }
+    }
+    return sorted;
+  }
+
+  void check(unsigned int num_threads)
+  {
+    check_result(sort_groups(host_group_by(keys, values, ops, num_threads,
+                                           key_valid, value_valid, include_null_keys)));
+  }
+
+  void check_privatized(unsigned int num_threads, size_t local_capacity)
+  {
+    check_result(sort_groups(host_group_by_privatized(keys, values, ops, num_threads, local_capacity,
+                                                      key_valid, value_valid, include_null_keys)));
+  }
+
+  // Computes the partial aggregates of num_parts contiguous parts of the rows,
+  // and merges them, concatenated in the order of the parts
+  host_groupby_result<key_type, double> partial_and_merge(size_t num_parts)
+  {
+    auto slice = [](std::vector<bool> const & valid, size_t begin, size_t end) {
+      return valid.empty() ? valid : std::vector<bool>(valid.begin() + begin, valid.begin() + end);
+    };
+
+    host_groupby_result<key_type, double> partials;
+    const size_t part_size = (keys.size() + num_parts - 1) / num_parts;
+    for (size_t begin = 0; begin < keys.size(); begin += part_size) {
+      const size_t end = std::min(keys.size(), begin + part_size);
+      std::vector<key_type> part_keys(keys.begin() + begin, keys.begin() + end);
+      std::vector<std::vector<value_type>> part_values;
+      std::vector<std::vector<bool>> part_value_valid;
+      for (size_t a = 0; a < ops.size(); ++a) {
+        part_values.emplace_back(values[a].begin() + begin, values[a].begin() + end);
+        if (!value_valid.empty()) part_value_valid.push_back(slice(value_valid[a], begin, end));
+      }
+
+      auto part = host_group_by_partial(part_keys, part_values, ops, slice(key_valid, begin, end),
+                                        part_value_valid, include_null_keys);
+      partials.keys.insert(partials.keys.end(), part.keys.begin(), part.keys.end());
+      partials.key_valid.insert(partials.key_valid.end(), part.key_valid.begin(), part.key_valid.end());
+      partials.aggregates.resize(part.aggregates.size());
+      partials.aggregate_valid.resize(part.aggregates.size());
+      for (size_t c = 0; c < part.aggregates.size(); ++c) {
+        partials.aggregates[c].insert(partials.aggregates[c].end(),
+                                      part.aggregates[c].begin(), part.aggregates[c].end());
+        partials.aggregate_valid[c].insert(partials.aggregate_valid[c].end(),
+                                           part.aggregate_valid[c].begin(), part.aggregate_valid[c].end());
+      }
+    }
+    return host_group_by_merge(partials, ops, include_null_keys);
+  }
+
+  void check_partial_merge(size_t num_parts)
+  {
+    // AVG is merged in double, so it is truncated like the integer division
+    // of the reference
+    auto merged = partial_and_merge(num_parts);
+    host_groupby_result<key_type, value_type> actual;
+    actual.keys = merged.keys;
+    actual.key_valid = merged.key_valid;
+    for (size_t a = 0; a < merged.aggregates.size(); ++a) {
+      actual.aggregates.emplace_back();
+      for (double aggregate : merged.aggregates[a]) {
+        actual.aggregates.back().push_back(static_cast<value_type>(aggregate));
+      }
+      actual.aggregate_valid.push_back(merged.aggregate_valid[a]);
+    }
+    check_result(sort_groups(actual));
+  }
+
+  void check_result(host_groupby_result<key_type, value_type> const & actual)
+  {
+    auto expected = compute_reference_solution();
+    EXPECT_EQ(expected.keys, actual.keys);
+    EXPECT_EQ(expected.key_valid, actual.key_valid);
+    for (size_t a = 0; a < ops.size(); ++a) {
+      EXPECT_EQ(expected.aggregates[a], actual.aggregates[a]) << "aggregation " << a;
+      EXPECT_EQ(expected.aggregate_valid[a], actual.aggregate_valid[a]) << "aggregation " << a;
+    }
+  }
+};
+
+// Integer values, and floating point values that are small integers so that
+// the sums are exact whatever the order of the rows
+typedef ::testing::Types<int32_t, int64_t, double> ValueTypes;
+
+TYPED_TEST_CASE(HostGroupbyTest, ValueTypes);
+
+TYPED_TEST(HostGroupbyTest, FewGroups)
+{
+  this->create_input(10000, 10);
+  this->check(1);
+  this->check(4);
+}
+
+TYPED_TEST(HostGroupbyTest, ManyGroups)
+{
+  this->create_input(10000, 5000);
+  this->check(1);
+  this->check(4);
+}
+
+TYPED_TEST(HostGroupbyTest, SameColumnManyOperations)
+{
+  this->create_input(5000, 100);
+  for (auto & column : this->values) column = this->values[0];
+  this->check(4);
+}
+
+TYPED_TEST(HostGroupbyTest, NullKeysDropped)
+{
+  this->create_input(10000, 100);
+  this->set_nulls(5);
+  this->check(1);
+  this->check(4);
+}
+
+TYPED_TEST(HostGroupbyTest, NullKeysGrouped)
+{
+  this->create_input(10000, 100);
+  this->set_nulls(5);
+  this->include_null_keys = true;
+  this->check(1);
+  this->check(4);
+}
+
+TYPED_TEST(HostGroupbyTest, AllValuesNullInGroups)
+{
+  // Most groups have a single row, so many have no non-null value
+  this->create_input(1000, 5000);
+  this->set_nulls(2);
+  this->include_null_keys = true;
+  this->check(4);
+}
+
+TYPED_TEST(HostGroupbyTest, PrivatizedFewGroups)
+{
+  // Every group fits in the table of every thread
+  this->create_input(10000, 10);
+  this->check_privatized(1, 1024);
+  this->check_privatized(4, 1024);
+}
+
+TYPED_TEST(HostGroupbyTest, PrivatizedLocalTablesFull)
+{
+  // Most rows spill from the tables of the threads
+  this->create_input(10000, 500);
+  this->check_privatized(1, 64);
+  this->check_privatized(4, 64);
+  this->check_privatized(4, 2);
+}
+
+TYPED_TEST(HostGroupbyTest, PrivatizedWithNulls)
+{
+  this->create_input(10000, 100);
+  this->set_nulls(5);
+  this->check_privatized(4, 128);
+  this->include_null_keys = true;
+  this->check_privatized(4, 128);
+}
+
+TYPED_TEST(HostGroupbyTest, PartialAndMerge)
+{
+  this->create_input(10000, 100);
+  this->check_partial_merge(1);
+  this->check_partial_merge(3);
+  this->check_partial_merge(50);
+}
+
+TYPED_TEST(HostGroupbyTest, PartialAndMergeWithNulls)
+{
+  // Many groups have no non-null value in some parts
+  this->create_input(10000, 500);
+  this->set_nulls(3);
+  this->check_partial_merge(20);
+  this->include_null_keys = true;
+  this->check_partial_merge(20);
+}
+
+using HostGroupbyMomentsTest = HostGroupbyTest<double>;
+
+TEST_F(HostGroupbyMomentsTest, MergedAcrossParts)
+{
+  // The moments of VAR and STD and the FIRST and LAST of the parts are merged
+  // into those of the whole table
+  ops = {GDF_VAR, GDF_STD, GDF_FIRST, GDF_LAST};
+  create_input(10000, 50);
+  for (auto & v : values[0]) v = 1e9 + v / 8;
+  set_nulls(4);
+  for (auto & column : values) column = values[0];
+  for (auto & column : value_valid) column = value_valid[0];
+
+  auto whole = sort_groups(partial_and_merge(1));
+  for (size_t num_parts : {2, 7, 100}) {
+    auto merged = sort_groups(partial_and_merge(num_parts));
+    ASSERT_EQ(whole.keys, merged.keys);
+    EXPECT_EQ(whole.aggregate_valid, merged.aggregate_valid);
+    for (size_t g = 0; g < whole.keys.size(); ++g) {
+      EXPECT_NEAR(whole.aggregates[0][g], merged.aggregates[0][g], 1e-6 * whole.aggregates[0][g]);
+      EXPECT_NEAR(whole.aggregates[1][g], merged.aggregates[1][g], 1e-6 * whole.aggregates[1][g]);
+    }
+    EXPECT_EQ(whole.aggregates[2], merged.aggregates[2]);
+    EXPECT_EQ(whole.aggregates[3], merged.aggregates[3]);
+  }
+
+  EXPECT_EQ(4u, whole.aggregates.size());
+  for (size_t g = 0; g < whole.keys.size(); ++g) {
+    if (!whole.aggregate_valid[0][g]) continue;
+    EXPECT_LT(0, whole.aggregates[0][g]);
+    EXPECT_NEAR(std::sqrt(whole.aggregates[0][g]), whole.aggregates[1][g], 1e-9 * whole.aggregates[1][g]);
+  }
+}
+
+TEST(HostGroupbyPartialTest, PartialAggregateLayout)
+{
+  std::vector<int> keys{1, 2, 1, 1};
+  std::vector<std::vector<double>> values{{1, 2, 3, 5}, {1, 2, 3, 5}};
+  auto partial = host_group_by_partial(keys, values, {GDF_AVG, GDF_VAR});
+  ASSERT_EQ(5u, partial.aggregates.size());
+  EXPECT_EQ((std::vector<int>{1, 2}), partial.keys);
+  EXPECT_EQ((std::vector<double>{9, 2}), partial.aggregates[0]);  // SUM
+  EXPECT_EQ((std::vector<double>{3, 1}), partial.aggregates[1]);  // COUNT
+  EXPECT_EQ((std::vector<double>{3, 1}), partial.aggregates[2]);  // COUNT
+  EXPECT_EQ((std::vector<double>{3, 2}), partial.aggregates[3]);  // mean
+  EXPECT_EQ((std::vector<double>{8, 0}), partial.aggregates[4]);  // M2
+
+  auto merged = host_group_by_merge(partial, {GDF_AVG, GDF_VAR});
+  EXPECT_EQ((std::vector<double>{3, 2}), merged.aggregates[0]);
+  EXPECT_EQ((std::vector<bool>{true, true}), merged.aggregate_valid[0]);
+  EXPECT_EQ(4, merged.aggregates[1][0]);
+  EXPECT_EQ((std::vector<bool>{true, false}), merged.aggregate_valid[1]);
+}
+
+TEST(HostGroupbyEmptyTest, NoRows)
+{
+  std::vector<int> keys;
+  std::vector<std::vector<double>> values(2);
+  auto result = host_group_by(keys, values, {GDF_SUM, GDF_COUNT});
+  EXPECT_TRUE(result.keys.empty());
+  ASSERT_EQ(2u, result.aggregates.size());
+  EXPECT_TRUE(result.aggregates[0].empty());
+  EXPECT_TRUE(result.aggregates[1].empty());
+}
+
+TEST(HostGroupbyEmptyTest, PrivatizedNoRows)
+{
+  std::vector<int> keys;
+  std::vector<std::vector<double>> values(1);
+  auto result = host_group_by_privatized(keys, values, {GDF_COUNT});
+  EXPECT_TRUE(result.keys.empty());
+  ASSERT_EQ(1u, result.aggregates.size());
+  EXPECT_TRUE(result.aggregates[0].empty());
+}
@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <cudf.h>
+#include <rmm/rmm.h>
+#include <cudf/functions.h>
+
+#include "groupby/host_groupby.h"
+
+#include "tests/utilities/cudf_test_utils.cuh"
+#include "tests/utilities/cudf_test_fixtures.h"
+
+template <typename T>
+struct MultiAggregationTest : public GdfTest
+{
+  using value_type = T;
+  using key_type = int64_t;
+  using result_type = host_groupby_result<key_type, value_type>;
+
+  gdf_context ctxt{0, GDF_HASH, 0, 1};
+
+  std::vector<key_type> keys;
+  std::vector<std::vector<value_type>> values;
+  std::vector<gdf_agg_op> ops{GDF_SUM, GDF_MIN, GDF_MAX, GDF_COUNT, GDF_AVG};
+
+  // Empty unless set by set_nulls
+  std::vector<bool> key_valid;
+  std::vector<std::vector<bool>> value_valid;
+
+  MultiAggregationTest()
+  {
+    std::srand(0);
+  }
+
+  void create_input(size_t num_rows, int max_key)
+  {
+    keys.resize(num_rows);
+    for(auto & k : keys) k = std::rand() % max_key;
+    values.assign(ops.size(), std::vector<value_type>(num_rows));
+    for(auto & column : values) {
+      for(auto & v : column) v = static_cast<value_type>(std::rand() % 2000 - 1000);
+    }
+  }
+
+  // Makes one in every null_period keys and values NULL, at random
+  void set_nulls(int null_period)
+  {
+    key_valid.resize(keys.size());
+    for(size_t i = 0; i < keys.size(); ++i) key_valid[i] = (0 != std::rand() % null_period);
+    value_valid.assign(ops.size(), std::vector<bool>(keys.size()));
+    for(auto & column : value_valid) {
+      for(size_t i = 0; i < column.size(); ++i) column[i] = (0 != std::rand() % null_period);
+    }
+  }
+
+  // Sorts the groups of a result by key, the NULL key first. The data under
+  // a NULL is undefined, so it is set to the default value.
+  static result_type sort_groups(result_type const & result)
+  {
+    std::vector<size_t> order(result.keys.size());
+    for(size_t i = 0; i < order.size(); ++i) order[i] = i;
+    auto sort_key = [&result](size_t i) {
+      return std::make_pair(result.key_valid[i], result.key_valid[i] ? result.keys[i] : key_type{});
+    };
+    std::sort(order.begin(), order.end(),
+              [&sort_key](size_t l, size_t r) { return sort_key(l) < sort_key(r); });
+
+    result_type sorted;
+    sorted.aggregates.resize(result.aggregates.size());
+    sorted.aggregate_valid.resize(result.aggregates.size());
+    for(size_t i : order) {
+      sorted.keys.push_back(sort_key(i).second);
+      sorted.key_valid.push_back(result.key_valid[i]);
+      for(size_t a = 0; a < result.aggregates.size(); ++a) {
+        const bool valid = result.aggregate_valid[a][i];
+        sorted.aggregates[a].push_back(valid ? result.aggregates[a][i] : value_type{});
+        sorted.aggregate_valid[a].push_back(valid);
+      }
+    }
+    return sorted;
+  }
+
+  // The host groupby, with its groups sorted by key
+  result_type compute_reference_solution()
+  {
+    return sort_groups(host_group_by(keys, values, ops, 0, key_valid, value_valid,
+                                     1 == ctxt.flag_groupby_include_nulls));
+  }
+
+  // The validity masks of a column, empty if all its rows are valid
+  static std::vector<gdf_valid_type> to_masks(std::vector<bool> const & valid)
+  {
+    std::vector<gdf_valid_type> masks;
+    if(valid.empty()) return masks;
+    masks.assign(gdf_get_num_chars_bitmask(valid.size()), 0);
+    for(size_t i = 0; i < valid.size(); ++i) {
+      if(valid[i]) gdf::util::turn_bit_on(masks.data(), i);
+    }
+    return masks;
+  }
+
+  template <typename col_type>
+  static std::vector<col_type> to_host(gdf_column const & column)
+  {
+    std::vector<col_type> host_vector(column.size);
+    if(column.size > 0) {
+      EXPECT_EQ(cudaSuccess, cudaMemcpy(host_vector.data(), column.data, column.size * sizeof(col_type),
+                                        cudaMemcpyDeviceToHost));
+    }
+    return host_vector;
+  }
+
+  // The validity of every row of a column, checked against its null_count
+  static std::vector<bool> valid_to_host(gdf_column const & column)
+  {
+    std::vector<bool> valid(column.size, true);
+    if((nullptr == column.valid) || (0 == column.size)) return valid;
+
+    std::vector<gdf_valid_type> masks(gdf_get_num_chars_bitmask(column.size));
+    EXPECT_EQ(cudaSuccess, cudaMemcpy(masks.data(), column.valid, masks.size(), cudaMemcpyDeviceToHost));
+    gdf_size_type null_count{0};
+    for(size_t i = 0; i < valid.size(); ++i) {
+      valid[i] = gdf_is_valid(masks.data(), i);
+      if(!valid[i]) ++null_count;
+    }
+    EXPECT_EQ(null_count, column.null_count);
+    return valid;
+  }
+
+  // Calls gdf_group_by and returns its result, sorted by key. The outputs have
+  // validity masks if the inputs have NULLs.
+  result_type compute_gdf_result(gdf_error expected_error = GDF_SUCCESS)
+  {
+    const std::vector<bool> all_valid(value_valid.empty() ? 0 : keys.size(), true);
+
+    gdf_col_pointer key_column = create_gdf_column(keys, to_masks(key_valid));
+    gdf_col_pointer out_key_column = create_gdf_column(keys, to_masks(all_valid));
+
+    std::vector<gdf_col_pointer> value_columns, out_value_columns;
+    std::vector<gdf_column*> raw_value_columns, raw_out_value_columns;
+    for(size_t a = 0; a < ops.size(); ++a) {
+      value_columns.push_back(create_gdf_column(values[a], to_masks(value_valid.empty() ? all_valid : value_valid[a])));
+      out_value_columns.push_back(create_gdf_column(values[a], to_masks(all_valid)));
+      raw_value_columns.push_back(value_columns.back().get());
+      raw_out_value_columns.push_back(out_value_columns.back().get());
+    }
+
+    gdf_column * key_columns[] = {key_column.get()};
+    gdf_column * out_key_columns[] = {out_key_column.get()};
+    EXPECT_EQ(expected_error, gdf_group_by(1, key_columns,
+                                           static_cast<int>(ops.size()), raw_value_columns.data(),
+                                           ops.data(), out_key_columns,
+                                           raw_out_value_columns.data(), &ctxt));
+
+    result_type result;
+    if(GDF_SUCCESS != expected_error) return result;
+
+    result.keys = to_host<key_type>(*out_key_column);
+    result.key_valid = valid_to_host(*out_key_column);
+    for(size_t a = 0; a < ops.size(); ++a) {
+      EXPECT_EQ(out_key_column->size, out_value_columns[a]->size);
+      result.aggregates.push_back(to_host<value_type>(*out_value_columns[a]));
+      result.aggregate_valid.push_back(valid_to_host(*out_value_columns[a]));
+    }
+    return sort_groups(result);
+  }
+
+  void check()
+  {
+    result_type expected = compute_reference_solution();
+    result_type actual = compute_gdf_result();
+    EXPECT_EQ(expected.keys, actual.keys);
+    EXPECT_EQ(expected.key_valid, actual.key_valid);
+    ASSERT_EQ(expected.aggregates.size(), actual.aggregates.size());
+    for(size_t a = 0; a < ops.size(); ++a) {
+      EXPECT_EQ(expected.aggregates[a], actual.aggregates[a]) << "aggregation " << a;
+      EXPECT_EQ(expected.aggregate_valid[a], actual.aggregate_valid[a]) << "aggregation " << a;
+    }
+  }
+};
+
+// The floating point values are small integers, so that the sums are exact
+// whatever the order of the rows
+typedef ::testing::Types<int32_t, int64_t, double> ValueTypes;
+
+TYPED_TEST_CASE(MultiAggregationTest, ValueTypes);
+
+TYPED_TEST(MultiAggregationTest, FewGroups)
+{
+  this->create_input(100000, 10);
+  this->check();
+}
+
+TYPED_TEST(MultiAggregationTest, ManyGroups)
+{
+  this->create_input(100000, 50000);
+  this->check();
+}
+
+TYPED_TEST(MultiAggregationTest, CardinalityHintTooLow)
+{
+  this->ctxt.cardinality_hint = 100;
+  this->create_input(100000, 50000);
+  this->check();
+}
+
+TYPED_TEST(MultiAggregationTest, EstimatedNumberOfGroups)
+{
+  // Without a hint, the hash table is sized for the estimated number of groups
+  // rather than for the input
+  gdf_hash_table_stats stats{};
+  this->ctxt.hash_table_stats = &stats;
+  this->create_input(1000000, 1000);
+  this->check();
+  EXPECT_EQ(1000u, stats.num_entries);
+  EXPECT_LT(stats.table_size, size_t{10000});
+}
+
+TYPED_TEST(MultiAggregationTest, SortMethod)
+{
+  // The sort-based groupby computes the aggregations one at a time
+  this->ctxt.flag_method = GDF_SORT;
+  this->ops = {GDF_SUM, GDF_MIN, GDF_MAX};
+  this->create_input(10000, 100);
+  this->check();
+}
+
+TYPED_TEST(MultiAggregationTest, NullKeysDropped)
+{
+  this->create_input(100000, 1000);
+  this->set_nulls(5);
+  this->check();
+}
+
+TYPED_TEST(MultiAggregationTest, NullKeysGrouped)
+{
+  this->ctxt.flag_groupby_include_nulls = 1;
+  this->create_input(100000, 1000);
+  this->set_nulls(5);
+  this->check();
+}
+
+TYPED_TEST(MultiAggregationTest, AllValuesNullInGroups)
+{
+  // Most groups have a single row, so many have no non-null value
+  this->ctxt.flag_groupby_include_nulls = 1;
+  this->create_input(10000, 50000);
+  this->set_nulls(2);
+  this->check();
+}
+
+TYPED_TEST(MultiAggregationTest, NullsUnsupportedBySortMethod)
+{
+  this->ctxt.flag_method = GDF_SORT;
+  this->ops = {GDF_SUM};
+  this->create_input(1000, 10);
+  this->set_nulls(5);
+  this->compute_gdf_result(GDF_VALIDITY_UNSUPPORTED);
+}
+
+TYPED_TEST(MultiAggregationTest, UnsupportedOperation)
+{
+  this->ops = {GDF_SUM, GDF_COUNT_DISTINCT};
+  this->create_input(100, 10);
+  this->compute_gdf_result(GDF_UNSUPPORTED_METHOD);
+}
@@ -0,0 +1,408 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <cudf.h>
+#include <rmm/rmm.h>
+#include <cudf/functions.h>
+
+#include "groupby/host_groupby.h"
+
+#include "tests/utilities/cudf_test_utils.cuh"
+#include "tests/utilities/cudf_test_fixtures.h"
+
+// Computes the partial aggregates of the parts of a table with
+// gdf_group_by_partial, merges them with gdf_group_by_merge, and checks both
+// against host_group_by_partial and host_group_by_merge, and the merge against
+// a single gdf_group_by of the whole table
+struct PartialAggregationTest : public GdfTest
+{
+  using key_type = int64_t;
+  using value_type = double;
+  using result_type = host_groupby_result<key_type, double>;
+
+  gdf_context ctxt{0, GDF_HASH, 0, 1};
+
+  std::vector<key_type> keys;
+  std::vector<std::vector<value_type>> values;
+  std::vector<gdf_agg_op> ops{GDF_SUM, GDF_MIN, GDF_MAX, GDF_COUNT, GDF_AVG, GDF_VAR, GDF_STD, GDF_FIRST, GDF_LAST};
+
+  // Empty unless set by set_nulls
+  std::vector<bool> key_valid;
+  std::vector<std::vector<bool>> value_valid;
+
+  PartialAggregationTest()
+  {
+    std::srand(0);
+  }
+
+  // The values are multiples of 1/8, so that the sums are exact whatever the
+  // order of the rows
+  void create_input(size_t num_rows, int max_key)
+  {
+    keys.resize(num_rows);
+    for(auto & k : keys) k = std::rand() % max_key;
+    values.assign(ops.size(), std::vector<value_type>(num_rows));
+    for(auto & column : values) {
+      for(auto & v : column) v = (std::rand() % 2000 - 1000) / 8.0;
+    }
+  }
+
+  void set_nulls(int null_period)
+  {
+    key_valid.resize(keys.size());
+    for(size_t i = 0; i < keys.size(); ++i) key_valid[i] = (0 != std::rand() % null_period);
+    value_valid.assign(ops.size(), std::vector<bool>(keys.size()));
+    for(auto & column : value_valid) {
+      for(size_t i = 0; i < column.size(); ++i) column[i] = (0 != std::rand() % null_period);
+    }
+  }
+
+  static std::vector<gdf_valid_type> to_masks(std::vector<bool> const & valid)
+  {
+    std::vector<gdf_valid_type> masks;
+    if(valid.empty()) return masks;
+    masks.assign(gdf_get_num_chars_bitmask(valid.size()), 0);
+    for(size_t i = 0; i < valid.size(); ++i) {
+      if(valid[i]) gdf::util::turn_bit_on(masks.data(), i);
+    }
+    return masks;
+  }
+
+  template <typename col_type>
+  static std::vector<col_type> to_host(gdf_column const & column)
+  {
+    std::vector<col_type> host_vector(column.size);
+    if(column.size > 0) {
+      EXPECT_EQ(cudaSuccess, cudaMemcpy(host_vector.data(), column.data, column.size * sizeof(col_type),
+                                        cudaMemcpyDeviceToHost));
+    }
+    return host_vector;
+  }
+
+  static std::vector<bool> valid_to_host(gdf_column const & column)
+  {
+    std::vector<bool> valid(column.size, true);
+    if((nullptr == column.valid) || (0 == column.size)) return valid;
+    std::vector<gdf_valid_type> masks(gdf_get_num_chars_bitmask(column.size));
+    EXPECT_EQ(cudaSuccess, cudaMemcpy(masks.data(), column.valid, masks.size(), cudaMemcpyDeviceToHost));
+    for(size_t i = 0; i < valid.size(); ++i) valid[i] = gdf_is_valid(masks.data(), i);
+    return valid;
+  }
+
+  // The partial aggregate columns of the operations: the COUNTs in int64_t
+  // and the other columns in double
+  std::vector<bool> partial_is_count() const
+  {
+    std::vector<bool> is_count;
+    for(auto op : ops) {
+      std::vector<gdf_agg_op> partial_ops = partial_aggregation_ops(op);
+      EXPECT_EQ(static_cast<int>(partial_ops.size()), gdf_group_by_num_partial_columns(op));
+      for(auto partial_op : partial_ops) is_count.push_back(GDF_COUNT == partial_op);
+    }
+    return is_count;
+  }
+
+  // Calls gdf_group_by_partial on the rows [begin, end), and returns the
+  // partial aggregates in double, in the order of the keys
+  result_type compute_gdf_partial(size_t begin, size_t end)
+  {
+    auto slice = [begin, end](std::vector<bool> const & valid) {
+      return valid.empty() ? valid : std::vector<bool>(valid.begin() + begin, valid.begin() + end);
+    };
+    const std::vector<key_type> part_keys(keys.begin() + begin, keys.begin() + end);
+    const std::vector<bool> all_valid(key_valid.empty() ? 0 : part_keys.size(), true);
+
+    gdf_col_pointer key_column = create_gdf_column(part_keys, to_masks(slice(key_valid)));
+    gdf_col_pointer out_key_column = create_gdf_column(part_keys, to_masks(all_valid));
+
+    std::vector<gdf_col_pointer> value_columns, partial_columns;
+    std::vector<gdf_column*> raw_value_columns, raw_partial_columns;
+    for(size_t a = 0; a < ops.size(); ++a) {
+      const std::vector<value_type> part_values(values[a].begin() + begin, values[a].begin() + end);
+      value_columns.push_back(create_gdf_column(part_values,
+                                                to_masks(value_valid.empty() ? std::vector<bool>{} : slice(value_valid[a]))));
+      raw_value_columns.push_back(value_columns.back().get());
+    }
+    const std::vector<bool> is_count = partial_is_count();
+    const std::vector<bool> partial_valid(part_keys.size(), true);
+    for(bool count : is_count) {
+      partial_columns.push_back(count ? create_gdf_column(std::vector<int64_t>(part_keys.size()), to_masks(partial_valid))
+                                      : create_gdf_column(std::vector<double>(part_keys.size()), to_masks(partial_valid)));
+      raw_partial_columns.push_back(partial_columns.back().get());
+    }
+
+    gdf_column * key_columns[] = {key_column.get()};
+    gdf_column * out_key_columns[] = {out_key_column.get()};
+    EXPECT_EQ(GDF_SUCCESS, gdf_group_by_partial(1, key_columns, static_cast<int>(ops.size()), raw_value_columns.data(),
+                                                ops.data(), out_key_columns, raw_partial_columns.data(), &ctxt));
+
+    result_type result;
+    result.keys = to_host<key_type>(*out_key_column);
+    result.key_valid = valid_to_host(*out_key_column);
+    for(size_t c = 0; c < is_count.size(); ++c) {
+      EXPECT_EQ(out_key_column->size, partial_columns[c]->size);
+      if(is_count[c]) {
+        const std::vector<int64_t> counts = to_host<int64_t>(*partial_columns[c]);
+        result.aggregates.emplace_back(counts.begin(), counts.end());
+      }
+      else {
+        result.aggregates.push_back(to_host<double>(*partial_columns[c]));
+      }
+      result.aggregate_valid.push_back(valid_to_host(*partial_columns[c]));
+    }
+    return result;
+  }
+
+  // Calls gdf_group_by_merge on partial aggregates
+  result_type compute_gdf_merge(result_type const & partials)
+  {
+    const std::vector<bool> is_count = partial_is_count();
+    gdf_col_pointer key_column = create_gdf_column(partials.keys, to_masks(partials.key_valid));
+    gdf_col_pointer out_key_column = create_gdf_column(partials.keys, to_masks(partials.key_valid));
+
+    std::vector<gdf_col_pointer> partial_columns, out_columns;
+    std::vector<gdf_column*> raw_partial_columns, raw_out_columns;
+    for(size_t c = 0; c < is_count.size(); ++c) {
+      auto const & column = partials.aggregates[c];
+      partial_columns.push_back(is_count[c]
+                                ? create_gdf_column(std::vector<int64_t>(column.begin(), column.end()))
+                                : create_gdf_column(column, to_masks(partials.aggregate_valid[c])));
+      raw_partial_columns.push_back(partial_columns.back().get());
+    }
+    for(size_t a = 0; a < ops.size(); ++a) {
+      out_columns.push_back(create_gdf_column(std::vector<double>(partials.keys.size()),
+                                              to_masks(std::vector<bool>(partials.keys.size(), true))));
+      raw_out_columns.push_back(out_columns.back().get());
+    }
+
+    gdf_column * key_columns[] = {key_column.get()};
+    gdf_column * out_key_columns[] = {out_key_column.get()};
+    EXPECT_EQ(GDF_SUCCESS, gdf_group_by_merge(1, key_columns, static_cast<int>(ops.size()), raw_partial_columns.data(),
+                                              ops.data(), out_key_columns, raw_out_columns.data(), &ctxt));
+
+    result_type result;
+    result.keys = to_host<key_type>(*out_key_column);
+    result.key_valid = valid_to_host(*out_key_column);
+    for(size_t a = 0; a < ops.size(); ++a) {
+      EXPECT_EQ(out_key_column->size, out_columns[a]->size);
+      result.aggregates.push_back(to_host<double>(*out_columns[a]));
+      result.aggregate_valid.push_back(valid_to_host(*out_columns[a]));
+    }
+    return result;
+  }
+
+  // Calls gdf_group_by on the whole table
+  result_type compute_gdf_group_by()
+  {
+    const std::vector<bool> all_valid(keys.size(), true);
+    gdf_col_pointer key_column = create_gdf_column(keys, to_masks(key_valid));
+    gdf_col_pointer out_key_column = create_gdf_column(keys, to_masks(all_valid));
+
+    std::vector<gdf_col_pointer> value_columns, out_columns;
+    std::vector<gdf_column*> raw_value_columns, raw_out_columns;
+    for(size_t a = 0; a < ops.size(); ++a) {
+      value_columns.push_back(create_gdf_column(values[a], to_masks(value_valid.empty() ? std::vector<bool>{} : value_valid[a])));
+      raw_value_columns.push_back(value_columns.back().get());
+      out_columns.push_back(create_gdf_column(std::vector<double>(keys.size()), to_masks(all_valid)));
+      raw_out_columns.push_back(out_columns.back().get());
+    }
+
+    gdf_column * key_columns[] = {key_column.get()};
+    gdf_column * out_key_columns[] = {out_key_column.get()};
+    EXPECT_EQ(GDF_SUCCESS, gdf_group_by(1, key_columns, static_cast<int>(ops.size()), raw_value_columns.data(),
+                                        ops.data(), out_key_columns, raw_out_columns.data(), &ctxt));
+
+    result_type result;
+    result.keys = to_host<key_type>(*out_key_column);
+    result.key_valid = valid_to_host(*out_key_column);
+    for(size_t a = 0; a < ops.size(); ++a) {
+      EXPECT_EQ(out_key_column->size, out_columns[a]->size);
+      result.aggregates.push_back(to_host<double>(*out_columns[a]));
+      result.aggregate_valid.push_back(valid_to_host(*out_columns[a]));
+    }
+    return result;
+  }
+
+  // Indexes the groups of a result by key, the NULL key first
+  static std::map<std::pair<bool, key_type>, size_t> index_groups(result_type const & result)
+  {
+    std::map<std::pair<bool, key_type>, size_t> groups;
+    for(size_t i = 0; i < result.keys.size(); ++i) {
+      groups[std::make_pair(bool(result.key_valid[i]), result.key_valid[i] ? result.keys[i] : key_type{})] = i;
+    }
+    EXPECT_EQ(result.keys.size(), groups.size());
+    return groups;
+  }
+
+  // Compares the groups of two results, whatever their order. The moments of
+  // VAR and STD depend on the order of the rows, so they are compared with a
+  // tolerance.
+  static void check_equal(result_type const & expected, result_type const & actual)
+  {
+    auto expected_groups = index_groups(expected);
+    auto actual_groups = index_groups(actual);
+    ASSERT_EQ(expected_groups.size(), actual_groups.size());
+    ASSERT_EQ(expected.aggregates.size(), actual.aggregates.size());
+    for(auto const & group : expected_groups) {
+      ASSERT_EQ(1u, actual_groups.count(group.first)) << "key " << group.first.second;
+      const size_t e = group.second;
+      const size_t g = actual_groups[group.first];
+      for(size_t c = 0; c < expected.aggregates.size(); ++c) {
+        ASSERT_EQ(expected.aggregate_valid[c][e], actual.aggregate_valid[c][g]) << "column " << c;
+        if(!expected.aggregate_valid[c][e]) continue;
+        EXPECT_NEAR(expected.aggregates[c][e], actual.aggregates[c][g], 1e-9 * std::abs(expected.aggregates[c][e]) + 1e-9)
+            << "column " << c << ", key " << group.first.second;
+      }
+    }
+  }
+
+  static void append(result_type & result, result_type const & part)
+  {
+    result.keys.insert(result.keys.end(), part.keys.begin(), part.keys.end());
+    result.key_valid.insert(result.key_valid.end(), part.key_valid.begin(), part.key_valid.end());
+    result.aggregates.resize(part.aggregates.size());
+    result.aggregate_valid.resize(part.aggregates.size());
+    for(size_t c = 0; c < part.aggregates.size(); ++c) {
+      result.aggregates[c].insert(result.aggregates[c].end(), part.aggregates[c].begin(), part.aggregates[c].end());
+      result.aggregate_valid[c].insert(result.aggregate_valid[c].end(),
+                                       part.aggregate_valid[c].begin(), part.aggregate_valid[c].end());
+    }
+  }
+
+  void check(size_t num_parts)
+  {
+    const bool include_null_keys = (1 == ctxt.flag_groupby_include_nulls);
+    const size_t part_size = (keys.size() + num_parts - 1) / num_parts;
+
+    result_type partials;
+    for(size_t begin = 0; begin < keys.size(); begin += part_size) {
+      const size_t end = std::min(keys.size(), begin + part_size);
+      result_type part = compute_gdf_partial(begin, end);
+
+      std::vector<std::vector<value_type>> part_values;
+      std::vector<std::vector<bool>> part_value_valid;
+      for(size_t a = 0; a < ops.size(); ++a) {
+        part_values.emplace_back(values[a].begin() + begin, values[a].begin() + end);
+        if(!value_valid.empty()) {
+          part_value_valid.emplace_back(value_valid[a].begin() + begin, value_valid[a].begin() + end);
+        }
+      }
+      const std::vector<key_type> part_keys(keys.begin() + begin, keys.begin() + end);
+      const std::vector<bool> part_key_valid = key_valid.empty() ? key_valid
+                                               : std::vector<bool>(key_valid.begin() + begin, key_valid.begin() + end);
+      check_equal(host_group_by_partial(part_keys, part_values, ops, part_key_valid, part_value_valid,
+                                        include_null_keys),
+                  part);
+      append(partials, part);
+    }
+
+    const result_type merged = compute_gdf_merge(partials);
+    check_equal(host_group_by_merge(partials, ops, include_null_keys), merged);
+    check_equal(compute_gdf_group_by(), merged);
+  }
+};
+
+TEST_F(PartialAggregationTest, SinglePart)
+{
+  create_input(10000, 100);
+  check(1);
+}
+
+TEST_F(PartialAggregationTest, ManyParts)
+{
+  create_input(100000, 1000);
+  check(8);
+}
+
+TEST_F(PartialAggregationTest, NullKeysDropped)
+{
+  create_input(100000, 1000);
+  set_nulls(5);
+  check(4);
+}
+
+TEST_F(PartialAggregationTest, NullKeysGrouped)
+{
+  ctxt.flag_groupby_include_nulls = 1;
+  create_input(100000, 1000);
+  set_nulls(5);
+  check(4);
+}
+
+TEST_F(PartialAggregationTest, GroupsWithoutValuesInSomeParts)
+{
+  // Most groups have a few rows, so many have no non-null value in a part
+  create_input(10000, 5000);
+  set_nulls(2);
+  check(4);
+}
+
+TEST_F(PartialAggregationTest, UnsupportedOperation)
+{
+  EXPECT_EQ(0, gdf_group_by_num_partial_columns(GDF_COUNT_DISTINCT));
+  EXPECT_EQ(0, gdf_group_by_num_partial_columns(GDF_MEDIAN));
+
+  ops = {GDF_COUNT_DISTINCT};
+  create_input(100, 10);
+  gdf_col_pointer key_column = create_gdf_column(keys);
+  gdf_col_pointer value_column = create_gdf_column(values[0]);
+  gdf_column * key_columns[] = {key_column.get()};
+  gdf_column * value_columns[] = {value_column.get()};
+  EXPECT_EQ(GDF_UNSUPPORTED_METHOD, gdf_group_by_partial(1, key_columns, 1, value_columns, ops.data(),
+                                                         key_columns, value_columns, &ctxt));
+  EXPECT_EQ(GDF_UNSUPPORTED_METHOD, gdf_group_by_merge(1, key_columns, 1, value_columns, ops.data(),
+                                                       key_columns, value_columns, &ctxt));
+}
+
+TEST_F(PartialAggregationTest, M2NeedsNoValidityMask)
+{
+  // Without nulls, the partial aggregates of VAR are never NULL, although the
+  // VAR the M2 is computed from is NULL for a group of a single value
+  ops = {GDF_VAR};
+  create_input(1000, 500);
+  gdf_col_pointer key_column = create_gdf_column(keys);
+  gdf_col_pointer value_column = create_gdf_column(values[0]);
+  gdf_col_pointer out_key_column = create_gdf_column(keys);
+  gdf_col_pointer count_column = create_gdf_column(std::vector<int64_t>(keys.size()));
+  gdf_col_pointer mean_column = create_gdf_column(std::vector<double>(keys.size()));
+  gdf_col_pointer m2_column = create_gdf_column(std::vector<double>(keys.size()));
+  gdf_column * key_columns[] = {key_column.get()};
+  gdf_column * value_columns[] = {value_column.get()};
+  gdf_column * out_key_columns[] = {out_key_column.get()};
+  gdf_column * partial_columns[] = {count_column.get(), mean_column.get(), m2_column.get()};
+  ASSERT_EQ(GDF_SUCCESS, gdf_group_by_partial(1, key_columns, 1, value_columns, ops.data(),
+                                              out_key_columns, partial_columns, &ctxt));
+  EXPECT_EQ(nullptr, m2_column->valid);
+  EXPECT_EQ(0, m2_column->null_count);
+
+  result_type result;
+  result.keys = to_host<key_type>(*out_key_column);
+  result.key_valid.assign(result.keys.size(), true);
+  const std::vector<int64_t> counts = to_host<int64_t>(*count_column);
+  result.aggregates = {std::vector<double>(counts.begin(), counts.end()),
+                       to_host<double>(*mean_column),
+                       to_host<double>(*m2_column)};
+  result.aggregate_valid.assign(3, std::vector<bool>(result.keys.size(), true));
+  check_equal(host_group_by_partial(keys, values, ops, {}, {}, false), result);
+}
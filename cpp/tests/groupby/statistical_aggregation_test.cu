@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <cudf.h>
+#include <rmm/rmm.h>
+#include <cudf/functions.h>
+
+#include "tests/utilities/cudf_test_utils.cuh"
+#include "tests/utilities/cudf_test_fixtures.h"
+
+// Checks VAR, STD, FIRST and LAST of the hash groupby and MEDIAN and the
+// quantiles of the sort groupby against std::map references
+struct StatisticalAggregationTest : public GdfTest
+{
+  using key_type = int32_t;
+  using value_type = double;
+
+  std::vector<key_type> keys;
+  std::vector<value_type> values;
+  std::vector<bool> value_valid; // Empty unless set by set_nulls
+
+  StatisticalAggregationTest()
+  {
+    std::srand(0);
+  }
+
+  void create_input(size_t num_rows, int max_key, double offset = 0)
+  {
+    keys.resize(num_rows);
+    values.resize(num_rows);
+    for(size_t i = 0; i < num_rows; ++i) {
+      keys[i] = std::rand() % max_key;
+      values[i] = offset + (std::rand() % 2000 - 1000) / 8.0;
+    }
+  }
+
+  void set_nulls(int null_period)
+  {
+    value_valid.resize(values.size());
+    for(size_t i = 0; i < values.size(); ++i) value_valid[i] = (0 != std::rand() % null_period);
+  }
+
+  bool is_valid(size_t row) const
+  {
+    return value_valid.empty() || value_valid[row];
+  }
+
+  // The non-null values of every group, in row order
+  std::map<key_type, std::vector<value_type>> groups() const
+  {
+    std::map<key_type, std::vector<value_type>> groups;
+    for(size_t i = 0; i < keys.size(); ++i) {
+      auto & group = groups[keys[i]];
+      if(is_valid(i)) group.push_back(values[i]);
+    }
+    return groups;
+  }
+
+  static std::vector<gdf_valid_type> to_masks(std::vector<bool> const & valid)
+  {
+    std::vector<gdf_valid_type> masks;
+    if(valid.empty()) return masks;
+    masks.assign(gdf_get_num_chars_bitmask(valid.size()), 0);
+    for(size_t i = 0; i < valid.size(); ++i) {
+      if(valid[i]) gdf::util::turn_bit_on(masks.data(), i);
+    }
+    return masks;
+  }
+
+  template <typename col_type>
+  static std::vector<col_type> to_host(gdf_column const & column)
+  {
+    std::vector<col_type> host_vector(column.size);
+    if(column.size > 0) {
+      EXPECT_EQ(cudaSuccess, cudaMemcpy(host_vector.data(), column.data, column.size * sizeof(col_type),
+                                        cudaMemcpyDeviceToHost));
+    }
+    return host_vector;
+  }
+
+  static std::vector<bool> valid_to_host(gdf_column const & column)
+  {
+    std::vector<bool> valid(column.size, true);
+    if((nullptr == column.valid) || (0 == column.size)) return valid;
+    std::vector<gdf_valid_type> masks(gdf_get_num_chars_bitmask(column.size));
+    EXPECT_EQ(cudaSuccess, cudaMemcpy(masks.data(), column.valid, masks.size(), cudaMemcpyDeviceToHost));
+    for(size_t i = 0; i < valid.size(); ++i) valid[i] = gdf_is_valid(masks.data(), i);
+    return valid;
+  }
+
+  // Calls gdf_group_by with the given operations on the values, and returns
+  // the result of every operation by key, without the NULL results
+  std::vector<std::map<key_type, value_type>> compute_gdf_result(std::vector<gdf_agg_op> ops,
+                                                                  gdf_method method)
+  {
+    gdf_context ctxt{0, method, 0, 1};
+    // The results of VAR and STD, and of any operation on a column with nulls,
+    // can be NULL, which requires a validity mask
+    const bool may_be_null = !value_valid.empty()
+                             || std::any_of(ops.begin(), ops.end(),
+                                            [](gdf_agg_op op) { return (GDF_VAR == op) || (GDF_STD == op); });
+    const std::vector<bool> all_valid(may_be_null ? keys.size() : 0, true);
+
+    gdf_col_pointer key_column = create_gdf_column(keys);
+    gdf_col_pointer out_key_column = create_gdf_column(keys);
+    std::vector<gdf_col_pointer> value_columns, out_value_columns;
+    std::vector<gdf_column*> raw_value_columns, raw_out_value_columns;
+    for(size_t a = 0; a < ops.size(); ++a) {
+      value_columns.push_back(create_gdf_column(values, to_masks(value_valid)));
+      out_value_columns.push_back(create_gdf_column(values, to_masks(all_valid)));
+      raw_value_columns.push_back(value_columns.back().get());
+      raw_out_value_columns.push_back(out_value_columns.back().get());
+    }
+
+    gdf_column * key_columns[] = {key_column.get()};
+    gdf_column * out_key_columns[] = {out_key_column.get()};
+    EXPECT_EQ(GDF_SUCCESS, gdf_group_by(1, key_columns, static_cast<int>(ops.size()), raw_value_columns.data(),
+                                        ops.data(), out_key_columns, raw_out_value_columns.data(), &ctxt));
+
+    const std::vector<key_type> result_keys = to_host<key_type>(*out_key_column);
+    std::vector<std::map<key_type, value_type>> results(ops.size());
+    for(size_t a = 0; a < ops.size(); ++a) {
+      EXPECT_EQ(out_key_column->size, out_value_columns[a]->size);
+      const std::vector<value_type> result = to_host<value_type>(*out_value_columns[a]);
+      const std::vector<bool> valid = valid_to_host(*out_value_columns[a]);
+      for(size_t i = 0; i < result.size(); ++i) {
+        if(valid[i]) results[a][result_keys[i]] = result[i];
+      }
+    }
+    return results;
+  }
+
+  // Calls gdf_group_by_quantile, whose groups are sorted by key
+  std::map<key_type, value_type> compute_gdf_quantile(double q, gdf_quantile_method method)
+  {
+    gdf_context ctxt{0, GDF_SORT, 0, 1};
+    gdf_col_pointer key_column = create_gdf_column(keys);
+    gdf_col_pointer out_key_column = create_gdf_column(keys);
+    gdf_col_pointer value_column = create_gdf_column(values);
+    gdf_col_pointer out_value_column = create_gdf_column(values);
+
+    gdf_column * key_columns[] = {key_column.get()};
+    gdf_column * out_key_columns[] = {out_key_column.get()};
+    EXPECT_EQ(GDF_SUCCESS, gdf_group_by_quantile(1, key_columns, value_column.get(), nullptr, out_key_columns,
+                                                 out_value_column.get(), q, method, &ctxt));
+
+    const std::vector<key_type> result_keys = to_host<key_type>(*out_key_column);
+    const std::vector<value_type> result = to_host<value_type>(*out_value_column);
+    EXPECT_EQ(out_key_column->size, out_value_column->size);
+    EXPECT_TRUE(std::is_sorted(result_keys.begin(), result_keys.end()));
+
+    std::map<key_type, value_type> results;
+    for(size_t i = 0; i < result.size(); ++i) results[result_keys[i]] = result[i];
+    return results;
+  }
+
+  static value_type variance(std::vector<value_type> const & group)
+  {
+    double mean{0};
+    for(auto v : group) mean += v;
+    mean /= group.size();
+    double m2{0};
+    for(auto v : group) m2 += (v - mean) * (v - mean);
+    return m2 / (group.size() - 1);
+  }
+
+  static value_type quantile(std::vector<value_type> group, double q, gdf_quantile_method method)
+  {
+    std::sort(group.begin(), group.end());
+    const double pos = q * (group.size() - 1);
+    const size_t lo = static_cast<size_t>(pos);
+    const double fraction = pos - lo;
+    const value_type y0 = group[lo];
+    const value_type y1 = group[(fraction > 0) ? lo + 1 : lo];
+    switch(method) {
+      case GDF_QUANT_LOWER:    return y0;
+      case GDF_QUANT_HIGHER:   return y1;
+      case GDF_QUANT_MIDPOINT: return (y0 + y1) / 2;
+      case GDF_QUANT_NEAREST:  return (fraction < 0.5) ? y0 : y1;
+      default:                 return y0 + fraction * (y1 - y0);
+    }
+  }
+
+  void check_variance(double tolerance)
+  {
+    const auto results = compute_gdf_result({GDF_VAR, GDF_STD}, GDF_HASH);
+    size_t num_valid{0};
+    for(auto const & group : groups()) {
+      if(group.second.size() < 2) {
+        EXPECT_EQ(0u, results[0].count(group.first)) << "key " << group.first;
+        continue;
+      }
+      ++num_valid;
+      const value_type expected = variance(group.second);
+      EXPECT_NEAR(expected, results[0].at(group.first), tolerance * expected) << "key " << group.first;
+      EXPECT_NEAR(std::sqrt(expected), results[1].at(group.first), tolerance * std::sqrt(expected))
+          << "key " << group.first;
+    }
+    EXPECT_EQ(num_valid, results[0].size());
+  }
+
+  void check_first_last()
+  {
+    const auto results = compute_gdf_result({GDF_FIRST, GDF_LAST}, GDF_HASH);
+    size_t num_valid{0};
+    for(auto const & group : groups()) {
+      if(group.second.empty()) continue;
+      ++num_valid;
+      EXPECT_EQ(group.second.front(), results[0].at(group.first)) << "key " << group.first;
+      EXPECT_EQ(group.second.back(), results[1].at(group.first)) << "key " << group.first;
+    }
+    EXPECT_EQ(num_valid, results[0].size());
+    EXPECT_EQ(num_valid, results[1].size());
+  }
+
+  void check_quantile(double q, gdf_quantile_method method)
+  {
+    const auto results = compute_gdf_quantile(q, method);
+    const auto expected = groups();
+    ASSERT_EQ(expected.size(), results.size());
+    for(auto const & group : expected) {
+      EXPECT_DOUBLE_EQ(quantile(group.second, q, method), results.at(group.first))
+          << "key " << group.first << ", q " << q << ", method " << method;
+    }
+  }
+};
+
+TEST_F(StatisticalAggregationTest, Variance)
+{
+  create_input(100000, 100);
+  check_variance(1e-9);
+}
+
+TEST_F(StatisticalAggregationTest, VarianceOfValuesFarFromZero)
+{
+  // The values are shifted by a value of their group, so the large offset
+  // does not cancel out their variance
+  create_input(100000, 100, 1e9);
+  check_variance(1e-6);
+}
+
+TEST_F(StatisticalAggregationTest, VarianceWithNulls)
+{
+  // Most groups have a few rows, so some have fewer than 2 non-null values
+  create_input(10000, 5000);
+  set_nulls(3);
+  check_variance(1e-9);
+}
+
+TEST_F(StatisticalAggregationTest, FirstAndLast)
+{
+  create_input(100000, 1000);
+  check_first_last();
+}
+
+TEST_F(StatisticalAggregationTest, FirstAndLastWithNulls)
+{
+  create_input(10000, 5000);
+  set_nulls(3);
+  check_first_last();
+}
+
+TEST_F(StatisticalAggregationTest, Median)
+{
+  create_input(10000, 100);
+  const auto results = compute_gdf_result({GDF_MEDIAN}, GDF_SORT);
+  for(auto const & group : groups()) {
+    EXPECT_EQ(quantile(group.second, 0.5, GDF_QUANT_LINEAR), results[0].at(group.first)) << "key " << group.first;
+  }
+}
+
+TEST_F(StatisticalAggregationTest, Quantiles)
+{
+  create_input(10000, 100);
+  for(double q : {0.0, 0.1, 0.25, 0.9, 1.0}) {
+    for(auto method : {GDF_QUANT_LINEAR, GDF_QUANT_LOWER, GDF_QUANT_HIGHER, GDF_QUANT_MIDPOINT, GDF_QUANT_NEAREST}) {
+      check_quantile(q, method);
+    }
+  }
+}
+
+TEST_F(StatisticalAggregationTest, UnsupportedMethods)
+{
+  create_input(100, 10);
+  gdf_col_pointer key_column = create_gdf_column(keys);
+  gdf_col_pointer value_column = create_gdf_column(values);
+  gdf_col_pointer out_key_column = create_gdf_column(keys);
+  gdf_col_pointer out_value_column = create_gdf_column(values);
+  gdf_column * key_columns[] = {key_column.get()};
+  gdf_column * value_columns[] = {value_column.get()};
+  gdf_column * out_key_columns[] = {out_key_column.get()};
+  gdf_column * out_value_columns[] = {out_value_column.get()};
+
+  gdf_context hash_ctxt{0, GDF_HASH, 0, 1};
+  gdf_context sort_ctxt{0, GDF_SORT, 0, 1};
+  gdf_agg_op median{GDF_MEDIAN};
+  gdf_agg_op var{GDF_VAR};
+  EXPECT_EQ(GDF_UNSUPPORTED_METHOD, gdf_group_by(1, key_columns, 1, value_columns, &median,
+                                                 out_key_columns, out_value_columns, &hash_ctxt));
+  EXPECT_EQ(GDF_UNSUPPORTED_METHOD, gdf_group_by(1, key_columns, 1, value_columns, &var,
+                                                 out_key_columns, out_value_columns, &sort_ctxt));
+  EXPECT_EQ(GDF_INVALID_API_CALL, gdf_group_by_quantile(1, key_columns, value_column.get(), nullptr,
+                                                        out_key_columns, out_value_column.get(), 1.5,
+                                                        GDF_QUANT_LINEAR, &sort_ctxt));
+}
+
+TEST_F(StatisticalAggregationTest, NullableResultsRequireAValidityMask)
+{
+  create_input(100, 10);
+  set_nulls(3);
+  gdf_col_pointer key_column = create_gdf_column(keys);
+  gdf_col_pointer value_column = create_gdf_column(values);
+  gdf_col_pointer nullable_value_column = create_gdf_column(values, to_masks(value_valid));
+  gdf_col_pointer out_key_column = create_gdf_column(keys);
+  gdf_col_pointer out_value_column = create_gdf_column(values);
+  gdf_column * key_columns[] = {key_column.get()};
+  gdf_column * value_columns[] = {value_column.get()};
+  gdf_column * nullable_value_columns[] = {nullable_value_column.get()};
+  gdf_column * out_key_columns[] = {out_key_column.get()};
+  gdf_column * out_value_columns[] = {out_value_column.get()};
+
+  gdf_context ctxt{0, GDF_HASH, 0, 1};
+  for(gdf_agg_op op : {GDF_VAR, GDF_STD}) {
+    EXPECT_EQ(GDF_VALIDITY_MISSING, gdf_group_by(1, key_columns, 1, value_columns, &op,
+                                                 out_key_columns, out_value_columns, &ctxt));
+  }
+  for(gdf_agg_op op : {GDF_SUM, GDF_MIN, GDF_AVG, GDF_FIRST}) {
+    EXPECT_EQ(GDF_SUCCESS, gdf_group_by(1, key_columns, 1, value_columns, &op,
+                                        out_key_columns, out_value_columns, &ctxt));
+    EXPECT_EQ(GDF_VALIDITY_MISSING, gdf_group_by(1, key_columns, 1, nullable_value_columns, &op,
+                                                 out_key_columns, out_value_columns, &ctxt));
+  }
+  // COUNT is never NULL
+  gdf_agg_op count{GDF_COUNT};
+  EXPECT_EQ(GDF_SUCCESS, gdf_group_by(1, key_columns, 1, nullable_value_columns, &count,
+                                      out_key_columns, out_value_columns, &ctxt));
+}
@@ -124,6 +124,7 @@ TestParameters<
 };
 
 const static gdf_method HASH = gdf_method::GDF_HASH;
+const static gdf_method SORT = gdf_method::GDF_SORT;
 typedef ::testing::Types<
     TestParameters< agg_op::AVG, HASH, VTuple<int32_t >, int32_t>,
     TestParameters< agg_op::AVG, HASH, VTuple<int64_t >, float>,
@@ -150,7 +151,14 @@ typedef ::testing::Types<
     TestParameters< agg_op::SUM, HASH, VTuple<uint32_t, int32_t , uint64_t>, int32_t >,
     TestParameters< agg_op::SUM, HASH, VTuple<uint64_t, uint32_t, double  >, uint64_t>,
     TestParameters< agg_op::AVG, HASH, VTuple<uint32_t, int32_t , int64_t >, int32_t >,
-    TestParameters< agg_op::AVG, HASH, VTuple<uint64_t, uint32_t, int32_t >, uint64_t>
+    TestParameters< agg_op::AVG, HASH, VTuple<uint64_t, uint32_t, int32_t >, uint64_t>,
+    // Keys of at most 64 bits are radix sorted as packed keys, wider keys are
+    // compared column by column
+    TestParameters< agg_op::SUM, SORT, VTuple<int32_t , int32_t >, int64_t >,
+    TestParameters< agg_op::MIN, SORT, VTuple<int8_t  , float   , int16_t >, double  >,
+    TestParameters< agg_op::CNT, SORT, VTuple<double  >, int32_t >,
+    TestParameters< agg_op::AVG, SORT, VTuple<int16_t , int32_t >, double  >,
+    TestParameters< agg_op::MAX, SORT, VTuple<int64_t , int32_t >, int32_t >
   > Implementations;
 
 typedef ::testing::Types<
@@ -0,0 +1,432 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <hash/host_concurrent_unordered_map.cuh>
+#include <hash/hash_table_growth.h>
+#include <groupby/aggregation_operations.cuh>
+#include <utilities/host_parallel.h>
+
+// This is necessary to do a parametrized typed-test over multiple template arguments
+template <typename Key, typename Value, template <typename> typename Aggregation_Operator>
+struct KeyValueTypes
+{
+  using key_type = Key;
+  using value_type = Value;
+  using op_type = Aggregation_Operator<value_type>;
+};
+
+// The host map does not need a GPU, so there is no need for the GdfTest fixture
+template <class T>
+class HostMapTest : public ::testing::Test
+{
+public:
+  using key_type = typename T::key_type;
+  using value_type = typename T::value_type;
+  using op_type = typename T::op_type;
+  using map_type = host_concurrent_unordered_map<key_type, value_type,
+                                                 std::numeric_limits<key_type>::max()>;
+  using pair_type = typename map_type::value_type;
+
+  map_type the_map;
+  std::vector<pair_type> pairs;
+  std::unordered_map<key_type, value_type> reference_map;
+
+  HostMapTest(const size_t hash_table_size = 10000)
+    : the_map(hash_table_size, op_type::IDENTITY)
+  {
+  }
+
+  void create_input(const int num_pairs, const key_type max_key, const value_type max_value)
+  {
+    std::default_random_engine generator;
+    std::uniform_int_distribution<int> key_distribution(0, max_key);
+    std::uniform_int_distribution<int> value_distribution(0, max_value);
+    op_type op;
+
+    pairs.clear();
+    for (int i = 0; i < num_pairs; ++i)
+    {
+      const key_type key = static_cast<key_type>(key_distribution(generator));
+      const value_type value = static_cast<value_type>(value_distribution(generator));
+      pairs.push_back(pair_type(key, value));
+
+      auto found = reference_map.find(key);
+      if (found == reference_map.end())
+        reference_map[key] = op(value, op_type::IDENTITY);
+      else
+        found->second = op(value, found->second);
+    }
+  }
+
+  void insert_all(unsigned int num_threads = 0)
+  {
+    cudf::detail::host_parallel_for(pairs.size(), [this](size_t i) {
+      auto it = the_map.insert(pairs[i], op_type());
+      EXPECT_NE(the_map.end(), it);
+    }, num_threads);
+  }
+
+  // Inserts all pairs with the same overflow protocol as the groupby: rows that
+  // do not fit are collected, then the map grows and only those rows are retried.
+  // Returns the number of times the map grew.
+  int insert_all_with_growth(map_type & map,
+                             hash_table_growth_policy const & policy,
+                             unsigned int num_threads)
+  {
+    std::vector<size_t> rows(pairs.size());
+    for (size_t i = 0; i < rows.size(); ++i) rows[i] = i;
+
+    int num_grows = 0;
+    while (!rows.empty())
+    {
+      std::vector<size_t> overflow_rows(rows.size());
+      std::atomic<size_t> overflow_count{0};
+      cudf::detail::host_parallel_for(rows.size(), [&](size_t i) {
+        if (map.end() == map.insert(pairs[rows[i]], op_type()))
+          overflow_rows[overflow_count++] = rows[i];
+      }, num_threads);
+      overflow_rows.resize(overflow_count);
+
+      if (overflow_rows.empty()) break;
+
+      const size_t new_size = policy.next_size(map.size(), map.get_occupancy(), overflow_rows.size());
+      EXPECT_GT(new_size, map.size());
+      map.rehash(new_size, typename map_type::hasher(), num_threads);
+      map.set_max_occupancy(policy.max_occupancy(new_size));
+      ++num_grows;
+
+      rows.swap(overflow_rows);
+    }
+    return num_grows;
+  }
+
+  void check_against_reference()
+  {
+    check_against_reference(the_map);
+  }
+
+  void check_against_reference(map_type const & map)
+  {
+    size_t num_keys = 0;
+    for (auto it = map.begin(); it != map.end(); ++it)
+    {
+      const key_type key = it->first;
+      if (key == map.get_unused_key()) continue;
+      ++num_keys;
+      auto expected = reference_map.find(key);
+      ASSERT_NE(reference_map.end(), expected) << "unexpected key " << key;
+      EXPECT_EQ(expected->second, static_cast<value_type>(it->second));
+    }
+    EXPECT_EQ(reference_map.size(), num_keys);
+    EXPECT_EQ(reference_map.size(), map.get_occupancy());
+
+    for (auto const& expected : reference_map)
+    {
+      auto found = map.find(expected.first);
+      ASSERT_NE(map.end(), found);
+      EXPECT_EQ(expected.second, static_cast<value_type>(found->second));
+    }
+  }
+};
+
+// Google Test can only do a parameterized typed-test over a single type, so we have
+// to nest multiple types inside of the KeyValueTypes struct above
+typedef ::testing::Types< KeyValueTypes<int32_t, int32_t, max_op>,
+                          KeyValueTypes<int64_t, int64_t, max_op>,
+                          KeyValueTypes<int32_t, float, min_op>,
+                          KeyValueTypes<int64_t, double, min_op>,
+                          KeyValueTypes<int32_t, int64_t, sum_op>,
+                          KeyValueTypes<int64_t, double, sum_op>,
+                          KeyValueTypes<int32_t, int32_t, count_op>,
+                          KeyValueTypes<int64_t, float, count_op>
+                          > Implementations;
+
+TYPED_TEST_CASE(HostMapTest, Implementations);
+
+TYPED_TEST(HostMapTest, InitialState)
+{
+  using key_type = typename TypeParam::key_type;
+  using value_type = typename TypeParam::value_type;
+  using op_type = typename TypeParam::op_type;
+
+  for (auto it = this->the_map.begin(); it != this->the_map.end(); ++it)
+  {
+    EXPECT_EQ(std::numeric_limits<key_type>::max(), static_cast<key_type>(it->first));
+    EXPECT_EQ(static_cast<value_type>(op_type::IDENTITY), static_cast<value_type>(it->second));
+  }
+  EXPECT_EQ(this->the_map.end(), this->the_map.find(0));
+}
+
+TYPED_TEST(HostMapTest, SingleThreadedInsert)
+{
+  this->create_input(5000, 1000, 100);
+  this->insert_all(1);
+  this->check_against_reference();
+}
+
+TYPED_TEST(HostMapTest, ConcurrentInsertFewKeys)
+{
+  // High contention on few keys exercises the CAS loops
+  this->create_input(10000, 10, 100);
+  this->insert_all(8);
+  this->check_against_reference();
+}
+
+TYPED_TEST(HostMapTest, ConcurrentInsertManyKeys)
+{
+  this->create_input(8000, 5000, 100);
+  this->insert_all(8);
+  this->check_against_reference();
+}
+
+TYPED_TEST(HostMapTest, GrowFromCardinalityHint)
+{
+  using map_type = typename TestFixture::map_type;
+  using op_type = typename TypeParam::op_type;
+
+  // 2000 distinct keys, but the table is sized for a hint of 100
+  this->create_input(20000, 1999, 100);
+  hash_table_growth_policy policy;
+  policy.min_size = 16;
+  const size_t initial_size = policy.initial_size(this->pairs.size(), 100);
+  EXPECT_EQ(200u, initial_size);
+
+  map_type map(initial_size, op_type::IDENTITY);
+  map.set_max_occupancy(policy.max_occupancy(initial_size));
+
+  const int num_grows = this->insert_all_with_growth(map, policy, 8);
+  EXPECT_GT(num_grows, 0);
+  EXPECT_LE(map.get_occupancy(), policy.max_occupancy(map.size()));
+  this->check_against_reference(map);
+}
+
+TYPED_TEST(HostMapTest, AccurateHintDoesNotGrow)
+{
+  using map_type = typename TestFixture::map_type;
+  using op_type = typename TypeParam::op_type;
+
+  this->create_input(20000, 499, 100);
+  hash_table_growth_policy policy;
+  const size_t initial_size = policy.initial_size(this->pairs.size(), 500);
+
+  map_type map(initial_size, op_type::IDENTITY);
+  map.set_max_occupancy(policy.max_occupancy(initial_size));
+
+  EXPECT_EQ(0, this->insert_all_with_growth(map, policy, 8));
+  this->check_against_reference(map);
+}
+
+TEST(HashTableGrowthPolicyTest, Sizes)
+{
+  hash_table_growth_policy policy;
+  policy.min_size = 16;
+
+  // No hint: sized for every row to be distinct
+  EXPECT_EQ(2000u, policy.initial_size(1000));
+  EXPECT_EQ(2000u, policy.initial_size(1000, 5000));
+  EXPECT_EQ(200u, policy.initial_size(1000, 100));
+  EXPECT_EQ(16u, policy.initial_size(3));
+  EXPECT_EQ(100u, policy.max_occupancy(200));
+
+  // Doubles, unless fewer buckets are enough for every pending row
+  EXPECT_EQ(400u, policy.next_size(200, 100, 1000));
+  EXPECT_EQ(210u, policy.next_size(200, 100, 5));
+  EXPECT_EQ(201u, policy.next_size(200, 100, 0));
+
+  policy.max_occupancy_percent = 80;
+  EXPECT_EQ(1250u, policy.initial_size(1000));
+  EXPECT_EQ(800u, policy.max_occupancy(1000));
+}
+
+TEST(HostMapFullTest, InsertIntoFullMapFails)
+{
+  host_concurrent_unordered_map<int, int, std::numeric_limits<int>::max()> the_map(4, 0);
+  for (int k = 0; k < 4; ++k)
+    EXPECT_NE(the_map.end(), the_map.insert(std::make_pair(k, 1), sum_op<int>()));
+  // Existing keys can still be aggregated, new keys are rejected
+  EXPECT_NE(the_map.end(), the_map.insert(std::make_pair(2, 1), sum_op<int>()));
+  EXPECT_EQ(the_map.end(), the_map.insert(std::make_pair(42, 1), sum_op<int>()));
+  EXPECT_EQ(2, static_cast<int>(the_map.find(2)->second));
+  EXPECT_EQ(the_map.end(), the_map.find(42));
+}
+
+TEST(HostMapFullTest, MaxOccupancy)
+{
+  host_concurrent_unordered_map<int, int, std::numeric_limits<int>::max()> the_map(100, 0);
+  the_map.set_max_occupancy(2);
+  EXPECT_NE(the_map.end(), the_map.insert(std::make_pair(1, 1), sum_op<int>()));
+  EXPECT_NE(the_map.end(), the_map.insert(std::make_pair(2, 1), sum_op<int>()));
+  EXPECT_EQ(the_map.end(), the_map.insert(std::make_pair(3, 1), sum_op<int>()));
+  EXPECT_NE(the_map.end(), the_map.insert(std::make_pair(1, 1), sum_op<int>()));
+  EXPECT_EQ(2u, the_map.get_occupancy());
+
+  // Growing keeps the entries and lifts the limit
+  the_map.rehash(200);
+  EXPECT_EQ(200u, the_map.size());
+  EXPECT_EQ(2u, the_map.get_occupancy());
+  EXPECT_EQ(2, static_cast<int>(the_map.find(1)->second));
+  EXPECT_NE(the_map.end(), the_map.insert(std::make_pair(3, 1), sum_op<int>()));
+  EXPECT_EQ(1, static_cast<int>(the_map.find(3)->second));
+}
+
+template <typename Probing>
+class HostMapProbingTest : public ::testing::Test {};
+
+typedef ::testing::Types< linear_probing,
+                          bucketed_probing<4>,
+                          bucketed_probing<8>
+                          > ProbingSchemes;
+
+TYPED_TEST_CASE(HostMapProbingTest, ProbingSchemes);
+
+TYPED_TEST(HostMapProbingTest, HighOccupancy)
+{
+  using map_type = host_concurrent_unordered_map<int, int, std::numeric_limits<int>::max(),
+                                                 default_hash<int>, std::equal_to<int>,
+                                                 false, TypeParam>;
+
+  // 9000 distinct keys in 10000 slots, each inserted 3 times
+  constexpr int num_keys{9000};
+  map_type the_map(10000, 0);
+  EXPECT_EQ(0u, the_map.size() % TypeParam::bucket_size);
+
+  cudf::detail::host_parallel_for(3 * num_keys, [&](size_t i) {
+    EXPECT_NE(the_map.end(), the_map.insert(std::make_pair(static_cast<int>(i % num_keys), 1),
+                                            sum_op<int>()));
+  }, 8);
+
+  EXPECT_EQ(static_cast<size_t>(num_keys), the_map.get_occupancy());
+  for (int k = 0; k < num_keys; ++k) {
+    auto found = the_map.find(k);
+    ASSERT_NE(the_map.end(), found);
+    EXPECT_EQ(3, static_cast<int>(found->second));
+    EXPECT_GE(the_map.probe_length(k), 1u);
+  }
+  EXPECT_EQ(the_map.end(), the_map.find(num_keys));
+
+  // Growing keeps the layout
+  the_map.rehash(20001);
+  EXPECT_EQ(0u, the_map.size() % TypeParam::bucket_size);
+  EXPECT_EQ(static_cast<size_t>(num_keys), the_map.get_occupancy());
+  EXPECT_EQ(3, static_cast<int>(the_map.find(42)->second));
+}
+
+TEST(HostMapProbingTest, BucketsShortenProbes)
+{
+  // Mean probe length of keys that are present, at 90% occupancy
+  auto mean_probe_length = [](auto& the_map, int num_keys) {
+    for (int k = 0; k < num_keys; ++k)
+      the_map.insert(std::make_pair(k, 1), sum_op<int>());
+    size_t total = 0;
+    for (int k = 0; k < num_keys; ++k)
+      total += the_map.probe_length(k);
+    return static_cast<double>(total) / num_keys;
+  };
+
+  host_concurrent_unordered_map<int, int, std::numeric_limits<int>::max(),
+                                MurmurHash3_32<int>, std::equal_to<int>,
+                                false, linear_probing> linear_map(10000, 0);
+  host_concurrent_unordered_map<int, int, std::numeric_limits<int>::max(),
+                                MurmurHash3_32<int>, std::equal_to<int>,
+                                false, bucketed_probing<8>> bucketed_map(10000, 0);
+
+  const double linear_length = mean_probe_length(linear_map, 9000);
+  const double bucketed_length = mean_probe_length(bucketed_map, 9000);
+  EXPECT_LT(bucketed_length, 2.0);
+  EXPECT_LT(bucketed_length, linear_length);
+}
+
+// Maps the keys 2k and 2k+1 to the same hash value
+struct half_hash
+{
+  using result_type = uint32_t;
+  result_type operator()(int key) const { return static_cast<result_type>(key / 2); }
+};
+
+TEST(HostMapStatsTest, EmptyMap)
+{
+  host_concurrent_unordered_map<int, int, std::numeric_limits<int>::max()> the_map(100, 0);
+  gdf_hash_table_stats stats;
+  the_map.get_stats(&stats);
+  EXPECT_EQ(100u, stats.table_size);
+  EXPECT_EQ(0u, stats.num_entries);
+  EXPECT_EQ(0.0, stats.load_factor);
+  EXPECT_EQ(0.0, stats.mean_probe_length);
+  EXPECT_EQ(0u, stats.max_probe_length);
+  EXPECT_EQ(0u, stats.num_hash_collisions);
+}
+
+TEST(HostMapStatsTest, CollidingKeys)
+{
+  host_concurrent_unordered_map<int, int, std::numeric_limits<int>::max(),
+                                half_hash, std::equal_to<int>> the_map(8, 0);
+
+  // Keys 0 and 1 hash to slot 0, keys 2 and 3 to slot 1. Inserted in order,
+  // they land in slots 0-3 with probe lengths 1, 2, 2 and 3.
+  for (int k = 0; k < 4; ++k)
+    the_map.insert(std::make_pair(k, 1), sum_op<int>());
+  // Aggregating into existing keys adds no entries
+  the_map.insert(std::make_pair(3, 1), sum_op<int>());
+
+  gdf_hash_table_stats stats;
+  the_map.get_stats(&stats);
+  EXPECT_EQ(8u, stats.table_size);
+  EXPECT_EQ(4u, stats.num_entries);
+  EXPECT_DOUBLE_EQ(0.5, stats.load_factor);
+  EXPECT_DOUBLE_EQ(2.0, stats.mean_probe_length);
+  EXPECT_EQ(3u, stats.max_probe_length);
+  EXPECT_EQ(2u, stats.num_hash_collisions);
+  for (int k = 0; k < 4; ++k)
+    EXPECT_EQ(static_cast<size_t>(1 + k / 2 + k % 2), the_map.probe_length(k));
+}
+
+TEST(HostMapStatsTest, BucketsCountBucketReads)
+{
+  host_concurrent_unordered_map<int, int, std::numeric_limits<int>::max(),
+                                half_hash, std::equal_to<int>,
+                                false, bucketed_probing<4>> the_map(8, 0);
+
+  // Keys 0-5 hash to bucket 0, 0, 1, 1, 0, 0: the first bucket holds keys
+  // 0, 1, 4 and 5, and keys 2 and 3 stay in their own bucket
+  for (int k = 0; k < 6; ++k)
+    the_map.insert(std::make_pair(k, 1), sum_op<int>());
+
+  gdf_hash_table_stats stats;
+  the_map.get_stats(&stats);
+  EXPECT_EQ(6u, stats.num_entries);
+  EXPECT_DOUBLE_EQ(0.75, stats.load_factor);
+  EXPECT_DOUBLE_EQ(1.0, stats.mean_probe_length);
+  EXPECT_EQ(1u, stats.max_probe_length);
+  EXPECT_EQ(3u, stats.num_hash_collisions);
+}
+
+TEST(HostMapStatsTest, CountHashCollisions)
+{
+  std::vector<uint32_t> hash_values{7, 3, 7, 1, 3, 7};
+  EXPECT_EQ(3u, count_hash_collisions(hash_values));
+
+  std::vector<uint32_t> no_hash_values;
+  EXPECT_EQ(0u, count_hash_collisions(no_hash_values));
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <hash/host_concurrent_unordered_multimap.cuh>
+#include <utilities/host_parallel.h>
+
+// This is necessary to do a parametrized typed-test over multiple template arguments
+template <typename Key, typename Value>
+struct KeyValueTypes
+{
+  using key_type = Key;
+  using value_type = Value;
+};
+
+// The host multimap does not need a GPU, so there is no need for the GdfTest fixture
+template <class T>
+class HostMultimapTest : public ::testing::Test
+{
+public:
+  using key_type = typename T::key_type;
+  using value_type = typename T::value_type;
+  using size_type = int;
+  using map_type = host_concurrent_unordered_multimap<key_type,
+                                                      value_type,
+                                                      size_type,
+                                                      std::numeric_limits<key_type>::max(),
+                                                      std::numeric_limits<value_type>::max()>;
+
+  map_type the_map;
+  std::vector<typename map_type::value_type> pairs;
+  std::multimap<key_type, value_type> reference_map;
+
+  HostMultimapTest(const size_type hash_table_size = 10000)
+    : the_map(hash_table_size)
+  {
+  }
+
+  void create_input(const int num_pairs, const int max_key)
+  {
+    std::default_random_engine generator;
+    std::uniform_int_distribution<int> key_distribution(0, max_key);
+    for (int i = 0; i < num_pairs; ++i)
+    {
+      const key_type key = static_cast<key_type>(key_distribution(generator));
+      // the value is the row index, as in the hash join
+      pairs.emplace_back(key, static_cast<value_type>(i));
+      reference_map.emplace(key, static_cast<value_type>(i));
+    }
+  }
+};
+
+typedef ::testing::Types< KeyValueTypes<int32_t, int32_t>,
+                          KeyValueTypes<int64_t, int32_t>,
+                          KeyValueTypes<int32_t, int64_t>,
+                          KeyValueTypes<int64_t, int64_t>
+                          > Implementations;
+
+TYPED_TEST_CASE(HostMultimapTest, Implementations);
+
+TYPED_TEST(HostMultimapTest, InitialState)
+{
+  using key_type = typename TypeParam::key_type;
+  using value_type = typename TypeParam::value_type;
+
+  for (auto it = this->the_map.begin(); it != this->the_map.end(); ++it)
+  {
+    EXPECT_EQ(std::numeric_limits<key_type>::max(), static_cast<key_type>(it->first));
+    EXPECT_EQ(std::numeric_limits<value_type>::max(), static_cast<value_type>(it->second));
+  }
+}
+
+TYPED_TEST(HostMultimapTest, ConcurrentBuildAndProbe)
+{
+  using key_type = typename TypeParam::key_type;
+  using value_type = typename TypeParam::value_type;
+
+  this->create_input(5000, 500);
+
+  // Build
+  cudf::detail::host_parallel_for(this->pairs.size(), [this](size_t i) {
+    EXPECT_NE(this->the_map.end(), this->the_map.insert(this->pairs[i]));
+  }, 8);
+
+  // Probe every possible key, including keys that were never inserted
+  std::atomic<size_t> total_matches{0};
+  cudf::detail::host_parallel_for(600, [&](size_t k) {
+    const key_type key = static_cast<key_type>(k);
+    std::vector<value_type> found;
+    size_t matches = this->the_map.for_each_match(key, [&found](value_type v) {
+      found.push_back(v);
+    });
+    total_matches += matches;
+
+    std::vector<value_type> expected;
+    auto range = this->reference_map.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) expected.push_back(it->second);
+
+    std::sort(found.begin(), found.end());
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(expected, found) << "key " << k;
+
+    if (expected.empty())
+      EXPECT_EQ(this->the_map.end(), this->the_map.find(key));
+    else
+      EXPECT_EQ(key, static_cast<key_type>(this->the_map.find(key)->first));
+  }, 8);
+
+  EXPECT_EQ(this->pairs.size(), total_matches.load());
+}
+
+TYPED_TEST(HostMultimapTest, PrecomputedHash)
+{
+  // All keys share one precomputed hash value, as rows with colliding hashes do
+  for (int i = 0; i < 10; ++i)
+    EXPECT_NE(this->the_map.end(), this->the_map.insert(std::make_pair(i, i), true, 7u));
+  for (int i = 0; i < 10; ++i)
+    EXPECT_EQ(1, this->the_map.for_each_match(i, [](typename TypeParam::value_type) {}, true, 7u));
+}
+
+TEST(HostMultimapFullTest, InsertIntoFullMapFails)
+{
+  host_concurrent_unordered_multimap<int, int, int,
+                                     std::numeric_limits<int>::max(),
+                                     std::numeric_limits<int>::max()> the_map(4);
+  for (int i = 0; i < 4; ++i)
+    EXPECT_NE(the_map.end(), the_map.insert(std::make_pair(1, i)));
+  EXPECT_EQ(the_map.end(), the_map.insert(std::make_pair(1, 4)));
+  EXPECT_EQ(4, the_map.for_each_match(1, [](int) {}));
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <cudf.h>
+#include <rmm/rmm.h>
+#include <cudf/functions.h>
+
+#include <hash/hyperloglog.cuh>
+
+#include "tests/utilities/cudf_test_utils.cuh"
+#include "tests/utilities/cudf_test_fixtures.h"
+
+struct ApproxCountDistinctTest : public GdfTest
+{
+  std::vector<int64_t> keys;
+
+  ApproxCountDistinctTest()
+  {
+    std::srand(0);
+  }
+
+  void create_input(size_t num_rows, int max_key)
+  {
+    keys.resize(num_rows);
+    for(auto & k : keys) k = std::rand() % max_key;
+  }
+
+  // The host sketch of the keys. A single GDF_INT64 column hashes its rows
+  // with MurmurHash3_64 of the keys, so the device sketch is identical.
+  size_t compute_reference_solution(int precision)
+  {
+    hyperloglog_sketch sketch(precision);
+    for(int64_t k : keys) sketch.add(MurmurHash3_64<int64_t>{}(k));
+    return static_cast<size_t>(std::llround(sketch.estimate()));
+  }
+
+  size_t compute_gdf_result(int precision)
+  {
+    gdf_col_pointer key_column = create_gdf_column(keys);
+    gdf_column * columns[] = {key_column.get()};
+    size_t count{0};
+    EXPECT_EQ(GDF_SUCCESS, gdf_approx_count_distinct(1, columns, precision, &count));
+    return count;
+  }
+};
+
+TEST_F(ApproxCountDistinctTest, MatchesHostSketch)
+{
+  create_input(1000000, 100000);
+  EXPECT_EQ(compute_reference_solution(HLL_DEFAULT_PRECISION), compute_gdf_result(0));
+  EXPECT_EQ(compute_reference_solution(10), compute_gdf_result(10));
+}
+
+TEST_F(ApproxCountDistinctTest, FewDistinctKeys)
+{
+  create_input(1000000, 1000);
+  EXPECT_EQ(compute_reference_solution(HLL_DEFAULT_PRECISION), compute_gdf_result(0));
+  EXPECT_NEAR(1000.0, static_cast<double>(compute_gdf_result(0)), 10.0);
+}
+
+TEST_F(ApproxCountDistinctTest, MultipleColumns)
+{
+  // Every (a, b) pair is distinct, but each column only has 1000 values
+  std::vector<int32_t> a(1000000), b(1000000);
+  for(size_t i = 0; i < a.size(); ++i) {
+    a[i] = static_cast<int32_t>(i % 1000);
+    b[i] = static_cast<int32_t>(i / 1000);
+  }
+  gdf_col_pointer a_column = create_gdf_column(a);
+  gdf_col_pointer b_column = create_gdf_column(b);
+  gdf_column * columns[] = {a_column.get(), b_column.get()};
+
+  size_t count{0};
+  ASSERT_EQ(GDF_SUCCESS, gdf_approx_count_distinct(2, columns, 0, &count));
+  EXPECT_NEAR(1000000.0, static_cast<double>(count), 1000000.0 * 0.04);
+}
+
+TEST_F(ApproxCountDistinctTest, NullRowsAreNotCounted)
+{
+  // Only the even rows are valid, and their keys are distinct
+  keys.resize(1000);
+  std::vector<gdf_valid_type> valid(gdf_get_num_chars_bitmask(keys.size()), 0);
+  for(size_t i = 0; i < keys.size(); ++i) {
+    keys[i] = static_cast<int64_t>(i);
+    if(0 == i % 2) gdf::util::turn_bit_on(valid.data(), i);
+  }
+  gdf_col_pointer key_column = create_gdf_column(keys, valid);
+  gdf_column * columns[] = {key_column.get()};
+
+  size_t count{0};
+  ASSERT_EQ(GDF_SUCCESS, gdf_approx_count_distinct(1, columns, 0, &count));
+  EXPECT_NEAR(500.0, static_cast<double>(count), 5.0);
+}
+
+TEST_F(ApproxCountDistinctTest, InvalidArguments)
+{
+  create_input(100, 10);
+  gdf_col_pointer key_column = create_gdf_column(keys);
+  gdf_column * columns[] = {key_column.get()};
+  size_t count{0};
+  EXPECT_EQ(GDF_INVALID_API_CALL, gdf_approx_count_distinct(1, columns, 30, &count));
+  EXPECT_EQ(GDF_DATASET_EMPTY, gdf_approx_count_distinct(0, columns, 0, &count));
+  EXPECT_EQ(GDF_DATASET_EMPTY, gdf_approx_count_distinct(1, columns, 0, nullptr));
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <type_traits>
+
+#include "gtest/gtest.h"
+
+#include <hash/hash_functions.cuh>
+
+// The hash functions are __host__ __device__, so they are checked on the host
+// against the reference implementation (smhasher, as exposed by the Python
+// mmh3 package: mmh3.hash and the first half of mmh3.hash64)
+
+// A key of N raw bytes, to hash strings with the same functors as column elements
+template <size_t N>
+struct bytes_key
+{
+  char data[N];
+};
+
+template <size_t N>
+bytes_key<N - 1> make_key(const char (&str)[N])
+{
+  bytes_key<N - 1> key;
+  std::memcpy(key.data, str, N - 1);
+  return key;
+}
+
+TEST(MurmurHash3_32Test, ReferenceValues)
+{
+  EXPECT_EQ(0xbc5b91e3u, MurmurHash3_32<int32_t>{}(42));
+  EXPECT_EQ(0x6f8f913eu, MurmurHash3_32<int64_t>{}(42));
+  EXPECT_EQ(0xf07a83dbu, MurmurHash3_32<double>{}(1.5));
+  EXPECT_EQ(0xf6a5c420u, MurmurHash3_32<bytes_key<3>>{}(make_key("foo")));
+}
+
+TEST(MurmurHash3_64Test, ReferenceValues)
+{
+  EXPECT_EQ(0x286f48e61c6e34cfull, MurmurHash3_64<int32_t>{}(42));
+  EXPECT_EQ(0xb6acc39989d27df8ull, MurmurHash3_64<int64_t>{}(42));
+  EXPECT_EQ(0xf262c8fe30b0f8b3ull, MurmurHash3_64<double>{}(1.5));
+  EXPECT_EQ(0xe271865701f54561ull, MurmurHash3_64<bytes_key<3>>{}(make_key("foo")));
+
+  // Two full 16 byte blocks and an 11 byte tail
+  EXPECT_EQ(0xe34bbc7bbc071b6cull,
+            MurmurHash3_64<bytes_key<43>>{}(make_key("The quick brown fox jumps over the lazy dog")));
+}
+
+TEST(MurmurHash3_64Test, UnalignedKeys)
+{
+  // Blocks are read byte by byte, so the hash of a key does not depend on its alignment
+  alignas(8) char buffer[64] = {};
+  const auto key = make_key("The quick brown fox jumps over the lazy dog");
+  const uint64_t expected = MurmurHash3_64<bytes_key<43>>{}(key);
+  for (int offset = 1; offset < 8; ++offset) {
+    std::memcpy(buffer + offset, &key, sizeof(key));
+    EXPECT_EQ(expected, MurmurHash3_64<bytes_key<43>>{}(
+                            *reinterpret_cast<bytes_key<43> const*>(buffer + offset)));
+  }
+}
+
+TEST(MurmurHash3_64Test, HashCombine)
+{
+  MurmurHash3_64<int32_t> hasher;
+  const uint64_t a = hasher(1);
+  const uint64_t b = hasher(2);
+  EXPECT_NE(hasher.hash_combine(a, b), hasher.hash_combine(b, a));
+  // The upper 32 bits take part in the combined hash
+  EXPECT_NE(hasher.hash_combine(a, b), hasher.hash_combine(a, b ^ (1ull << 40)));
+}
+
+TEST(HashResultTest, Types)
+{
+  static_assert(std::is_same<hash_result_t<MurmurHash3_32>, uint32_t>::value, "");
+  static_assert(std::is_same<hash_result_t<MurmurHash3_64>, uint64_t>::value, "");
+  static_assert(std::is_same<hash_result_t<IdentityHash>, uint32_t>::value, "");
+}
+
+TEST(SeededHashTest, ReferenceValues)
+{
+  EXPECT_EQ(0x01c0e12du, MurmurHash3_32<int32_t>{42}(42));
+  EXPECT_EQ(0x1f35a00f446c3666ull, MurmurHash3_64<int32_t>{42}(42));
+  EXPECT_EQ(0xf4569d51637053f2ull, MurmurHash3_64<bytes_key<3>>{42}(make_key("foo")));
+
+  // The identity hash has no seed
+  EXPECT_EQ(IdentityHash<int32_t>{}(42), IdentityHash<int32_t>{42}(42));
+}
+
+TEST(SeededHashTest, RepartitionSpreadsRows)
+{
+  // Re-partitioning the rows of one partition with the same seed leaves them
+  // all in a single partition, a different seed spreads them again
+  const uint32_t num_partitions{8};
+  const uint32_t num_sub_partitions{5};
+  MurmurHash3_32<int32_t> first_level{0};
+  MurmurHash3_32<int32_t> same_seed{0};
+  MurmurHash3_32<int32_t> second_level{1};
+
+  std::set<uint32_t> same_seed_partitions;
+  std::set<uint32_t> sub_partitions;
+  for (int32_t key = 0; key < 10000; ++key) {
+    if (0 == first_level(key) % num_partitions) {
+      same_seed_partitions.insert(same_seed(key) % num_partitions);
+      sub_partitions.insert(second_level(key) % num_sub_partitions);
+    }
+  }
+  EXPECT_EQ(1u, same_seed_partitions.size());
+  EXPECT_EQ(num_sub_partitions, sub_partitions.size());
+}
@@ -47,14 +47,15 @@ template <template <typename> class hash_function,
 struct row_partition_mapper
 {
   __device__
-  row_partition_mapper(gdf_table<size_type> const & table_to_hash, const size_type _num_partitions)
-    : the_table{table_to_hash}, num_partitions{_num_partitions}
+  row_partition_mapper(gdf_table<size_type> const & table_to_hash, const size_type _num_partitions,
+                       uint32_t _seed = 0)
+    : the_table{table_to_hash}, num_partitions{_num_partitions}, seed{_seed}
   {}
 
   __device__
-  hash_value_type operator()(size_type row_index) const
+  size_type operator()(size_type row_index) const
   {
-    return the_table.template hash_row<hash_function>(row_index) % num_partitions;
+    return the_table.template hash_row<hash_function>(row_index, 0, seed) % num_partitions;
   }
 
   gdf_table<size_type> const & the_table;
@@ -62,6 +63,8 @@ struct row_partition_mapper
   // Using int_fastdiv can return results different from using the normal modulus
   // operation, therefore we need to use it in result verfication as well
   size_type num_partitions;
+
+  uint32_t seed;
 };
 
 // Put all repeated setup and validation stuff here
@@ -127,7 +130,7 @@ struct HashPartitionTest : public GdfTest
     }
   }
 
-  std::vector<int> compute_gdf_result(const int num_partitions, bool print = false)
+  std::vector<int> compute_gdf_result(const int num_partitions, uint32_t seed = 0, bool print = false)
   {
     const int num_columns = std::tuple_size<multi_column_t>::value;
 
@@ -145,7 +148,8 @@ struct HashPartitionTest : public GdfTest
                                       num_partitions,
                                       gdf_output_columns,
                                       partition_offsets.data(),
-                                      gdf_hash_function);
+                                      gdf_hash_function,
+                                      seed);
 
     EXPECT_EQ(GDF_SUCCESS, result_error);
 
@@ -163,10 +167,10 @@ struct HashPartitionTest : public GdfTest
   } 
 
 
-  void verify_gdf_result(int num_partitions, std::vector<int> partition_offsets, bool print = false)
+  // Computes the partition number of every row of the output with the hash
+  // function of the test
+  std::vector<int> compute_row_partition_numbers(int num_partitions, uint32_t seed, bool print = false)
   {
-
-
     std::vector<gdf_column*> gdf_cols_to_hash;
 
     for(int i = 0; i < num_cols_to_hash; ++i)
@@ -187,7 +191,15 @@ struct HashPartitionTest : public GdfTest
           thrust::tabulate(thrust::device,
                            row_partition_numbers.begin(),
                            row_partition_numbers.end(),
-                           row_partition_mapper<MurmurHash3_32,int>(*table_to_hash,num_partitions));
+                           row_partition_mapper<MurmurHash3_32,int>(*table_to_hash,num_partitions,seed));
+          break;
+        }
+      case GDF_HASH_MURMUR3_64:
+        {
+          thrust::tabulate(thrust::device,
+                           row_partition_numbers.begin(),
+                           row_partition_numbers.end(),
+                           row_partition_mapper<MurmurHash3_64,int>(*table_to_hash,num_partitions,seed));
           break;
         }
       case GDF_HASH_IDENTITY:
@@ -195,7 +207,7 @@ struct HashPartitionTest : public GdfTest
           thrust::tabulate(thrust::device,
                            row_partition_numbers.begin(),
                            row_partition_numbers.end(),
-                           row_partition_mapper<IdentityHash,int>(*table_to_hash,num_partitions));
+                           row_partition_mapper<IdentityHash,int>(*table_to_hash,num_partitions,seed));
 
           break;
         }
@@ -220,6 +232,15 @@ struct HashPartitionTest : public GdfTest
       std::cout << std::endl;
     }
 
+    return host_row_partition_numbers;
+  }
+
+  void verify_gdf_result(int num_partitions, std::vector<int> partition_offsets,
+                         uint32_t seed = 0, bool print = false)
+  {
+    std::vector<int> host_row_partition_numbers = compute_row_partition_numbers(num_partitions, seed, print);
+    const int num_rows = host_row_partition_numbers.size();
+
     // Check that the partition number for every row is correct
     for(int partition_number = 0; partition_number < num_partitions; ++partition_number)
     {
@@ -233,7 +254,7 @@ struct HashPartitionTest : public GdfTest
       // The end of the last partition is the end of the table
       else
       {
-        partition_stop = table_to_hash->get_column_length();
+        partition_stop = num_rows;
       }
 
       // Everything in the current partition should have the same partition
@@ -244,6 +265,63 @@ struct HashPartitionTest : public GdfTest
       }
     }
   }
+
+  gdf_error compute_two_level_gdf_result(const int num_partitions,
+                                         const int num_sub_partitions,
+                                         std::vector<int> & partition_offsets,
+                                         std::vector<int> & sub_partition_offsets,
+                                         uint32_t seed, uint32_t sub_seed)
+  {
+    const int num_columns = std::tuple_size<multi_column_t>::value;
+
+    partition_offsets.assign(num_partitions, 0);
+    sub_partition_offsets.assign(num_partitions * num_sub_partitions, 0);
+
+    return gdf_hash_partition_two_level(num_columns, 
+                                        raw_gdf_input_columns.data(),
+                                        this->cols_to_hash.data(),
+                                        this->num_cols_to_hash,
+                                        num_partitions,
+                                        num_sub_partitions,
+                                        raw_gdf_output_columns.data(),
+                                        partition_offsets.data(),
+                                        sub_partition_offsets.data(),
+                                        gdf_hash_function,
+                                        seed,
+                                        sub_seed);
+  }
+
+  void verify_two_level_gdf_result(int num_partitions, int num_sub_partitions,
+                                   std::vector<int> const & partition_offsets,
+                                   std::vector<int> const & sub_partition_offsets,
+                                   uint32_t seed, uint32_t sub_seed)
+  {
+    // The first level must match a single level partitioning with the same seed
+    verify_gdf_result(num_partitions, partition_offsets, seed);
+
+    for(int partition_number = 0; partition_number < num_partitions; ++partition_number)
+    {
+      EXPECT_EQ(partition_offsets[partition_number],
+                sub_partition_offsets[partition_number * num_sub_partitions]);
+    }
+
+    // Every sub-partition must match a single level partitioning with the sub seed
+    std::vector<int> host_sub_partition_numbers = compute_row_partition_numbers(num_sub_partitions, sub_seed);
+    const int num_rows = host_sub_partition_numbers.size();
+    const int num_bins = num_partitions * num_sub_partitions;
+
+    for(int bin = 0; bin < num_bins; ++bin)
+    {
+      const int bin_start = sub_partition_offsets[bin];
+      const int bin_stop = (bin < (num_bins - 1)) ? sub_partition_offsets[bin + 1] : num_rows;
+
+      for(int i = bin_start; i < bin_stop; ++i)
+      {
+        EXPECT_EQ(bin % num_sub_partitions, host_sub_partition_numbers[i])
+          << "Sub-partition number for row: " << i << " doesn't match!";
+      }
+    }
+  }
 };
 
 template< typename tuple_of_vectors, 
@@ -285,7 +363,8 @@ typedef ::testing::Types< TestParameters< VTuple<int32_t>, GDF_HASH_IDENTITY, 0
                           TestParameters< VTuple<uint32_t, double, int32_t, double>, GDF_HASH_MURMUR3, 0, 2, 3>,
                           TestParameters< VTuple<int64_t, int64_t, float, double>, GDF_HASH_MURMUR3, 1, 3>,
                           TestParameters< VTuple<int64_t, int64_t>, GDF_HASH_MURMUR3, 0, 1>,
-                          TestParameters< VTuple<float, int32_t>, GDF_HASH_MURMUR3, 0>
+                          TestParameters< VTuple<float, int32_t>, GDF_HASH_MURMUR3, 0>,
+                          TestParameters< VTuple<int64_t, double>, GDF_HASH_MURMUR3_64, 0, 1>
                          >Implementations;
 
 TYPED_TEST_CASE(HashPartitionTest, Implementations);
@@ -349,3 +428,52 @@ TYPED_TEST(HashPartitionTest, 257Partitions)
   this->verify_gdf_result(num_partitions, partition_offsets);
 }
 
+TYPED_TEST(HashPartitionTest, SeededPartitions)
+{
+  const int num_partitions = 10;
+
+  this->create_input(100000, 1000);
+
+  std::vector<int> partition_offsets = this->compute_gdf_result(num_partitions, 42);
+
+  this->verify_gdf_result(num_partitions, partition_offsets, 42);
+}
+
+TYPED_TEST(HashPartitionTest, TwoLevelPartitions)
+{
+  const int num_partitions = 8;
+  const int num_sub_partitions = 5;
+  const uint32_t seed = 0;
+  const uint32_t sub_seed = 1;
+
+  this->create_input(1000000, 1000);
+
+  std::vector<int> partition_offsets;
+  std::vector<int> sub_partition_offsets;
+  gdf_error result_error = this->compute_two_level_gdf_result(num_partitions, num_sub_partitions,
+                                                              partition_offsets, sub_partition_offsets,
+                                                              seed, sub_seed);
+
+  // The identity hash cannot split a partition any further
+  if(GDF_HASH_IDENTITY == this->gdf_hash_function)
+  {
+    EXPECT_EQ(GDF_INVALID_HASH_FUNCTION, result_error);
+    return;
+  }
+
+  ASSERT_EQ(GDF_SUCCESS, result_error);
+
+  this->verify_two_level_gdf_result(num_partitions, num_sub_partitions,
+                                    partition_offsets, sub_partition_offsets,
+                                    seed, sub_seed);
+}
+
+TYPED_TEST(HashPartitionTest, TwoLevelSameSeed)
+{
+  this->create_input(100, 100);
+
+  std::vector<int> partition_offsets;
+  std::vector<int> sub_partition_offsets;
+  EXPECT_EQ(GDF_INVALID_API_CALL, this->compute_two_level_gdf_result(4, 4, partition_offsets,
+                                                                     sub_partition_offsets, 7, 7));
+}
@@ -26,6 +26,7 @@
 #include <cudf.h>
  #include <cudf/functions.h>
  #include <rmm/thrust_rmm_allocator.h>
+ #include <hash/hash_functions.cuh>
  
  // thrust::device_vector set to use rmmAlloc and rmmFree.
  template <typename T>
@@ -145,7 +146,7 @@
  
 	 {
 		 gdf_hash_func hash = GDF_HASH_MURMUR3;
-		 gdf_error gdfError = gdf_hash(ncols, inputCol, hash, outputCol);
+		 gdf_error gdfError = gdf_hash(ncols, inputCol, hash, 0, outputCol);
  
 		 EXPECT_TRUE( gdfError == GDF_SUCCESS );
 		 EXPECT_FALSE( gdfError == GDF_CUDA_ERROR );
@@ -158,4 +159,66 @@
 		 EXPECT_TRUE( results[0] == results[nrows-1]);
 	 }
  }
- 
\ No newline at end of file
+ 
+
+ TEST_F(gdf_hashing_test, murmur3_64Test) {
+
+	 const int nrows = 4;
+	 std::vector<int32_t> inputData{42, 7, 42, -1};
+
+	 Vector<int32_t> inputDataDev(inputData);
+	 Vector<int64_t> outDataDev(nrows);
+	 Vector<int32_t> outDataDev32(nrows);
+
+	 gdf_column inputCol{};
+	 gdf_column_view(&inputCol, thrust::raw_pointer_cast(inputDataDev.data()), nullptr, nrows, GDF_INT32);
+	 gdf_column *inputCols[] = {&inputCol};
+
+	 // The 64-bit hash requires a 64-bit output column
+	 gdf_column outputCol32{};
+	 gdf_column_view(&outputCol32, thrust::raw_pointer_cast(outDataDev32.data()), nullptr, nrows, GDF_INT32);
+	 EXPECT_EQ(GDF_UNSUPPORTED_DTYPE, gdf_hash(1, inputCols, GDF_HASH_MURMUR3_64, 0, &outputCol32));
+
+	 gdf_column outputCol{};
+	 gdf_column_view(&outputCol, thrust::raw_pointer_cast(outDataDev.data()), nullptr, nrows, GDF_INT64);
+	 ASSERT_EQ(GDF_SUCCESS, gdf_hash(1, inputCols, GDF_HASH_MURMUR3_64, 0, &outputCol));
+
+	 std::vector<int64_t> results(nrows);
+	 thrust::copy(outDataDev.begin(), outDataDev.end(), results.begin());
+
+	 // The device hashes match the host hash function
+	 MurmurHash3_64<int32_t> hasher;
+	 for(int i = 0; i < nrows; ++i)
+		 EXPECT_EQ(hasher(inputData[i]), static_cast<uint64_t>(results[i]));
+	 EXPECT_EQ(results[0], results[2]);
+	 EXPECT_NE(results[0], results[1]);
+ }
+
+ TEST_F(gdf_hashing_test, seededTest) {
+
+	 const int nrows = 4;
+	 std::vector<int32_t> inputData{42, 7, 42, -1};
+
+	 Vector<int32_t> inputDataDev(inputData);
+	 Vector<int32_t> outDataDev(nrows);
+
+	 gdf_column inputCol{};
+	 gdf_column_view(&inputCol, thrust::raw_pointer_cast(inputDataDev.data()), nullptr, nrows, GDF_INT32);
+	 gdf_column *inputCols[] = {&inputCol};
+
+	 gdf_column outputCol{};
+	 gdf_column_view(&outputCol, thrust::raw_pointer_cast(outDataDev.data()), nullptr, nrows, GDF_INT32);
+	 ASSERT_EQ(GDF_SUCCESS, gdf_hash(1, inputCols, GDF_HASH_MURMUR3, 42, &outputCol));
+
+	 std::vector<int32_t> results(nrows);
+	 thrust::copy(outDataDev.begin(), outDataDev.end(), results.begin());
+
+	 // The device hashes match the host hash function of the same seed
+	 MurmurHash3_32<int32_t> hasher{42};
+	 MurmurHash3_32<int32_t> unseeded_hasher;
+	 for(int i = 0; i < nrows; ++i)
+	 {
+		 EXPECT_EQ(hasher(inputData[i]), static_cast<uint32_t>(results[i]));
+		 EXPECT_NE(unseeded_hasher(inputData[i]), static_cast<uint32_t>(results[i]));
+	 }
+ }
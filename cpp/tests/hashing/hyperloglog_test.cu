@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <hash/hyperloglog.cuh>
+
+// The sketch is __host__ __device__, so its accuracy is checked on the host
+
+namespace {
+
+// The sketch of the keys [begin, end), hashed like the rows of a GDF_INT64 column
+hyperloglog_sketch sketch_of_range(int64_t begin, int64_t end, int precision = HLL_DEFAULT_PRECISION)
+{
+  hyperloglog_sketch sketch(precision);
+  for (int64_t k = begin; k < end; ++k) sketch.add(MurmurHash3_64<int64_t>{}(k));
+  return sketch;
+}
+
+// Four standard errors of a sketch
+double tolerance(int precision)
+{
+  return 4 * 1.04 / std::sqrt(static_cast<double>(1 << precision));
+}
+
+}  // namespace
+
+TEST(HyperLogLogTest, Empty)
+{
+  hyperloglog_sketch sketch;
+  EXPECT_EQ(HLL_DEFAULT_PRECISION, sketch.precision());
+  EXPECT_EQ(size_t{1} << HLL_DEFAULT_PRECISION, sketch.num_registers());
+  EXPECT_EQ(0.0, sketch.estimate());
+}
+
+TEST(HyperLogLogTest, PrecisionIsClamped)
+{
+  EXPECT_EQ(HLL_MIN_PRECISION, hyperloglog_sketch(1).precision());
+  EXPECT_EQ(HLL_MAX_PRECISION, hyperloglog_sketch(30).precision());
+}
+
+TEST(HyperLogLogTest, RankIsBounded)
+{
+  // All the bits below the register index are 0
+  EXPECT_EQ(uint32_t{65 - 14}, hll_rank(uint64_t{0x3} << 62, 14));
+  EXPECT_EQ(uint32_t{1}, hll_rank(~uint64_t{0}, 14));
+  EXPECT_EQ(uint32_t{(1 << 14) - 1}, hll_register_index(~uint64_t{0}, 14));
+}
+
+TEST(HyperLogLogTest, Accuracy)
+{
+  for (int precision : {10, 14}) {
+    for (int64_t cardinality : {10, 1000, 30000, 1000000}) {
+      const double estimate = sketch_of_range(0, cardinality, precision).estimate();
+      EXPECT_NEAR(static_cast<double>(cardinality), estimate, tolerance(precision) * cardinality)
+          << "precision " << precision << ", cardinality " << cardinality;
+    }
+  }
+}
+
+TEST(HyperLogLogTest, SmallCardinalitiesAreNearlyExact)
+{
+  // Linear counting is used while most registers are empty
+  for (int64_t cardinality : {1, 2, 5, 50}) {
+    EXPECT_EQ(cardinality, std::llround(sketch_of_range(0, cardinality).estimate()));
+  }
+}
+
+TEST(HyperLogLogTest, DuplicatesAreNotCounted)
+{
+  hyperloglog_sketch once = sketch_of_range(0, 10000);
+  hyperloglog_sketch many = sketch_of_range(0, 10000);
+  for (int repeat = 0; repeat < 4; ++repeat) {
+    for (int64_t k = 0; k < 10000; ++k) many.add(MurmurHash3_64<int64_t>{}(k));
+  }
+  EXPECT_EQ(once.estimate(), many.estimate());
+}
+
+TEST(HyperLogLogTest, MergeIsUnion)
+{
+  // Overlapping parts, merged in any order, give the sketch of their union
+  hyperloglog_sketch whole = sketch_of_range(0, 100000);
+
+  hyperloglog_sketch first = sketch_of_range(0, 60000);
+  hyperloglog_sketch second = sketch_of_range(40000, 100000);
+  hyperloglog_sketch merged = second;
+  ASSERT_TRUE(merged.merge(first));
+  ASSERT_TRUE(first.merge(second));
+
+  EXPECT_EQ(std::vector<uint32_t>(whole.registers(), whole.registers() + whole.num_registers()),
+            std::vector<uint32_t>(merged.registers(), merged.registers() + merged.num_registers()));
+  EXPECT_EQ(whole.estimate(), merged.estimate());
+  EXPECT_EQ(whole.estimate(), first.estimate());
+}
+
+TEST(HyperLogLogTest, MergeRequiresSamePrecision)
+{
+  hyperloglog_sketch sketch = sketch_of_range(0, 1000, 12);
+  const double estimate = sketch.estimate();
+  EXPECT_FALSE(sketch.merge(sketch_of_range(1000, 2000, 14)));
+  EXPECT_EQ(estimate, sketch.estimate());
+}
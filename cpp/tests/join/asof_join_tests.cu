@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <cudf.h>
+#include <rmm/rmm.h>
+#include <cudf/functions.h>
+
+#include "join/host_asof_join.h"
+
+#include "tests/utilities/cudf_test_utils.cuh"
+#include "tests/utilities/cudf_test_fixtures.h"
+
+struct AsofJoinTest : public GdfTest
+{
+  gdf_context ctxt{0, GDF_SORT, 0};
+
+  // Trades (left) and quotes (right), with a symbol and a venue as by columns
+  std::vector<int64_t> left_time, right_time;
+  std::vector<int32_t> left_symbol, right_symbol;
+  std::vector<int16_t> left_venue, right_venue;
+
+  AsofJoinTest()
+  {
+    std::srand(0);
+  }
+
+  void create_input(size_t left_size, size_t right_size, int max_time, int num_symbols)
+  {
+    auto fill = [=](std::vector<int64_t> & time, std::vector<int32_t> & symbol,
+                    std::vector<int16_t> & venue, size_t size) {
+      time.resize(size);
+      symbol.resize(size);
+      venue.resize(size);
+      for(size_t i = 0; i < size; ++i) {
+        time[i] = std::rand() % max_time;
+        symbol[i] = std::rand() % num_symbols;
+        venue[i] = std::rand() % 2;
+      }
+    };
+    fill(left_time, left_symbol, left_venue, left_size);
+    fill(right_time, right_symbol, right_venue, right_size);
+  }
+
+  // Sorts the rows of a table by (symbol, venue, time), as flag_sorted expects
+  static void sort_rows(std::vector<int64_t> & time, std::vector<int32_t> & symbol,
+                        std::vector<int16_t> & venue)
+  {
+    std::vector<std::tuple<int32_t, int16_t, int64_t>> rows(time.size());
+    for(size_t i = 0; i < time.size(); ++i) rows[i] = std::make_tuple(symbol[i], venue[i], time[i]);
+    std::stable_sort(rows.begin(), rows.end());
+    for(size_t i = 0; i < time.size(); ++i) std::tie(symbol[i], venue[i], time[i]) = rows[i];
+  }
+
+  std::vector<int> compute_reference_solution(int num_by_cols, int64_t tolerance)
+  {
+    std::vector<std::tuple<int32_t, int16_t>> left_by, right_by;
+    if(num_by_cols > 0) {
+      for(size_t i = 0; i < left_time.size(); ++i) {
+        left_by.emplace_back(left_symbol[i], (num_by_cols > 1) ? left_venue[i] : 0);
+      }
+      for(size_t i = 0; i < right_time.size(); ++i) {
+        right_by.emplace_back(right_symbol[i], (num_by_cols > 1) ? right_venue[i] : 0);
+      }
+    }
+    return host_asof_join(left_time, right_time, left_by, right_by, tolerance);
+  }
+
+  std::vector<int> compute_gdf_result(int num_by_cols, int64_t tolerance, gdf_dtype time_dtype)
+  {
+    gdf_col_pointer left_on = create_gdf_column(left_time);
+    gdf_col_pointer right_on = create_gdf_column(right_time);
+    left_on->dtype = time_dtype;
+    right_on->dtype = time_dtype;
+
+    gdf_col_pointer left_by_cols[] = {create_gdf_column(left_symbol), create_gdf_column(left_venue)};
+    gdf_col_pointer right_by_cols[] = {create_gdf_column(right_symbol), create_gdf_column(right_venue)};
+    gdf_column * left_by[] = {left_by_cols[0].get(), left_by_cols[1].get()};
+    gdf_column * right_by[] = {right_by_cols[0].get(), right_by_cols[1].get()};
+
+    gdf_column left_indices{}, right_indices{};
+    EXPECT_EQ(GDF_SUCCESS, gdf_asof_join(left_on.get(), right_on.get(), left_by, right_by,
+                                         num_by_cols, tolerance,
+                                         &left_indices, &right_indices, &ctxt));
+    EXPECT_EQ(left_time.size(), left_indices.size);
+    EXPECT_EQ(left_time.size(), right_indices.size);
+
+    std::vector<int> h_left(left_indices.size), h_right(right_indices.size);
+    if(left_indices.size > 0) {
+      EXPECT_EQ(cudaSuccess, cudaMemcpy(h_left.data(), left_indices.data,
+                                        left_indices.size * sizeof(int), cudaMemcpyDeviceToHost));
+      EXPECT_EQ(cudaSuccess, cudaMemcpy(h_right.data(), right_indices.data,
+                                        right_indices.size * sizeof(int), cudaMemcpyDeviceToHost));
+    }
+    if(nullptr != left_indices.data) EXPECT_EQ(RMM_SUCCESS, RMM_FREE(left_indices.data, 0));
+    if(nullptr != right_indices.data) EXPECT_EQ(RMM_SUCCESS, RMM_FREE(right_indices.data, 0));
+
+    // Every left row is in the output, in order
+    std::vector<int> expected_left(left_time.size());
+    std::iota(expected_left.begin(), expected_left.end(), 0);
+    EXPECT_EQ(expected_left, h_left);
+
+    return h_right;
+  }
+
+  void check(int num_by_cols, int64_t tolerance, gdf_dtype time_dtype = GDF_TIMESTAMP)
+  {
+    EXPECT_EQ(compute_reference_solution(num_by_cols, tolerance),
+              compute_gdf_result(num_by_cols, tolerance, time_dtype));
+  }
+};
+
+TEST_F(AsofJoinTest, NoByColumns)
+{
+  create_input(10000, 5000, 20000, 10);
+  check(0, -1);
+}
+
+TEST_F(AsofJoinTest, OneByColumn)
+{
+  create_input(10000, 5000, 20000, 10);
+  check(1, -1);
+}
+
+TEST_F(AsofJoinTest, TwoByColumns)
+{
+  create_input(10000, 5000, 20000, 10);
+  check(2, -1, GDF_DATE64);
+}
+
+TEST_F(AsofJoinTest, Tolerance)
+{
+  create_input(10000, 5000, 20000, 10);
+  check(1, 0);
+  check(1, 20);
+  check(0, 5);
+}
+
+TEST_F(AsofJoinTest, DuplicateRightKeys)
+{
+  // Many quotes share a time, the last of them is matched
+  create_input(5000, 10000, 100, 3);
+  check(1, -1);
+}
+
+TEST_F(AsofJoinTest, SortedInput)
+{
+  create_input(10000, 5000, 20000, 10);
+  sort_rows(left_time, left_symbol, left_venue);
+  sort_rows(right_time, right_symbol, right_venue);
+  ctxt.flag_sorted = 1;
+  check(2, -1);
+  check(2, 50);
+}
+
+TEST_F(AsofJoinTest, UnsupportedOnType)
+{
+  create_input(100, 100, 1000, 10);
+  std::vector<double> times(100, 1.0);
+  gdf_col_pointer left_on = create_gdf_column(times);
+  gdf_col_pointer right_on = create_gdf_column(times);
+  gdf_column left_indices{}, right_indices{};
+  EXPECT_EQ(GDF_UNSUPPORTED_DTYPE, gdf_asof_join(left_on.get(), right_on.get(), nullptr, nullptr,
+                                                 0, -1, &left_indices, &right_indices, &ctxt));
+}
@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <join/chunked_probe.h>
+#include <join/host_asof_join.h>
+#include <join/host_hash_join.h>
+
+// The host join does not need a GPU, so there is no need for the GdfTest fixture
+template <class T>
+class HostJoinTest : public ::testing::Test
+{
+public:
+  using key_type = T;
+  using result_type = std::pair<int, int>;
+
+  std::vector<key_type> build_keys;
+  std::vector<key_type> probe_keys;
+
+  void create_input(int num_build_rows, int num_probe_rows, int max_key)
+  {
+    std::default_random_engine generator;
+    std::uniform_int_distribution<int> key_distribution(0, max_key);
+    build_keys.resize(num_build_rows);
+    probe_keys.resize(num_probe_rows);
+    for (auto & k : build_keys) k = static_cast<key_type>(key_distribution(generator));
+    for (auto & k : probe_keys) k = static_cast<key_type>(key_distribution(generator));
+  }
+
+  std::vector<result_type> compute_reference_solution(bool left_join)
+  {
+    std::multimap<key_type, int> reference_map;
+    for (size_t i = 0; i < build_keys.size(); ++i) reference_map.emplace(build_keys[i], i);
+
+    std::vector<result_type> result;
+    for (size_t i = 0; i < probe_keys.size(); ++i) {
+      auto range = reference_map.equal_range(probe_keys[i]);
+      for (auto it = range.first; it != range.second; ++it) result.emplace_back(i, it->second);
+      if (left_join && (range.first == range.second)) result.emplace_back(i, HostJoinNoneValue);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  template <bool left_join>
+  void check(unsigned int num_threads)
+  {
+    auto build_map = host_build_join_map(build_keys, num_threads);
+
+    std::vector<int> output_probe, output_build;
+    host_hash_join<left_join>(*build_map, probe_keys, output_probe, output_build, num_threads);
+
+    ASSERT_EQ(output_probe.size(), output_build.size());
+
+    // The output is in probe row order
+    EXPECT_TRUE(std::is_sorted(output_probe.begin(), output_probe.end()));
+
+    std::vector<result_type> result;
+    for (size_t i = 0; i < output_probe.size(); ++i) result.emplace_back(output_probe[i], output_build[i]);
+    std::sort(result.begin(), result.end());
+
+    EXPECT_EQ(compute_reference_solution(left_join), result);
+  }
+};
+
+typedef ::testing::Types<int32_t, int64_t> Implementations;
+
+TYPED_TEST_CASE(HostJoinTest, Implementations);
+
+TYPED_TEST(HostJoinTest, InnerJoin)
+{
+  this->create_input(5000, 10000, 2000);
+  this->template check<false>(8);
+}
+
+TYPED_TEST(HostJoinTest, LeftJoin)
+{
+  this->create_input(5000, 10000, 8000);
+  this->template check<true>(8);
+}
+
+TYPED_TEST(HostJoinTest, SkewedKeys)
+{
+  // A few keys match thousands of rows
+  this->create_input(1000, 1000, 3);
+  this->template check<true>(8);
+}
+
+TYPED_TEST(HostJoinTest, EmptyBuild)
+{
+  this->create_input(0, 1000, 100);
+  this->template check<false>(8);
+  this->template check<true>(8);
+}
+
+TYPED_TEST(HostJoinTest, SameOutputForAnyNumberOfThreads)
+{
+  this->create_input(5000, 10000, 2000);
+
+  // Build once, so that the matches of a probe row are in the same order
+  auto build_map = host_build_join_map(this->build_keys, 1);
+
+  std::vector<int> probe_1, build_1, probe_8, build_8;
+  host_hash_join<true>(*build_map, this->probe_keys, probe_1, build_1, 1);
+  host_hash_join<true>(*build_map, this->probe_keys, probe_8, build_8, 8);
+
+  EXPECT_EQ(probe_1, probe_8);
+  EXPECT_EQ(build_1, build_8);
+}
+
+TYPED_TEST(HostJoinTest, BuildSideSelection)
+{
+  // Left is the smaller side, so the map is built on it
+  this->create_input(2000, 500, 1000);
+  std::vector<typename TestFixture::key_type> left_keys = this->probe_keys;
+  std::vector<typename TestFixture::key_type> right_keys = this->build_keys;
+
+  std::vector<int> output_left, output_right;
+  gdf_hash_table_stats stats{};
+  host_inner_hash_join(left_keys, right_keys, output_left, output_right, &stats, 0, 0, nullptr, 8);
+  EXPECT_EQ(1, stats.build_side_swapped);
+  EXPECT_EQ(left_keys.size(), stats.num_entries);
+
+  // The output is flipped back: reference with right as build and left as probe
+  std::vector<typename TestFixture::result_type> result;
+  for (size_t i = 0; i < output_left.size(); ++i) result.emplace_back(output_left[i], output_right[i]);
+  std::sort(result.begin(), result.end());
+  EXPECT_EQ(this->compute_reference_solution(false), result);
+
+  // Right is the smaller side, so the map is built on it
+  host_inner_hash_join(right_keys, left_keys, output_left, output_right, &stats, 0, 0, nullptr, 8);
+  EXPECT_EQ(0, stats.build_side_swapped);
+  EXPECT_EQ(left_keys.size(), stats.num_entries);
+}
+
+TYPED_TEST(HostJoinTest, BuildSideCostHook)
+{
+  this->create_input(1000, 1000, 100);
+
+  // With equal sizes the map is built on the right side
+  std::vector<int> output_left, output_right;
+  gdf_hash_table_stats stats{};
+  host_inner_hash_join(this->probe_keys, this->build_keys, output_left, output_right, &stats);
+  EXPECT_EQ(0, stats.build_side_swapped);
+
+  // Many right rows per key make every probe of a map built on the right side
+  // read long runs of duplicates, so building on the unique left keys is cheaper
+  host_inner_hash_join(this->probe_keys, this->build_keys, output_left, output_right, &stats,
+                       1000, 10);
+  EXPECT_EQ(1, stats.build_side_swapped);
+
+  // A custom hook that prefers building on the side of 1000 rows
+  join_build_side_cost_fn prefer_left = [](size_t build_rows, size_t, size_t probe_rows, size_t,
+                                           size_t, int64_t) {
+    return (build_rows == 1000 && probe_rows == 1500) ? 0.0 : 1.0;
+  };
+  this->create_input(1500, 1000, 100);
+  host_inner_hash_join(this->build_keys, this->probe_keys, output_left, output_right, &stats,
+                       0, 0, prefer_left);
+  EXPECT_EQ(0, stats.build_side_swapped);
+  host_inner_hash_join(this->probe_keys, this->build_keys, output_left, output_right, &stats,
+                       0, 0, prefer_left);
+  EXPECT_EQ(1, stats.build_side_swapped);
+}
+
+TEST(JoinBuildSide, DefaultCost)
+{
+  join_side_info small_side;
+  small_side.num_rows = 100;
+  join_side_info large_side;
+  large_side.num_rows = 10000;
+
+  // Without key statistics, build on the smaller side
+  EXPECT_TRUE(join_build_on_left(small_side, large_side, 8, 50));
+  EXPECT_FALSE(join_build_on_left(large_side, small_side, 8, 50));
+  EXPECT_FALSE(join_build_on_left(small_side, small_side, 8, 50));
+
+  // The multimap memory grows as the occupancy drops
+  EXPECT_EQ(16u * 100, join_hash_table_memory(100, 8, 50));
+  EXPECT_EQ(8u * 400, join_hash_table_memory(100, 8, 25));
+  EXPECT_EQ(8u, join_hash_table_memory(0, 8, 50));
+}
+
+TYPED_TEST(HostJoinTest, PrebuiltHashTable)
+{
+  this->create_input(3000, 9000, 2000);
+  host_join_hash_table<typename TestFixture::key_type> hash_table(this->build_keys, 8);
+  EXPECT_EQ(this->build_keys.size(), hash_table.num_build_rows());
+
+  // Probe the same table with successive batches of the probe keys
+  const std::vector<typename TestFixture::key_type> all_probe_keys = this->probe_keys;
+  const size_t batch_size = 2500;
+  for (size_t begin = 0; begin < all_probe_keys.size(); begin += batch_size) {
+    const size_t end = std::min(all_probe_keys.size(), begin + batch_size);
+    this->probe_keys.assign(all_probe_keys.begin() + begin, all_probe_keys.begin() + end);
+
+    for (bool left_join : {false, true}) {
+      std::vector<int> output_probe, output_build;
+      hash_table.probe(this->probe_keys, left_join, output_probe, output_build, 8);
+
+      std::vector<typename TestFixture::result_type> result;
+      for (size_t i = 0; i < output_probe.size(); ++i) result.emplace_back(output_probe[i], output_build[i]);
+      std::sort(result.begin(), result.end());
+      EXPECT_EQ(this->compute_reference_solution(left_join), result);
+    }
+  }
+}
+
+TYPED_TEST(HostJoinTest, ChunkedProbe)
+{
+  this->create_input(3000, 10000, 2000);
+  host_join_hash_table<typename TestFixture::key_type> hash_table(this->build_keys, 8);
+
+  struct chunk_output
+  {
+    std::vector<typename TestFixture::key_type> probe_keys;
+    std::vector<int> probe;
+    std::vector<int> build;
+  };
+
+  for (bool left_join : {false, true}) {
+    for (size_t chunk_rows : {size_t{0}, size_t{1}, size_t{1000}, size_t{4093}, size_t{20000},
+                              std::numeric_limits<size_t>::max()}) {
+      chunk_output output;
+      std::vector<typename TestFixture::result_type> result;
+      size_t max_chunk_rows{0};
+      size_t next_begin{0};
+
+      auto probe_chunk = [&](size_t begin, size_t end, chunk_output & out) {
+        out.probe_keys.assign(this->probe_keys.begin() + begin, this->probe_keys.begin() + end);
+        hash_table.probe(out.probe_keys, left_join, out.probe, out.build, 4);
+        return GDF_SUCCESS;
+      };
+      auto consume = [&](size_t begin, size_t end, chunk_output & out) {
+        // The chunks are consecutive and cover the probe rows once
+        EXPECT_EQ(next_begin, begin);
+        next_begin = end;
+        max_chunk_rows = std::max(max_chunk_rows, end - begin);
+        for (size_t i = 0; i < out.probe.size(); ++i) {
+          result.emplace_back(begin + out.probe[i], out.build[i]);
+        }
+        return GDF_SUCCESS;
+      };
+
+      EXPECT_EQ(GDF_SUCCESS, probe_in_chunks(this->probe_keys.size(), chunk_rows, output,
+                                             probe_chunk, consume));
+      EXPECT_EQ(this->probe_keys.size(), next_begin);
+      EXPECT_EQ(probe_chunk_rows(chunk_rows, this->probe_keys.size()) % GDF_VALID_BITSIZE, 0u);
+      EXPECT_LE(max_chunk_rows, probe_chunk_rows(chunk_rows, this->probe_keys.size()));
+
+      std::sort(result.begin(), result.end());
+      EXPECT_EQ(this->compute_reference_solution(left_join), result);
+    }
+  }
+}
+
+TYPED_TEST(HostJoinTest, ChunkedProbeStopsOnError)
+{
+  this->create_input(100, 1000, 50);
+  host_join_hash_table<typename TestFixture::key_type> hash_table(this->build_keys);
+
+  std::vector<int> probe, build;
+  int num_chunks{0};
+  auto probe_chunk = [&](size_t begin, size_t end, std::vector<int> &) {
+    std::vector<typename TestFixture::key_type> keys(this->probe_keys.begin() + begin,
+                                                     this->probe_keys.begin() + end);
+    hash_table.probe(keys, false, probe, build);
+    return GDF_SUCCESS;
+  };
+  auto consume = [&](size_t, size_t, std::vector<int> &) {
+    return (++num_chunks < 3) ? GDF_SUCCESS : GDF_INVALID_API_CALL;
+  };
+
+  EXPECT_EQ(GDF_INVALID_API_CALL, probe_in_chunks(this->probe_keys.size(), 64, probe,
+                                                  probe_chunk, consume));
+  EXPECT_EQ(3, num_chunks);
+}
+
+TEST(ProbeChunkRowsTest, ClampsToProbeTable)
+{
+  const size_t max_rows = std::numeric_limits<size_t>::max();
+  EXPECT_EQ(1008u, probe_chunk_rows(max_rows, 1001));
+  EXPECT_EQ(1008u, probe_chunk_rows(0, 1001));
+  EXPECT_EQ(8u, probe_chunk_rows(max_rows, 0));
+  EXPECT_EQ(104u, probe_chunk_rows(100, 1000));
+}
+
+// Naive as-of join: scans every right row for every left row
+template <typename on_type, typename by_type>
+std::vector<int> naive_asof_join(std::vector<on_type> const & left_on,
+                                 std::vector<on_type> const & right_on,
+                                 std::vector<by_type> const & left_by,
+                                 std::vector<by_type> const & right_by,
+                                 int64_t tolerance)
+{
+  std::vector<int> result(left_on.size(), -1);
+  for (size_t i = 0; i < left_on.size(); ++i) {
+    for (size_t j = 0; j < right_on.size(); ++j) {
+      if (!left_by.empty() && !(left_by[i] == right_by[j])) continue;
+      if (right_on[j] > left_on[i]) continue;
+      if ((tolerance >= 0) && (left_on[i] - right_on[j] > tolerance)) continue;
+      // The latest on value, then the largest index
+      if ((-1 == result[i]) || (right_on[j] >= right_on[result[i]])) result[i] = j;
+    }
+  }
+  return result;
+}
+
+TEST(HostAsofJoin, MatchesNaiveJoin)
+{
+  std::default_random_engine generator;
+  std::uniform_int_distribution<int64_t> time_distribution(0, 5000);
+  std::uniform_int_distribution<int> symbol_distribution(0, 9);
+
+  std::vector<int64_t> left_on(1000), right_on(1500);
+  std::vector<std::tuple<int, int>> left_by(left_on.size()), right_by(right_on.size());
+  for (size_t i = 0; i < left_on.size(); ++i) {
+    left_on[i] = time_distribution(generator);
+    left_by[i] = std::make_tuple(symbol_distribution(generator), symbol_distribution(generator) % 2);
+  }
+  for (size_t i = 0; i < right_on.size(); ++i) {
+    right_on[i] = time_distribution(generator);
+    right_by[i] = std::make_tuple(symbol_distribution(generator), symbol_distribution(generator) % 2);
+  }
+
+  for (int64_t tolerance : {-1, 0, 10, 100}) {
+    EXPECT_EQ(naive_asof_join(left_on, right_on, left_by, right_by, tolerance),
+              host_asof_join(left_on, right_on, left_by, right_by, tolerance));
+
+    std::vector<int> no_by;
+    EXPECT_EQ(naive_asof_join(left_on, right_on, no_by, no_by, tolerance),
+              host_asof_join(left_on, right_on, no_by, no_by, tolerance));
+  }
+}
+
+TEST(HostAsofJoin, TradesAndQuotes)
+{
+  // Quotes of two symbols, the second quote of symbol 1 at time 20 is repeated
+  std::vector<int64_t> quote_time{10, 20, 20, 15, 30, 40};
+  std::vector<int> quote_symbol{1, 1, 1, 2, 2, 1};
+
+  std::vector<int64_t> trade_time{5, 10, 25, 25, 45, 100};
+  std::vector<int> trade_symbol{1, 1, 1, 2, 2, 1};
+
+  EXPECT_EQ((std::vector<int>{-1, 0, 2, 3, 4, 5}),
+            host_asof_join(trade_time, quote_time, trade_symbol, quote_symbol, -1));
+  EXPECT_EQ((std::vector<int>{-1, 0, 2, 3, 4, -1}),
+            host_asof_join(trade_time, quote_time, trade_symbol, quote_symbol, 15));
+
+  std::vector<int> no_by;
+  EXPECT_EQ((std::vector<int>{-1, 0, 2, 2, 5, 5}),
+            host_asof_join(trade_time, quote_time, no_by, no_by, -1));
+}
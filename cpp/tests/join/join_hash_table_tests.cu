@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <cudf.h>
+#include <rmm/rmm.h>
+#include <cudf/functions.h>
+
+#include "tests/utilities/cudf_test_utils.cuh"
+#include "tests/utilities/cudf_test_fixtures.h"
+
+struct JoinHashTableTest : public GdfTest
+{
+  using result_type = std::pair<int, int>;
+
+  gdf_context ctxt{0, GDF_HASH, 0};
+
+  std::vector<int32_t> build_keys;
+  std::vector<int64_t> build_payload;
+
+  gdf_col_pointer build_key_column;
+  gdf_col_pointer build_payload_column;
+
+  gdf_join_hash_table * hash_table{nullptr};
+
+  JoinHashTableTest()
+  {
+    std::srand(0);
+  }
+
+  ~JoinHashTableTest()
+  {
+    if(nullptr != hash_table) {
+      EXPECT_EQ(GDF_SUCCESS, gdf_join_hash_table_free(hash_table));
+    }
+  }
+
+  // The payload column is a function of the key, so the rows of the two
+  // column join match exactly when their keys match
+  static int64_t payload(int32_t key) { return 3 * static_cast<int64_t>(key) + 1; }
+
+  void create_build(size_t num_rows, int max_key)
+  {
+    build_keys.resize(num_rows);
+    build_payload.resize(num_rows);
+    for(size_t i = 0; i < num_rows; ++i) {
+      build_keys[i] = std::rand() % max_key;
+      build_payload[i] = payload(build_keys[i]);
+    }
+    build_key_column = create_gdf_column(build_keys);
+    build_payload_column = create_gdf_column(build_payload);
+
+    gdf_column * build_cols[] = {build_key_column.get(), build_payload_column.get()};
+    ASSERT_EQ(GDF_SUCCESS, gdf_join_build(build_cols, 2, &hash_table, &ctxt));
+  }
+
+  std::vector<result_type> compute_reference_solution(std::vector<int32_t> const & probe_keys,
+                                                      bool left_join)
+  {
+    std::multimap<int32_t, int> reference_map;
+    for(size_t i = 0; i < build_keys.size(); ++i) reference_map.emplace(build_keys[i], i);
+
+    std::vector<result_type> result;
+    for(size_t i = 0; i < probe_keys.size(); ++i) {
+      auto range = reference_map.equal_range(probe_keys[i]);
+      for(auto it = range.first; it != range.second; ++it) result.emplace_back(i, it->second);
+      if(left_join && (range.first == range.second)) result.emplace_back(i, -1);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  std::vector<result_type> probe(std::vector<int32_t> const & probe_keys, bool left_join)
+  {
+    std::vector<int64_t> probe_payload(probe_keys.size());
+    std::transform(probe_keys.begin(), probe_keys.end(), probe_payload.begin(), payload);
+    gdf_col_pointer probe_key_column = create_gdf_column(probe_keys);
+    gdf_col_pointer probe_payload_column = create_gdf_column(probe_payload);
+
+    gdf_column * probe_cols[] = {probe_key_column.get(), probe_payload_column.get()};
+    gdf_column probe_indices{}, build_indices{};
+    EXPECT_EQ(GDF_SUCCESS, gdf_join_probe(hash_table, probe_cols, 2, left_join ? 1 : 0,
+                                          &probe_indices, &build_indices, &ctxt));
+    EXPECT_EQ(probe_indices.size, build_indices.size);
+
+    std::vector<int> h_probe(probe_indices.size), h_build(build_indices.size);
+    if(probe_indices.size > 0) {
+      EXPECT_EQ(cudaSuccess, cudaMemcpy(h_probe.data(), probe_indices.data,
+                                        probe_indices.size * sizeof(int), cudaMemcpyDeviceToHost));
+      EXPECT_EQ(cudaSuccess, cudaMemcpy(h_build.data(), build_indices.data,
+                                        build_indices.size * sizeof(int), cudaMemcpyDeviceToHost));
+    }
+    if(nullptr != probe_indices.data) EXPECT_EQ(RMM_SUCCESS, RMM_FREE(probe_indices.data, 0));
+    if(nullptr != build_indices.data) EXPECT_EQ(RMM_SUCCESS, RMM_FREE(build_indices.data, 0));
+
+    std::vector<result_type> result;
+    for(size_t i = 0; i < h_probe.size(); ++i) result.emplace_back(h_probe[i], h_build[i]);
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  std::vector<int32_t> random_keys(size_t num_rows, int max_key)
+  {
+    std::vector<int32_t> keys(num_rows);
+    for(auto & k : keys) k = std::rand() % max_key;
+    return keys;
+  }
+};
+
+// Accumulates the output of every chunk of a chunked probe
+struct chunked_result
+{
+  std::vector<std::pair<int, int>> rows;
+  size_t num_chunks{0};
+  size_t next_begin{0};
+};
+
+gdf_error collect_chunk(gdf_size_type chunk_begin, gdf_size_type chunk_end,
+                        gdf_column * probe_indices, gdf_column * build_indices,
+                        void * user_data)
+{
+  chunked_result * result = static_cast<chunked_result*>(user_data);
+  if(chunk_begin != result->next_begin) return GDF_INVALID_API_CALL;
+  result->next_begin = chunk_end;
+  ++result->num_chunks;
+
+  std::vector<int> h_probe(probe_indices->size), h_build(build_indices->size);
+  if(probe_indices->size > 0) {
+    if((cudaSuccess != cudaMemcpy(h_probe.data(), probe_indices->data,
+                                  probe_indices->size * sizeof(int), cudaMemcpyDeviceToHost)) ||
+       (cudaSuccess != cudaMemcpy(h_build.data(), build_indices->data,
+                                  build_indices->size * sizeof(int), cudaMemcpyDeviceToHost))) {
+      return GDF_CUDA_ERROR;
+    }
+  }
+  for(size_t i = 0; i < h_probe.size(); ++i) {
+    result->rows.emplace_back(chunk_begin + h_probe[i], h_build[i]);
+  }
+  return GDF_SUCCESS;
+}
+
+TEST_F(JoinHashTableTest, ProbeManyBatches)
+{
+  create_build(5000, 2000);
+
+  // The hash table is built once and probed with every batch
+  for(int batch = 0; batch < 4; ++batch) {
+    std::vector<int32_t> probe_keys = random_keys(3000 + 1000 * batch, 4000);
+    EXPECT_EQ(compute_reference_solution(probe_keys, false), probe(probe_keys, false));
+    EXPECT_EQ(compute_reference_solution(probe_keys, true), probe(probe_keys, true));
+  }
+}
+
+TEST_F(JoinHashTableTest, ExactOutputSize)
+{
+  ctxt.flag_exact_join_size = 1;
+  create_build(5000, 2000);
+  std::vector<int32_t> probe_keys = random_keys(10000, 4000);
+  EXPECT_EQ(compute_reference_solution(probe_keys, false), probe(probe_keys, false));
+  EXPECT_EQ(compute_reference_solution(probe_keys, true), probe(probe_keys, true));
+}
+
+TEST_F(JoinHashTableTest, HashTable64Bit)
+{
+  ctxt.flag_hash_64bit = 1;
+  create_build(5000, 2000);
+  std::vector<int32_t> probe_keys = random_keys(10000, 4000);
+  EXPECT_EQ(compute_reference_solution(probe_keys, false), probe(probe_keys, false));
+}
+
+TEST_F(JoinHashTableTest, MismatchedProbeColumns)
+{
+  create_build(100, 10);
+
+  std::vector<int64_t> wrong_keys(100, 1);
+  gdf_col_pointer wrong_key_column = create_gdf_column(wrong_keys);
+  gdf_column * probe_cols[] = {wrong_key_column.get(), build_payload_column.get()};
+  gdf_column probe_indices{}, build_indices{};
+  EXPECT_EQ(GDF_JOIN_DTYPE_MISMATCH, gdf_join_probe(hash_table, probe_cols, 2, 0,
+                                                    &probe_indices, &build_indices, &ctxt));
+  EXPECT_EQ(GDF_COLUMN_SIZE_MISMATCH, gdf_join_probe(hash_table, probe_cols, 1, 0,
+                                                     &probe_indices, &build_indices, &ctxt));
+}
+
+TEST_F(JoinHashTableTest, UnsupportedMethod)
+{
+  ctxt.flag_method = GDF_SORT;
+  std::vector<int32_t> keys(10, 1);
+  gdf_col_pointer key_column = create_gdf_column(keys);
+  gdf_column * build_cols[] = {key_column.get()};
+  EXPECT_EQ(GDF_UNSUPPORTED_METHOD, gdf_join_build(build_cols, 1, &hash_table, &ctxt));
+  EXPECT_EQ(nullptr, hash_table);
+}
+
+TEST_F(JoinHashTableTest, ChunkedProbe)
+{
+  create_build(3000, 2000);
+  std::vector<int32_t> probe_keys = random_keys(20000, 4000);
+  std::vector<int64_t> probe_payload(probe_keys.size());
+  std::transform(probe_keys.begin(), probe_keys.end(), probe_payload.begin(), payload);
+  gdf_col_pointer probe_key_column = create_gdf_column(probe_keys);
+  gdf_col_pointer probe_payload_column = create_gdf_column(probe_payload);
+  gdf_column * probe_cols[] = {probe_key_column.get(), probe_payload_column.get()};
+
+  for(int left_join : {0, 1}) {
+    chunked_result result;
+    EXPECT_EQ(GDF_SUCCESS, gdf_join_probe_chunked(hash_table, probe_cols, 2, left_join, 3000,
+                                                  collect_chunk, &result, &ctxt));
+    EXPECT_EQ(7u, result.num_chunks);
+    EXPECT_EQ(probe_keys.size(), result.next_begin);
+
+    std::sort(result.rows.begin(), result.rows.end());
+    EXPECT_EQ(compute_reference_solution(probe_keys, 0 != left_join), result.rows);
+  }
+}
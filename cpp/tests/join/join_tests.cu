@@ -18,6 +18,8 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <numeric>
+#include <algorithm>
 #include <type_traits>
 #include <memory>
 
@@ -107,6 +109,9 @@ struct JoinTest : public GdfTest
     // Each time the class is constructed a new constant seed is used
     static size_t number_of_instantiations{0};
     std::srand(number_of_instantiations++);
+
+    // Small partitions, so that the test inputs are split into many partitions
+    ctxt.max_partition_rows = 256;
   }
 
   ~JoinTest()
@@ -282,6 +287,69 @@ struct JoinTest : public GdfTest
     }
   }
 
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  Computes a reference solution with a merge join: the rows of both
+   * sets of columns are sorted and the runs of equal rows are merged
+   *
+   * @Param sort Option to sort the solution. This is necessary for comparison against the gdf solution
+   *
+   * @Returns A vector of 'result_type' where result_type is a structure with a left_index, right_index
+   * where left_columns[left_index] == right_columns[right_index]
+   */
+  /* ----------------------------------------------------------------------------*/
+  std::vector<result_type> compute_merge_join_reference(bool sort = true)
+  {
+    constexpr int JoinNullValue{-1};
+
+    auto sorted_rows = [](multi_column_t const & columns) {
+      std::vector<int> order(std::get<0>(columns).size());
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(), [&columns](int a, int b) {
+        return rows_less(columns, columns, a, b);
+      });
+      return order;
+    };
+    std::vector<int> left_order = sorted_rows(left_columns);
+    std::vector<int> right_order = sorted_rows(right_columns);
+
+    std::vector<result_type> reference_result;
+    size_t l = 0, r = 0;
+    while((l < left_order.size()) || (r < right_order.size()))
+    {
+      if((r == right_order.size()) ||
+         ((l < left_order.size()) && rows_less(left_columns, right_columns, left_order[l], right_order[r]))) {
+        if(op != join_op::INNER) reference_result.emplace_back(left_order[l], JoinNullValue);
+        ++l;
+      }
+      else if((l == left_order.size()) ||
+              rows_less(right_columns, left_columns, right_order[r], left_order[l])) {
+        if(op == join_op::FULL) reference_result.emplace_back(JoinNullValue, right_order[r]);
+        ++r;
+      }
+      else {
+        // Merge the runs of rows equal to the current left row
+        size_t l_end = l, r_end = r;
+        while((l_end < left_order.size()) && rows_equal(left_columns, left_columns, left_order[l], left_order[l_end])) ++l_end;
+        while((r_end < right_order.size()) && rows_equal(left_columns, right_columns, left_order[l], right_order[r_end])) ++r_end;
+        for(size_t i = l; i < l_end; ++i) {
+          for(size_t j = r; j < r_end; ++j) {
+            reference_result.emplace_back(left_order[i], right_order[j]);
+          }
+        }
+        l = l_end;
+        r = r_end;
+      }
+    }
+
+    if(sort)
+    {
+      std::sort(reference_result.begin(), reference_result.end());
+    }
+
+    return reference_result;
+  }
+
   /* --------------------------------------------------------------------------*/
   /**
    * @Synopsis  Computes a reference solution for joining the left and right sets of columns
@@ -295,6 +363,20 @@ struct JoinTest : public GdfTest
   /* ----------------------------------------------------------------------------*/
   std::vector<result_type> compute_reference_solution(bool print = false, bool sort = true)
   {
+    // The sort based joins are checked against a merge join
+    if(gdf_method::GDF_SORT == test_parameters::join_type)
+    {
+      std::vector<result_type> reference_result = compute_merge_join_reference(sort);
+      if(print)
+      {
+        std::cout << "Reference result size: " << reference_result.size() << std::endl;
+        std::cout << "left index, right index" << std::endl;
+        std::copy(reference_result.begin(), reference_result.end(), std::ostream_iterator<result_type>(std::cout, ""));
+        std::cout << "\n";
+      }
+      return reference_result;
+    }
+
 
     // Use the type of the first vector as the key_type
     using key_type = typename std::tuple_element<0, multi_column_t>::type::value_type;
@@ -538,6 +620,7 @@ struct TestParameters
 
 const static gdf_method HASH = gdf_method::GDF_HASH;
 const static gdf_method SORT = gdf_method::GDF_SORT;
+const static gdf_method PARTITIONED = gdf_method::GDF_HASH_PARTITIONED;
 
 template <typename... T>
 using VTuple = std::tuple<std::vector<T>...>;
@@ -583,6 +666,8 @@ typedef ::testing::Types<
                           TestParameters< join_op::FULL, HASH, VTuple<double  > >,
                           TestParameters< join_op::FULL, HASH, VTuple<uint32_t> >,
                           TestParameters< join_op::FULL, HASH, VTuple<uint64_t> >,
+                          TestParameters< join_op::FULL, SORT, VTuple<int32_t > >,
+                          TestParameters< join_op::FULL, SORT, VTuple<double  > >,
                           // Two Column Left Join tests for some combination of types
                           TestParameters< join_op::LEFT,  HASH, VTuple<int32_t , int32_t> >,
                           TestParameters< join_op::LEFT,  HASH, VTuple<uint32_t, int32_t> >,
@@ -604,7 +689,22 @@ typedef ::testing::Types<
                           // Five column test for Left Joins
                           TestParameters< join_op::LEFT, HASH, VTuple<double, int32_t, int64_t, int32_t, int32_t> >,
                           // Five column test for Inner Joins
-                          TestParameters< join_op::INNER, HASH, VTuple<uint32_t, float, int64_t, int32_t, float> >
+                          TestParameters< join_op::INNER, HASH, VTuple<uint32_t, float, int64_t, int32_t, float> >,
+                          // Multi-column sort based join tests
+                          TestParameters< join_op::INNER, SORT, VTuple<int32_t , int32_t> >,
+                          TestParameters< join_op::LEFT,  SORT, VTuple<uint32_t, int32_t> >,
+                          TestParameters< join_op::FULL,  SORT, VTuple<int32_t , int64_t> >,
+                          TestParameters< join_op::INNER, SORT, VTuple<int32_t , uint32_t, float  > >,
+                          TestParameters< join_op::LEFT,  SORT, VTuple<double  , uint32_t, int64_t> >,
+                          TestParameters< join_op::FULL,  SORT, VTuple<double, int32_t, int64_t, int32_t> >,
+                          // Radix-partitioned hash join tests
+                          TestParameters< join_op::INNER, PARTITIONED, VTuple<int32_t > >,
+                          TestParameters< join_op::INNER, PARTITIONED, VTuple<double  > >,
+                          TestParameters< join_op::LEFT,  PARTITIONED, VTuple<int32_t > >,
+                          TestParameters< join_op::LEFT,  PARTITIONED, VTuple<int64_t > >,
+                          TestParameters< join_op::FULL,  PARTITIONED, VTuple<int32_t > >,
+                          TestParameters< join_op::INNER, PARTITIONED, VTuple<int32_t , uint32_t, float  > >,
+                          TestParameters< join_op::LEFT,  PARTITIONED, VTuple<double  , uint32_t, int64_t> >
                           > Implementations;
 
 TYPED_TEST_CASE(JoinTest, Implementations);
@@ -664,6 +764,65 @@ TYPED_TEST(JoinTest, MaxRandomValues)
   }
 }
 
+TYPED_TEST(JoinTest, MaxRandomValues64BitHash)
+{
+  this->ctxt.flag_hash_64bit = 1;
+
+  this->create_input(10000,RAND_MAX,
+                     10000,RAND_MAX);
+
+  std::vector<result_type> reference_result = this->compute_reference_solution();
+
+  std::vector<result_type> gdf_result = this->compute_gdf_result();
+
+  ASSERT_EQ(reference_result.size(), gdf_result.size()) << "Size of gdf result does not match reference result\n";
+
+  // Compare the GDF and reference solutions
+  for(size_t i = 0; i < reference_result.size(); ++i){
+    EXPECT_EQ(reference_result[i], gdf_result[i]);
+  }
+}
+
+TYPED_TEST(JoinTest, ExactOutputSize)
+{
+  // Only used by the hash join, which then writes the output in probe row order
+  this->ctxt.flag_exact_join_size = 1;
+
+  this->create_input(10000, 100,
+                     1000, 100);
+
+  std::vector<result_type> reference_result = this->compute_reference_solution();
+
+  std::vector<result_type> gdf_result = this->compute_gdf_result();
+
+  ASSERT_EQ(reference_result.size(), gdf_result.size()) << "Size of gdf result does not match reference result\n";
+
+  // Compare the GDF and reference solutions
+  for(size_t i = 0; i < reference_result.size(); ++i){
+    EXPECT_EQ(reference_result[i], gdf_result[i]);
+  }
+}
+
+TYPED_TEST(JoinTest, UnsortedInput)
+{
+  // The sort based joins sort the rows first
+  this->ctxt.flag_sorted = 0;
+
+  this->create_input(10000, 1000,
+                     10000, 1000);
+
+  std::vector<result_type> reference_result = this->compute_reference_solution();
+
+  std::vector<result_type> gdf_result = this->compute_gdf_result();
+
+  ASSERT_EQ(reference_result.size(), gdf_result.size()) << "Size of gdf result does not match reference result\n";
+
+  // Compare the GDF and reference solutions
+  for(size_t i = 0; i < reference_result.size(); ++i){
+    EXPECT_EQ(reference_result[i], gdf_result[i]);
+  }
+}
+
 TYPED_TEST(JoinTest, LeftColumnsBigger)
 {
   this->create_input(10000,100,
@@ -816,3 +975,91 @@ TYPED_TEST(MaxJoinTest, InputTooLarge)
                                                                    sort_result, 
                                                                    expected_error);
 }
+
+// Checks that the key statistics and the cost hook of the gdf_context choose
+// the side the hash table of an inner join is built on
+struct JoinBuildSideTest : public GdfTest
+{
+  std::vector<int32_t> left_keys;
+  std::vector<int32_t> right_keys;
+
+  // Inner joins the left and right keys with GDF_HASH, and returns
+  // build_side_swapped
+  int inner_join_build_side(gdf_context & ctxt)
+  {
+    gdf_hash_table_stats stats{};
+    ctxt.flag_method = GDF_HASH;
+    ctxt.hash_table_stats = &stats;
+
+    gdf_column left_column, right_column;
+    EXPECT_EQ(RMM_ALLOC(&left_column.data, left_keys.size() * sizeof(int32_t), 0), RMM_SUCCESS);
+    EXPECT_EQ(RMM_ALLOC(&right_column.data, right_keys.size() * sizeof(int32_t), 0), RMM_SUCCESS);
+    cudaMemcpy(left_column.data, left_keys.data(), left_keys.size() * sizeof(int32_t), cudaMemcpyHostToDevice);
+    cudaMemcpy(right_column.data, right_keys.data(), right_keys.size() * sizeof(int32_t), cudaMemcpyHostToDevice);
+    gdf_column_view(&left_column, left_column.data, nullptr, left_keys.size(), GDF_INT32);
+    gdf_column_view(&right_column, right_column.data, nullptr, right_keys.size(), GDF_INT32);
+
+    gdf_column * left_columns[] = {&left_column};
+    gdf_column * right_columns[] = {&right_column};
+    int join_cols[] = {0};
+    gdf_column left_result, right_result;
+    left_result.size = 0;
+    right_result.size = 0;
+    EXPECT_EQ(GDF_SUCCESS, gdf_inner_join(left_columns, 1, join_cols,
+                                          right_columns, 1, join_cols,
+                                          1, 0, nullptr,
+                                          &left_result, &right_result,
+                                          &ctxt));
+
+    // Every right key matches the left key of the same value
+    EXPECT_EQ(static_cast<gdf_size_type>(right_keys.size()), left_result.size);
+    if (left_result.size > 0) {
+      gdf_column_free(&left_result);
+      gdf_column_free(&right_result);
+    }
+    RMM_FREE(left_column.data, 0);
+    RMM_FREE(right_column.data, 0);
+
+    return stats.build_side_swapped;
+  }
+};
+
+TEST_F(JoinBuildSideTest, KeyStatistics)
+{
+  // 1000 unique left keys, and 1000 right rows of 10 keys
+  for (int i = 0; i < 1000; ++i) {
+    left_keys.push_back(i);
+    right_keys.push_back(i % 10);
+  }
+
+  // With equal sizes and no statistics the table is built on the right side
+  gdf_context ctxt;
+  gdf_context_view(&ctxt, 0, GDF_HASH, 0, 0, 0);
+  EXPECT_EQ(0, inner_join_build_side(ctxt));
+
+  // Many right rows per key make every probe of a table built on the right side
+  // read long runs of duplicates, so building on the unique left keys is cheaper
+  ctxt.join_left_distinct_keys = 1000;
+  ctxt.join_right_distinct_keys = 10;
+  EXPECT_EQ(1, inner_join_build_side(ctxt));
+}
+
+TEST_F(JoinBuildSideTest, CostHook)
+{
+  // 1500 left rows and 1000 right rows of unique keys
+  for (int i = 0; i < 1500; ++i) {
+    left_keys.push_back(i);
+    if (i < 1000) right_keys.push_back(i);
+  }
+
+  // By default the table is built on the smaller right side
+  gdf_context ctxt;
+  gdf_context_view(&ctxt, 0, GDF_HASH, 0, 0, 0);
+  EXPECT_EQ(0, inner_join_build_side(ctxt));
+
+  // A hook that prefers building on the larger side
+  ctxt.join_build_side_cost = [](size_t build_rows, size_t, size_t, size_t, size_t, int64_t) {
+    return -static_cast<double>(build_rows);
+  };
+  EXPECT_EQ(1, inner_join_build_side(ctxt));
+}
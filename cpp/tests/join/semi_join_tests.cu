@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include <cudf.h>
+#include <rmm/rmm.h>
+#include <cudf/functions.h>
+
+#include "tests/utilities/cudf_test_utils.cuh"
+#include "tests/utilities/cudf_test_fixtures.h"
+
+// Selects whether the matching or the non matching left rows are returned
+enum struct existence_join_op
+{
+  SEMI,
+  ANTI
+};
+
+// Returns row i of a tuple of vectors as a tuple of values
+template <typename... Tp, std::size_t... I>
+std::tuple<Tp...> get_row(std::tuple<std::vector<Tp>...> const & columns, size_t i,
+                          std::index_sequence<I...>)
+{
+  return std::make_tuple(std::get<I>(columns)[i]...);
+}
+
+template <typename... Tp>
+std::tuple<Tp...> get_row(std::tuple<std::vector<Tp>...> const & columns, size_t i)
+{
+  return get_row(columns, i, std::index_sequence_for<Tp...>{});
+}
+
+template <class test_parameters>
+struct SemiJoinTest : public GdfTest
+{
+  const existence_join_op op = test_parameters::op;
+
+  gdf_context ctxt{0, GDF_HASH, 0};
+
+  // multi_column_t is a tuple of vectors. The number of vectors in the tuple
+  // determines the number of columns to be joined, and the value_type of each
+  // vector determines the data type of the column
+  using multi_column_t = typename test_parameters::multi_column_t;
+  using row_t = decltype(get_row(std::declval<multi_column_t>(), 0));
+  static constexpr size_t num_columns = std::tuple_size<multi_column_t>::value;
+
+  multi_column_t left_columns;
+  multi_column_t right_columns;
+
+  // Whether each row is valid in every column. Rows are invalidated as a whole
+  // since a single NULL value is enough to prevent a row from matching.
+  std::vector<bool> left_row_valid;
+  std::vector<bool> right_row_valid;
+
+  std::vector<gdf_col_pointer> gdf_left_columns;
+  std::vector<gdf_col_pointer> gdf_right_columns;
+
+  std::vector<gdf_column*> gdf_raw_left_columns;
+  std::vector<gdf_column*> gdf_raw_right_columns;
+
+  SemiJoinTest()
+  {
+    // Use constant seed so the psuedo-random order is the same each time
+    // Each time the class is constructed a new constant seed is used
+    static size_t number_of_instantiations{0};
+    std::srand(number_of_instantiations++);
+  }
+
+  std::vector<gdf_col_pointer> make_gdf_columns(multi_column_t & host_columns,
+                                                std::vector<bool> const & row_valid)
+  {
+    if(0 == std::get<0>(host_columns).size()) {
+      // The test utilities cannot create empty columns, so create columns of
+      // one row and empty them
+      multi_column_t one_row;
+      initialize_tuple(one_row, 1, 1);
+      auto gdf_columns = initialize_gdf_columns(one_row);
+      for(auto & c : gdf_columns) {
+        c->size = 0;
+        c->null_count = 0;
+      }
+      return gdf_columns;
+    }
+    return initialize_gdf_columns(host_columns,
+                                  [&row_valid](size_t row, size_t col){ return row_valid[row]; });
+  }
+
+  /* --------------------------------------------------------------------------*
+   * @Synopsis  Initializes the left and right columns with random values
+   *
+   * @Param left_column_length The length of the left set of columns
+   * @Param left_column_range The upper bound of random values for the left
+   *                          columns. Values are [0, left_column_range)
+   * @Param right_column_length The length of the right set of columns
+   * @Param right_column_range The upper bound of random values for the right
+   *                           columns. Values are [0, right_column_range)
+   * @Param null_frequency If not 0, one row in null_frequency is NULL
+   * -------------------------------------------------------------------------*/
+  void create_input(size_t left_column_length, size_t left_column_range,
+                    size_t right_column_length, size_t right_column_range,
+                    size_t null_frequency = 0)
+  {
+    initialize_tuple(left_columns, left_column_length, left_column_range);
+    initialize_tuple(right_columns, right_column_length, right_column_range);
+
+    auto valid = [null_frequency](size_t row) {
+      return (0 == null_frequency) || (0 != (std::rand() % null_frequency));
+    };
+    left_row_valid.resize(left_column_length);
+    right_row_valid.resize(right_column_length);
+    for(size_t i = 0; i < left_column_length; ++i) left_row_valid[i] = valid(i);
+    for(size_t i = 0; i < right_column_length; ++i) right_row_valid[i] = valid(i);
+
+    gdf_left_columns = make_gdf_columns(left_columns, left_row_valid);
+    gdf_right_columns = make_gdf_columns(right_columns, right_row_valid);
+
+    gdf_raw_left_columns.clear();
+    gdf_raw_right_columns.clear();
+    for(auto const& c : gdf_left_columns) gdf_raw_left_columns.push_back(c.get());
+    for(auto const& c : gdf_right_columns) gdf_raw_right_columns.push_back(c.get());
+  }
+
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  Computes the reference solution on the host with a set of the
+   * valid right rows
+   *
+   * @Returns The indices of the selected left rows, in increasing order
+   */
+  /* ----------------------------------------------------------------------------*/
+  std::vector<int> compute_reference_solution()
+  {
+    std::set<row_t> right_rows;
+    for(size_t i = 0; i < right_row_valid.size(); ++i) {
+      if(right_row_valid[i]) right_rows.insert(get_row(right_columns, i));
+    }
+
+    std::vector<int> result;
+    for(size_t i = 0; i < left_row_valid.size(); ++i) {
+      const bool found = left_row_valid[i]
+                         && (right_rows.end() != right_rows.find(get_row(left_columns, i)));
+      if(found == (existence_join_op::SEMI == op)) result.push_back(i);
+    }
+    return result;
+  }
+
+  /* --------------------------------------------------------------------------*/
+  /**
+   * @Synopsis  Computes the result of the semi-join or anti-join on the device
+   *
+   * @Returns The indices of the selected left rows
+   */
+  /* ----------------------------------------------------------------------------*/
+  std::vector<int> compute_gdf_result(gdf_error expected_result = GDF_SUCCESS)
+  {
+    std::vector<int> join_cols(num_columns);
+    for(size_t i = 0; i < num_columns; ++i) join_cols[i] = i;
+
+    gdf_column left_result{};
+    gdf_error result_error{GDF_SUCCESS};
+    if(existence_join_op::SEMI == op) {
+      result_error = gdf_left_semi_join(gdf_raw_left_columns.data(), join_cols.data(),
+                                        gdf_raw_right_columns.data(), join_cols.data(),
+                                        num_columns, &left_result, &ctxt);
+    } else {
+      result_error = gdf_left_anti_join(gdf_raw_left_columns.data(), join_cols.data(),
+                                        gdf_raw_right_columns.data(), join_cols.data(),
+                                        num_columns, &left_result, &ctxt);
+    }
+    EXPECT_EQ(expected_result, result_error) << "The gdf join function did not complete successfully";
+
+    std::vector<int> result;
+    if(GDF_SUCCESS == result_error) {
+      EXPECT_EQ(GDF_INT32, left_result.dtype);
+      result.resize(left_result.size);
+      if(left_result.size > 0) {
+        EXPECT_EQ(cudaSuccess, cudaMemcpy(result.data(), left_result.data,
+                                          left_result.size * sizeof(int),
+                                          cudaMemcpyDeviceToHost));
+      }
+      if(nullptr != left_result.data) {
+        EXPECT_EQ(RMM_SUCCESS, RMM_FREE(left_result.data, 0));
+      }
+    }
+    return result;
+  }
+
+  void check(size_t left_length, size_t left_range,
+             size_t right_length, size_t right_range,
+             size_t null_frequency = 0)
+  {
+    create_input(left_length, left_range, right_length, right_range, null_frequency);
+    std::vector<int> reference_result = compute_reference_solution();
+    std::vector<int> gdf_result = compute_gdf_result();
+
+    // Both results are in increasing order, so they compare as is
+    ASSERT_EQ(reference_result.size(), gdf_result.size()) << "Size of gdf result does not match reference result\n";
+    EXPECT_EQ(reference_result, gdf_result);
+  }
+};
+
+template <existence_join_op join_operation, typename tuple_of_vectors>
+struct TestParameters
+{
+  const static existence_join_op op{join_operation};
+  using multi_column_t = tuple_of_vectors;
+};
+
+template <typename... T>
+using VTuple = std::tuple<std::vector<T>...>;
+
+typedef ::testing::Types<
+                          TestParameters< existence_join_op::SEMI, VTuple<int32_t> >,
+                          TestParameters< existence_join_op::SEMI, VTuple<int64_t> >,
+                          TestParameters< existence_join_op::SEMI, VTuple<int32_t, int64_t, double> >,
+                          TestParameters< existence_join_op::ANTI, VTuple<int32_t> >,
+                          TestParameters< existence_join_op::ANTI, VTuple<int64_t> >,
+                          TestParameters< existence_join_op::ANTI, VTuple<int32_t, int64_t, double> >
+                        > Implementations;
+
+TYPED_TEST_CASE(SemiJoinTest, Implementations);
+
+TYPED_TEST(SemiJoinTest, RandomValues)
+{
+  this->check(10000, 5000, 10000, 5000);
+}
+
+TYPED_TEST(SemiJoinTest, DuplicateRightKeys)
+{
+  // Every right key repeats about 100 times, but a left row is returned once
+  this->check(1000, 200, 10000, 100);
+}
+
+TYPED_TEST(SemiJoinTest, LeftColumnsBigger)
+{
+  this->check(10000, 100, 100, 100);
+}
+
+TYPED_TEST(SemiJoinTest, RightColumnsBigger)
+{
+  this->check(100, 1000, 10000, 1000);
+}
+
+TYPED_TEST(SemiJoinTest, NullRows)
+{
+  this->check(10000, 100, 10000, 100, 7);
+}
+
+TYPED_TEST(SemiJoinTest, RandomValues64BitHash)
+{
+  this->ctxt.flag_hash_64bit = 1;
+  this->check(10000, 5000, 10000, 5000);
+}
+
+TYPED_TEST(SemiJoinTest, EmptyRightFrame)
+{
+  this->check(1000, 100, 0, 100);
+}
+
+TYPED_TEST(SemiJoinTest, EmptyLeftFrame)
+{
+  this->check(0, 100, 1000, 100);
+}
+
+TYPED_TEST(SemiJoinTest, UnsupportedMethod)
+{
+  this->ctxt.flag_method = GDF_SORT;
+  this->create_input(100, 10, 100, 10);
+  this->compute_gdf_result(GDF_UNSUPPORTED_METHOD);
+}
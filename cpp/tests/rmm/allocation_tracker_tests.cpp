@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "gtest/gtest.h"
+#include <rmm/allocation_tracker.h>
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+// Helper macros to simplify testing for success or failure
+#define ASSERT_SUCCESS(res) ASSERT_EQ(RMM_SUCCESS, (res));
+#define ASSERT_FAILURE(res) ASSERT_NE(RMM_SUCCESS, (res));
+
+/// Host memory resource that tracks its allocations the same way rmmAlloc and
+/// rmmFree do, so the tracker can be tested without a device.
+struct HostMemoryResource {
+    rmm::AllocationTracker tracker;
+
+    rmmError_t allocate(void **ptr, size_t size, const char* file, unsigned int line) {
+        *ptr = std::malloc(size);
+        if (!*ptr) return RMM_ERROR_OUT_OF_MEMORY;
+        tracker.record_alloc(*ptr, size, 0, file, line);
+        return RMM_SUCCESS;
+    }
+
+    rmmError_t deallocate(void *ptr, const char* file, unsigned int line) {
+        rmmError_t result = tracker.check_free(ptr, 0, file, line);
+        if (RMM_SUCCESS != result) return result;
+        // std::free cannot fail, so the free is recorded first, which keeps
+        // ptr from being used after it is freed
+        result = tracker.record_free(ptr, 0, file, line);
+        std::free(ptr);
+        return result;
+    }
+};
+
+#define HOST_ALLOC(res, ptr, sz) (res).allocate((ptr), (sz), __FILE__, __LINE__)
+#define HOST_FREE(res, ptr) (res).deallocate((ptr), __FILE__, __LINE__)
+
+struct AllocationTrackerTest : public ::testing::Test {
+    HostMemoryResource resource;
+};
+
+TEST_F(AllocationTrackerTest, NoLeaks) {
+    void *a = nullptr, *b = nullptr;
+    ASSERT_SUCCESS( HOST_ALLOC(resource, &a, 16) );
+    ASSERT_SUCCESS( HOST_ALLOC(resource, &b, 32) );
+    EXPECT_EQ(2u, resource.tracker.outstanding_count());
+    EXPECT_EQ(48u, resource.tracker.outstanding_size());
+
+    ASSERT_SUCCESS( HOST_FREE(resource, a) );
+    ASSERT_SUCCESS( HOST_FREE(resource, b) );
+    EXPECT_EQ(0u, resource.tracker.outstanding_count());
+    EXPECT_EQ(0u, resource.tracker.outstanding_size());
+    EXPECT_EQ(0u, resource.tracker.double_free_count());
+    EXPECT_EQ(0u, resource.tracker.unknown_free_count());
+}
+
+TEST_F(AllocationTrackerTest, ReportsLeakWithLocation) {
+    void *a = nullptr, *b = nullptr;
+    ASSERT_SUCCESS( HOST_ALLOC(resource, &a, 100) );
+    unsigned int leak_line = __LINE__ + 1;
+    ASSERT_SUCCESS( HOST_ALLOC(resource, &b, 200) );
+    ASSERT_SUCCESS( HOST_FREE(resource, a) );
+
+    auto leaks = resource.tracker.outstanding();
+    ASSERT_EQ(1u, leaks.size());
+    EXPECT_EQ(b, leaks[0].ptr);
+    EXPECT_EQ(200u, leaks[0].size);
+    EXPECT_EQ(leak_line, leaks[0].line);
+
+    std::ostringstream report;
+    resource.tracker.report(report);
+    std::string location = std::string(__FILE__) + ":" + std::to_string(leak_line);
+    EXPECT_NE(std::string::npos, report.str().find(location));
+    EXPECT_NE(std::string::npos, report.str().find("1 outstanding allocation(s), 200 bytes"));
+
+    ASSERT_SUCCESS( HOST_FREE(resource, b) );
+}
+
+TEST_F(AllocationTrackerTest, DetectsDoubleFree) {
+    void *a = nullptr;
+    ASSERT_SUCCESS( HOST_ALLOC(resource, &a, 64) );
+    ASSERT_SUCCESS( HOST_FREE(resource, a) );
+    // The second free is rejected, so the host memory is not freed twice
+    ASSERT_FAILURE( HOST_FREE(resource, a) );
+    EXPECT_EQ(1u, resource.tracker.double_free_count());
+    EXPECT_EQ(0u, resource.tracker.unknown_free_count());
+
+    std::ostringstream report;
+    resource.tracker.report(report);
+    EXPECT_NE(std::string::npos, report.str().find("double free:"));
+}
+
+TEST_F(AllocationTrackerTest, DetectsUnknownFree) {
+    int not_allocated = 0;
+    ASSERT_FAILURE( HOST_FREE(resource, &not_allocated) );
+    EXPECT_EQ(0u, resource.tracker.double_free_count());
+    EXPECT_EQ(1u, resource.tracker.unknown_free_count());
+}
+
+TEST_F(AllocationTrackerTest, CheckedFreeStaysOutstanding) {
+    // A free that fails after the check leaves the allocation outstanding
+    void *a = nullptr;
+    ASSERT_SUCCESS( HOST_ALLOC(resource, &a, 64) );
+    ASSERT_SUCCESS( resource.tracker.check_free(a, 0, __FILE__, __LINE__) );
+    EXPECT_EQ(1u, resource.tracker.outstanding_count());
+    EXPECT_EQ(64u, resource.tracker.outstanding_size());
+
+    ASSERT_SUCCESS( HOST_FREE(resource, a) );
+    EXPECT_EQ(0u, resource.tracker.outstanding_count());
+    ASSERT_FAILURE( resource.tracker.check_free(a, 0, __FILE__, __LINE__) );
+    EXPECT_EQ(1u, resource.tracker.double_free_count());
+}
+
+TEST_F(AllocationTrackerTest, FreeNullIsNoop) {
+    ASSERT_SUCCESS( HOST_FREE(resource, nullptr) );
+    EXPECT_EQ(0u, resource.tracker.unknown_free_count());
+}
+
+TEST_F(AllocationTrackerTest, ReusedAddressIsNotDoubleFree) {
+    // Simulate an allocator handing out an address that was freed earlier
+    int storage = 0;
+    void *p = &storage;
+    resource.tracker.record_alloc(p, 4, 0, __FILE__, __LINE__);
+    ASSERT_SUCCESS( resource.tracker.record_free(p, 0, __FILE__, __LINE__) );
+    resource.tracker.record_alloc(p, 8, 0, __FILE__, __LINE__);
+    EXPECT_EQ(8u, resource.tracker.outstanding_size());
+    ASSERT_SUCCESS( resource.tracker.record_free(p, 0, __FILE__, __LINE__) );
+    EXPECT_EQ(0u, resource.tracker.double_free_count());
+}
+
+TEST_F(AllocationTrackerTest, BoundedFreeHistory) {
+    // With no free history every invalid free is reported as unknown
+    rmm::AllocationTracker tracker(0);
+    int storage = 0;
+    tracker.record_alloc(&storage, 4, 0, __FILE__, __LINE__);
+    ASSERT_SUCCESS( tracker.record_free(&storage, 0, __FILE__, __LINE__) );
+    ASSERT_FAILURE( tracker.record_free(&storage, 0, __FILE__, __LINE__) );
+    EXPECT_EQ(0u, tracker.double_free_count());
+    EXPECT_EQ(1u, tracker.unknown_free_count());
+}
+
+TEST_F(AllocationTrackerTest, Clear) {
+    void *a = nullptr;
+    ASSERT_SUCCESS( HOST_ALLOC(resource, &a, 64) );
+    ASSERT_FAILURE( HOST_FREE(resource, &resource) );
+    resource.tracker.clear();
+    EXPECT_EQ(0u, resource.tracker.outstanding_count());
+    EXPECT_EQ(0u, resource.tracker.unknown_free_count());
+    std::free(a);
+}
@@ -190,3 +190,68 @@ TEST_F(MemoryManagerTest, AllocationOffset) {
     ASSERT_SUCCESS( RMM_FREE(a, stream) );
     ASSERT_SUCCESS( RMM_FREE(b, stream) );
 }
+
+TEST_F(MemoryManagerTest, LeakTracking) {
+    // Restart the memory manager with leak tracking enabled
+    ASSERT_SUCCESS( rmmFinalize() );
+    rmmOptions_t options = { CudaDefaultAllocation, 0, false, true };
+    ASSERT_SUCCESS( rmmInitialize(&options) );
+
+    char *a = nullptr, *b = nullptr;
+    size_t count = 0, size = 0;
+    ASSERT_SUCCESS( RMM_ALLOC((void**)&a, size_kb, stream) );
+    ASSERT_SUCCESS( RMM_ALLOC((void**)&b, size_mb, stream) );
+    ASSERT_SUCCESS( rmmGetOutstandingAllocations(&count, &size) );
+    ASSERT_EQ(2u, count);
+    ASSERT_EQ(size_kb + size_mb, size);
+
+    ASSERT_SUCCESS( RMM_FREE(a, stream) );
+    ASSERT_FAILURE( RMM_FREE(a, stream) ); // double free
+    ASSERT_FAILURE( RMM_FREE(b + 1, stream) ); // unknown pointer
+    ASSERT_SUCCESS( rmmGetOutstandingAllocations(&count, &size) );
+    ASSERT_EQ(1u, count);
+    ASSERT_EQ(size_mb, size);
+
+    ASSERT_SUCCESS( RMM_FREE(b, stream) );
+    ASSERT_SUCCESS( rmmGetOutstandingAllocations(&count, &size) );
+    ASSERT_EQ(0u, count);
+
+    // Restore the default options for the remaining tests
+    ASSERT_SUCCESS( rmmFinalize() );
+    options.enable_leak_tracking = false;
+    ASSERT_SUCCESS( rmmInitialize(&options) );
+    ASSERT_FAILURE( rmmGetOutstandingAllocations(&count, &size) );
+}
+
+TEST_F(MemoryManagerTest, StreamOrderedPool) {
+    // Restart the memory manager with the stream-ordered pool
+    ASSERT_SUCCESS( rmmFinalize() );
+    rmmOptions_t options = { StreamOrderedPoolAllocation, 0, false, false };
+    ASSERT_SUCCESS( rmmInitialize(&options) );
+
+    cudaStream_t other;
+    ASSERT_EQ( cudaSuccess, cudaStreamCreate(&other) );
+
+    char *a = nullptr, *b = nullptr;
+    ASSERT_SUCCESS( RMM_ALLOC((void**)&a, size_mb, stream) );
+    ASSERT_SUCCESS( RMM_FREE(a, stream) );
+    // Reused on another stream, either directly or after a stream wait
+    ASSERT_SUCCESS( RMM_ALLOC((void**)&b, size_mb, other) );
+    ASSERT_EQ(a, b);
+    ASSERT_SUCCESS( RMM_REALLOC((void**)&b, size_kb, other) );
+    ASSERT_SUCCESS( RMM_FREE(b, other) );
+
+    // Every block is back in the pool
+    size_t freeSize = 0, totalSize = 0;
+    ASSERT_SUCCESS( rmmGetInfo(&freeSize, &totalSize, other) );
+    ASSERT_GE(totalSize, size_mb);
+    ASSERT_EQ(totalSize, freeSize);
+
+    ASSERT_EQ( cudaSuccess, cudaStreamSynchronize(other) );
+    ASSERT_EQ( cudaSuccess, cudaStreamDestroy(other) );
+
+    // Restore the default options for the remaining tests
+    ASSERT_SUCCESS( rmmFinalize() );
+    options.allocation_mode = CudaDefaultAllocation;
+    ASSERT_SUCCESS( rmmInitialize(&options) );
+}
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "gtest/gtest.h"
+#include <rmm/stream_ordered_pool.h>
+
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Helper macros to simplify testing for success or failure
+#define ASSERT_SUCCESS(res) ASSERT_EQ(RMM_SUCCESS, (res));
+#define ASSERT_FAILURE(res) ASSERT_NE(RMM_SUCCESS, (res));
+
+/// Simulated streams and events. Events complete only when the test says so,
+/// and stream waits are recorded so the test can check them.
+struct SimulatedState {
+    struct Event {
+        int stream{-1};
+        bool completed{true};
+        bool destroyed{false};
+    };
+
+    std::vector<std::unique_ptr<Event>> events;
+    std::vector<std::pair<int, Event*>> waits;
+    std::map<void*, size_t> sizes;
+    size_t capacity{size_t{1} << 20};
+    size_t in_use{0};
+    size_t allocations{0};
+    size_t deallocations{0};
+
+    /// Complete all work submitted to a stream so far
+    void synchronize(int stream) {
+        for (auto& e : events)
+            if (e->stream == stream) e->completed = true;
+    }
+};
+
+struct SimulatedBackend {
+    typedef int stream_type;
+    typedef SimulatedState::Event* event_type;
+
+    SimulatedState* state;
+
+    rmmError_t allocate(void **ptr, size_t size) {
+        if (state->in_use + size > state->capacity) return RMM_ERROR_OUT_OF_MEMORY;
+        *ptr = std::malloc(size);
+        state->sizes[*ptr] = size;
+        state->in_use += size;
+        ++state->allocations;
+        return RMM_SUCCESS;
+    }
+
+    rmmError_t deallocate(void *ptr) {
+        state->in_use -= state->sizes[ptr];
+        state->sizes.erase(ptr);
+        std::free(ptr);
+        ++state->deallocations;
+        return RMM_SUCCESS;
+    }
+
+    rmmError_t create_event(event_type *event) {
+        state->events.emplace_back(new SimulatedState::Event);
+        *event = state->events.back().get();
+        return RMM_SUCCESS;
+    }
+
+    rmmError_t destroy_event(event_type event) {
+        event->destroyed = true;
+        return RMM_SUCCESS;
+    }
+
+    rmmError_t record_event(event_type event, stream_type stream) {
+        event->stream = stream;
+        event->completed = false;
+        return RMM_SUCCESS;
+    }
+
+    bool event_completed(event_type event) { return event->completed; }
+
+    rmmError_t stream_wait_event(stream_type stream, event_type event) {
+        state->waits.emplace_back(stream, event);
+        return RMM_SUCCESS;
+    }
+};
+
+using Pool = rmm::StreamOrderedPool<SimulatedBackend>;
+
+struct StreamOrderedPoolTest : public ::testing::Test {
+    SimulatedState state;
+    Pool pool{SimulatedBackend{&state}};
+
+    const int stream_a = 1;
+    const int stream_b = 2;
+};
+
+TEST_F(StreamOrderedPoolTest, SameStreamReuse) {
+    void *a = nullptr, *b = nullptr;
+    ASSERT_SUCCESS( pool.allocate(&a, 1000, stream_a) );
+    ASSERT_SUCCESS( pool.deallocate(a, stream_a) );
+    // No synchronization needed: the block is reused in stream order
+    ASSERT_SUCCESS( pool.allocate(&b, 1000, stream_a) );
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(1u, state.allocations);
+    EXPECT_EQ(1u, pool.get_stats().same_stream_reuses);
+    EXPECT_TRUE(state.waits.empty());
+    ASSERT_SUCCESS( pool.deallocate(b, stream_a) );
+}
+
+TEST_F(StreamOrderedPoolTest, CrossStreamReuseAfterEventCompletes) {
+    void *a = nullptr, *b = nullptr;
+    ASSERT_SUCCESS( pool.allocate(&a, 4096, stream_a) );
+    ASSERT_SUCCESS( pool.deallocate(a, stream_a) );
+    state.synchronize(stream_a);
+
+    ASSERT_SUCCESS( pool.allocate(&b, 4096, stream_b) );
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(1u, state.allocations);
+    EXPECT_EQ(1u, pool.get_stats().cross_stream_reuses);
+    EXPECT_TRUE(state.waits.empty());
+
+    // The block now belongs to stream_b: a free there makes it reusable there
+    ASSERT_SUCCESS( pool.deallocate(b, stream_b) );
+    ASSERT_SUCCESS( pool.allocate(&a, 4096, stream_b) );
+    EXPECT_EQ(b, a);
+    EXPECT_EQ(1u, pool.get_stats().same_stream_reuses);
+    ASSERT_SUCCESS( pool.deallocate(a, stream_b) );
+}
+
+TEST_F(StreamOrderedPoolTest, CrossStreamReuseWithWait) {
+    void *a = nullptr, *b = nullptr;
+    ASSERT_SUCCESS( pool.allocate(&a, 4096, stream_a) );
+    ASSERT_SUCCESS( pool.deallocate(a, stream_a) );
+
+    // The free on stream_a has not completed: stream_b must wait for it
+    ASSERT_SUCCESS( pool.allocate(&b, 4096, stream_b) );
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(1u, state.allocations);
+    EXPECT_EQ(1u, pool.get_stats().cross_stream_waits);
+    ASSERT_EQ(1u, state.waits.size());
+    EXPECT_EQ(stream_b, state.waits[0].first);
+    EXPECT_EQ(stream_a, state.waits[0].second->stream);
+    ASSERT_SUCCESS( pool.deallocate(b, stream_b) );
+}
+
+TEST_F(StreamOrderedPoolTest, PrefersCompletedBlockOverWait) {
+    void *a = nullptr, *b = nullptr, *c = nullptr;
+    const int stream_c = 3;
+    ASSERT_SUCCESS( pool.allocate(&a, 4096, stream_a) );
+    ASSERT_SUCCESS( pool.allocate(&b, 4096, stream_c) );
+    ASSERT_SUCCESS( pool.deallocate(a, stream_a) );
+    ASSERT_SUCCESS( pool.deallocate(b, stream_c) );
+    state.synchronize(stream_c);
+
+    ASSERT_SUCCESS( pool.allocate(&c, 4096, stream_b) );
+    EXPECT_EQ(b, c);
+    EXPECT_TRUE(state.waits.empty());
+    ASSERT_SUCCESS( pool.deallocate(c, stream_b) );
+}
+
+TEST_F(StreamOrderedPoolTest, GrowsWhenNoBlockFits) {
+    void *a = nullptr, *b = nullptr, *c = nullptr;
+    ASSERT_SUCCESS( pool.allocate(&a, 1024, stream_a) );
+    ASSERT_SUCCESS( pool.deallocate(a, stream_a) );
+
+    // Too large for the free block
+    ASSERT_SUCCESS( pool.allocate(&b, 4096, stream_a) );
+    EXPECT_NE(a, b);
+    // Too small: reusing the 4KB block would waste more than half of it
+    ASSERT_SUCCESS( pool.deallocate(b, stream_a) );
+    ASSERT_SUCCESS( pool.allocate(&c, 256, stream_a) );
+    EXPECT_NE(b, c);
+    EXPECT_EQ(3u, pool.get_stats().backend_allocations);
+    EXPECT_EQ(1024u + 4096u + 256u, pool.get_stats().pool_size);
+    ASSERT_SUCCESS( pool.deallocate(c, stream_a) );
+}
+
+TEST_F(StreamOrderedPoolTest, AlignsSizes) {
+    void *a = nullptr;
+    ASSERT_SUCCESS( pool.allocate(&a, 1, stream_a) );
+    EXPECT_EQ(Pool::allocation_alignment, pool.allocation_size(a));
+    ASSERT_SUCCESS( pool.deallocate(a, stream_a) );
+    EXPECT_EQ(0u, pool.allocation_size(a));
+}
+
+TEST_F(StreamOrderedPoolTest, ReleasesCompletedBlocksOnOutOfMemory) {
+    state.capacity = 8192;
+    void *a = nullptr, *b = nullptr, *c = nullptr;
+    ASSERT_SUCCESS( pool.allocate(&a, 4096, stream_a) );
+    ASSERT_SUCCESS( pool.allocate(&b, 2048, stream_a) );
+    ASSERT_SUCCESS( pool.deallocate(b, stream_a) );
+
+    // Pending free blocks are kept; the pool is out of memory
+    ASSERT_FAILURE( pool.allocate(&c, 4096, stream_b) );
+
+    // Once the free has completed its block is returned to make room
+    state.synchronize(stream_a);
+    ASSERT_SUCCESS( pool.allocate(&c, 4096, stream_b) );
+    EXPECT_EQ(1u, state.deallocations);
+    EXPECT_EQ(0u, pool.free_block_count());
+    ASSERT_SUCCESS( pool.deallocate(a, stream_a) );
+    ASSERT_SUCCESS( pool.deallocate(c, stream_b) );
+}
+
+TEST_F(StreamOrderedPoolTest, InvalidFree) {
+    int not_allocated = 0;
+    ASSERT_FAILURE( pool.deallocate(&not_allocated, stream_a) );
+    ASSERT_SUCCESS( pool.deallocate(nullptr, stream_a) );
+    ASSERT_FAILURE( pool.allocate(nullptr, 16, stream_a) );
+}
+
+TEST_F(StreamOrderedPoolTest, Release) {
+    void *a = nullptr, *b = nullptr;
+    ASSERT_SUCCESS( pool.allocate(&a, 1024, stream_a) );
+    ASSERT_SUCCESS( pool.allocate(&b, 1024, stream_b) );
+    ASSERT_SUCCESS( pool.deallocate(a, stream_a) );
+    ASSERT_SUCCESS( pool.release() );
+    EXPECT_EQ(0u, pool.free_block_count());
+    EXPECT_EQ(1u, state.deallocations);
+    EXPECT_EQ(1024u, pool.get_stats().pool_size);
+    ASSERT_SUCCESS( pool.deallocate(b, stream_b) );
+}
+
+TEST_F(StreamOrderedPoolTest, GetInfo) {
+    void *a = nullptr, *b = nullptr;
+    size_t free_size = 1, total_size = 1;
+    pool.get_info(&free_size, &total_size);
+    EXPECT_EQ(0u, free_size);
+    EXPECT_EQ(0u, total_size);
+
+    ASSERT_SUCCESS( pool.allocate(&a, 1024, stream_a) );
+    ASSERT_SUCCESS( pool.allocate(&b, 4096, stream_b) );
+    ASSERT_SUCCESS( pool.deallocate(a, stream_a) );
+    pool.get_info(&free_size, &total_size);
+    EXPECT_EQ(1024u, free_size);
+    EXPECT_EQ(1024u + 4096u, total_size);
+
+    ASSERT_SUCCESS( pool.deallocate(b, stream_b) );
+    pool.get_info(&free_size, &total_size);
+    EXPECT_EQ(1024u + 4096u, free_size);
+    EXPECT_EQ(1024u + 4096u, total_size);
+}
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "gtest/gtest.h"
+#include "spill/spill_manager.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <vector>
+
+/// "Device" memory is host memory with an artificial capacity
+struct HostResource {
+    size_t capacity{0};
+    size_t in_use{0};
+    std::map<void*, size_t> sizes;
+};
+
+struct HostSpillBackend {
+    HostResource *device;
+    size_t *host_allocations;
+
+    gdf_error device_allocate(void **ptr, size_t size) {
+        if (device->in_use + size > device->capacity) return GDF_MEMORYMANAGER_ERROR;
+        *ptr = std::malloc(size);
+        device->sizes[*ptr] = size;
+        device->in_use += size;
+        return GDF_SUCCESS;
+    }
+
+    gdf_error device_free(void *ptr) {
+        device->in_use -= device->sizes[ptr];
+        device->sizes.erase(ptr);
+        std::free(ptr);
+        return GDF_SUCCESS;
+    }
+
+    gdf_error host_allocate(void **ptr, size_t size) {
+        *ptr = std::malloc(size);
+        ++*host_allocations;
+        return GDF_SUCCESS;
+    }
+
+    gdf_error host_free(void *ptr) {
+        std::free(ptr);
+        --*host_allocations;
+        return GDF_SUCCESS;
+    }
+
+    gdf_error copy_to_host(void *dst, const void *src, size_t size) {
+        std::memcpy(dst, src, size);
+        return GDF_SUCCESS;
+    }
+
+    gdf_error copy_to_device(void *dst, const void *src, size_t size) {
+        std::memcpy(dst, src, size);
+        return GDF_SUCCESS;
+    }
+};
+
+using Manager = cudf::SpillManager<HostSpillBackend>;
+
+struct SpillManagerTest : public ::testing::Test {
+    HostResource device;
+    size_t host_allocations{0};
+    Manager manager{HostSpillBackend{&device, &host_allocations}};
+
+    SpillManagerTest() { device.capacity = 4096; }
+
+    /// Allocate a "device" buffer filled with value, spilling on failure the
+    /// way the RMM out of memory callback does
+    void* allocate(size_t size, char value) {
+        void *ptr = nullptr;
+        HostSpillBackend& backend = manager.get_backend();
+        while (GDF_SUCCESS != backend.device_allocate(&ptr, size)) {
+            if (0 == manager.spill(size)) return nullptr;
+        }
+        std::memset(ptr, value, size);
+        return ptr;
+    }
+
+    gdf_spill_handle make_spillable(size_t size, char value) {
+        gdf_spill_handle handle = 0;
+        void *ptr = allocate(size, value);
+        EXPECT_NE(nullptr, ptr);
+        EXPECT_EQ(GDF_SUCCESS, manager.register_buffer(ptr, size, &handle));
+        return handle;
+    }
+
+    void expect_contents(gdf_spill_handle handle, size_t size, char value) {
+        void *ptr = nullptr;
+        ASSERT_EQ(GDF_SUCCESS, manager.acquire(handle, &ptr));
+        std::vector<char> expected(size, value);
+        EXPECT_EQ(0, std::memcmp(expected.data(), ptr, size));
+        ASSERT_EQ(GDF_SUCCESS, manager.release(handle));
+    }
+
+    void free_buffer(gdf_spill_handle handle) {
+        void *ptr = nullptr;
+        ASSERT_EQ(GDF_SUCCESS, manager.unregister(handle, &ptr));
+        manager.get_backend().device_free(ptr);
+    }
+};
+
+TEST_F(SpillManagerTest, SpillsLeastRecentlyUsed) {
+    gdf_spill_handle a = make_spillable(1024, 'a');
+    gdf_spill_handle b = make_spillable(1024, 'b');
+    gdf_spill_handle c = make_spillable(1024, 'c');
+
+    // Touch a so that b becomes the coldest buffer
+    expect_contents(a, 1024, 'a');
+
+    EXPECT_EQ(1024u, manager.spill(1000));
+    EXPECT_FALSE(manager.is_spilled(a));
+    EXPECT_TRUE(manager.is_spilled(b));
+    EXPECT_FALSE(manager.is_spilled(c));
+    EXPECT_EQ(2048u, device.in_use);
+
+    auto stats = manager.get_stats();
+    EXPECT_EQ(1u, stats.spill_count);
+    EXPECT_EQ(2048u, stats.device_bytes);
+    EXPECT_EQ(1024u, stats.host_bytes);
+
+    free_buffer(a);
+    free_buffer(b);
+    free_buffer(c);
+    EXPECT_EQ(0u, device.in_use);
+    EXPECT_EQ(0u, host_allocations);
+}
+
+TEST_F(SpillManagerTest, AllocationUnderPressureSpills) {
+    gdf_spill_handle a = make_spillable(2048, 'a');
+    gdf_spill_handle b = make_spillable(2048, 'b');
+
+    // The device is full: the allocation only succeeds by spilling a
+    void *ptr = allocate(2048, 'x');
+    ASSERT_NE(nullptr, ptr);
+    EXPECT_TRUE(manager.is_spilled(a));
+    EXPECT_FALSE(manager.is_spilled(b));
+
+    manager.get_backend().device_free(ptr);
+    free_buffer(a);
+    free_buffer(b);
+}
+
+TEST_F(SpillManagerTest, UnspillOnAcquire) {
+    gdf_spill_handle a = make_spillable(2048, 'a');
+    gdf_spill_handle b = make_spillable(2048, 'b');
+    ASSERT_EQ(2048u, manager.spill(2048));
+    ASSERT_TRUE(manager.is_spilled(a));
+
+    // Device is half full: a is brought back, and b is spilled to make room
+    void *ptr = allocate(2048, 'x');
+    ASSERT_NE(nullptr, ptr);
+    expect_contents(a, 2048, 'a');
+    EXPECT_FALSE(manager.is_spilled(a));
+    EXPECT_TRUE(manager.is_spilled(b));
+    EXPECT_EQ(1u, manager.get_stats().unspill_count);
+
+    manager.get_backend().device_free(ptr);
+    expect_contents(b, 2048, 'b');
+    free_buffer(a);
+    free_buffer(b);
+}
+
+TEST_F(SpillManagerTest, AcquiredBuffersAreNotSpilled) {
+    gdf_spill_handle a = make_spillable(2048, 'a');
+    gdf_spill_handle b = make_spillable(2048, 'b');
+
+    void *pa = nullptr, *pb = nullptr;
+    ASSERT_EQ(GDF_SUCCESS, manager.acquire(a, &pa));
+    ASSERT_EQ(GDF_SUCCESS, manager.acquire(b, &pb));
+    EXPECT_EQ(0u, manager.spill(1));
+    EXPECT_EQ(nullptr, allocate(16, 'x'));
+
+    // Nested acquire: still pinned after one release
+    ASSERT_EQ(GDF_SUCCESS, manager.acquire(a, &pa));
+    ASSERT_EQ(GDF_SUCCESS, manager.release(a));
+    EXPECT_EQ(0u, manager.spill(1));
+    ASSERT_EQ(GDF_SUCCESS, manager.release(a));
+    EXPECT_EQ(2048u, manager.spill(1));
+    EXPECT_TRUE(manager.is_spilled(a));
+
+    ASSERT_EQ(GDF_SUCCESS, manager.release(b));
+    free_buffer(a);
+    free_buffer(b);
+}
+
+TEST_F(SpillManagerTest, AcquireFailsWhenNothingCanBeSpilled) {
+    gdf_spill_handle a = make_spillable(4096, 'a');
+    ASSERT_EQ(4096u, manager.spill(1));
+    void *ptr = allocate(4096, 'x');
+    ASSERT_NE(nullptr, ptr);
+
+    void *pa = nullptr;
+    EXPECT_NE(GDF_SUCCESS, manager.acquire(a, &pa));
+    EXPECT_TRUE(manager.is_spilled(a));
+
+    manager.get_backend().device_free(ptr);
+    expect_contents(a, 4096, 'a');
+    free_buffer(a);
+}
+
+TEST_F(SpillManagerTest, UnregistersAllOrNothing) {
+    gdf_spill_handle a = make_spillable(2048, 'a');
+    gdf_spill_handle b = make_spillable(2048, 'b');
+    ASSERT_EQ(4096u, manager.spill(4096));
+    void *ptr = allocate(2048, 'x');
+    ASSERT_NE(nullptr, ptr);
+
+    // a fits back on the device, b does not: neither is unregistered, and a
+    // is not spilled again to make room for b
+    gdf_spill_handle handles[2] = {a, b};
+    void *ptrs[2] = {nullptr, nullptr};
+    EXPECT_NE(GDF_SUCCESS, manager.unregister(handles, 2, ptrs));
+    EXPECT_FALSE(manager.is_spilled(a));
+    EXPECT_TRUE(manager.is_spilled(b));
+    expect_contents(a, 2048, 'a');
+
+    manager.get_backend().device_free(ptr);
+    ASSERT_EQ(GDF_SUCCESS, manager.unregister(handles, 2, ptrs));
+    EXPECT_EQ(0u, manager.get_stats().device_bytes);
+    EXPECT_EQ(0u, manager.get_stats().host_bytes);
+    EXPECT_EQ('a', *static_cast<char*>(ptrs[0]));
+    EXPECT_EQ('b', *static_cast<char*>(ptrs[1]));
+    manager.get_backend().device_free(ptrs[0]);
+    manager.get_backend().device_free(ptrs[1]);
+}
+
+TEST_F(SpillManagerTest, InvalidHandles) {
+    void *ptr = nullptr;
+    gdf_spill_handle handle = 0;
+    EXPECT_EQ(GDF_INVALID_API_CALL, manager.acquire(42, &ptr));
+    EXPECT_EQ(GDF_INVALID_API_CALL, manager.release(42));
+    EXPECT_EQ(GDF_INVALID_API_CALL, manager.unregister(42, &ptr));
+    EXPECT_EQ(GDF_DATASET_EMPTY, manager.register_buffer(nullptr, 16, &handle));
+
+    gdf_spill_handle a = make_spillable(16, 'a');
+    EXPECT_EQ(GDF_INVALID_API_CALL, manager.release(a));
+    ASSERT_EQ(GDF_SUCCESS, manager.acquire(a, &ptr));
+    EXPECT_EQ(GDF_INVALID_API_CALL, manager.unregister(a, &ptr));
+    ASSERT_EQ(GDF_SUCCESS, manager.release(a));
+    free_buffer(a);
+}
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <cudf.h>
+#include <rmm/rmm.h>
+#include <cudf/functions.h>
+#include <rmm/thrust_rmm_allocator.h>
+#include <sqls/packed_keys.h>
+#include <utilities/bit_util.cuh>
+
+#include <thrust/copy.h>
+#include <thrust/device_vector.h>
+
+#include "tests/utilities/cudf_test_utils.cuh"
+#include "tests/utilities/cudf_test_fixtures.h"
+
+template<typename T>
+using Vector = thrust::device_vector<T, rmm_allocator<T>>;
+
+// Sorts random columns with gdf_order_by_asc_desc and gdf_order_by, and checks
+// the permutations against a stable sort of the rows on the host
+struct OrderByTest : public GdfTest
+{
+  std::vector<int32_t> a;
+  std::vector<double> b;
+  std::vector<int8_t> c;
+  std::vector<int64_t> d;
+  std::vector<bool> a_valid;
+  std::vector<bool> c_valid;
+
+  OrderByTest()
+  {
+    std::srand(0);
+  }
+
+  // Few distinct values per column, so that the rows tie on every prefix of
+  // the columns
+  void create_input(size_t num_rows)
+  {
+    a.resize(num_rows);
+    b.resize(num_rows);
+    c.resize(num_rows);
+    d.resize(num_rows);
+    a_valid.resize(num_rows);
+    c_valid.resize(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+      a[i] = std::rand() % 5 - 2;
+      b[i] = (std::rand() % 5 - 2) * 0.25;
+      c[i] = static_cast<int8_t>(std::rand() % 5 - 2);
+      d[i] = (std::rand() % 2) ? std::numeric_limits<int64_t>::min() : int64_t(std::rand() % 5 - 2);
+      a_valid[i] = (std::rand() % 4) != 0;
+      c_valid[i] = (std::rand() % 4) != 0;
+    }
+  }
+
+  static std::vector<gdf_valid_type> to_masks(std::vector<bool> const & valid)
+  {
+    std::vector<gdf_valid_type> masks(gdf_get_num_chars_bitmask(valid.size()), 0);
+    for (size_t i = 0; i < valid.size(); ++i) {
+      if (valid[i]) gdf::util::turn_bit_on(masks.data(), i);
+    }
+    return masks;
+  }
+
+  // Sorts the columns, and returns the sorted row indices
+  std::vector<size_t> order_by(std::vector<gdf_column> & columns,
+                               std::vector<order_by_type> & orders,
+                               std::vector<gdf_null_order> & null_orders,
+                               gdf_error expected_error = GDF_SUCCESS)
+  {
+    const size_t num_rows = columns[0].size;
+    Vector<size_t> d_indx(num_rows);
+    EXPECT_EQ(expected_error, gdf_order_by_asc_desc(num_rows, columns.data(), columns.size(),
+                                                    orders.data(), null_orders.data(),
+                                                    d_indx.data().get()));
+    std::vector<size_t> indx(num_rows);
+    thrust::copy(d_indx.begin(), d_indx.end(), indx.begin());
+    return indx;
+  }
+
+  // The rows sorted by a stable sort on the host
+  template <typename Less>
+  std::vector<size_t> host_order_by(Less less)
+  {
+    std::vector<size_t> indx(a.size());
+    std::iota(indx.begin(), indx.end(), 0);
+    std::stable_sort(indx.begin(), indx.end(), less);
+    return indx;
+  }
+};
+
+TEST_F(OrderByTest, AscendingAndDescendingWithNulls)
+{
+  // 170 bits: the keys are three words, with columns straddling words
+  create_input(10000);
+  gdf_col_pointer a_column = create_gdf_column(a, to_masks(a_valid));
+  gdf_col_pointer b_column = create_gdf_column(b, to_masks(std::vector<bool>(b.size(), true)));
+  gdf_col_pointer c_column = create_gdf_column(c, to_masks(c_valid));
+  gdf_col_pointer d_column = create_gdf_column(d, to_masks(std::vector<bool>(d.size(), true)));
+  std::vector<gdf_column> columns{*a_column, *b_column, *c_column, *d_column};
+  std::vector<order_by_type> orders{GDF_ORDER_ASC, GDF_ORDER_DESC, GDF_ORDER_DESC, GDF_ORDER_ASC};
+  std::vector<gdf_null_order> null_orders{GDF_NULLS_FIRST, GDF_NULLS_LAST, GDF_NULLS_LAST, GDF_NULLS_LAST};
+
+  const std::vector<size_t> expected = host_order_by([&](size_t i, size_t j) {
+    if (a_valid[i] != a_valid[j]) return !a_valid[i];
+    if (a_valid[i] && (a[i] != a[j])) return a[i] < a[j];
+    if (b[i] != b[j]) return b[i] > b[j];
+    if (c_valid[i] != c_valid[j]) return c_valid[i];
+    if (c_valid[i] && (c[i] != c[j])) return c[i] > c[j];
+    return d[i] < d[j];
+  });
+  EXPECT_EQ(expected, order_by(columns, orders, null_orders));
+}
+
+TEST_F(OrderByTest, OneWordKeys)
+{
+  create_input(10000);
+  gdf_col_pointer c_column = create_gdf_column(c, to_masks(c_valid));
+  gdf_col_pointer a_column = create_gdf_column(a, to_masks(std::vector<bool>(a.size(), true)));
+  std::vector<gdf_column> columns{*c_column, *a_column};
+  std::vector<order_by_type> orders{GDF_ORDER_DESC, GDF_ORDER_DESC};
+  std::vector<gdf_null_order> null_orders{GDF_NULLS_FIRST, GDF_NULLS_FIRST};
+
+  const std::vector<size_t> expected = host_order_by([&](size_t i, size_t j) {
+    if (c_valid[i] != c_valid[j]) return !c_valid[i];
+    if (c_valid[i] && (c[i] != c[j])) return c[i] > c[j];
+    return a[i] > a[j];
+  });
+  EXPECT_EQ(expected, order_by(columns, orders, null_orders));
+}
+
+TEST_F(OrderByTest, OrderByWithoutNulls)
+{
+  // gdf_order_by sorts the columns ascending, through their normalized keys
+  create_input(10000);
+  gdf_col_pointer b_column = create_gdf_column(b, to_masks(std::vector<bool>(b.size(), true)));
+  gdf_col_pointer d_column = create_gdf_column(d, to_masks(std::vector<bool>(d.size(), true)));
+  std::vector<gdf_column> columns{*b_column, *d_column};
+
+  Vector<void*> d_cols(columns.size());
+  Vector<int> d_types(columns.size());
+  Vector<size_t> d_indx(b.size());
+  EXPECT_EQ(GDF_SUCCESS, gdf_order_by(b.size(), columns.data(), columns.size(),
+                                      d_cols.data().get(), d_types.data().get(),
+                                      d_indx.data().get()));
+  std::vector<size_t> indx(b.size());
+  thrust::copy(d_indx.begin(), d_indx.end(), indx.begin());
+
+  const std::vector<size_t> expected = host_order_by([&](size_t i, size_t j) {
+    return (b[i] != b[j]) ? (b[i] < b[j]) : (d[i] < d[j]);
+  });
+  EXPECT_EQ(expected, indx);
+}
+
+TEST_F(OrderByTest, UnsupportedColumns)
+{
+  create_input(10);
+  gdf_col_pointer a_column = create_gdf_column(a, to_masks(std::vector<bool>(a.size(), true)));
+  std::vector<order_by_type> orders(MAX_NORMALIZED_KEY_COLUMNS + 1, GDF_ORDER_ASC);
+  std::vector<gdf_null_order> null_orders(MAX_NORMALIZED_KEY_COLUMNS + 1, GDF_NULLS_LAST);
+
+  std::vector<gdf_column> date_columns{*a_column};
+  date_columns[0].dtype = GDF_DATE32;
+  order_by(date_columns, orders, null_orders, GDF_UNSUPPORTED_DTYPE);
+
+  std::vector<gdf_column> too_many(MAX_NORMALIZED_KEY_COLUMNS + 1, *a_column);
+  order_by(too_many, orders, null_orders, GDF_COLUMN_SIZE_TOO_BIG);
+
+  // cub's radix sort takes the number of rows as an int
+  const size_t too_many_rows = static_cast<size_t>(std::numeric_limits<int>::max()) + 1;
+  std::vector<gdf_column> int_columns{*a_column};
+  Vector<size_t> d_indx(1);
+  EXPECT_EQ(GDF_COLUMN_SIZE_TOO_BIG, gdf_order_by_asc_desc(too_many_rows, int_columns.data(), 1,
+                                                           orders.data(), null_orders.data(),
+                                                           d_indx.data().get()));
+}
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2018, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <sqls/packed_keys.h>
+#include <utilities/cudf_utils.h>
+
+// The key packing is __host__ __device__, so its ordering is checked on the host
+
+namespace {
+
+// Checks that the normalized keys of the sorted values are sorted, and that
+// only equal values have equal normalized keys
+template <typename T>
+void check_order_preserved(std::vector<T> values)
+{
+  std::sort(values.begin(), values.end());
+  for (size_t i = 1; i < values.size(); ++i) {
+    if (values[i - 1] < values[i]) {
+      EXPECT_LT(normalize_key(values[i - 1]), normalize_key(values[i]))
+          << values[i - 1] << " < " << values[i];
+    }
+    else {
+      EXPECT_EQ(normalize_key(values[i - 1]), normalize_key(values[i]))
+          << values[i - 1] << " == " << values[i];
+    }
+  }
+}
+
+template <typename T>
+gdf_column make_column(std::vector<T> & values, gdf_dtype dtype)
+{
+  gdf_column column{};
+  column.data = values.data();
+  column.size = static_cast<gdf_size_type>(values.size());
+  column.dtype = dtype;
+  return column;
+}
+
+// The normalized key of a row, word by word
+std::vector<uint64_t> normalized_key(normalized_key_layout const & layout, size_t row)
+{
+  std::vector<uint64_t> key(layout.num_words());
+  for (int w = 0; w < layout.num_words(); ++w) {
+    key[w] = layout.key_word(row, w);
+  }
+  return key;
+}
+
+std::vector<gdf_valid_type> make_valid(std::vector<bool> const & valid)
+{
+  std::vector<gdf_valid_type> bits((valid.size() + GDF_VALID_BITSIZE - 1) / GDF_VALID_BITSIZE, 0);
+  for (size_t i = 0; i < valid.size(); ++i) {
+    if (valid[i]) bits[i / GDF_VALID_BITSIZE] |= gdf_valid_type{1} << (i % GDF_VALID_BITSIZE);
+  }
+  return bits;
+}
+
+// -1, 0 or 1 as a compares less than, equal to or greater than b
+template <typename T>
+int compare(T const & a, T const & b)
+{
+  return (a < b) ? -1 : ((b < a) ? 1 : 0);
+}
+
+}  // namespace
+
+TEST(PackedKeysTest, SignedIntegersKeepTheirOrder)
+{
+  check_order_preserved<int8_t>({-128, -127, -1, 0, 1, 126, 127});
+  check_order_preserved<int16_t>({-32768, -300, -1, 0, 1, 300, 32767});
+  check_order_preserved<int32_t>({std::numeric_limits<int32_t>::min(), -70000, -1, 0, 1, 70000,
+                                  std::numeric_limits<int32_t>::max()});
+  check_order_preserved<int64_t>({std::numeric_limits<int64_t>::min(), -(int64_t{1} << 40), -1, 0, 1,
+                                  int64_t{1} << 40, std::numeric_limits<int64_t>::max()});
+}
+
+TEST(PackedKeysTest, NormalizedKeysUseTheWidthOfTheValue)
+{
+  EXPECT_EQ(uint64_t{0}, normalize_key(int8_t{-128}));
+  EXPECT_EQ(uint64_t{0xff}, normalize_key(int8_t{127}));
+  EXPECT_EQ(uint64_t{0x80000000}, normalize_key(int32_t{0}));
+  EXPECT_EQ(~uint64_t{0}, normalize_key(std::numeric_limits<int64_t>::max()));
+  EXPECT_GE(uint64_t{0xffffffff}, normalize_key(std::numeric_limits<float>::infinity()));
+}
+
+TEST(PackedKeysTest, FloatsKeepTheirOrder)
+{
+  const double infinity = std::numeric_limits<double>::infinity();
+  check_order_preserved<double>({-infinity, -std::numeric_limits<double>::max(), -1.5, -1.0,
+                                 -std::numeric_limits<double>::denorm_min(), 0.0,
+                                 std::numeric_limits<double>::denorm_min(), 1.0, 1.5,
+                                 std::numeric_limits<double>::max(), infinity});
+  const float infinity_f = std::numeric_limits<float>::infinity();
+  check_order_preserved<float>({-infinity_f, -3.5f, -1.0f, -1e-30f, 0.0f, 1e-30f, 1.0f, 3.5f, infinity_f});
+}
+
+TEST(PackedKeysTest, NegativeZeroAndNaNAreNormalized)
+{
+  EXPECT_EQ(normalize_key(0.0), normalize_key(-0.0));
+  EXPECT_EQ(normalize_key(0.0f), normalize_key(-0.0f));
+
+  // Every NaN is the same key, greater than infinity
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_EQ(normalize_key(nan), normalize_key(-nan));
+  EXPECT_EQ(normalize_key(nan), normalize_key(std::numeric_limits<double>::signaling_NaN()));
+  EXPECT_LT(normalize_key(std::numeric_limits<double>::infinity()), normalize_key(nan));
+  EXPECT_EQ(normalize_key(std::numeric_limits<float>::quiet_NaN()),
+            normalize_key(-std::numeric_limits<float>::quiet_NaN()));
+}
+
+TEST(PackedKeysTest, PackedKeysFollowTheRowOrder)
+{
+  // Every combination of a few values per column, in any order
+  std::vector<int8_t> a;
+  std::vector<float> b;
+  std::vector<int16_t> c;
+  for (int8_t va : {-100, -1, 0, 1, 100}) {
+    for (float vb : {-2.5f, -0.0f, 0.0f, 1.0f}) {
+      for (int16_t vc : {-1000, -1, 0, 999}) {
+        a.push_back(va);
+        b.push_back(vb);
+        c.push_back(vc);
+      }
+    }
+  }
+  std::srand(0);
+  for (size_t i = a.size() - 1; i > 0; --i) {
+    const size_t j = std::rand() % (i + 1);
+    std::swap(a[i], a[j]);
+    std::swap(b[i], b[j]);
+    std::swap(c[i], c[j]);
+  }
+
+  gdf_column columns[] = {make_column(a, GDF_INT8), make_column(b, GDF_FLOAT32), make_column(c, GDF_INT16)};
+  packed_key_layout layout;
+  ASSERT_TRUE(make_packed_key_layout(3, columns, layout));
+  EXPECT_EQ(56, layout.total_bits);
+  EXPECT_EQ(48, layout.shifts[0]);
+  EXPECT_EQ(16, layout.shifts[1]);
+  EXPECT_EQ(0, layout.shifts[2]);
+
+  auto row = [&](size_t i) { return std::make_tuple(a[i], b[i], c[i]); };
+  for (size_t i = 0; i < a.size(); ++i) {
+    EXPECT_GT(uint64_t{1} << layout.total_bits, layout.pack(i));
+    for (size_t j = 0; j < a.size(); ++j) {
+      EXPECT_EQ(row(i) < row(j), layout.pack(i) < layout.pack(j)) << "rows " << i << ", " << j;
+      EXPECT_EQ(row(i) == row(j), layout.pack(i) == layout.pack(j)) << "rows " << i << ", " << j;
+    }
+  }
+}
+
+TEST(PackedKeysTest, WideOrUnsupportedKeysAreNotPacked)
+{
+  std::vector<int64_t> a(4);
+  std::vector<int32_t> b(4);
+  std::vector<int32_t> c(4);
+  packed_key_layout layout;
+
+  gdf_column fits[] = {make_column(b, GDF_INT32), make_column(c, GDF_INT32)};
+  EXPECT_TRUE(make_packed_key_layout(2, fits, layout));
+  EXPECT_EQ(64, layout.total_bits);
+
+  gdf_column too_wide[] = {make_column(a, GDF_INT64), make_column(b, GDF_INT32)};
+  EXPECT_FALSE(make_packed_key_layout(2, too_wide, layout));
+
+  gdf_column unsupported[] = {make_column(b, GDF_DATE32)};
+  EXPECT_FALSE(make_packed_key_layout(1, unsupported, layout));
+
+  gdf_valid_type valid{0x0e};
+  gdf_column with_nulls[] = {make_column(b, GDF_INT32)};
+  with_nulls[0].valid = &valid;
+  with_nulls[0].null_count = 1;
+  EXPECT_FALSE(make_packed_key_layout(1, with_nulls, layout));
+
+  EXPECT_FALSE(make_packed_key_layout(0, fits, layout));
+}
+
+TEST(PackedKeysTest, RadixSortableRowsFitAnInt)
+{
+  const size_t max_int = static_cast<size_t>(std::numeric_limits<int>::max());
+  EXPECT_TRUE(radix_sortable_rows(0));
+  EXPECT_TRUE(radix_sortable_rows(max_int));
+  EXPECT_FALSE(radix_sortable_rows(max_int + 1));
+  EXPECT_FALSE(radix_sortable_rows(std::numeric_limits<size_t>::max()));
+}
+
+TEST(PackedKeysTest, NormalizedKeysFollowTheOrderBy)
+{
+  // Ascending int32 with NULLs first, ascending double, descending int8 with
+  // NULLs last and descending int64: 170 bits, in three words
+  const size_t num_rows = 300;
+  std::srand(1);
+  std::vector<int32_t> a(num_rows);
+  std::vector<double> b(num_rows);
+  std::vector<int8_t> c(num_rows);
+  std::vector<int64_t> d(num_rows);
+  std::vector<bool> a_valid(num_rows), c_valid(num_rows);
+  for (size_t i = 0; i < num_rows; ++i) {
+    a[i] = std::rand() % 3 - 1;
+    b[i] = (std::rand() % 3 - 1) * 0.5;
+    c[i] = static_cast<int8_t>(std::rand() % 5 - 2);
+    d[i] = (std::rand() % 2) ? std::numeric_limits<int64_t>::min() : int64_t(std::rand() % 3 - 1);
+    a_valid[i] = (std::rand() % 4) != 0;
+    c_valid[i] = (std::rand() % 4) != 0;
+  }
+  std::vector<gdf_valid_type> a_bits = make_valid(a_valid);
+  std::vector<gdf_valid_type> c_bits = make_valid(c_valid);
+
+  gdf_column columns[] = {make_column(a, GDF_INT32), make_column(b, GDF_FLOAT64),
+                          make_column(c, GDF_INT8), make_column(d, GDF_INT64)};
+  columns[0].valid = a_bits.data();
+  columns[0].null_count = static_cast<gdf_size_type>(std::count(a_valid.begin(), a_valid.end(), false));
+  columns[2].valid = c_bits.data();
+  columns[2].null_count = static_cast<gdf_size_type>(std::count(c_valid.begin(), c_valid.end(), false));
+  const bool descending[] = {false, false, true, true};
+  const bool nulls_first[] = {true, true, false, false};
+
+  normalized_key_layout layout;
+  ASSERT_TRUE(make_normalized_key_layout(4, columns, descending, nulls_first, false, layout));
+  EXPECT_EQ(170, layout.total_bits);
+  EXPECT_EQ(3, layout.num_words());
+  EXPECT_EQ(0, layout.offsets[0]);
+  EXPECT_EQ(33, layout.offsets[1]);
+  EXPECT_EQ(97, layout.offsets[2]);
+  EXPECT_EQ(106, layout.offsets[3]);
+
+  // The reference order, column by column
+  auto compare_rows = [&](size_t i, size_t j) {
+    if (a_valid[i] != a_valid[j]) return a_valid[i] ? 1 : -1;
+    if (a_valid[i] && (a[i] != a[j])) return compare(a[i], a[j]);
+    if (b[i] != b[j]) return compare(b[i], b[j]);
+    if (c_valid[i] != c_valid[j]) return c_valid[i] ? -1 : 1;
+    if (c_valid[i] && (c[i] != c[j])) return -compare(c[i], c[j]);
+    return -compare(d[i], d[j]);
+  };
+  for (size_t i = 0; i < num_rows; ++i) {
+    const std::vector<uint64_t> key_i = normalized_key(layout, i);
+    // The low bits of the last word are unused
+    EXPECT_EQ(uint64_t{0}, key_i[2] & ((uint64_t{1} << (3 * 64 - 170)) - 1));
+    for (size_t j = 0; j < num_rows; ++j) {
+      EXPECT_EQ(compare_rows(i, j), compare(key_i, normalized_key(layout, j)))
+          << "rows " << i << " and " << j;
+    }
+  }
+}
+
+TEST(PackedKeysTest, NormalizedKeysOfOneColumn)
+{
+  std::vector<int16_t> values{-2, 5, 0, 7};
+  std::vector<gdf_valid_type> valid = make_valid({true, true, false, true});
+  gdf_column columns[] = {make_column(values, GDF_INT16)};
+  columns[0].valid = valid.data();
+  columns[0].null_count = 1;
+
+  auto order = [&](bool descending, bool nulls_first, bool ignore_nulls) {
+    normalized_key_layout layout;
+    EXPECT_TRUE(make_normalized_key_layout(1, columns, &descending, &nulls_first, ignore_nulls, layout));
+    std::vector<size_t> rows{0, 1, 2, 3};
+    std::stable_sort(rows.begin(), rows.end(), [&](size_t i, size_t j) {
+      return layout.key_word(i, 0) < layout.key_word(j, 0);
+    });
+    return rows;
+  };
+  EXPECT_EQ((std::vector<size_t>{0, 1, 3, 2}), order(false, false, false));
+  EXPECT_EQ((std::vector<size_t>{2, 0, 1, 3}), order(false, true, false));
+  EXPECT_EQ((std::vector<size_t>{3, 1, 0, 2}), order(true, false, false));
+  EXPECT_EQ((std::vector<size_t>{2, 3, 1, 0}), order(true, true, false));
+
+  // Ignoring the NULLs sorts them by their data, the 0 of row 2
+  EXPECT_EQ((std::vector<size_t>{0, 2, 1, 3}), order(false, false, true));
+
+  normalized_key_layout layout;
+  ASSERT_TRUE(make_normalized_key_layout(1, columns, nullptr, nullptr, true, layout));
+  EXPECT_EQ(16, layout.total_bits);
+  EXPECT_EQ(1, layout.num_words());
+  EXPECT_EQ(uint64_t{0x8000} << 48, layout.key_word(2, 0));
+}
+
+TEST(PackedKeysTest, NormalizedKeysOfUnsupportedColumns)
+{
+  std::vector<int32_t> values(10);
+  gdf_column date_column[] = {make_column(values, GDF_DATE32)};
+  normalized_key_layout layout;
+  EXPECT_FALSE(make_normalized_key_layout(1, date_column, nullptr, nullptr, false, layout));
+
+  std::vector<gdf_column> too_many(MAX_NORMALIZED_KEY_COLUMNS + 1, make_column(values, GDF_INT32));
+  EXPECT_FALSE(make_normalized_key_layout(MAX_NORMALIZED_KEY_COLUMNS + 1, too_many.data(),
+                                          nullptr, nullptr, false, layout));
+  EXPECT_TRUE(make_normalized_key_layout(MAX_NORMALIZED_KEY_COLUMNS, too_many.data(),
+                                         nullptr, nullptr, false, layout));
+  EXPECT_EQ(16, layout.num_words());
+  EXPECT_FALSE(make_normalized_key_layout(0, too_many.data(), nullptr, nullptr, false, layout));
+}
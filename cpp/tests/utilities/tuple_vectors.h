@@ -143,4 +143,24 @@ rows_equal(const std::tuple<std::vector<Tp>...>& left, const std::tuple<std::vec
         return false;
 }
 
+// compile time recursion to compute the lexicographic order of two rows
+// in two tuples of vectors
+template<std::size_t I = 0, typename... Tp>
+inline typename std::enable_if<I == (sizeof...(Tp)), bool>::type
+rows_less(const std::tuple<std::vector<Tp>...>& left, const std::tuple<std::vector<Tp>...>& right, const size_t left_index, const size_t right_index)
+{
+    // bottom of recursion: the rows are equal
+    return false;
+}
+template<std::size_t I = 0, typename... Tp>
+inline typename std::enable_if<I < sizeof...(Tp), bool>::type
+rows_less(const std::tuple<std::vector<Tp>...>& left, const std::tuple<std::vector<Tp>...>& right, const size_t left_index, const size_t right_index)
+{
+    if(std::get<I>(left)[left_index] < std::get<I>(right)[right_index])
+        return true;
+    if(std::get<I>(right)[right_index] < std::get<I>(left)[left_index])
+        return false;
+    return rows_less<I + 1, Tp...>(left, right, left_index, right_index);
+}
+
 #endif
@@ -204,7 +204,8 @@ _join_how_api = {
 
 _join_method_api = {
     'sort': libgdf.GDF_SORT,
-    'hash': libgdf.GDF_HASH
+    'hash': libgdf.GDF_HASH,
+    'hash_partitioned': libgdf.GDF_HASH_PARTITIONED
 }
 
 
@@ -442,8 +443,9 @@ class SegmentedRadixortPlan(object):
                                                    unwrap_devary(d_ends[s:]))
 
 
-def hash_columns(columns, result):
-    """Hash the *columns* and store in *result*.
+def hash_columns(columns, result, seed=0):
+    """Hash the *columns* with the hash function of the given *seed* and
+    store in *result*.
     Returns *result*
     """
     assert len(columns) > 0
@@ -455,11 +457,11 @@ def hash_columns(columns, result):
     col_out = result.cffi_view
     ncols = len(col_input)
     hashfn = libgdf.GDF_HASH_MURMUR3
-    libgdf.gdf_hash(ncols, col_input, hashfn, col_out)
+    libgdf.gdf_hash(ncols, col_input, hashfn, seed, col_out)
     return result
 
 
-def hash_partition(input_columns, key_indices, nparts, output_columns):
+def hash_partition(input_columns, key_indices, nparts, output_columns, seed=0):
     """Partition the input_columns by the hash values on the keys.
 
     Parameters
@@ -469,6 +471,9 @@ def hash_partition(input_columns, key_indices, nparts, output_columns):
         Indices into `input_columns` that indicates the key columns.
     nparts : int
         number of partitions
+    seed : int
+        seed of the hash function; re-partition a partition with a
+        different seed to split it further
 
     Returns
     -------
@@ -490,7 +495,8 @@ def hash_partition(input_columns, key_indices, nparts, output_columns):
         nparts,
         col_outputs,
         offsets,
-        hashfn
+        hashfn,
+        seed
     )
 
     offsets = list(offsets)
@@ -6,7 +6,7 @@
 # cython: language_level = 3
 
 from libcpp cimport bool
-from numpy cimport uint8_t, int64_t, int32_t, int16_t, int8_t
+from numpy cimport uint8_t, uint32_t, int64_t, int32_t, int16_t, int8_t
 
 # Utility functions to build gdf_columns, gdf_context and error handling
 
@@ -80,6 +80,7 @@ cdef extern from "cudf.h" nogil:
     ctypedef enum gdf_hash_func:
         GDF_HASH_MURMUR3=0,
         GDF_HASH_IDENTITY,
+        GDF_HASH_MURMUR3_64,
 
 
     ctypedef enum gdf_time_unit:
@@ -104,8 +105,13 @@ cdef extern from "cudf.h" nogil:
     ctypedef enum gdf_method:
       GDF_SORT = 0,
       GDF_HASH,
+      GDF_HASH_PARTITIONED,
       N_GDF_METHODS,
 
+    ctypedef enum gdf_groupby_strategy:
+      GDF_GROUPBY_AUTO = 0,
+      GDF_GROUPBY_GLOBAL_TABLE,
+      GDF_GROUPBY_SHARED_MEMORY,
 
     ctypedef enum gdf_quantile_method:
       GDF_QUANT_LINEAR =0,
@@ -122,6 +128,11 @@ cdef extern from "cudf.h" nogil:
       GDF_AVG,
       GDF_COUNT,
       GDF_COUNT_DISTINCT,
+      GDF_VAR,
+      GDF_STD,
+      GDF_FIRST,
+      GDF_LAST,
+      GDF_MEDIAN,
       N_GDF_AGG_OPS,
 
     ctypedef enum gdf_color:
@@ -136,12 +147,38 @@ cdef extern from "cudf.h" nogil:
       GDF_ORANGE,
       GDF_NUM_COLORS,
 
+    ctypedef struct gdf_hash_table_stats:
+      size_t table_size
+      size_t num_entries
+      double load_factor
+      double mean_probe_length
+      size_t max_probe_length
+      size_t num_hash_collisions
+      int build_side_swapped
+
+    ctypedef double (*gdf_join_build_side_cost)(size_t build_rows,
+                                                size_t build_distinct_keys,
+                                                size_t probe_rows,
+                                                size_t probe_distinct_keys,
+                                                size_t entry_size,
+                                                int64_t occupancy_percent)
+
     ctypedef struct gdf_context:
       int flag_sorted
       gdf_method flag_method
       int flag_distinct
       int flag_sort_result
       int flag_sort_inplace
+      size_t cardinality_hint
+      int flag_hash_64bit
+      gdf_hash_table_stats *hash_table_stats
+      size_t max_partition_rows
+      int flag_exact_join_size
+      int flag_groupby_include_nulls
+      gdf_groupby_strategy groupby_strategy
+      size_t join_left_distinct_keys
+      size_t join_right_distinct_keys
+      gdf_join_build_side_cost join_build_side_cost
 
     ctypedef struct _OpaqueIpcParser:
         pass
@@ -160,10 +197,26 @@ cdef extern from "cudf.h" nogil:
     ctypedef struct  gdf_segmented_radixsort_plan_type:
         pass
 
+
+    ctypedef struct _OpaqueJoinHashTable:
+        pass
+    ctypedef struct  gdf_join_hash_table:
+        pass
+
+    ctypedef gdf_error (*gdf_join_chunk_callback)(gdf_size_type chunk_begin,
+                                                  gdf_size_type chunk_end,
+                                                  gdf_column * probe_indices,
+                                                  gdf_column * build_indices,
+                                                  void * user_data)
+
     ctypedef enum order_by_type:
         GDF_ORDER_ASC,
         GDF_ORDER_DESC
 
+    ctypedef enum gdf_null_order:
+        GDF_NULLS_LAST,
+        GDF_NULLS_FIRST
+
     ctypedef enum gdf_comparison_operator:
         GDF_EQUALS,
         GDF_NOT_EQUALS,
@@ -340,6 +393,58 @@ cdef extern from "cudf.h" nogil:
                              gdf_column * right_indices,
                              gdf_context *join_context)
 
+    cdef gdf_error gdf_left_semi_join(
+                             gdf_column **left_cols,
+                             int left_join_cols[],
+                             gdf_column **right_cols,
+                             int right_join_cols[],
+                             int num_cols_to_join,
+                             gdf_column * left_indices,
+                             gdf_context *join_context)
+
+    cdef gdf_error gdf_left_anti_join(
+                             gdf_column **left_cols,
+                             int left_join_cols[],
+                             gdf_column **right_cols,
+                             int right_join_cols[],
+                             int num_cols_to_join,
+                             gdf_column * left_indices,
+                             gdf_context *join_context)
+
+    cdef gdf_error gdf_asof_join(gdf_column *left_on,
+                             gdf_column *right_on,
+                             gdf_column **left_by,
+                             gdf_column **right_by,
+                             int num_by_cols,
+                             int64_t tolerance,
+                             gdf_column * left_indices,
+                             gdf_column * right_indices,
+                             gdf_context *join_context)
+
+    cdef gdf_error gdf_join_build(gdf_column **build_cols,
+                             int num_cols,
+                             gdf_join_hash_table **hash_table,
+                             gdf_context *join_context)
+
+    cdef gdf_error gdf_join_probe(gdf_join_hash_table *hash_table,
+                             gdf_column **probe_cols,
+                             int num_cols,
+                             int left_join,
+                             gdf_column * probe_indices,
+                             gdf_column * build_indices,
+                             gdf_context *join_context)
+
+    cdef gdf_error gdf_join_probe_chunked(gdf_join_hash_table *hash_table,
+                             gdf_column **probe_cols,
+                             int num_cols,
+                             int left_join,
+                             gdf_size_type chunk_rows,
+                             gdf_join_chunk_callback callback,
+                             void *user_data,
+                             gdf_context *join_context)
+
+    cdef gdf_error gdf_join_hash_table_free(gdf_join_hash_table *hash_table)
+
     cdef gdf_error gdf_hash_partition(int num_input_cols,
                                  gdf_column * input[],
                                  int columns_to_hash[],
@@ -347,14 +452,30 @@ cdef extern from "cudf.h" nogil:
                                  int num_partitions,
                                  gdf_column * partitioned_output[],
                                  int partition_offsets[],
-                                 gdf_hash_func hash)
+                                 gdf_hash_func hash,
+                                 uint32_t seed)
+
+    cdef gdf_error gdf_hash_partition_two_level(int num_input_cols,
+                                 gdf_column * input[],
+                                 int columns_to_hash[],
+                                 int num_cols_to_hash,
+                                 int num_partitions,
+                                 int num_sub_partitions,
+                                 gdf_column * partitioned_output[],
+                                 int partition_offsets[],
+                                 int sub_partition_offsets[],
+                                 gdf_hash_func hash,
+                                 uint32_t seed,
+                                 uint32_t sub_seed)
 
     cdef gdf_error gdf_prefixsum_generic(gdf_column *inp, gdf_column *out, int inclusive)
     cdef gdf_error gdf_prefixsum_i8(gdf_column *inp, gdf_column *out, int inclusive)
     cdef gdf_error gdf_prefixsum_i32(gdf_column *inp, gdf_column *out, int inclusive)
     cdef gdf_error gdf_prefixsum_i64(gdf_column *inp, gdf_column *out, int inclusive)
 
-    cdef gdf_error gdf_hash(int num_cols, gdf_column **input, gdf_hash_func hash, gdf_column *output)
+    cdef gdf_error gdf_hash(int num_cols, gdf_column **input, gdf_hash_func hash, uint32_t seed, gdf_column *output)
+
+    cdef gdf_error gdf_approx_count_distinct(int num_cols, gdf_column **input, int precision, size_t *count)
 
     cdef gdf_error gdf_sin_generic(gdf_column *input, gdf_column *output)
     cdef gdf_error gdf_sin_f32(gdf_column *input, gdf_column *output)
@@ -606,6 +727,13 @@ cdef extern from "cudf.h" nogil:
                    int* d_types,
                    size_t* d_indx)
 
+    cdef gdf_error gdf_order_by_asc_desc(size_t nrows,
+                   gdf_column* cols,
+                   size_t ncols,
+                   order_by_type* orders,
+                   gdf_null_order* null_orders,
+                   size_t* d_indx)
+
     cdef gdf_error gdf_filter(size_t nrows,
                  gdf_column* cols,
                  size_t ncols,
@@ -662,6 +790,45 @@ cdef extern from "cudf.h" nogil:
                                  gdf_column* out_col_agg,
                                  gdf_context* ctxt)
 
+    cdef gdf_error gdf_group_by(int ncols,
+                                gdf_column** cols,
+                                int num_aggs,
+                                gdf_column** col_aggs,
+                                gdf_agg_op* agg_ops,
+                                gdf_column** out_col_values,
+                                gdf_column** out_col_aggs,
+                                gdf_context* ctxt)
+
+    cdef int gdf_group_by_num_partial_columns(gdf_agg_op op)
+
+    cdef gdf_error gdf_group_by_partial(int ncols,
+                                gdf_column** cols,
+                                int num_aggs,
+                                gdf_column** col_aggs,
+                                gdf_agg_op* agg_ops,
+                                gdf_column** out_col_values,
+                                gdf_column** out_col_partials,
+                                gdf_context* ctxt)
+
+    cdef gdf_error gdf_group_by_merge(int ncols,
+                                gdf_column** cols,
+                                int num_aggs,
+                                gdf_column** col_partials,
+                                gdf_agg_op* agg_ops,
+                                gdf_column** out_col_values,
+                                gdf_column** out_col_aggs,
+                                gdf_context* ctxt)
+
+    cdef gdf_error gdf_group_by_quantile(int ncols,
+                                gdf_column** cols,
+                                gdf_column* col_agg,
+                                gdf_column* out_col_indices,
+                                gdf_column** out_col_values,
+                                gdf_column* out_col_agg,
+                                double q,
+                                gdf_quantile_method method,
+                                gdf_context* ctxt)
+
     cdef gdf_error gdf_quantile_exact(   gdf_column*         col_in,
                                     gdf_quantile_method prec,
                                     double              q,
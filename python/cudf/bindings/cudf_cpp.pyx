@@ -166,7 +166,8 @@ cdef gdf_column* column_view_from_NDArrays(size, data, mask, dtype,
 
 _join_method_api = {
     'sort': GDF_SORT,
-    'hash': GDF_HASH
+    'hash': GDF_HASH,
+    'hash_partitioned': GDF_HASH_PARTITIONED
 }
 
 cdef gdf_context* create_context_view(flag_sorted, method, flag_distinct,